@@ -1038,6 +1038,8 @@ class LoadOption {
   int req_num_threads;
   bool triangulate;
   bool verbose;
+  std::string mtl_basedir;  // prepended to a relative mtllib path, with a
+                            // trailing separator. empty means the cwd.
 };
 
 /// Parse wavefront .obj(.obj string data is expanded to linear char array
@@ -1449,13 +1451,22 @@ bool parseObj(attrib_t *attrib, std::vector<shape_t> *shapes,
     if (material_filename.back() == '\r') {
       material_filename.pop_back();
     }
-    std::ifstream ifs(material_filename);
+    std::string material_path = material_filename;
+    bool absolute = material_filename[0] == '/' || material_filename[0] == '\\' ||
+                    (material_filename.size() > 1 && material_filename[1] == ':');
+    if (!absolute) {
+      material_path = option.mtl_basedir + material_filename;
+    }
+    std::ifstream ifs(material_path);
     if (ifs.good()) {
       LoadMtl(&material_map, materials, &ifs);
 
       // std::cout << "maetrials = " << materials.size() << std::endl;
 
       ifs.close();
+    } else {
+      std::cerr << "WARN: failed to open mtllib '" << material_path << "'"
+                << std::endl;
     }
 
     auto t2 = std::chrono::high_resolution_clock::now();
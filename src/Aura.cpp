@@ -1,125 +1,126 @@
 #include "Aura.h"
+#include <chrono>
 
 namespace Aura {
-    void Aura::run() {
+    static double elapsedMs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+
+    void Aura::run(bool headless, uint32_t headless_frame_count) {
+        this->headless_frame_count = headless_frame_count;
+        startup(headless);
+        mainLoop();
+
         
+    }
+
+    void Aura::startup(bool headless) {
+        this->headless = headless;
+
+        job_system.initialize(jobWorkerCount());
+
         rhi = new VulkanRHI();
+        rhi->m_headless = headless;
+        rhi->m_job_system = &job_system;
+        configureRHI(rhi);
         rhi->initialize();
         rhi->render_test();
         initialize();
-        mainLoop();
-
-        
     }
 
     void Aura::initialize() {
         
-        setupRenderPass();
-        setupFrameBuffers();
+        setupRenderGraph();
         setupDescriptorSetLayout();
     }
-    void Aura::setupRenderPass() {
-        
-        RHIAttachmentDescription colorAttachment{};
-        
-        colorAttachment.format = rhi->m_swapchain_image_format;
-        
-        colorAttachment.samples = RHI_SAMPLE_COUNT_1_BIT;
-        colorAttachment.loadOp = RHI_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachment.storeOp = RHI_ATTACHMENT_STORE_OP_STORE;
-        colorAttachment.stencilLoadOp = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachment.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        
-        RHIAttachmentDescription depthAttachment{};
-        depthAttachment.format = rhi->m_depth_image_format;
-        depthAttachment.samples = RHI_SAMPLE_COUNT_1_BIT;
-        depthAttachment.loadOp = RHI_ATTACHMENT_LOAD_OP_CLEAR;
-        depthAttachment.storeOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthAttachment.stencilLoadOp = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
-        depthAttachment.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthAttachment.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
-        depthAttachment.finalLayout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-    
-        RHIAttachmentDescription attachments[] = {colorAttachment, depthAttachment};
-        
-
 
-        RHIAttachmentReference colorAttachmentRef{};
-        colorAttachmentRef.attachment = 0;
-        colorAttachmentRef.layout = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    void Aura::setupRenderGraph() {
+        render_graph.initialize(rhi);
 
-        RHIAttachmentReference depthAttachmentRef{};
-        depthAttachmentRef.attachment = 1;
-        depthAttachmentRef.layout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        RenderGraphImageDesc back_buffer_desc{};
+        back_buffer_desc.format = rhi->m_swapchain_image_format;
+        // offscreen targets are left ready for readback instead of presentation
+        back_buffer = render_graph.importImage("back_buffer",
+                                               back_buffer_desc,
+                                               RHI_IMAGE_LAYOUT_UNDEFINED,
+                                               headless ? RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
+        RenderGraphImageDesc depth_desc{};
+        depth_desc.format = rhi->m_depth_image_format;
+        depth_buffer = render_graph.createImage("depth", depth_desc);
 
+        buildRenderGraph(render_graph);
+        if (!render_graph.compile()) {
+            throw std::runtime_error("failed to compile render graph");
+        }
+    }
 
-        RHISubpassDescription subpass{};
-        subpass.pipelineBindPoint = RHI_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentRef;
-        subpass.pDepthStencilAttachment = &depthAttachmentRef;
-        RHISubpassDescription subpasses[] = {subpass};
-
-        RHISubpassDependency dependency{};
-        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dependency.dstSubpass = 0;
-        dependency.srcStageMask = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstStageMask = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-        dependency.dstAccessMask = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        RHISubpassDependency dependencies[] = {dependency};
-        
-        RHIRenderPassCreateInfo renderpass_create_info {};
-        renderpass_create_info.sType = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderpass_create_info.attachmentCount = (sizeof(attachments) / sizeof(attachments[0]));
-        renderpass_create_info.pAttachments    = attachments;
-        renderpass_create_info.subpassCount    = (sizeof(subpasses) / sizeof(subpasses[0]));
-        renderpass_create_info.pSubpasses      = subpasses;
-        renderpass_create_info.dependencyCount = (sizeof(dependencies) / sizeof(dependencies[0]));
-        renderpass_create_info.pDependencies   = dependencies;
-        
-        if (rhi->createRenderPass(&renderpass_create_info, renderpass) != RHI_SUCCESS) {
-            throw std::runtime_error("failed to create render pass");
+    void Aura::buildRenderGraph(RenderGraph& graph) {
+        RenderGraphPassBuilder pass = graph.addPass("main_pass", [this](RHICommandBuffer command_buffer) { recordScene(command_buffer); });
+        pass.writeColor(back_buffer).writeDepth(depth_buffer);
+        if (recordsSceneInParallel()) {
+            pass.setRecordsInParallel();
         }
+        main_pass = pass.getPass();
     }
     void Aura::mainLoop() {
-        while (!glfwWindowShouldClose(rhi->m_window)) {
-            glfwPollEvents();
-            drawFrame();
+        if (headless) {
+            for (uint32_t i = 0; i < headless_frame_count; ++i) {
+                drawFrame();
+            }
+        }
+        else {
+            while (!glfwWindowShouldClose(rhi->m_window)) {
+                drawFrame();
+            }
         }
 
-        vkDeviceWaitIdle(rhi->m_device);
+        shutdown();
+    }
+
+    void Aura::shutdown() {
+        job_system.shutdown();
+        render_graph.shutdown();
+        rhi->shutdown();
     }
 
     void Aura::drawFrame() {
+            auto frame_begin = std::chrono::steady_clock::now();
             rhi->waitForFences();
-            rhi->prepareBeforePass();
+            auto fences_end = std::chrono::steady_clock::now();
+            frame_limiter.wait();
+            auto limiter_end = std::chrono::steady_clock::now();
+            if (!headless) {
+                glfwPollEvents();
+            }
+            rhi->markInputSampled();
+            auto recreate_framebuffers = [this]() { render_graph.invalidate(); };
+            bool prepared = rhi->prepareBeforePass(recreate_framebuffers);
+            auto prepare_end = std::chrono::steady_clock::now();
+            last_frame_timings.wait_for_fences_ms = elapsedMs(frame_begin, fences_end);
+            last_frame_timings.limiter_ms = elapsedMs(fences_end, limiter_end);
+            last_frame_timings.prepare_before_pass_ms = elapsedMs(limiter_end, prepare_end);
+            if (!prepared) {
+                last_frame_timings.record_ms = 0.0;
+                last_frame_timings.submit_ms = 0.0;
+                last_frame_timings.total_ms = elapsedMs(frame_begin, prepare_end);
+                return;
+            }
 
+            RHICommandBuffer command_buffer = rhi->getCurrentCommandBuffer();
+            render_graph.setImportedImage(back_buffer,
+                                          rhi->m_swapchain_rhi_images[rhi->m_current_swapchain_image_index],
+                                          rhi->m_swapchain_imageviews[rhi->m_current_swapchain_image_index]);
+            render_graph.execute(command_buffer);
+            auto record_end = std::chrono::steady_clock::now();
 
-    }
+            rhi->submitRendering(recreate_framebuffers);
+            auto submit_end = std::chrono::steady_clock::now();
+
+            last_frame_timings.record_ms = elapsedMs(prepare_end, record_end);
+            last_frame_timings.submit_ms = elapsedMs(record_end, submit_end);
+            last_frame_timings.total_ms = elapsedMs(frame_begin, submit_end);
 
-    void Aura::setupFrameBuffers() {
-        const std::vector<RHIImageView*>& imageViews = rhi->m_swapchain_imageviews;
-        framebuffers.resize(imageViews.size());
-        for (size_t i = 0; i < framebuffers.size(); i++) { 
-            RHIImageView* attachments[2] = { imageViews[i], rhi->m_depth_image_view};
-
-            RHIFramebufferCreateInfo framebuffer_create_info{};
-            framebuffer_create_info.sType = RHI_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebuffer_create_info.renderPass = renderpass;
-            framebuffer_create_info.attachmentCount = sizeof(attachments) / sizeof(attachments[0]);
-            framebuffer_create_info.pAttachments = attachments;
-            framebuffer_create_info.width = rhi->m_swapchain_extent.width;
-            framebuffer_create_info.height = rhi->m_swapchain_extent.height;
-            framebuffer_create_info.layers = 1;
-
-            if (rhi->createFramebuffer(&framebuffer_create_info, framebuffers[i]) !=RHI_SUCCESS) {
-                throw std::runtime_error("create inefficient pick framebuffer");
-            }
-        }
     }
 
     void Aura::setupDescriptorSetLayout() {
@@ -2,24 +2,68 @@
 
 #include "render/interface/vulkan_rhi/vulkan_rhi.h"
 #include "render/interface/rhi.h"
+#include "render/render_graph.h"
+#include "util/frame_limiter.h"
+#include "util/job_system.h"
 
 namespace Aura {
+    // cpu time spent in each stage of the last drawFrame()
+    struct FrameTimings {
+        double wait_for_fences_ms{0.0};
+        double limiter_ms{0.0};
+        double prepare_before_pass_ms{0.0};
+        double record_ms{0.0};
+        double submit_ms{0.0};
+        double total_ms{0.0};
+    };
+
     class Aura {
         public:
-            void run();
-        private:
+            virtual ~Aura() = default;
+            void run(bool headless = false, uint32_t headless_frame_count = 1000);
+            void startup(bool headless);
+            void drawFrame();
+            // drains the job system, then waits for the gpu and releases the RHI's threads
+            void shutdown();
+            const FrameTimings& getLastFrameTimings() const { return last_frame_timings; }
+            VulkanRHI* getRHI() const { return rhi; }
+            JobSystem& getJobSystem() { return job_system; }
+            const RenderGraph& getRenderGraph() const { return render_graph; }
+            // caps the frame rate, 0 renders as fast as the present mode allows
+            void setFrameRateLimit(double fps) { frame_limiter.setTargetFps(fps); }
+        protected:
             VulkanRHI* rhi;
-            RHIRenderPass* renderpass;
-            std::vector<RHIFramebuffer*> framebuffers;
-            RHIDescriptorSetLayout* layout;
+            bool headless{false};
+            uint32_t headless_frame_count{0};
+            // rebuilt from buildRenderGraph() once, recompiled when the swapchain is recreated
+            RenderGraph render_graph;
+            RenderGraphResource back_buffer{k_invalid_render_graph_resource};
+            RenderGraphResource depth_buffer{k_invalid_render_graph_resource};
+            uint32_t main_pass{0};
+            RHIDescriptorSetLayout layout;
             std::vector<RHIDescriptorSet> descriptorSets;
+            FrameTimings last_frame_timings;
+            // culling, recording, asset decoding and upload preparation fan out over this
+            JobSystem job_system;
+            // runs after the frame slot is free and before input is polled, so waiting never delays input
+            FrameLimiter frame_limiter;
+            // records the scene into the main render pass, empty by default
+            virtual void recordScene(RHICommandBuffer command_buffer) {}
+            // true when recordScene only issues cmdRecordParallel, the main pass then takes secondaries
+            virtual bool recordsSceneInParallel() const { return false; }
+            // declares the frame's passes, the default is a single main pass into the back buffer. back_buffer
+            // and depth_buffer are set up before it runs
+            virtual void buildRenderGraph(RenderGraph& graph);
+            // tweaks the RHI settings before it is initialized
+            virtual void configureRHI(VulkanRHI* rhi) {}
+            // job system workers next to the main thread, one per remaining core by default
+            virtual uint32_t jobWorkerCount() const { return std::max(std::thread::hardware_concurrency(), 1u) - 1; }
+        private:
             void mainLoop();
-            void drawFrame();
             void initialize();
-            void setupRenderPass();
-            void setupFrameBuffers();
+            void setupRenderGraph();
             void setupDescriptorSetLayout();
             void setupVertexBuffer();
             void setupDescriptorSet();
     };
-}
\ No newline at end of file
+}
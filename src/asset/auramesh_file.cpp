@@ -0,0 +1,124 @@
+#include "auramesh_file.h"
+#include "vertex_layout.h"
+
+#include <iostream>
+
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+
+namespace Aura
+{
+    static bool sectionFits(uint64_t offset, uint64_t size, uint64_t file_size)
+    {
+        return offset % k_auramesh_alignment == 0 && size <= file_size && offset <= file_size - size;
+    }
+
+    bool AuraMeshFile::open(const std::string& path)
+    {
+        close();
+        if (!m_file.open(path))
+        {
+            LOG_ERROR("failed to open " << path);
+            return false;
+        }
+        // mappings start on a page boundary, the header can be read in place
+        m_header = (const AuraMeshHeader*)m_file.getData();
+        if (!validate(path))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void AuraMeshFile::close()
+    {
+        m_file.close();
+        m_header = nullptr;
+    }
+
+    const char* AuraMeshFile::getMaterialName(uint32_t material) const
+    {
+        const uint8_t* names = m_file.getData() + m_header->material_name_offset;
+        return material < m_header->material_count ? (const char*)names + ((const uint32_t*)names)[material] : "";
+    }
+
+    // indices are not range-checked against vertex_count, that would mean reading the whole index section.
+    // the same goes for the meshlet vertex and triangle lists, only the meshlets' runs of them are checked
+    bool AuraMeshFile::validate(const std::string& path) const
+    {
+        uint64_t file_size = m_file.getSize();
+        if (file_size < sizeof(AuraMeshHeader) || m_header->magic != k_auramesh_magic)
+        {
+            LOG_ERROR(path << " is not an .auramesh");
+            return false;
+        }
+        if (m_header->version != k_auramesh_version)
+        {
+            LOG_ERROR(path << " has version " << m_header->version << ", expected " << k_auramesh_version << ", recook it");
+            return false;
+        }
+        if (m_header->file_size != file_size || m_header->vertex_layout >= VERTEX_LAYOUT_COUNT ||
+            m_header->vertex_stride != VertexEncoder::getLayoutInfo((VertexLayout)m_header->vertex_layout).stride ||
+            (m_header->index_size != 2 && m_header->index_size != 4) || m_header->index_count % 3 != 0)
+        {
+            LOG_ERROR(path << " has an inconsistent header");
+            return false;
+        }
+        if (!sectionFits(m_header->vertex_offset, getVertexDataSize(), file_size) ||
+            !sectionFits(m_header->index_offset, getIndexDataSize(), file_size) ||
+            !sectionFits(m_header->submesh_offset, (uint64_t)m_header->submesh_count * sizeof(AuraMeshSubmesh), file_size) ||
+            !sectionFits(m_header->meshlet_offset, (uint64_t)m_header->meshlet_count * sizeof(AuraMeshMeshlet), file_size) ||
+            !sectionFits(m_header->meshlet_vertex_offset, (uint64_t)m_header->meshlet_vertex_count * sizeof(uint32_t), file_size) ||
+            !sectionFits(m_header->meshlet_triangle_offset, (uint64_t)m_header->meshlet_triangle_count * sizeof(uint32_t), file_size) ||
+            !sectionFits(m_header->material_name_offset, m_header->material_name_size, file_size))
+        {
+            LOG_ERROR(path << " is truncated");
+            return false;
+        }
+
+        const AuraMeshSubmesh* submeshes = getSubmeshes();
+        for (uint32_t i = 0; i < m_header->submesh_count; ++i)
+        {
+            if ((uint64_t)submeshes[i].first_index + submeshes[i].index_count > m_header->index_count ||
+                submeshes[i].material < -1 || submeshes[i].material >= (int32_t)m_header->material_count ||
+                (uint64_t)submeshes[i].first_meshlet + submeshes[i].meshlet_count > m_header->meshlet_count)
+            {
+                LOG_ERROR(path << " has a submesh out of range");
+                return false;
+            }
+        }
+
+        const AuraMeshMeshlet* meshlets = getMeshlets();
+        for (uint32_t i = 0; i < m_header->meshlet_count; ++i)
+        {
+            if (meshlets[i].submesh >= m_header->submesh_count || meshlets[i].vertex_count > 256 ||
+                (uint64_t)meshlets[i].vertex_offset + meshlets[i].vertex_count > m_header->meshlet_vertex_count ||
+                (uint64_t)meshlets[i].triangle_offset + meshlets[i].triangle_count > m_header->meshlet_triangle_count)
+            {
+                LOG_ERROR(path << " has a meshlet out of range");
+                return false;
+            }
+        }
+
+        if (m_header->material_count != 0)
+        {
+            const uint8_t*  names        = m_file.getData() + m_header->material_name_offset;
+            const uint32_t* name_offsets = (const uint32_t*)names;
+            uint64_t        names_size   = m_header->material_name_size;
+            if ((uint64_t)m_header->material_count * sizeof(uint32_t) >= names_size || names[names_size - 1] != 0)
+            {
+                LOG_ERROR(path << " has a broken material name table");
+                return false;
+            }
+            for (uint32_t i = 0; i < m_header->material_count; ++i)
+            {
+                if (name_offsets[i] < m_header->material_count * sizeof(uint32_t) || name_offsets[i] >= names_size)
+                {
+                    LOG_ERROR(path << " has a broken material name table");
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+} // namespace Aura
@@ -0,0 +1,35 @@
+#pragma once
+#include "auramesh_format.h"
+#include "../util/mapped_file.h"
+
+#include <string>
+namespace Aura
+{
+    // a mapped .auramesh. open() checks the header and that every section lies inside the file, after that
+    // the accessors point straight into the mapping, nothing is parsed or copied
+    class AuraMeshFile
+    {
+    public:
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const { return m_header != nullptr; }
+
+        const AuraMeshHeader&  getHeader() const { return *m_header; }
+        const void*            getVertexData() const { return m_file.getData() + m_header->vertex_offset; }
+        uint64_t               getVertexDataSize() const { return (uint64_t)m_header->vertex_count * m_header->vertex_stride; }
+        const void*            getIndexData() const { return m_file.getData() + m_header->index_offset; }
+        uint64_t               getIndexDataSize() const { return (uint64_t)m_header->index_count * m_header->index_size; }
+        const AuraMeshSubmesh* getSubmeshes() const { return (const AuraMeshSubmesh*)(m_file.getData() + m_header->submesh_offset); }
+        const char*            getMaterialName(uint32_t material) const;
+        // empty sections when the mesh was cooked without meshlets
+        const AuraMeshMeshlet* getMeshlets() const { return (const AuraMeshMeshlet*)(m_file.getData() + m_header->meshlet_offset); }
+        const uint32_t*        getMeshletVertices() const { return (const uint32_t*)(m_file.getData() + m_header->meshlet_vertex_offset); }
+        const uint32_t*        getMeshletTriangles() const { return (const uint32_t*)(m_file.getData() + m_header->meshlet_triangle_offset); }
+
+    private:
+        bool validate(const std::string& path) const;
+
+        MappedFile            m_file;
+        const AuraMeshHeader* m_header {nullptr};
+    };
+} // namespace Aura
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+namespace Aura
+{
+    // .auramesh, the cooked form of a mesh. laid out to be memory-mapped and used in place: a header, then
+    // the vertex data, the index data, the submesh table, the meshlets with their vertex and triangle lists and
+    // the material names, each starting at a multiple of k_auramesh_alignment. all offsets count from the start of the file, everything is little-endian
+    static uint32_t const k_auramesh_magic {0x48534D41}; // "AMSH"
+    static uint32_t const k_auramesh_version {3};
+    static uint32_t const k_auramesh_alignment {16};
+
+    struct AuraMeshHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t file_size;
+        float    bounds_min[3];
+        float    bounds_max[3];
+        // VertexQuantization of the vertex layout
+        float    position_offset[3];
+        float    position_scale[3];
+        // VertexLayout
+        uint32_t vertex_layout;
+        uint32_t vertex_stride;
+        uint32_t vertex_count;
+        // 2 or 4 bytes
+        uint32_t index_size;
+        uint32_t index_count;
+        uint32_t submesh_count;
+        uint32_t material_count;
+        // 0 when the mesh was cooked without meshlets
+        uint32_t meshlet_count;
+        uint32_t meshlet_vertex_count;
+        uint32_t meshlet_triangle_count;
+        uint64_t vertex_offset;
+        uint64_t index_offset;
+        uint64_t submesh_offset;
+        uint64_t meshlet_offset;
+        // uint32_t vertex indices
+        uint64_t meshlet_vertex_offset;
+        // uint32_t triangles, see Meshlet
+        uint64_t meshlet_triangle_offset;
+        // material_count uint32_t offsets into the names that follow them, each name is null-terminated
+        uint64_t material_name_offset;
+        uint64_t material_name_size;
+    };
+    static_assert(sizeof(AuraMeshHeader) == 168, "the header layout is part of the file format");
+
+    struct AuraMeshSubmesh
+    {
+        uint32_t first_index;
+        uint32_t index_count;
+        // -1 without a material
+        int32_t  material;
+        uint32_t first_meshlet;
+        uint32_t meshlet_count;
+        uint32_t reserved;
+        float    bounds_min[3];
+        float    bounds_max[3];
+    };
+    static_assert(sizeof(AuraMeshSubmesh) == 48, "the submesh layout is part of the file format");
+
+    // a Meshlet, laid out so the cull shader can read the section as an std430 array as it is
+    struct AuraMeshMeshlet
+    {
+        float    center[3];
+        float    radius;
+        float    cone_apex[3];
+        float    cone_cutoff;
+        float    cone_axis[3];
+        uint32_t submesh;
+        uint32_t vertex_offset;
+        uint32_t triangle_offset;
+        uint32_t vertex_count;
+        uint32_t triangle_count;
+    };
+    static_assert(sizeof(AuraMeshMeshlet) == 64, "the meshlet layout is part of the file format");
+} // namespace Aura
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+namespace Aura
+{
+    // interleaved and ready for a vertex buffer, the texcoord origin is top-left
+    struct MeshVertex
+    {
+        float position[3];
+        float normal[3];
+        float texcoord[2];
+    };
+
+    // a run of the index stream drawn with one material, -1 when it has none
+    struct Submesh
+    {
+        uint32_t first_index {0};
+        uint32_t index_count {0};
+        int32_t  material {-1};
+    };
+
+    // triangle list with 32-bit indices
+    struct MeshData
+    {
+        std::vector<MeshVertex>  vertices;
+        std::vector<uint32_t>    indices;
+        std::vector<Submesh>     submeshes;
+        std::vector<std::string> material_names;
+        float                    bounds_min[3] {0.0f, 0.0f, 0.0f};
+        float                    bounds_max[3] {0.0f, 0.0f, 0.0f};
+    };
+} // namespace Aura
@@ -0,0 +1,359 @@
+#include "mesh_cooker.h"
+#include "auramesh_format.h"
+#include "mesh_optimizer.h"
+#include "meshlet_builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+
+namespace Aura
+{
+    static uint64_t alignOffset(uint64_t offset)
+    {
+        return (offset + k_auramesh_alignment - 1) & ~(uint64_t)(k_auramesh_alignment - 1);
+    }
+
+    static uint32_t hashVertex(const MeshVertex& vertex)
+    {
+        uint32_t words[sizeof(MeshVertex) / 4];
+        memcpy(words, &vertex, sizeof(words));
+        uint64_t hash = 0;
+        for (uint32_t word : words)
+        {
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        }
+        return (uint32_t)(hash ^ (hash >> 32));
+    }
+
+    // triangles only move inside their submesh and culled indices are compacted into the submesh's own range,
+    // so either needs submeshes that do not share indices
+    static bool submeshesDisjoint(const std::vector<Submesh>& submeshes)
+    {
+        std::vector<Submesh> ranges = submeshes;
+        std::sort(ranges.begin(), ranges.end(), [](const Submesh& a, const Submesh& b) { return a.first_index < b.first_index; });
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (ranges[i].first_index % 3 != 0 || ranges[i].index_count % 3 != 0 ||
+                (i + 1 < ranges.size() && ranges[i].first_index + ranges[i].index_count > ranges[i + 1].first_index))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool MeshCooker::cook(const MeshData& mesh, std::vector<uint8_t>& blob)
+    {
+        typedef std::chrono::steady_clock clock;
+        clock::time_point cook_begin = clock::now();
+        m_stats                      = {};
+        m_stats.input_vertices       = (uint32_t)mesh.vertices.size();
+
+        if (mesh.indices.empty() || mesh.indices.size() % 3 != 0 || mesh.vertices.size() > UINT32_MAX / 2)
+        {
+            LOG_ERROR("cannot cook a mesh of " << mesh.indices.size() << " indices");
+            return false;
+        }
+        for (const Submesh& submesh : mesh.submeshes)
+        {
+            if ((uint64_t)submesh.first_index + submesh.index_count > mesh.indices.size() ||
+                submesh.material >= (int32_t)mesh.material_names.size())
+            {
+                LOG_ERROR("submesh out of range");
+                return false;
+            }
+        }
+
+        // open addressing over the cooked vertices, at most half full
+        uint32_t table_size = 1;
+        while (table_size < mesh.vertices.size() * 2)
+        {
+            table_size *= 2;
+        }
+        std::vector<uint32_t>   table(table_size, UINT32_MAX);
+        std::vector<uint32_t>   remap(mesh.vertices.size(), UINT32_MAX);
+        std::vector<uint32_t>   indices(mesh.indices.size());
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.indices.size(); ++i)
+        {
+            uint32_t index = mesh.indices[i];
+            if (index >= mesh.vertices.size())
+            {
+                LOG_ERROR("index " << index << " out of range");
+                return false;
+            }
+            if (remap[index] == UINT32_MAX)
+            {
+                const MeshVertex& vertex = mesh.vertices[index];
+                uint32_t          slot   = hashVertex(vertex) & (table_size - 1);
+                while (table[slot] != UINT32_MAX && memcmp(&vertices[table[slot]], &vertex, sizeof(MeshVertex)) != 0)
+                {
+                    slot = (slot + 1) & (table_size - 1);
+                }
+                if (table[slot] == UINT32_MAX)
+                {
+                    table[slot] = (uint32_t)vertices.size();
+                    vertices.push_back(vertex);
+                }
+                remap[index] = table[slot];
+            }
+            indices[i] = remap[index];
+        }
+
+        // a mesh without submeshes is drawn as one
+        std::vector<Submesh> submeshes = mesh.submeshes;
+        if (submeshes.empty())
+        {
+            Submesh submesh;
+            submesh.index_count = (uint32_t)indices.size();
+            submeshes.push_back(submesh);
+        }
+
+        m_stats.cache_before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), (uint32_t)vertices.size());
+        m_stats.cache_after  = m_stats.cache_before;
+        if (m_optimize)
+        {
+            clock::time_point optimize_begin = clock::now();
+            optimize(submeshes, indices, vertices);
+            m_stats.cache_after = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), (uint32_t)vertices.size());
+            m_stats.optimize_ms = std::chrono::duration<double, std::milli>(clock::now() - optimize_begin).count();
+        }
+
+        std::vector<AuraMeshMeshlet> meshlets;
+        std::vector<uint32_t>        meshlet_vertices;
+        std::vector<uint32_t>        meshlet_triangles;
+        std::vector<uint32_t>        first_meshlets;
+        if (m_build_meshlets)
+        {
+            clock::time_point meshlet_begin = clock::now();
+            buildMeshlets(submeshes, indices, vertices, meshlets, meshlet_vertices, meshlet_triangles, first_meshlets);
+            m_stats.meshlet_ms = std::chrono::duration<double, std::milli>(clock::now() - meshlet_begin).count();
+        }
+
+        std::vector<uint8_t> encoded_vertices;
+        VertexQuantization   quantization;
+        VertexLayout         layout = encodeVertices(mesh, vertices, indices, encoded_vertices, quantization);
+        uint32_t             stride = VertexEncoder::getLayoutInfo(layout).stride;
+
+        uint32_t index_size   = vertices.size() <= 0x10000 ? 2 : 4;
+        uint64_t names_offset = sizeof(uint32_t) * mesh.material_names.size();
+        uint64_t names_size   = names_offset;
+        for (const std::string& name : mesh.material_names)
+        {
+            names_size += name.size() + 1;
+        }
+
+        AuraMeshHeader header {};
+        header.magic                   = k_auramesh_magic;
+        header.version                 = k_auramesh_version;
+        header.vertex_layout           = layout;
+        header.vertex_stride           = stride;
+        header.vertex_count            = (uint32_t)vertices.size();
+        header.index_size              = index_size;
+        header.index_count             = (uint32_t)indices.size();
+        header.submesh_count           = (uint32_t)submeshes.size();
+        header.material_count          = (uint32_t)mesh.material_names.size();
+        header.meshlet_count           = (uint32_t)meshlets.size();
+        header.meshlet_vertex_count    = (uint32_t)meshlet_vertices.size();
+        header.meshlet_triangle_count  = (uint32_t)meshlet_triangles.size();
+        header.vertex_offset           = alignOffset(sizeof(AuraMeshHeader));
+        header.index_offset            = alignOffset(header.vertex_offset + (uint64_t)vertices.size() * stride);
+        header.submesh_offset          = alignOffset(header.index_offset + (uint64_t)indices.size() * index_size);
+        header.meshlet_offset          = alignOffset(header.submesh_offset + submeshes.size() * sizeof(AuraMeshSubmesh));
+        header.meshlet_vertex_offset   = alignOffset(header.meshlet_offset + meshlets.size() * sizeof(AuraMeshMeshlet));
+        header.meshlet_triangle_offset = alignOffset(header.meshlet_vertex_offset + meshlet_vertices.size() * sizeof(uint32_t));
+        header.material_name_offset    = alignOffset(header.meshlet_triangle_offset + meshlet_triangles.size() * sizeof(uint32_t));
+        header.material_name_size      = names_size;
+        header.file_size               = header.material_name_offset + names_size;
+        memcpy(header.bounds_min, mesh.bounds_min, sizeof(header.bounds_min));
+        memcpy(header.bounds_max, mesh.bounds_max, sizeof(header.bounds_max));
+        memcpy(header.position_offset, quantization.position_offset, sizeof(header.position_offset));
+        memcpy(header.position_scale, quantization.position_scale, sizeof(header.position_scale));
+
+        blob.assign(header.file_size, 0);
+        memcpy(blob.data(), &header, sizeof(header));
+        memcpy(blob.data() + header.vertex_offset, encoded_vertices.data(), encoded_vertices.size());
+        if (index_size == 2)
+        {
+            uint16_t* short_indices = (uint16_t*)(blob.data() + header.index_offset);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                short_indices[i] = (uint16_t)indices[i];
+            }
+        }
+        else
+        {
+            memcpy(blob.data() + header.index_offset, indices.data(), indices.size() * sizeof(uint32_t));
+        }
+
+        AuraMeshSubmesh* cooked_submeshes = (AuraMeshSubmesh*)(blob.data() + header.submesh_offset);
+        for (size_t i = 0; i < submeshes.size(); ++i)
+        {
+            AuraMeshSubmesh& cooked = cooked_submeshes[i];
+            cooked.first_index      = submeshes[i].first_index;
+            cooked.index_count      = submeshes[i].index_count;
+            cooked.material         = submeshes[i].material;
+            if (!first_meshlets.empty())
+            {
+                cooked.first_meshlet = first_meshlets[i];
+                cooked.meshlet_count = first_meshlets[i + 1] - first_meshlets[i];
+            }
+            for (uint32_t k = 0; k < submeshes[i].index_count; ++k)
+            {
+                const float* position = vertices[indices[submeshes[i].first_index + k]].position;
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    cooked.bounds_min[axis] = k == 0 ? position[axis] : std::min(cooked.bounds_min[axis], position[axis]);
+                    cooked.bounds_max[axis] = k == 0 ? position[axis] : std::max(cooked.bounds_max[axis], position[axis]);
+                }
+            }
+        }
+
+        if (!meshlets.empty())
+        {
+            memcpy(blob.data() + header.meshlet_offset, meshlets.data(), meshlets.size() * sizeof(AuraMeshMeshlet));
+            memcpy(blob.data() + header.meshlet_vertex_offset, meshlet_vertices.data(), meshlet_vertices.size() * sizeof(uint32_t));
+            memcpy(blob.data() + header.meshlet_triangle_offset, meshlet_triangles.data(), meshlet_triangles.size() * sizeof(uint32_t));
+        }
+
+        uint8_t*  names        = blob.data() + header.material_name_offset;
+        uint32_t* name_offsets = (uint32_t*)names;
+        for (size_t i = 0; i < mesh.material_names.size(); ++i)
+        {
+            name_offsets[i] = (uint32_t)names_offset;
+            memcpy(names + names_offset, mesh.material_names[i].c_str(), mesh.material_names[i].size() + 1);
+            names_offset += mesh.material_names[i].size() + 1;
+        }
+
+        m_stats.output_vertices = (uint32_t)vertices.size();
+        m_stats.index_size      = index_size;
+        m_stats.vertex_layout   = layout;
+        m_stats.vertex_bytes    = encoded_vertices.size();
+        m_stats.meshlet_count   = header.meshlet_count;
+        m_stats.file_bytes      = header.file_size;
+        m_stats.cook_ms         = std::chrono::duration<double, std::milli>(clock::now() - cook_begin).count();
+        return true;
+    }
+
+    void MeshCooker::optimize(const std::vector<Submesh>& submeshes, std::vector<uint32_t>& indices, std::vector<MeshVertex>& vertices)
+    {
+        if (!submeshesDisjoint(submeshes))
+        {
+            LOG_ERROR("submeshes overlap or split triangles, cooking without reordering");
+            return;
+        }
+
+        for (const Submesh& submesh : submeshes)
+        {
+            uint32_t* submesh_indices = indices.data() + submesh.first_index;
+            MeshOptimizer::optimizeVertexCache(submesh_indices, submesh.index_count, (uint32_t)vertices.size());
+            MeshOptimizer::optimizeOverdraw(submesh_indices, submesh.index_count, vertices.data(), (uint32_t)vertices.size());
+        }
+        MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), vertices);
+    }
+
+    // first_meshlets gets one more entry than there are submeshes, submesh i owns the meshlets from
+    // first_meshlets[i] up to first_meshlets[i + 1]
+    void MeshCooker::buildMeshlets(const std::vector<Submesh>& submeshes, const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+                                   std::vector<AuraMeshMeshlet>& meshlets, std::vector<uint32_t>& meshlet_vertices,
+                                   std::vector<uint32_t>& meshlet_triangles, std::vector<uint32_t>& first_meshlets)
+    {
+        if (!submeshesDisjoint(submeshes))
+        {
+            LOG_ERROR("submeshes overlap or split triangles, cooking without meshlets");
+            return;
+        }
+
+        std::vector<Meshlet> built;
+        for (const Submesh& submesh : submeshes)
+        {
+            first_meshlets.push_back((uint32_t)built.size());
+            MeshletBuilder::build(indices.data() + submesh.first_index, submesh.index_count, vertices.data(), (uint32_t)vertices.size(),
+                                  m_meshlet_max_vertices, m_meshlet_max_triangles, built, meshlet_vertices, meshlet_triangles);
+        }
+        first_meshlets.push_back((uint32_t)built.size());
+
+        meshlets.resize(built.size());
+        for (uint32_t submesh = 0; submesh < (uint32_t)submeshes.size(); ++submesh)
+        {
+            for (uint32_t i = first_meshlets[submesh]; i < first_meshlets[submesh + 1]; ++i)
+            {
+                AuraMeshMeshlet& cooked = meshlets[i];
+                memcpy(cooked.center, built[i].center, sizeof(cooked.center));
+                cooked.radius = built[i].radius;
+                memcpy(cooked.cone_apex, built[i].cone_apex, sizeof(cooked.cone_apex));
+                cooked.cone_cutoff = built[i].cone_cutoff;
+                memcpy(cooked.cone_axis, built[i].cone_axis, sizeof(cooked.cone_axis));
+                cooked.submesh         = submesh;
+                cooked.vertex_offset   = built[i].vertex_offset;
+                cooked.triangle_offset = built[i].triangle_offset;
+                cooked.vertex_count    = built[i].vertex_count;
+                cooked.triangle_count  = built[i].triangle_count;
+            }
+        }
+    }
+
+    VertexLayout MeshCooker::encodeVertices(const MeshData& mesh, const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                                            std::vector<uint8_t>& encoded, VertexQuantization& quantization)
+    {
+        std::vector<float> tangents;
+        if (m_pick_vertex_layout || m_vertex_layout != VERTEX_LAYOUT_FLOAT32)
+        {
+            VertexEncoder::computeTangents(vertices, indices, tangents);
+        }
+        if (!m_pick_vertex_layout)
+        {
+            quantization = VertexEncoder::getQuantization(m_vertex_layout, vertices);
+            encoded.resize(vertices.size() * VertexEncoder::getLayoutInfo(m_vertex_layout).stride);
+            VertexEncoder::encode(m_vertex_layout, vertices, tangents, quantization, encoded.data(), m_stats.vertex_error);
+            return m_vertex_layout;
+        }
+
+        float diagonal = 0.0f;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            diagonal += (mesh.bounds_max[k] - mesh.bounds_min[k]) * (mesh.bounds_max[k] - mesh.bounds_min[k]);
+        }
+        diagonal = std::sqrt(diagonal);
+
+        // smallest first, float32 is exact and always fits
+        VertexLayout const candidates[] = {VERTEX_LAYOUT_SNORM16_OCT8, VERTEX_LAYOUT_SNORM16, VERTEX_LAYOUT_FLOAT16, VERTEX_LAYOUT_FLOAT32};
+        for (VertexLayout layout : candidates)
+        {
+            quantization = VertexEncoder::getQuantization(layout, vertices);
+            encoded.resize(vertices.size() * VertexEncoder::getLayoutInfo(layout).stride);
+            VertexEncoder::encode(layout, vertices, tangents, quantization, encoded.data(), m_stats.vertex_error);
+            const VertexEncodingError& error = m_stats.vertex_error;
+            if (layout == VERTEX_LAYOUT_FLOAT32 ||
+                (error.position <= m_position_tolerance * diagonal && error.normal_degrees <= m_normal_tolerance_degrees &&
+                 error.tangent_degrees <= m_normal_tolerance_degrees && error.texcoord <= m_texcoord_tolerance))
+            {
+                return layout;
+            }
+        }
+        return VERTEX_LAYOUT_FLOAT32;
+    }
+
+    bool MeshCooker::cookToFile(const MeshData& mesh, const std::string& path)
+    {
+        std::vector<uint8_t> blob;
+        if (!cook(mesh, blob))
+        {
+            return false;
+        }
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write((const char*)blob.data(), (std::streamsize)blob.size()))
+        {
+            LOG_ERROR("failed to write " << path);
+            return false;
+        }
+        return true;
+    }
+} // namespace Aura
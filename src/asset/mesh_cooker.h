@@ -0,0 +1,66 @@
+#pragma once
+#include "auramesh_format.h"
+#include "mesh.h"
+#include "mesh_optimizer.h"
+#include "meshlet_builder.h"
+#include "vertex_layout.h"
+
+#include <string>
+namespace Aura
+{
+    struct MeshCookStats
+    {
+        uint32_t            input_vertices {0};
+        uint32_t            output_vertices {0};
+        uint32_t            index_size {0};
+        VertexLayout        vertex_layout {VERTEX_LAYOUT_FLOAT32};
+        uint64_t            vertex_bytes {0};
+        // of the layout that was written
+        VertexEncodingError vertex_error;
+        uint64_t            file_bytes {0};
+        // the index stream as deduplicated and as written
+        VertexCacheStats    cache_before;
+        VertexCacheStats    cache_after;
+        double              optimize_ms {0.0};
+        uint32_t            meshlet_count {0};
+        double              meshlet_ms {0.0};
+        double              cook_ms {0.0};
+    };
+
+    // MeshData to a .auramesh blob, see auramesh_format.h. vertices are merged when they are bitwise equal
+    // and are stored in the order the index stream first uses them. unreferenced vertices are dropped. indices shrink to 16 bits when every vertex
+    // fits. by default every submesh is then reordered for the vertex cache and for overdraw, and the
+    // vertices are renumbered into fetch order. each submesh is then split into meshlets for gpu culling.
+    // last, the vertices are written in the smallest layout that keeps every vertex within the tolerances
+    class MeshCooker
+    {
+    public:
+        bool cook(const MeshData& mesh, std::vector<uint8_t>& blob);
+        bool cookToFile(const MeshData& mesh, const std::string& path);
+        const MeshCookStats& getStats() const { return m_stats; }
+
+        bool         m_optimize {true};
+        bool         m_build_meshlets {true};
+        uint32_t     m_meshlet_max_vertices {MeshletBuilder::k_max_vertices};
+        uint32_t     m_meshlet_max_triangles {MeshletBuilder::k_max_triangles};
+        // false writes m_vertex_layout whatever it costs
+        bool         m_pick_vertex_layout {true};
+        VertexLayout m_vertex_layout {VERTEX_LAYOUT_FLOAT32};
+        // relative to the bounds diagonal
+        float        m_position_tolerance {1e-4f};
+        // for normals and tangents alike
+        float        m_normal_tolerance_degrees {1.0f};
+        // a texel of a 4096 texture
+        float        m_texcoord_tolerance {1.0f / 4096.0f};
+
+    private:
+        VertexLayout encodeVertices(const MeshData& mesh, const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                                    std::vector<uint8_t>& encoded, VertexQuantization& quantization);
+        void optimize(const std::vector<Submesh>& submeshes, std::vector<uint32_t>& indices, std::vector<MeshVertex>& vertices);
+        void buildMeshlets(const std::vector<Submesh>& submeshes, const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+                           std::vector<AuraMeshMeshlet>& meshlets, std::vector<uint32_t>& meshlet_vertices,
+                           std::vector<uint32_t>& meshlet_triangles, std::vector<uint32_t>& first_meshlets);
+
+        MeshCookStats m_stats;
+    };
+} // namespace Aura
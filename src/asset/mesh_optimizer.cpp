@@ -0,0 +1,364 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Aura
+{
+    namespace
+    {
+        // the scoring models a larger lru cache than the fifo it is analyzed against, a wider window keeps
+        // the greedy walk from wandering off a strip it could still finish
+        uint32_t const k_score_cache_size {32};
+        uint32_t const k_valence_table_size {32};
+
+        struct ScoreTables
+        {
+            float cache[k_score_cache_size];
+            float valence[k_valence_table_size];
+
+            ScoreTables()
+            {
+                for (uint32_t i = 0; i < k_score_cache_size; ++i)
+                {
+                    // the last triangle's vertices score a fixed amount so its neighbours do not always win
+                    cache[i] = i < 3 ? 0.75f : std::pow(1.0f - (float)(i - 3) / (float)(k_score_cache_size - 3), 1.5f);
+                }
+                valence[0] = 0.0f;
+                for (uint32_t i = 1; i < k_valence_table_size; ++i)
+                {
+                    valence[i] = 2.0f / std::sqrt((float)i);
+                }
+            }
+        };
+
+        // fifo with a timestamp per vertex, a vertex is cached while it was added fewer than k_cache_size misses ago
+        struct FifoCache
+        {
+            std::vector<uint32_t> timestamps;
+            uint32_t              time {MeshOptimizer::k_cache_size + 1};
+
+            explicit FifoCache(uint32_t vertex_count) : timestamps(vertex_count, 0) {}
+
+            uint32_t addTriangle(const uint32_t* triangle)
+            {
+                uint32_t misses = 0;
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    if (time - timestamps[triangle[corner]] > MeshOptimizer::k_cache_size)
+                    {
+                        timestamps[triangle[corner]] = time++;
+                        ++misses;
+                    }
+                }
+                return misses;
+            }
+
+            void flush() { time += MeshOptimizer::k_cache_size + 1; }
+        };
+    } // namespace
+
+    static float vertexScore(const ScoreTables& tables, int32_t cache_position, uint32_t remaining_triangles)
+    {
+        if (remaining_triangles == 0)
+        {
+            return -1.0f;
+        }
+        float score = cache_position >= 0 ? tables.cache[cache_position] : 0.0f;
+        return score + tables.valence[std::min(remaining_triangles, k_valence_table_size - 1)];
+    }
+
+    VertexCacheStats MeshOptimizer::analyzeVertexCache(const uint32_t* indices, size_t index_count, uint32_t vertex_count)
+    {
+        VertexCacheStats     stats;
+        FifoCache            cache(vertex_count);
+        std::vector<uint8_t> referenced(vertex_count, 0);
+        uint32_t             misses           = 0;
+        uint32_t             referenced_count = 0;
+        for (size_t i = 0; i + 3 <= index_count; i += 3)
+        {
+            misses += cache.addTriangle(indices + i);
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                referenced_count += referenced[indices[i + corner]] == 0;
+                referenced[indices[i + corner]] = 1;
+            }
+        }
+        stats.acmr = index_count >= 3 ? (float)misses / (float)(index_count / 3) : 0.0f;
+        stats.atvr = referenced_count > 0 ? (float)misses / (float)referenced_count : 0.0f;
+        return stats;
+    }
+
+    void MeshOptimizer::optimizeVertexCache(uint32_t* indices, size_t index_count, uint32_t vertex_count)
+    {
+        static const ScoreTables tables;
+        size_t                   triangle_count = index_count / 3;
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        // triangles around each vertex, the first remaining_triangles[v] of a vertex's range are not emitted yet
+        std::vector<uint32_t> remaining_triangles(vertex_count, 0);
+        std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+        for (size_t i = 0; i < triangle_count * 3; ++i)
+        {
+            ++remaining_triangles[indices[i]];
+        }
+        for (uint32_t v = 0; v < vertex_count; ++v)
+        {
+            adjacency_offsets[v + 1] = adjacency_offsets[v] + remaining_triangles[v];
+        }
+        std::vector<uint32_t> adjacency(triangle_count * 3);
+        std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (size_t i = 0; i < triangle_count * 3; ++i)
+        {
+            adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+
+        std::vector<int32_t> cache_positions(vertex_count, -1);
+        std::vector<float>   vertex_scores(vertex_count);
+        for (uint32_t v = 0; v < vertex_count; ++v)
+        {
+            vertex_scores[v] = vertexScore(tables, -1, remaining_triangles[v]);
+        }
+        auto triangleScore = [&](uint32_t triangle) {
+            const uint32_t* corners = indices + (size_t)triangle * 3;
+            return vertex_scores[corners[0]] + vertex_scores[corners[1]] + vertex_scores[corners[2]];
+        };
+
+        uint32_t best_triangle = 0;
+        float    best_score    = triangleScore(0);
+        for (uint32_t triangle = 1; triangle < triangle_count; ++triangle)
+        {
+            float score = triangleScore(triangle);
+            if (score > best_score)
+            {
+                best_triangle = triangle;
+                best_score    = score;
+            }
+        }
+
+        std::vector<uint8_t>  emitted(triangle_count, 0);
+        std::vector<uint32_t> output(triangle_count * 3);
+        uint32_t              cache[k_score_cache_size + 3];
+        uint32_t              new_cache[k_score_cache_size + 3];
+        uint32_t              evicted[k_score_cache_size + 3];
+        uint32_t              cache_count  = 0;
+        size_t                input_cursor = 0;
+        for (size_t output_triangle = 0; output_triangle < triangle_count; ++output_triangle)
+        {
+            // dead end, nothing around the cache is left. continue with the next triangle in input order
+            if (best_triangle == UINT32_MAX)
+            {
+                while (emitted[input_cursor])
+                {
+                    ++input_cursor;
+                }
+                best_triangle = (uint32_t)input_cursor;
+            }
+
+            const uint32_t* corners = indices + (size_t)best_triangle * 3;
+            emitted[best_triangle]  = 1;
+            std::copy(corners, corners + 3, output.begin() + output_triangle * 3);
+
+            uint32_t new_cache_count = 0;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                uint32_t  v     = corners[corner];
+                uint32_t* begin = adjacency.data() + adjacency_offsets[v];
+                uint32_t* end   = begin + remaining_triangles[v];
+                uint32_t* found = std::find(begin, end, best_triangle);
+                if (found != end)
+                {
+                    std::swap(*found, *(end - 1));
+                    --remaining_triangles[v];
+                }
+                if (std::find(new_cache, new_cache + new_cache_count, v) == new_cache + new_cache_count)
+                {
+                    new_cache[new_cache_count++] = v;
+                }
+            }
+            uint32_t evicted_count = 0;
+            for (uint32_t i = 0; i < cache_count; ++i)
+            {
+                uint32_t v = cache[i];
+                if (v == corners[0] || v == corners[1] || v == corners[2])
+                {
+                    continue;
+                }
+                if (new_cache_count < k_score_cache_size)
+                {
+                    new_cache[new_cache_count++] = v;
+                }
+                else
+                {
+                    evicted[evicted_count++] = v;
+                }
+            }
+            for (uint32_t i = 0; i < evicted_count; ++i)
+            {
+                cache_positions[evicted[i]] = -1;
+                vertex_scores[evicted[i]]   = vertexScore(tables, -1, remaining_triangles[evicted[i]]);
+            }
+            for (uint32_t i = 0; i < new_cache_count; ++i)
+            {
+                cache[i]                      = new_cache[i];
+                cache_positions[new_cache[i]] = (int32_t)i;
+                vertex_scores[new_cache[i]]   = vertexScore(tables, (int32_t)i, remaining_triangles[new_cache[i]]);
+            }
+            cache_count = new_cache_count;
+
+            // only triangles touching the cache can have gained, the rest keep losing to them
+            best_triangle = UINT32_MAX;
+            best_score    = -1.0f;
+            for (uint32_t i = 0; i < cache_count; ++i)
+            {
+                uint32_t        v         = cache[i];
+                const uint32_t* triangles = adjacency.data() + adjacency_offsets[v];
+                for (uint32_t k = 0; k < remaining_triangles[v]; ++k)
+                {
+                    float score = triangleScore(triangles[k]);
+                    if (score > best_score)
+                    {
+                        best_triangle = triangles[k];
+                        best_score    = score;
+                    }
+                }
+            }
+        }
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    void MeshOptimizer::optimizeOverdraw(uint32_t* indices, size_t index_count, const MeshVertex* vertices, uint32_t vertex_count,
+                                         float threshold)
+    {
+        size_t triangle_count = index_count / 3;
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        // a triangle that misses on all three vertices starts a new patch of the cache-optimized order
+        std::vector<uint32_t> hard_clusters;
+        FifoCache             cache(vertex_count);
+        for (uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            if (cache.addTriangle(indices + (size_t)triangle * 3) == 3 || triangle == 0)
+            {
+                hard_clusters.push_back(triangle);
+            }
+        }
+        hard_clusters.push_back((uint32_t)triangle_count);
+
+        // split each patch further wherever the part before the split alone is about as cache friendly as
+        // the whole patch, the cold start of the next part is then the only cost
+        std::vector<uint32_t> clusters;
+        for (size_t i = 0; i + 1 < hard_clusters.size(); ++i)
+        {
+            uint32_t begin  = hard_clusters[i];
+            uint32_t end    = hard_clusters[i + 1];
+            uint32_t misses = 0;
+            cache.flush();
+            for (uint32_t triangle = begin; triangle < end; ++triangle)
+            {
+                misses += cache.addTriangle(indices + (size_t)triangle * 3);
+            }
+            float acmr_limit = (float)misses / (float)(end - begin) * threshold;
+
+            cache.flush();
+            uint32_t cluster_begin  = begin;
+            uint32_t cluster_misses = 0;
+            clusters.push_back(begin);
+            for (uint32_t triangle = begin; triangle + 1 < end; ++triangle)
+            {
+                cluster_misses += cache.addTriangle(indices + (size_t)triangle * 3);
+                if ((float)cluster_misses / (float)(triangle + 1 - cluster_begin) <= acmr_limit)
+                {
+                    cluster_begin  = triangle + 1;
+                    cluster_misses = 0;
+                    clusters.push_back(cluster_begin);
+                    cache.flush();
+                }
+            }
+        }
+        uint32_t cluster_count = (uint32_t)clusters.size();
+        clusters.push_back((uint32_t)triangle_count);
+
+        // clusters further out along their own normal draw first, they are the likelier occluders
+        float mesh_centroid[3] = {0.0f, 0.0f, 0.0f};
+        for (size_t i = 0; i < triangle_count * 3; ++i)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                mesh_centroid[k] += vertices[indices[i]].position[k] / (float)(triangle_count * 3);
+            }
+        }
+        std::vector<float> sort_keys(cluster_count);
+        for (uint32_t cluster = 0; cluster < cluster_count; ++cluster)
+        {
+            float centroid[3] = {0.0f, 0.0f, 0.0f};
+            float normal[3]   = {0.0f, 0.0f, 0.0f};
+            float area_sum    = 0.0f;
+            for (uint32_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle)
+            {
+                const float* p0    = vertices[indices[(size_t)triangle * 3 + 0]].position;
+                const float* p1    = vertices[indices[(size_t)triangle * 3 + 1]].position;
+                const float* p2    = vertices[indices[(size_t)triangle * 3 + 2]].position;
+                float        e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                float        e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                float        n[3]  = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+                float        area  = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    centroid[k] += (p0[k] + p1[k] + p2[k]) / 3.0f * area;
+                    normal[k] += n[k];
+                }
+                area_sum += area;
+            }
+            float normal_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            float key           = 0.0f;
+            if (area_sum > 0.0f && normal_length > 0.0f)
+            {
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    key += (centroid[k] / area_sum - mesh_centroid[k]) * normal[k] / normal_length;
+                }
+            }
+            sort_keys[cluster] = key;
+        }
+
+        std::vector<uint32_t> order(cluster_count);
+        for (uint32_t cluster = 0; cluster < cluster_count; ++cluster)
+        {
+            order[cluster] = cluster;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sort_keys[a] > sort_keys[b]; });
+
+        std::vector<uint32_t> output;
+        output.reserve(triangle_count * 3);
+        for (uint32_t cluster : order)
+        {
+            output.insert(output.end(), indices + (size_t)clusters[cluster] * 3, indices + (size_t)clusters[cluster + 1] * 3);
+        }
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(uint32_t* indices, size_t index_count, std::vector<MeshVertex>& vertices)
+    {
+        std::vector<uint32_t>   remap(vertices.size(), UINT32_MAX);
+        std::vector<MeshVertex> fetch_ordered;
+        fetch_ordered.reserve(vertices.size());
+        for (size_t i = 0; i < index_count; ++i)
+        {
+            uint32_t& mapped = remap[indices[i]];
+            if (mapped == UINT32_MAX)
+            {
+                mapped = (uint32_t)fetch_ordered.size();
+                fetch_ordered.push_back(vertices[indices[i]]);
+            }
+            indices[i] = mapped;
+        }
+        vertices.swap(fetch_ordered);
+    }
+} // namespace Aura
@@ -0,0 +1,32 @@
+#pragma once
+#include "mesh.h"
+namespace Aura
+{
+    // transformed vertices per triangle and per vertex when the indices run through a fifo post-transform
+    // cache, 0.5 and 1.0 are the ideals for a regular grid
+    struct VertexCacheStats
+    {
+        float acmr {0.0f};
+        float atvr {0.0f};
+    };
+
+    // reorders of an indexed triangle list that leave the rendered result alone. run them in the order they
+    // are declared, each one keeps what the previous one gained: the overdraw pass only swaps clusters the
+    // cache pass left behind, and the fetch pass only renumbers vertices
+    class MeshOptimizer
+    {
+    public:
+        static uint32_t const k_cache_size {16};
+
+        static VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t index_count, uint32_t vertex_count);
+
+        // triangle order for post-transform cache reuse, tom forsyth's linear-speed greedy scoring
+        static void optimizeVertexCache(uint32_t* indices, size_t index_count, uint32_t vertex_count);
+        // sorts clusters of cache-optimized triangles so the outer ones draw first. a cluster boundary may cost
+        // up to threshold times the acmr of the run it splits, after sander et al.'s fast triangle reordering
+        static void optimizeOverdraw(uint32_t* indices, size_t index_count, const MeshVertex* vertices, uint32_t vertex_count,
+                                     float threshold = 1.05f);
+        // renumbers vertices in the order the indices first use them and drops unreferenced ones
+        static void optimizeVertexFetch(uint32_t* indices, size_t index_count, std::vector<MeshVertex>& vertices);
+    };
+} // namespace Aura
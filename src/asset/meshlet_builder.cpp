@@ -0,0 +1,207 @@
+#include "meshlet_builder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Aura
+{
+    static float dot3(const float* a, const float* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // ritter's, within a few percent of the minimal sphere
+    static void computeSphere(Meshlet& meshlet, const uint32_t* meshlet_vertices, const MeshVertex* vertices)
+    {
+        uint32_t extremes[3][2] = {};
+        for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+        {
+            const float* position = vertices[meshlet_vertices[i]].position;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                if (position[axis] < vertices[meshlet_vertices[extremes[axis][0]]].position[axis])
+                {
+                    extremes[axis][0] = i;
+                }
+                if (position[axis] > vertices[meshlet_vertices[extremes[axis][1]]].position[axis])
+                {
+                    extremes[axis][1] = i;
+                }
+            }
+        }
+
+        // start from the pair of extremes farthest apart
+        float    widest = -1.0f;
+        uint32_t first  = 0;
+        uint32_t second = 0;
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const float* a = vertices[meshlet_vertices[extremes[axis][0]]].position;
+            const float* b = vertices[meshlet_vertices[extremes[axis][1]]].position;
+            float        d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            if (dot3(d, d) > widest)
+            {
+                widest = dot3(d, d);
+                first  = extremes[axis][0];
+                second = extremes[axis][1];
+            }
+        }
+        const float* a = vertices[meshlet_vertices[first]].position;
+        const float* b = vertices[meshlet_vertices[second]].position;
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            meshlet.center[axis] = (a[axis] + b[axis]) * 0.5f;
+        }
+        meshlet.radius = std::sqrt(widest) * 0.5f;
+
+        for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+        {
+            const float* position = vertices[meshlet_vertices[i]].position;
+            float        d[3]     = {position[0] - meshlet.center[0], position[1] - meshlet.center[1], position[2] - meshlet.center[2]};
+            float        distance = std::sqrt(dot3(d, d));
+            if (distance > meshlet.radius)
+            {
+                float grow = (distance - meshlet.radius) * 0.5f;
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    meshlet.center[axis] += d[axis] / distance * grow;
+                }
+                meshlet.radius += grow;
+            }
+        }
+    }
+
+    // the axis is the mean of the triangle normals and the cutoff the sine of the widest angle between the two.
+    // the apex sits on the axis behind every triangle's plane, so a camera only passes the test when it is
+    // behind all of them
+    static void computeCone(Meshlet& meshlet, const uint32_t* meshlet_vertices, const uint32_t* meshlet_triangles,
+                            const MeshVertex* vertices)
+    {
+        float normals[MeshletBuilder::k_max_triangles][3];
+        bool  valid[MeshletBuilder::k_max_triangles];
+        float axis[3] = {0.0f, 0.0f, 0.0f};
+        for (uint32_t i = 0; i < meshlet.triangle_count; ++i)
+        {
+            uint32_t     triangle = meshlet_triangles[i];
+            const float* p0       = vertices[meshlet_vertices[triangle & 0xFF]].position;
+            const float* p1       = vertices[meshlet_vertices[(triangle >> 8) & 0xFF]].position;
+            const float* p2       = vertices[meshlet_vertices[(triangle >> 16) & 0xFF]].position;
+            float        e1[3]    = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float        e2[3]    = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float*       n        = normals[i];
+            n[0]                  = e1[1] * e2[2] - e1[2] * e2[1];
+            n[1]                  = e1[2] * e2[0] - e1[0] * e2[2];
+            n[2]                  = e1[0] * e2[1] - e1[1] * e2[0];
+            float length          = std::sqrt(dot3(n, n));
+            valid[i]              = length > 0.0f;
+            if (valid[i])
+            {
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    n[k] /= length;
+                    axis[k] += n[k];
+                }
+            }
+        }
+
+        meshlet.cone_cutoff = 1.0f;
+        float axis_length   = std::sqrt(dot3(axis, axis));
+        if (axis_length == 0.0f)
+        {
+            return;
+        }
+        float min_dot = 1.0f;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            axis[k] /= axis_length;
+        }
+        for (uint32_t i = 0; i < meshlet.triangle_count; ++i)
+        {
+            if (valid[i])
+            {
+                min_dot = std::min(min_dot, dot3(normals[i], axis));
+            }
+        }
+        // past about 84 degrees the apex runs off towards infinity and the cone would hardly ever cull
+        if (min_dot <= 0.1f)
+        {
+            return;
+        }
+
+        float max_t = 0.0f;
+        for (uint32_t i = 0; i < meshlet.triangle_count; ++i)
+        {
+            if (!valid[i])
+            {
+                continue;
+            }
+            const float* p0    = vertices[meshlet_vertices[meshlet_triangles[i] & 0xFF]].position;
+            float        to[3] = {meshlet.center[0] - p0[0], meshlet.center[1] - p0[1], meshlet.center[2] - p0[2]};
+            max_t              = std::max(max_t, dot3(to, normals[i]) / dot3(axis, normals[i]));
+        }
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            meshlet.cone_axis[k] = axis[k];
+            meshlet.cone_apex[k] = meshlet.center[k] - axis[k] * max_t;
+        }
+        meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+    }
+
+    void MeshletBuilder::build(const uint32_t* indices, size_t index_count, const MeshVertex* vertices, uint32_t vertex_count,
+                               uint32_t max_vertices, uint32_t max_triangles, std::vector<Meshlet>& meshlets,
+                               std::vector<uint32_t>& meshlet_vertices, std::vector<uint32_t>& meshlet_triangles)
+    {
+        max_vertices  = std::max(3u, std::min(max_vertices, k_max_vertices));
+        max_triangles = std::max(1u, std::min(max_triangles, k_max_triangles));
+
+        // the vertex's index in the open meshlet, reset for every vertex the meshlet used when it is closed
+        std::vector<uint8_t> local(vertex_count, 0xFF);
+        Meshlet              meshlet;
+        meshlet.vertex_offset   = (uint32_t)meshlet_vertices.size();
+        meshlet.triangle_offset = (uint32_t)meshlet_triangles.size();
+
+        auto close = [&]() {
+            if (meshlet.triangle_count == 0)
+            {
+                return;
+            }
+            const uint32_t* used = meshlet_vertices.data() + meshlet.vertex_offset;
+            for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+            {
+                local[used[i]] = 0xFF;
+            }
+            computeSphere(meshlet, used, vertices);
+            computeCone(meshlet, used, meshlet_triangles.data() + meshlet.triangle_offset, vertices);
+            meshlets.push_back(meshlet);
+
+            meshlet                 = Meshlet();
+            meshlet.vertex_offset   = (uint32_t)meshlet_vertices.size();
+            meshlet.triangle_offset = (uint32_t)meshlet_triangles.size();
+        };
+
+        for (size_t i = 0; i + 2 < index_count; i += 3)
+        {
+            uint32_t const corners[3] = {indices[i], indices[i + 1], indices[i + 2]};
+            uint32_t       added      = (local[corners[0]] == 0xFF) + (local[corners[1]] == 0xFF && corners[1] != corners[0]) +
+                             (local[corners[2]] == 0xFF && corners[2] != corners[0] && corners[2] != corners[1]);
+            if (meshlet.vertex_count + added > max_vertices || meshlet.triangle_count == max_triangles)
+            {
+                close();
+            }
+
+            uint32_t packed = 0;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                if (local[corners[corner]] == 0xFF)
+                {
+                    local[corners[corner]] = (uint8_t)meshlet.vertex_count++;
+                    meshlet_vertices.push_back(corners[corner]);
+                }
+                packed |= (uint32_t)local[corners[corner]] << (corner * 8);
+            }
+            meshlet_triangles.push_back(packed);
+            ++meshlet.triangle_count;
+        }
+        close();
+    }
+} // namespace Aura
@@ -0,0 +1,37 @@
+#pragma once
+#include "mesh.h"
+namespace Aura
+{
+    // a small cluster of a submesh's triangles. its vertices are a run of the meshlet vertex list, which holds
+    // indices into the mesh's vertices, and its triangles a run of the triangle list, three 8-bit indices into
+    // the meshlet's vertices packed as a | b << 8 | c << 16
+    struct Meshlet
+    {
+        uint32_t vertex_offset {0};
+        uint32_t triangle_offset {0};
+        uint32_t vertex_count {0};
+        uint32_t triangle_count {0};
+        // bounding sphere
+        float    center[3] {0.0f, 0.0f, 0.0f};
+        float    radius {0.0f};
+        // every triangle faces away from a camera at p when dot(normalize(cone_apex - p), cone_axis) >= cone_cutoff.
+        // a cutoff of 1 never culls, that is what meshlets whose normals spread too far get
+        float    cone_apex[3] {0.0f, 0.0f, 0.0f};
+        float    cone_axis[3] {0.0f, 0.0f, 0.0f};
+        float    cone_cutoff {1.0f};
+    };
+
+    class MeshletBuilder
+    {
+    public:
+        // limits the triangle packing and the cull shader's workgroup size hold to
+        static constexpr uint32_t k_max_vertices {64};
+        static constexpr uint32_t k_max_triangles {124};
+
+        // appends the meshlets of one run of the index stream, splitting it greedily in index order. run it on
+        // cache-optimized indices, their triangles already come in tight neighbourhoods
+        static void build(const uint32_t* indices, size_t index_count, const MeshVertex* vertices, uint32_t vertex_count,
+                          uint32_t max_vertices, uint32_t max_triangles, std::vector<Meshlet>& meshlets,
+                          std::vector<uint32_t>& meshlet_vertices, std::vector<uint32_t>& meshlet_triangles);
+    };
+} // namespace Aura
@@ -0,0 +1,319 @@
+#include "obj_importer.h"
+#include "../util/job_system.h"
+#include "../util/mapped_file.h"
+
+#define TINYOBJ_LOADER_OPT_IMPLEMENTATION
+#include "experimental/tinyobj_loader_opt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <unordered_map>
+
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+
+namespace Aura
+{
+    namespace
+    {
+        struct CornerKey
+        {
+            int position;
+            int texcoord;
+            int normal;
+
+            bool operator==(const CornerKey& other) const
+            {
+                return position == other.position && texcoord == other.texcoord && normal == other.normal;
+            }
+        };
+
+        struct CornerKeyHash
+        {
+            size_t operator()(const CornerKey& key) const
+            {
+                uint64_t hash = (uint64_t)(uint32_t)key.position * 0x9E3779B97F4A7C15ull;
+                hash ^= ((uint64_t)(uint32_t)key.texcoord << 32 | (uint32_t)key.normal) * 0xC2B2AE3D27D4EB4Full;
+                return (size_t)(hash ^ (hash >> 29));
+            }
+        };
+
+        // the distinct corners of a run of faces, its indices point into them until the chunks are merged
+        struct EmitChunk
+        {
+            uint32_t               first_face {0};
+            uint32_t               face_count {0};
+            bool                   valid {true};
+            std::vector<CornerKey> corners;
+            std::vector<uint32_t>  indices;
+            // corner to mesh vertex, filled by the merge
+            std::vector<uint32_t> remap;
+        };
+
+        uint32_t const k_faces_per_chunk {64 * 1024};
+        uint32_t const k_vertices_per_batch {16 * 1024};
+    } // namespace
+
+    static void emitChunk(const tinyobj_opt::attrib_t& attrib, EmitChunk& chunk)
+    {
+        const int position_count = (int)(attrib.vertices.size() / 3);
+        const int normal_count   = (int)(attrib.normals.size() / 3);
+        const int texcoord_count = (int)(attrib.texcoords.size() / 2);
+
+        std::unordered_map<CornerKey, uint32_t, CornerKeyHash> corner_indices;
+        corner_indices.reserve(chunk.face_count);
+        chunk.corners.reserve(chunk.face_count);
+        chunk.indices.resize((size_t)chunk.face_count * 3);
+
+        for (uint32_t face = 0; face < chunk.face_count; ++face)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const tinyobj_opt::index_t& index = attrib.indices[((size_t)chunk.first_face + face) * 3 + corner];
+                if (index.vertex_index < 0 || index.vertex_index >= position_count || index.texcoord_index >= texcoord_count ||
+                    index.normal_index >= normal_count)
+                {
+                    chunk.valid = false;
+                    return;
+                }
+
+                CornerKey key {index.vertex_index, std::max(index.texcoord_index, -1), std::max(index.normal_index, -1)};
+                auto      inserted = corner_indices.emplace(key, (uint32_t)chunk.corners.size());
+                if (inserted.second)
+                {
+                    chunk.corners.push_back(key);
+                }
+                chunk.indices[(size_t)face * 3 + corner] = inserted.first->second;
+            }
+        }
+    }
+
+    // area weighted sum per obj position over the corners that have no normal, the cross product is twice the
+    // triangle's area. keyed by position rather than vertex so uv seams and chunk boundaries stay smooth
+    static void accumulateMissingNormals(const tinyobj_opt::attrib_t& attrib, std::vector<float>& position_normals)
+    {
+        position_normals.assign(attrib.vertices.size(), 0.0f);
+        for (size_t i = 0; i < attrib.indices.size(); i += 3)
+        {
+            const tinyobj_opt::index_t* face = &attrib.indices[i];
+            if (face[0].normal_index >= 0 && face[1].normal_index >= 0 && face[2].normal_index >= 0)
+            {
+                continue;
+            }
+            const float* p0    = &attrib.vertices[(size_t)face[0].vertex_index * 3];
+            const float* p1    = &attrib.vertices[(size_t)face[1].vertex_index * 3];
+            const float* p2    = &attrib.vertices[(size_t)face[2].vertex_index * 3];
+            float        e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float        e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float        n[3]  = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                if (face[corner].normal_index >= 0)
+                {
+                    continue;
+                }
+                float* sum = &position_normals[(size_t)face[corner].vertex_index * 3];
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    sum[k] += n[k];
+                }
+            }
+        }
+    }
+
+    bool ObjImporter::import(const std::string& path, MeshData& mesh, JobSystem* job_system)
+    {
+        typedef std::chrono::steady_clock clock;
+        m_stats = {};
+
+        clock::time_point map_begin = clock::now();
+        MappedFile        file;
+        if (!file.open(path))
+        {
+            LOG_ERROR("failed to open " << path);
+            return false;
+        }
+        m_stats.file_bytes = file.getSize();
+
+        clock::time_point               parse_begin = clock::now();
+        tinyobj_opt::attrib_t           attrib;
+        std::vector<tinyobj_opt::shape_t>    shapes;
+        std::vector<tinyobj_opt::material_t> materials;
+        tinyobj_opt::LoadOption         option;
+        option.req_num_threads = m_parse_threads;
+        option.triangulate     = true;
+        // mtllib is relative to the obj, not to the cwd
+        size_t separator   = path.find_last_of("/\\");
+        option.mtl_basedir = separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+        if (!tinyobj_opt::parseObj(&attrib, &shapes, &materials, (const char*)file.getData(), file.getSize(), option))
+        {
+            LOG_ERROR("failed to parse " << path);
+            return false;
+        }
+        // the parser copied everything it keeps out of the text
+        file.close();
+
+        clock::time_point emit_begin = clock::now();
+        size_t            face_count = attrib.face_num_verts.size();
+        if (attrib.indices.size() != face_count * 3 || face_count * 3 > UINT32_MAX)
+        {
+            LOG_ERROR("unsupported face layout in " << path);
+            return false;
+        }
+
+        mesh = MeshData();
+        for (const tinyobj_opt::material_t& material : materials)
+        {
+            mesh.material_names.push_back(material.name);
+        }
+        for (size_t face = 0; face < face_count; ++face)
+        {
+            int32_t material = face < attrib.material_ids.size() ? attrib.material_ids[face] : -1;
+            material         = material >= 0 && material < (int32_t)materials.size() ? material : -1;
+            if (mesh.submeshes.empty() || mesh.submeshes.back().material != material)
+            {
+                Submesh submesh;
+                submesh.first_index = (uint32_t)face * 3;
+                submesh.material    = material;
+                mesh.submeshes.push_back(submesh);
+            }
+            mesh.submeshes.back().index_count += 3;
+        }
+
+        std::vector<EmitChunk> chunks((face_count + k_faces_per_chunk - 1) / k_faces_per_chunk);
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            chunks[i].first_face = (uint32_t)i * k_faces_per_chunk;
+            chunks[i].face_count = (uint32_t)std::min<size_t>(k_faces_per_chunk, face_count - chunks[i].first_face);
+        }
+        auto emit = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                emitChunk(attrib, chunks[i]);
+            }
+        };
+        if (job_system != nullptr)
+        {
+            job_system->parallelFor((uint32_t)chunks.size(), 1, emit);
+        }
+        else
+        {
+            emit(0, (uint32_t)chunks.size());
+        }
+
+        // a corner shared by two chunks was seen by both, merge them in face order so the numbering does not
+        // depend on the chunking
+        size_t corner_count = 0;
+        for (const EmitChunk& chunk : chunks)
+        {
+            if (!chunk.valid)
+            {
+                LOG_ERROR("face index out of range in " << path);
+                return false;
+            }
+            corner_count += chunk.corners.size();
+        }
+        std::unordered_map<CornerKey, uint32_t, CornerKeyHash> mesh_vertices;
+        std::vector<CornerKey>                                 vertex_keys;
+        mesh_vertices.reserve(corner_count);
+        vertex_keys.reserve(corner_count);
+        bool any_missing_normal = false;
+        for (EmitChunk& chunk : chunks)
+        {
+            chunk.remap.resize(chunk.corners.size());
+            for (size_t i = 0; i < chunk.corners.size(); ++i)
+            {
+                auto inserted = mesh_vertices.emplace(chunk.corners[i], (uint32_t)vertex_keys.size());
+                if (inserted.second)
+                {
+                    vertex_keys.push_back(chunk.corners[i]);
+                    any_missing_normal |= chunk.corners[i].normal < 0;
+                }
+                chunk.remap[i] = inserted.first->second;
+            }
+            if (vertex_keys.size() > UINT32_MAX)
+            {
+                LOG_ERROR("too many vertices in " << path);
+                return false;
+            }
+        }
+        mesh_vertices = {};
+
+        std::vector<float> position_normals;
+        if (any_missing_normal)
+        {
+            accumulateMissingNormals(attrib, position_normals);
+        }
+
+        mesh.vertices.resize(vertex_keys.size());
+        mesh.indices.resize(face_count * 3);
+        auto stitch = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const EmitChunk& chunk   = chunks[i];
+                uint32_t*        indices = mesh.indices.data() + (size_t)chunk.first_face * 3;
+                for (size_t k = 0; k < chunk.indices.size(); ++k)
+                {
+                    indices[k] = chunk.remap[chunk.indices[k]];
+                }
+            }
+        };
+        auto fill = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const CornerKey& key    = vertex_keys[i];
+                MeshVertex&      vertex = mesh.vertices[i];
+                vertex                  = {};
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    vertex.position[k] = attrib.vertices[(size_t)key.position * 3 + k];
+                }
+                if (key.texcoord >= 0)
+                {
+                    // obj puts the origin bottom-left, vulkan samples from the top-left
+                    vertex.texcoord[0] = attrib.texcoords[(size_t)key.texcoord * 2 + 0];
+                    vertex.texcoord[1] = 1.0f - attrib.texcoords[(size_t)key.texcoord * 2 + 1];
+                }
+                const float* n = key.normal >= 0 ? &attrib.normals[(size_t)key.normal * 3] : &position_normals[(size_t)key.position * 3];
+                float length   = key.normal >= 0 ? 1.0f : std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length > 0.0f)
+                {
+                    vertex.normal[0] = n[0] / length;
+                    vertex.normal[1] = n[1] / length;
+                    vertex.normal[2] = n[2] / length;
+                }
+                else
+                {
+                    vertex.normal[2] = 1.0f;
+                }
+            }
+        };
+        if (job_system != nullptr)
+        {
+            job_system->parallelFor((uint32_t)chunks.size(), 1, stitch);
+            job_system->parallelFor((uint32_t)vertex_keys.size(), k_vertices_per_batch, fill);
+        }
+        else
+        {
+            stitch(0, (uint32_t)chunks.size());
+            fill(0, (uint32_t)vertex_keys.size());
+        }
+
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                float value        = mesh.vertices[i].position[k];
+                mesh.bounds_min[k] = i == 0 ? value : std::min(mesh.bounds_min[k], value);
+                mesh.bounds_max[k] = i == 0 ? value : std::max(mesh.bounds_max[k], value);
+            }
+        }
+
+        clock::time_point emit_end = clock::now();
+        m_stats.map_ms             = std::chrono::duration<double, std::milli>(parse_begin - map_begin).count();
+        m_stats.parse_ms           = std::chrono::duration<double, std::milli>(emit_begin - parse_begin).count();
+        m_stats.emit_ms            = std::chrono::duration<double, std::milli>(emit_end - emit_begin).count();
+        return true;
+    }
+} // namespace Aura
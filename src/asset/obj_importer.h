@@ -0,0 +1,35 @@
+#pragma once
+#include "mesh.h"
+
+#include <string>
+namespace Aura
+{
+    class JobSystem;
+
+    // milliseconds per stage of the last import()
+    struct ObjImportStats
+    {
+        uint64_t file_bytes {0};
+        double   map_ms {0.0};
+        double   parse_ms {0.0};
+        double   emit_ms {0.0};
+    };
+
+    // wavefront obj to MeshData. the file is memory-mapped and handed to tinyobj_opt's line-chunked parser,
+    // then the corners are deduplicated by chunks of faces in parallel and merged into one vertex per distinct
+    // corner of the whole mesh. vertices without a normal get the smoothed normal of the faces around their
+    // position. a mtllib is opened relative to the obj
+    class ObjImporter
+    {
+    public:
+        // job_system may be null, emission then runs on the calling thread
+        bool import(const std::string& path, MeshData& mesh, JobSystem* job_system = nullptr);
+        const ObjImportStats& getStats() const { return m_stats; }
+
+        // parser threads, negative uses one per hardware thread
+        int m_parse_threads {-1};
+
+    private:
+        ObjImportStats m_stats;
+    };
+} // namespace Aura
@@ -0,0 +1,331 @@
+#include "vertex_layout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Aura
+{
+    namespace
+    {
+        VertexLayoutInfo const k_layouts[VERTEX_LAYOUT_COUNT] = {
+            {"float32", 32, {VERTEX_ATTRIBUTE_FLOAT32X3, 0}, {VERTEX_ATTRIBUTE_FLOAT32X3, 12}, {VERTEX_ATTRIBUTE_FLOAT32X2, 24}},
+            {"snorm16", 20, {VERTEX_ATTRIBUTE_SNORM16X4, 0}, {VERTEX_ATTRIBUTE_SNORM16X4, 8}, {VERTEX_ATTRIBUTE_FLOAT16X2, 16}},
+            {"float16", 20, {VERTEX_ATTRIBUTE_FLOAT16X4, 0}, {VERTEX_ATTRIBUTE_SNORM16X4, 8}, {VERTEX_ATTRIBUTE_FLOAT16X2, 16}},
+            {"snorm16_oct8", 16, {VERTEX_ATTRIBUTE_SNORM16X4, 0}, {VERTEX_ATTRIBUTE_SNORM8X4, 8}, {VERTEX_ATTRIBUTE_FLOAT16X2, 12}},
+        };
+
+        float const k_degrees_per_radian {57.2957795f};
+    } // namespace
+
+    static uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign      = (bits >> 16) & 0x8000;
+        uint32_t magnitude = bits & 0x7FFFFFFF;
+        if (magnitude >= 0x7F800000)
+        {
+            return (uint16_t)(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0));
+        }
+        // 65520 and up round to infinity
+        if (magnitude >= 0x477FF000)
+        {
+            return (uint16_t)(sign | 0x7C00);
+        }
+        // below 2^-14 the half is subnormal, counted in steps of 2^-24
+        if (magnitude < 0x38800000)
+        {
+            float absolute;
+            memcpy(&absolute, &magnitude, sizeof(absolute));
+            return (uint16_t)(sign | (uint32_t)std::nearbyint(absolute * 16777216.0f));
+        }
+        // rebias the exponent and round the mantissa to nearest even
+        uint32_t half      = (magnitude - 0x38000000) >> 13;
+        uint32_t remainder = magnitude & 0x1FFF;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        {
+            ++half;
+        }
+        return (uint16_t)(sign | half);
+    }
+
+    static float halfToFloat(uint16_t half)
+    {
+        uint32_t sign     = (uint32_t)(half & 0x8000) << 16;
+        uint32_t exponent = (half >> 10) & 0x1F;
+        uint32_t mantissa = half & 0x3FF;
+        if (exponent == 0)
+        {
+            float value = (float)mantissa / 16777216.0f;
+            return sign ? -value : value;
+        }
+        uint32_t bits = exponent == 31 ? sign | 0x7F800000 | (mantissa << 13) : sign | ((exponent + 112) << 23) | (mantissa << 13);
+        float    value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // what the vertex fetch unit does with snorm: c / max and clamped at -1
+    static int32_t encodeSnorm(float value, int32_t max)
+    {
+        return (int32_t)std::lround(std::min(std::max(value, -1.0f), 1.0f) * (float)max);
+    }
+
+    static float decodeSnorm(int32_t value, int32_t max)
+    {
+        return std::max((float)value / (float)max, -1.0f);
+    }
+
+    static float signNotZero(float value)
+    {
+        return value < 0.0f ? -1.0f : 1.0f;
+    }
+
+    // unit vector onto the octahedron, the lower half folded over the diagonals, in [-1, 1]^2
+    static void octEncode(const float* direction, float* encoded)
+    {
+        float l1 = std::fabs(direction[0]) + std::fabs(direction[1]) + std::fabs(direction[2]);
+        if (l1 == 0.0f)
+        {
+            encoded[0] = 0.0f;
+            encoded[1] = 0.0f;
+            return;
+        }
+        float u = direction[0] / l1;
+        float v = direction[1] / l1;
+        if (direction[2] < 0.0f)
+        {
+            float folded_u = (1.0f - std::fabs(v)) * signNotZero(u);
+            v              = (1.0f - std::fabs(u)) * signNotZero(v);
+            u              = folded_u;
+        }
+        encoded[0] = u;
+        encoded[1] = v;
+    }
+
+    static void octDecode(const float* encoded, float* direction)
+    {
+        direction[0] = encoded[0];
+        direction[1] = encoded[1];
+        direction[2] = 1.0f - std::fabs(encoded[0]) - std::fabs(encoded[1]);
+        if (direction[2] < 0.0f)
+        {
+            direction[0] = (1.0f - std::fabs(encoded[1])) * signNotZero(encoded[0]);
+            direction[1] = (1.0f - std::fabs(encoded[0])) * signNotZero(encoded[1]);
+        }
+        float length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            direction[k] /= length;
+        }
+    }
+
+    // atan2 stays accurate for the tiny angles acos rounds to zero
+    static float angleDegrees(const float* a, const float* b)
+    {
+        float cross[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        float sine     = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+        return std::atan2(sine, a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) * k_degrees_per_radian;
+    }
+
+    const VertexLayoutInfo& VertexEncoder::getLayoutInfo(VertexLayout layout)
+    {
+        return k_layouts[layout];
+    }
+
+    VertexQuantization VertexEncoder::getQuantization(VertexLayout layout, const std::vector<MeshVertex>& vertices)
+    {
+        VertexQuantization quantization;
+        if (layout == VERTEX_LAYOUT_FLOAT32 || vertices.empty())
+        {
+            return quantization;
+        }
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            float min_value = vertices[0].position[k];
+            float max_value = vertices[0].position[k];
+            for (const MeshVertex& vertex : vertices)
+            {
+                min_value = std::min(min_value, vertex.position[k]);
+                max_value = std::max(max_value, vertex.position[k]);
+            }
+            quantization.position_offset[k] = (min_value + max_value) * 0.5f;
+            // a flat axis stores 0 whatever the scale
+            quantization.position_scale[k] = max_value > min_value ? (max_value - min_value) * 0.5f : 1.0f;
+        }
+        return quantization;
+    }
+
+    void VertexEncoder::computeTangents(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                                        std::vector<float>& tangents)
+    {
+        std::vector<float> bitangents(vertices.size() * 3, 0.0f);
+        tangents.assign(vertices.size() * 4, 0.0f);
+        for (size_t i = 0; i + 3 <= indices.size(); i += 3)
+        {
+            const MeshVertex& v0  = vertices[indices[i + 0]];
+            const MeshVertex& v1  = vertices[indices[i + 1]];
+            const MeshVertex& v2  = vertices[indices[i + 2]];
+            float             du1 = v1.texcoord[0] - v0.texcoord[0];
+            float             dv1 = v1.texcoord[1] - v0.texcoord[1];
+            float             du2 = v2.texcoord[0] - v0.texcoord[0];
+            float             dv2 = v2.texcoord[1] - v0.texcoord[1];
+            float             det = du1 * dv2 - du2 * dv1;
+            if (std::fabs(det) < 1e-20f)
+            {
+                continue;
+            }
+            float tangent[3], bitangent[3];
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                float e1     = v1.position[k] - v0.position[k];
+                float e2     = v2.position[k] - v0.position[k];
+                tangent[k]   = (e1 * dv2 - e2 * dv1) / det;
+                bitangent[k] = (e2 * du1 - e1 * du2) / det;
+            }
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                uint32_t vertex = indices[i + corner];
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    tangents[(size_t)vertex * 4 + k] += tangent[k];
+                    bitangents[(size_t)vertex * 3 + k] += bitangent[k];
+                }
+            }
+        }
+
+        // gram-schmidt against the normal
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const float* n  = vertices[i].normal;
+            float*       t  = &tangents[i * 4];
+            const float* b  = &bitangents[i * 3];
+            float        nt = n[0] * t[0] + n[1] * t[1] + n[2] * t[2];
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                t[k] -= n[k] * nt;
+            }
+            float length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+            if (length < 1e-12f)
+            {
+                // crossed with the axis the normal is least aligned with
+                uint32_t axis_index = 0;
+                for (uint32_t k = 1; k < 3; ++k)
+                {
+                    axis_index = std::fabs(n[k]) < std::fabs(n[axis_index]) ? k : axis_index;
+                }
+                float axis[3]    = {0.0f, 0.0f, 0.0f};
+                axis[axis_index] = 1.0f;
+                t[0]   = n[1] * axis[2] - n[2] * axis[1];
+                t[1]   = n[2] * axis[0] - n[0] * axis[2];
+                t[2]   = n[0] * axis[1] - n[1] * axis[0];
+                length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+            }
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                t[k] = length > 0.0f ? t[k] / length : (k == 0 ? 1.0f : 0.0f);
+            }
+            float cross[3] = {n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2], n[0] * t[1] - n[1] * t[0]};
+            t[3]           = cross[0] * b[0] + cross[1] * b[1] + cross[2] * b[2] < 0.0f ? -1.0f : 1.0f;
+        }
+    }
+
+    void VertexEncoder::encode(VertexLayout layout, const std::vector<MeshVertex>& vertices, const std::vector<float>& tangents,
+                               const VertexQuantization& quantization, uint8_t* out, VertexEncodingError& error)
+    {
+        const VertexLayoutInfo& info = k_layouts[layout];
+        error                        = VertexEncodingError();
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const MeshVertex& vertex     = vertices[i];
+            uint8_t*          encoded    = out + i * info.stride;
+            float             handedness = layout == VERTEX_LAYOUT_FLOAT32 ? 1.0f : tangents[i * 4 + 3];
+            float             position[3], normal[3], tangent[3], texcoord[2];
+
+            float stored[4];
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                stored[k] = (vertex.position[k] - quantization.position_offset[k]) / quantization.position_scale[k];
+            }
+            stored[3] = handedness;
+            switch (info.position.encoding)
+            {
+                case VERTEX_ATTRIBUTE_SNORM16X4: {
+                    int16_t* values = (int16_t*)(encoded + info.position.offset);
+                    for (uint32_t k = 0; k < 4; ++k)
+                    {
+                        values[k] = (int16_t)encodeSnorm(stored[k], 32767);
+                        stored[k] = decodeSnorm(values[k], 32767);
+                    }
+                    break;
+                }
+                case VERTEX_ATTRIBUTE_FLOAT16X4: {
+                    uint16_t* values = (uint16_t*)(encoded + info.position.offset);
+                    for (uint32_t k = 0; k < 4; ++k)
+                    {
+                        values[k] = floatToHalf(stored[k]);
+                        stored[k] = halfToFloat(values[k]);
+                    }
+                    break;
+                }
+                default:
+                    memcpy(encoded + info.position.offset, vertex.position, sizeof(vertex.position));
+                    break;
+            }
+            float position_error = 0.0f;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                position[k] = info.position.encoding == VERTEX_ATTRIBUTE_FLOAT32X3 ?
+                                  vertex.position[k] :
+                                  quantization.position_offset[k] + quantization.position_scale[k] * stored[k];
+                position_error += (position[k] - vertex.position[k]) * (position[k] - vertex.position[k]);
+            }
+            error.position = std::max(error.position, std::sqrt(position_error));
+
+            if (info.normal.encoding == VERTEX_ATTRIBUTE_FLOAT32X3)
+            {
+                memcpy(encoded + info.normal.offset, vertex.normal, sizeof(vertex.normal));
+            }
+            else
+            {
+                float frame[4];
+                octEncode(vertex.normal, frame);
+                octEncode(&tangents[i * 4], frame + 2);
+                int32_t max = info.normal.encoding == VERTEX_ATTRIBUTE_SNORM16X4 ? 32767 : 127;
+                for (uint32_t k = 0; k < 4; ++k)
+                {
+                    int32_t value = encodeSnorm(frame[k], max);
+                    if (max == 127)
+                    {
+                        ((int8_t*)(encoded + info.normal.offset))[k] = (int8_t)value;
+                    }
+                    else
+                    {
+                        ((int16_t*)(encoded + info.normal.offset))[k] = (int16_t)value;
+                    }
+                    frame[k] = decodeSnorm(value, max);
+                }
+                octDecode(frame, normal);
+                octDecode(frame + 2, tangent);
+                error.normal_degrees  = std::max(error.normal_degrees, angleDegrees(vertex.normal, normal));
+                error.tangent_degrees = std::max(error.tangent_degrees, angleDegrees(&tangents[i * 4], tangent));
+            }
+
+            if (info.texcoord.encoding == VERTEX_ATTRIBUTE_FLOAT16X2)
+            {
+                uint16_t* values = (uint16_t*)(encoded + info.texcoord.offset);
+                for (uint32_t k = 0; k < 2; ++k)
+                {
+                    values[k]      = floatToHalf(vertex.texcoord[k]);
+                    texcoord[k]    = halfToFloat(values[k]);
+                    error.texcoord = std::max(error.texcoord, std::fabs(texcoord[k] - vertex.texcoord[k]));
+                }
+            }
+            else
+            {
+                memcpy(encoded + info.texcoord.offset, vertex.texcoord, sizeof(vertex.texcoord));
+            }
+        }
+    }
+} // namespace Aura
@@ -0,0 +1,79 @@
+#pragma once
+#include "mesh.h"
+namespace Aura
+{
+    // how a cooked mesh stores its vertices. the quantized layouts keep positions in [-1, 1] across the mesh
+    // bounds, the vertex shader multiplies by the header's position_scale and adds position_offset. their
+    // normal attribute holds the octahedral normal in xy and the octahedral tangent in zw, position.w is the
+    // bitangent sign
+    enum VertexLayout : uint32_t
+    {
+        // MeshVertex as is, 32 bytes and no tangent
+        VERTEX_LAYOUT_FLOAT32 = 0,
+        // snorm16x4 position, snorm16x4 normal and tangent, half2 texcoord, 20 bytes
+        VERTEX_LAYOUT_SNORM16 = 1,
+        // half4 position, otherwise VERTEX_LAYOUT_SNORM16
+        VERTEX_LAYOUT_FLOAT16 = 2,
+        // snorm8x4 normal and tangent, otherwise VERTEX_LAYOUT_SNORM16, 16 bytes
+        VERTEX_LAYOUT_SNORM16_OCT8 = 3,
+        VERTEX_LAYOUT_COUNT
+    };
+
+    enum VertexAttributeEncoding : uint32_t
+    {
+        VERTEX_ATTRIBUTE_FLOAT32X2,
+        VERTEX_ATTRIBUTE_FLOAT32X3,
+        VERTEX_ATTRIBUTE_FLOAT16X2,
+        VERTEX_ATTRIBUTE_FLOAT16X4,
+        VERTEX_ATTRIBUTE_SNORM16X4,
+        VERTEX_ATTRIBUTE_SNORM8X4
+    };
+
+    struct VertexAttributeInfo
+    {
+        VertexAttributeEncoding encoding;
+        uint32_t                offset;
+    };
+
+    struct VertexLayoutInfo
+    {
+        const char*         name;
+        uint32_t            stride;
+        VertexAttributeInfo position;
+        VertexAttributeInfo normal;
+        VertexAttributeInfo texcoord;
+    };
+
+    // decoded position = offset + scale * stored
+    struct VertexQuantization
+    {
+        float position_offset[3] {0.0f, 0.0f, 0.0f};
+        float position_scale[3] {1.0f, 1.0f, 1.0f};
+    };
+
+    // worst case over a mesh after a round trip through a layout
+    struct VertexEncodingError
+    {
+        // in object units
+        float position {0.0f};
+        float normal_degrees {0.0f};
+        float tangent_degrees {0.0f};
+        float texcoord {0.0f};
+    };
+
+    class VertexEncoder
+    {
+    public:
+        static const VertexLayoutInfo& getLayoutInfo(VertexLayout layout);
+
+        // the mesh bounds mapped onto [-1, 1], identity for VERTEX_LAYOUT_FLOAT32
+        static VertexQuantization getQuantization(VertexLayout layout, const std::vector<MeshVertex>& vertices);
+        // per-vertex xyz tangent and bitangent sign in w from the texcoord gradients of the faces around it,
+        // any tangent perpendicular to the normal where the texcoords are degenerate
+        static void computeTangents(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+                                    std::vector<float>& tangents);
+        // out holds vertices.size() * stride bytes, tangents is only read by the quantized layouts
+        static void encode(VertexLayout layout, const std::vector<MeshVertex>& vertices, const std::vector<float>& tangents,
+                           const VertexQuantization& quantization, uint8_t* out, VertexEncodingError& error);
+    };
+} // namespace Aura
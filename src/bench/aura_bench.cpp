@@ -0,0 +1,1187 @@
+#include "../Aura.h"
+#include "../asset/obj_importer.h"
+#include "../render/cluster_culler.h"
+#include "../render/gpu_mesh.h"
+#include "../util/mapped_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// Aura_bench: drives a fixed number of frames over a synthetic scene and
+// reports cpu/gpu frame time percentiles as JSON.
+//
+//   Aura_bench [--frames N] [--warmup N] [--meshes N] [--materials N]
+//              [--lights N] [--output file.json] [--windowed] [--no-bindless]
+//              [--record-threads N] [--job-threads N] [--frames-in-flight N]
+//              [--present-mode fifo|fifo_relaxed|mailbox|immediate] [--fps-limit N]
+//              [--resize-every N] [--no-dynamic-rendering] [--translation-calls N]
+//              [--assert-allocation-free] [--import-obj file.obj]
+//              [--load-mesh file.auramesh [--cluster-cull]]
+//   Aura_bench --self-check
+//
+// --self-check compiles small render graphs on the headless device instead of
+// benchmarking and exits non-zero when culling or transient aliasing is off.
+
+namespace Aura {
+    struct BenchConfig {
+        uint32_t frames{1000};
+        uint32_t warmup_frames{60};
+        uint32_t mesh_count{1000};
+        uint32_t material_count{64};
+        uint32_t light_count{16};
+        bool headless{true};
+        bool bindless{true};
+        // 1 records inline on the main thread, more splits the meshes over secondaries
+        uint32_t record_threads{1};
+        // job system workers next to the main thread, negative uses one per remaining core
+        int job_threads{-1};
+        // 1 favours latency, 3 throughput
+        uint32_t frames_in_flight{3};
+        RHIPresentMode present_mode{RHI_PRESENT_MODE_MAILBOX_KHR};
+        // 0 runs unlimited
+        double fps_limit{0.0};
+        // windowed only, toggles the window size every N measured frames to exercise swapchain recreation
+        uint32_t resize_every{0};
+        // off records through render pass and framebuffer objects even where dynamic rendering is available
+        bool dynamic_rendering{true};
+        // after the measured frames, times N calls of RHI entry points that translate arrays, once through the
+        // scratch arena and once with every temporary on the heap. 0 skips it
+        uint32_t translation_calls{0};
+        // debug builds assert that measured frames take no heap blocks for scratch memory
+        bool assert_allocation_free{false};
+        // imported once on the app's job system before the warmup, only timed
+        std::string import_obj_path;
+        // mapped and uploaded before the warmup, timed until the copies completed
+        std::string load_mesh_path;
+        // culls the loaded mesh's meshlets on the compute queue every frame, from a fixed camera in front of it,
+        // and draws the surviving triangles into the main pass
+        bool cluster_cull{false};
+        bool self_check{false};
+        std::string output_path;
+    };
+
+    struct TranslationCallRates {
+        double update_descriptor_sets{0.0};
+        double create_render_pass{0.0};
+        uint64_t scratch_heap_allocations{0};
+    };
+
+    struct BenchLight {
+        float position[4];
+        float color[4];
+    };
+
+    struct BenchObjectConstants {
+        float model[16];
+    };
+
+    // the push constants of cluster_draw.vert
+    struct ClusterDrawConstants {
+        float view_projection[16];
+        float position_offset[4];
+        float position_scale[4];
+    };
+    static_assert(sizeof(ClusterDrawConstants) == 96, "must match the push constants of cluster_draw.vert");
+
+    // set by the build next to the compiled spir-v
+#ifndef AURA_SHADER_DIR
+#define AURA_SHADER_DIR "shaders"
+#endif
+
+    class BenchApp : public Aura {
+        public:
+            explicit BenchApp(const BenchConfig& config) : config(config) {}
+            void setupScene();
+            void updateLights(uint32_t frame);
+            // calls per second of each entry point, heap_fallback emulates the per-call std::vector temporaries
+            TranslationCallRates measureTranslationCalls(uint32_t calls, bool heap_fallback);
+            bool isBindless() const { return config.bindless; }
+            // the mesh must stay alive until shutdownClusterCull()
+            bool setupClusterCull(const GpuMesh& mesh, const float bounds_min[3], const float bounds_max[3]);
+            void shutdownClusterCull();
+            // triangles the culled draws kept in the latest completed frame, -1 before the first one
+            int64_t getVisibleClusterTriangles() const { return cluster_target.visible_triangles; }
+        protected:
+            virtual void recordScene(RHICommandBuffer command_buffer) override;
+            virtual bool recordsSceneInParallel() const override { return config.record_threads > 1; }
+            virtual void configureRHI(VulkanRHI* rhi) override {
+                rhi->m_recording_worker_threads = config.record_threads - 1;
+                rhi->m_frames_in_flight = config.frames_in_flight;
+                rhi->m_present_mode = config.present_mode;
+            }
+            virtual void buildRenderGraph(RenderGraph& graph) override {
+                graph.m_dynamic_rendering = config.dynamic_rendering;
+                Aura::buildRenderGraph(graph);
+            }
+            virtual uint32_t jobWorkerCount() const override {
+                return config.job_threads < 0 ? Aura::jobWorkerCount() : (uint32_t)config.job_threads;
+            }
+        private:
+            BenchConfig config;
+            std::vector<RHIBuffer> vertex_buffers;
+            std::vector<RHIBuffer> index_buffers;
+            RHIDescriptorSetLayout  material_layout{nullptr};
+            std::vector<RHIDescriptorSet> material_sets;
+            // bindless mode: one slot per material in the global set instead of one set each
+            std::vector<uint32_t> material_indices;
+            RHIBuffer material_buffer{nullptr};
+            RHIDeviceMemory material_buffer_memory{nullptr};
+            RHIBuffer light_buffer{nullptr};
+            RHIDeviceMemory light_buffer_memory{nullptr};
+            void* light_buffer_data{nullptr};
+            RHIDescriptorSetLayout object_layout{nullptr};
+            RHIDescriptorSet object_set{nullptr};
+            // set 0 is the bindless set or a material set, set 1 the per-object constants
+            RHIPipelineLayout scene_layout{nullptr};
+            std::vector<uint32_t> object_dynamic_offsets;
+            uint32_t frame_counter{0};
+            ClusterCuller cluster_culler;
+            ClusterCullTarget cluster_target;
+            bool cluster_culling{false};
+            float cull_planes[6][4];
+            float cull_camera_position[3];
+            // draws the culled indices into the main pass, flat shaded from the positions alone
+            const GpuMesh* cluster_mesh{nullptr};
+            RHIPipelineLayout cluster_draw_layout{nullptr};
+            RHIPipeline cluster_draw_pipeline{nullptr};
+            ClusterDrawConstants cluster_draw_constants;
+            bool setupClusterDraw(float radius);
+            void recordClusterDraw(RHICommandBuffer command_buffer);
+            void setupMeshes();
+            void setupMaterials();
+            void setupLights();
+            void setupObjects();
+            void setupSceneLayout();
+            void recordMeshes(RHICommandBuffer command_buffer, uint32_t begin, uint32_t end, float t);
+    };
+
+    void BenchApp::setupScene() {
+        setupMeshes();
+        setupMaterials();
+        setupLights();
+        setupObjects();
+        setupSceneLayout();
+    }
+
+    void BenchApp::setupSceneLayout() {
+        RHIDescriptorSetLayout set_layouts[2] = {
+            config.bindless ? rhi->getBindlessDescriptorSetLayout() : material_layout,
+            object_layout,
+        };
+        RHIPipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layout_info.setLayoutCount = 2;
+        layout_info.pSetLayouts = set_layouts;
+        if (!rhi->createPipelineLayout(&layout_info, scene_layout)) {
+            throw std::runtime_error("create bench scene layout");
+        }
+    }
+
+    void BenchApp::setupMeshes() {
+        const float vertices[] = {
+            -0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f, 0.5f, -0.5f,  -0.5f, 0.5f, -0.5f,
+            -0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f, 0.5f,  0.5f,  -0.5f, 0.5f,  0.5f,
+        };
+        const uint16_t indices[] = {
+            0, 1, 2, 2, 3, 0,  4, 6, 5, 6, 4, 7,  0, 3, 7, 7, 4, 0,
+            1, 5, 6, 6, 2, 1,  3, 2, 6, 6, 7, 3,  0, 4, 5, 5, 1, 0,
+        };
+        vertex_buffers.resize(config.mesh_count);
+        index_buffers.resize(config.mesh_count);
+        for (uint32_t i = 0; i < config.mesh_count; ++i) {
+            RHIDeviceMemory  vertex_buffer_memory;
+            RHIDeviceMemory  index_buffer_memory;
+            rhi->createBuffer(sizeof(vertices),
+                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                              vertex_buffers[i],
+                              vertex_buffer_memory);
+            rhi->createBuffer(sizeof(indices),
+                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                              index_buffers[i],
+                              index_buffer_memory);
+            rhi->uploadBuffer(vertex_buffers[i], 0, vertices, sizeof(vertices));
+            rhi->uploadBuffer(index_buffers[i], 0, indices, sizeof(indices));
+        }
+        rhi->flushUploads();
+    }
+
+    void BenchApp::setupMaterials() {
+        const RHIDeviceSize material_stride = 256; // covers min{Uniform,Storage}BufferOffsetAlignment everywhere
+        if (config.bindless && rhi->m_bindless_supported) {
+            rhi->createBuffer(material_stride * config.material_count,
+                              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                              material_buffer,
+                              material_buffer_memory);
+            material_indices.resize(config.material_count);
+            for (uint32_t i = 0; i < config.material_count; ++i) {
+                material_indices[i] = rhi->registerBindlessBuffer(material_buffer, material_stride * i, material_stride);
+                if (material_indices[i] == RHI_INVALID_BINDLESS_INDEX) {
+                    throw std::runtime_error("register bench material");
+                }
+            }
+            return;
+        }
+        config.bindless = false;
+
+        RHIDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = RHI_SHADER_STAGE_FRAGMENT_BIT;
+        binding.pImmutableSamplers = nullptr;
+
+        RHIDescriptorSetLayoutCreateInfo layout_info{};
+        layout_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.bindingCount = 1;
+        layout_info.pBindings = &binding;
+        if (rhi->createDescriptorSetLayout(&layout_info, material_layout) != RHI_SUCCESS) {
+            throw std::runtime_error("create bench material layout");
+        }
+
+        rhi->createBuffer(material_stride * config.material_count,
+                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          material_buffer,
+                          material_buffer_memory);
+
+        material_sets.resize(config.material_count);
+        for (uint32_t i = 0; i < config.material_count; ++i) {
+            RHIDescriptorSetAllocateInfo allocate_info{};
+            allocate_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocate_info.descriptorPool = rhi->m_descriptor_pool;
+            allocate_info.descriptorSetCount = 1;
+            allocate_info.pSetLayouts = &material_layout;
+            if (rhi->allocateDescriptorSets(&allocate_info, material_sets[i]) != RHI_SUCCESS) {
+                throw std::runtime_error("allocate bench material descriptor set");
+            }
+
+            RHIDescriptorBufferInfo buffer_info{};
+            buffer_info.buffer = material_buffer;
+            buffer_info.offset = material_stride * i;
+            buffer_info.range = material_stride;
+
+            RHIWriteDescriptorSet write{};
+            write.sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = material_sets[i];
+            write.dstBinding = 0;
+            write.dstArrayElement = 0;
+            write.descriptorCount = 1;
+            write.descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            write.pBufferInfo = &buffer_info;
+            rhi->updateDescriptorSets(1, &write, 0, nullptr);
+        }
+    }
+
+    void BenchApp::setupLights() {
+        RHIDeviceSize size = sizeof(BenchLight) * std::max(config.light_count, 1u);
+        rhi->createBuffer(size,
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          light_buffer,
+                          light_buffer_memory);
+        rhi->mapMemory(light_buffer_memory, 0, size, &light_buffer_data);
+    }
+
+    void BenchApp::setupObjects() {
+        RHIDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        binding.descriptorCount = 1;
+        binding.stageFlags = RHI_SHADER_STAGE_VERTEX_BIT;
+        binding.pImmutableSamplers = nullptr;
+
+        RHIDescriptorSetLayoutCreateInfo layout_info{};
+        layout_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.bindingCount = 1;
+        layout_info.pBindings = &binding;
+        if (rhi->createDescriptorSetLayout(&layout_info, object_layout) != RHI_SUCCESS) {
+            throw std::runtime_error("create bench object layout");
+        }
+
+        RHIDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = rhi->m_descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &object_layout;
+        if (rhi->allocateDescriptorSets(&allocate_info, object_set) != RHI_SUCCESS) {
+            throw std::runtime_error("allocate bench object descriptor set");
+        }
+
+        // written once, every draw only changes its dynamic offset into the frame ring
+        RHIDescriptorBufferInfo buffer_info{};
+        buffer_info.buffer = rhi->getFrameRingBuffer();
+        buffer_info.offset = 0;
+        buffer_info.range = sizeof(BenchObjectConstants);
+
+        RHIWriteDescriptorSet write{};
+        write.sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = object_set;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        write.pBufferInfo = &buffer_info;
+        rhi->updateDescriptorSets(1, &write, 0, nullptr);
+
+        object_dynamic_offsets.resize(config.mesh_count);
+    }
+
+    void BenchApp::updateLights(uint32_t frame) {
+        BenchLight* lights = (BenchLight*)light_buffer_data;
+        for (uint32_t i = 0; i < config.light_count; ++i) {
+            float t = (float)(frame + i);
+            lights[i] = {{t, 2.0f * t, 3.0f * t, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+        }
+    }
+
+    TranslationCallRates BenchApp::measureTranslationCalls(uint32_t calls, bool heap_fallback) {
+        TranslationCallRates rates;
+        // a set of its own, the scene's sets may still be in use by frames in flight
+        RHIDescriptorSet set = nullptr;
+        RHIDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = rhi->m_descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &object_layout;
+        if (rhi->allocateDescriptorSets(&allocate_info, set) != RHI_SUCCESS) {
+            throw std::runtime_error("allocate bench translation descriptor set");
+        }
+
+        RHIDescriptorBufferInfo buffer_info{};
+        buffer_info.buffer = rhi->getFrameRingBuffer();
+        buffer_info.offset = 0;
+        buffer_info.range = sizeof(BenchObjectConstants);
+        RHIWriteDescriptorSet write{};
+        write.sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        write.pBufferInfo = &buffer_info;
+
+        // every call after the first is a render pass cache hit, what is left is the translation and the key
+        RHIAttachmentDescription attachment{};
+        attachment.format = RHI_FORMAT_R8G8B8A8_UNORM;
+        attachment.samples = RHI_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = RHI_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = RHI_ATTACHMENT_STORE_OP_STORE;
+        attachment.stencilLoadOp = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout = RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        RHIAttachmentReference color_reference{0, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        RHISubpassDescription subpass{};
+        subpass.pipelineBindPoint = RHI_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &color_reference;
+        RHIRenderPassCreateInfo render_pass_info{};
+        render_pass_info.sType = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        render_pass_info.attachmentCount = 1;
+        render_pass_info.pAttachments = &attachment;
+        render_pass_info.subpassCount = 1;
+        render_pass_info.pSubpasses = &subpass;
+
+        ScratchArena::setHeapFallback(heap_fallback);
+        uint64_t heap_allocations = ScratchArena::getHeapAllocationCount();
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < calls; ++i) {
+            rhi->updateDescriptorSets(1, &write, 0, nullptr);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        rates.update_descriptor_sets = seconds > 0.0 ? calls / seconds : 0.0;
+
+        begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < calls; ++i) {
+            RHIRenderPass render_pass = nullptr;
+            if (rhi->createRenderPass(&render_pass_info, render_pass) != RHI_SUCCESS) {
+                throw std::runtime_error("create bench translation render pass");
+            }
+            rhi->destroyRenderPass(render_pass);
+        }
+        end = std::chrono::steady_clock::now();
+        seconds = std::chrono::duration<double>(end - begin).count();
+        rates.create_render_pass = seconds > 0.0 ? calls / seconds : 0.0;
+        rates.scratch_heap_allocations = ScratchArena::getHeapAllocationCount() - heap_allocations;
+        ScratchArena::setHeapFallback(false);
+        return rates;
+    }
+
+    bool BenchApp::setupClusterCull(const GpuMesh& mesh, const float bounds_min[3], const float bounds_max[3]) {
+        RHIUploadTicket ticket;
+        if (!cluster_culler.initialize(rhi)) {
+            return false;
+        }
+        if (!cluster_culler.createTarget(mesh, cluster_target, ticket)) {
+            cluster_culler.shutdown();
+            return false;
+        }
+        rhi->flushUploads();
+        rhi->waitForUpload(ticket);
+
+        // looking down -z from twice the bounding radius, a 90 degree frustum whose side planes meet at the camera
+        float radius = 0.0f;
+        for (uint32_t k = 0; k < 3; ++k) {
+            cull_camera_position[k] = (bounds_min[k] + bounds_max[k]) * 0.5f;
+            radius += (bounds_max[k] - bounds_min[k]) * (bounds_max[k] - bounds_min[k]) * 0.25f;
+        }
+        radius = std::sqrt(radius);
+        cull_camera_position[2] += 2.0f * radius;
+        const float s = std::sqrt(0.5f);
+        const float normals[6][3] = {
+            {s, 0.0f, -s}, {-s, 0.0f, -s}, {0.0f, s, -s}, {0.0f, -s, -s}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, 1.0f},
+        };
+        for (uint32_t i = 0; i < 6; ++i) {
+            float point[3] = {cull_camera_position[0], cull_camera_position[1], cull_camera_position[2]};
+            point[2] -= i == 4 ? 0.01f * radius : (i == 5 ? 4.0f * radius : 0.0f);
+            for (uint32_t k = 0; k < 3; ++k) {
+                cull_planes[i][k] = normals[i][k];
+            }
+            cull_planes[i][3] = -(normals[i][0] * point[0] + normals[i][1] * point[1] + normals[i][2] * point[2]);
+        }
+        cluster_mesh = &mesh;
+        if (!setupClusterDraw(radius)) {
+            cluster_culler.destroyTarget(cluster_target);
+            cluster_culler.shutdown();
+            return false;
+        }
+        cluster_culling = true;
+        return true;
+    }
+
+    static RHIShader loadBenchShader(VulkanRHI* rhi, const char* name) {
+        std::string path = std::string(AURA_SHADER_DIR) + "/" + name;
+        MappedFile file;
+        if (!file.open(path) || file.getSize() == 0) {
+            fprintf(stderr, "failed to open %s\n", path.c_str());
+            return nullptr;
+        }
+        std::vector<unsigned char> code(file.getData(), file.getData() + file.getSize());
+        return rhi->createShaderModule(code);
+    }
+
+    bool BenchApp::setupClusterDraw(float radius) {
+        // the projection matching cull_planes: 90 degrees both ways, y flipped and depth 0 to 1 between the
+        // near and far planes. column major, the camera only translates
+        const float n = 0.01f * radius, f = 4.0f * radius;
+        const float a = f / (n - f), b = n * f / (n - f);
+        const float* c = cull_camera_position;
+        const float view_projection[16] = {
+            1.0f, 0.0f, 0.0f, 0.0f,  0.0f, -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, a, -1.0f,  -c[0], c[1], b - a * c[2], c[2],
+        };
+        memcpy(cluster_draw_constants.view_projection, view_projection, sizeof(view_projection));
+        const VertexQuantization& quantization = cluster_mesh->getQuantization();
+        for (uint32_t k = 0; k < 3; ++k) {
+            cluster_draw_constants.position_offset[k] = quantization.position_offset[k];
+            cluster_draw_constants.position_scale[k] = quantization.position_scale[k];
+        }
+        cluster_draw_constants.position_offset[3] = 0.0f;
+        cluster_draw_constants.position_scale[3] = 1.0f;
+
+        RHIPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = RHI_SHADER_STAGE_VERTEX_BIT;
+        push_constant_range.size = sizeof(ClusterDrawConstants);
+        RHIPipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layout_info.pushConstantRangeCount = 1;
+        layout_info.pPushConstantRanges = &push_constant_range;
+        if (!rhi->createPipelineLayout(&layout_info, cluster_draw_layout)) {
+            return false;
+        }
+
+        RHIShader  vertex_shader = loadBenchShader(rhi, "cluster_draw.vert.spv");
+        RHIShader  fragment_shader = loadBenchShader(rhi, "cluster_draw.frag.spv");
+        bool created = vertex_shader != nullptr && fragment_shader != nullptr;
+        if (created) {
+            RHIPipelineShaderStageCreateInfo stages[2]{};
+            stages[0].sType = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stages[0].stage = RHI_SHADER_STAGE_VERTEX_BIT;
+            stages[0].module = vertex_shader;
+            stages[0].pName = "main";
+            stages[1].sType = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stages[1].stage = RHI_SHADER_STAGE_FRAGMENT_BIT;
+            stages[1].module = fragment_shader;
+            stages[1].pName = "main";
+
+            // the shaders only read the position, location 0
+            VertexInputDescription vertex_input = GpuMesh::getVertexInputDescription(cluster_mesh->getVertexLayout());
+            RHIPipelineVertexInputStateCreateInfo vertex_input_state{};
+            vertex_input_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            vertex_input_state.vertexBindingDescriptionCount = 1;
+            vertex_input_state.pVertexBindingDescriptions = &vertex_input.binding;
+            vertex_input_state.vertexAttributeDescriptionCount = 1;
+            vertex_input_state.pVertexAttributeDescriptions = &vertex_input.attributes[0];
+
+            RHIPipelineInputAssemblyStateCreateInfo input_assembly_state{};
+            input_assembly_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            input_assembly_state.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+            // set while recording, the swapchain size changes on resize
+            RHIPipelineViewportStateCreateInfo viewport_state{};
+            viewport_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            viewport_state.viewportCount = 1;
+            viewport_state.scissorCount = 1;
+            const RHIDynamicState dynamic_states[2] = {RHI_DYNAMIC_STATE_VIEWPORT, RHI_DYNAMIC_STATE_SCISSOR};
+            RHIPipelineDynamicStateCreateInfo dynamic_state{};
+            dynamic_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            dynamic_state.dynamicStateCount = 2;
+            dynamic_state.pDynamicStates = dynamic_states;
+
+            // imported meshes do not agree on a winding, both sides are drawn
+            RHIPipelineRasterizationStateCreateInfo rasterization_state{};
+            rasterization_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+            rasterization_state.polygonMode = RHI_POLYGON_MODE_FILL;
+            rasterization_state.cullMode = RHI_CULL_MODE_NONE;
+            rasterization_state.frontFace = RHI_FRONT_FACE_COUNTER_CLOCKWISE;
+            rasterization_state.lineWidth = 1.0f;
+
+            RHIPipelineMultisampleStateCreateInfo multisample_state{};
+            multisample_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+            multisample_state.rasterizationSamples = RHI_SAMPLE_COUNT_1_BIT;
+
+            RHIPipelineDepthStencilStateCreateInfo depth_stencil_state{};
+            depth_stencil_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+            depth_stencil_state.depthTestEnable = VK_TRUE;
+            depth_stencil_state.depthWriteEnable = VK_TRUE;
+            depth_stencil_state.depthCompareOp = RHI_COMPARE_OP_LESS_OR_EQUAL;
+
+            RHIPipelineColorBlendAttachmentState color_blend_attachment{};
+            color_blend_attachment.colorWriteMask =
+                RHI_COLOR_COMPONENT_R_BIT | RHI_COLOR_COMPONENT_G_BIT | RHI_COLOR_COMPONENT_B_BIT | RHI_COLOR_COMPONENT_A_BIT;
+            RHIPipelineColorBlendStateCreateInfo color_blend_state{};
+            color_blend_state.sType = RHI_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+            color_blend_state.attachmentCount = 1;
+            color_blend_state.pAttachments = &color_blend_attachment;
+
+            RHIGraphicsPipelineCreateInfo pipeline_info{};
+            pipeline_info.sType = RHI_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+            // with dynamic rendering the pass has no render pass object, the attachment formats stand in for it
+            pipeline_info.pNext = render_graph.getPipelineRenderingCreateInfo(main_pass);
+            pipeline_info.stageCount = 2;
+            pipeline_info.pStages = stages;
+            pipeline_info.pVertexInputState = &vertex_input_state;
+            pipeline_info.pInputAssemblyState = &input_assembly_state;
+            pipeline_info.pViewportState = &viewport_state;
+            pipeline_info.pRasterizationState = &rasterization_state;
+            pipeline_info.pMultisampleState = &multisample_state;
+            pipeline_info.pDepthStencilState = &depth_stencil_state;
+            pipeline_info.pColorBlendState = &color_blend_state;
+            pipeline_info.pDynamicState = &dynamic_state;
+            pipeline_info.layout = cluster_draw_layout;
+            pipeline_info.renderPass = render_graph.getRenderPass(main_pass);
+            pipeline_info.subpass = render_graph.getSubpass(main_pass);
+            pipeline_info.basePipelineIndex = -1;
+            created = rhi->createGraphicsPipeline(&pipeline_info, cluster_draw_pipeline);
+        }
+        if (vertex_shader != nullptr) {
+            rhi->destroyShaderModule(vertex_shader);
+        }
+        if (fragment_shader != nullptr) {
+            rhi->destroyShaderModule(fragment_shader);
+        }
+        if (!created) {
+            fprintf(stderr, "failed to create the cluster draw pipeline\n");
+            rhi->destroyPipelineLayout(cluster_draw_layout);
+            cluster_draw_layout = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    void BenchApp::shutdownClusterCull() {
+        if (cluster_culling) {
+            VulkanRHI* rhi = this->rhi;
+            RHIPipelineLayout layout = cluster_draw_layout;
+            RHIPipeline pipeline = cluster_draw_pipeline;
+            rhi->deferDestroy([rhi, layout, pipeline]() {
+                rhi->destroyPipeline(pipeline);
+                rhi->destroyPipelineLayout(layout);
+            });
+            cluster_draw_layout = nullptr;
+            cluster_draw_pipeline = nullptr;
+            cluster_culler.destroyTarget(cluster_target);
+            cluster_culler.shutdown();
+            cluster_mesh = nullptr;
+            cluster_culling = false;
+        }
+    }
+
+    void BenchApp::recordScene(RHICommandBuffer command_buffer) {
+        float t = (float)frame_counter++;
+        if (cluster_culling) {
+            cluster_culler.cull(cluster_target, cull_planes, cull_camera_position);
+        }
+        if (recordsSceneInParallel()) {
+            rhi->cmdRecordParallel(command_buffer, config.mesh_count, 64, [this, t](RHICommandBuffer secondary, uint32_t begin, uint32_t end) {
+                recordMeshes(secondary, begin, end, t);
+            });
+            if (cluster_culling) {
+                // the pass only takes secondaries, the draw gets one of its own
+                rhi->cmdRecordParallel(command_buffer, 1, 1, [this](RHICommandBuffer secondary, uint32_t, uint32_t) {
+                    recordClusterDraw(secondary);
+                });
+            }
+        }
+        else {
+            recordMeshes(command_buffer, 0, config.mesh_count, t);
+            if (cluster_culling) {
+                recordClusterDraw(command_buffer);
+            }
+        }
+    }
+
+    // the graphics submit waits on this frame's cull before the indirect arguments and indices are read
+    void BenchApp::recordClusterDraw(RHICommandBuffer command_buffer) {
+        RHIViewport viewport{};
+        viewport.width = (float)rhi->m_swapchain_extent.width;
+        viewport.height = (float)rhi->m_swapchain_extent.height;
+        viewport.maxDepth = 1.0f;
+        const RHIDeviceSize offset = 0;
+        RHIBuffer vertex_buffer = cluster_mesh->getVertexBuffer();
+        rhi->cmdBindPipeline(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, cluster_draw_pipeline);
+        rhi->cmdSetViewport(command_buffer, 0, 1, &viewport);
+        rhi->cmdSetScissor(command_buffer, 0, 1, &rhi->m_scissor);
+        rhi->cmdPushConstants(command_buffer, cluster_draw_layout, RHI_SHADER_STAGE_VERTEX_BIT, 0,
+                              sizeof(ClusterDrawConstants), &cluster_draw_constants);
+        rhi->cmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &offset);
+        cluster_culler.cmdDraw(command_buffer, cluster_target);
+    }
+
+    void BenchApp::recordMeshes(RHICommandBuffer command_buffer, uint32_t begin, uint32_t end, float t) {
+        const RHIDeviceSize offset = 0;
+        if (config.bindless) {
+            // one bind per command buffer for every material in the scene
+            RHIDescriptorSet bindless_set = rhi->getBindlessDescriptorSet();
+            rhi->cmdBindDescriptorSets(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, scene_layout, 0, 1, &bindless_set, 0, nullptr);
+        }
+        for (uint32_t i = begin; i < end; ++i) {
+            BenchObjectConstants* constants =
+                (BenchObjectConstants*)rhi->allocateFrameData(sizeof(BenchObjectConstants), object_dynamic_offsets[i]);
+            if (constants != nullptr) {
+                *constants = {{1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  (float)i, t, 0.0f, 1.0f}};
+            }
+            if (!config.bindless && config.material_count > 0) {
+                rhi->cmdBindDescriptorSets(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, scene_layout, 0, 1,
+                                           &material_sets[i % config.material_count], 0, nullptr);
+            }
+            rhi->cmdBindDescriptorSets(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, scene_layout, 1, 1,
+                                       &object_set, 1, &object_dynamic_offsets[i]);
+            rhi->cmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffers[i], &offset);
+            rhi->cmdBindIndexBuffer(command_buffer, index_buffers[i], 0, RHI_INDEX_TYPE_UINT16);
+        }
+    }
+
+    struct Percentiles {
+        double mean{0.0};
+        double p50{0.0};
+        double p95{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    // nearest-rank percentiles
+    static Percentiles computePercentiles(std::vector<double> samples) {
+        Percentiles result;
+        if (samples.empty()) {
+            return result;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto rank = [&](double p) {
+            size_t index = (size_t)(p * (double)samples.size() + 0.5);
+            index = index == 0 ? 0 : index - 1;
+            return samples[std::min(index, samples.size() - 1)];
+        };
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        result.mean = sum / (double)samples.size();
+        result.p50 = rank(0.50);
+        result.p95 = rank(0.95);
+        result.p99 = rank(0.99);
+        result.max = samples.back();
+        return result;
+    }
+
+    static void writePercentiles(std::ostringstream& out, const char* name, const std::vector<double>& samples, bool last = false) {
+        Percentiles p = computePercentiles(samples);
+        out << "    \"" << name << "\": {\"samples\": " << samples.size() << ", \"mean\": " << p.mean
+            << ", \"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99
+            << ", \"max\": " << p.max << "}" << (last ? "\n" : ",\n");
+    }
+
+    static const std::pair<const char*, RHIPresentMode> k_present_modes[] = {
+        {"fifo", RHI_PRESENT_MODE_FIFO_KHR},
+        {"fifo_relaxed", RHI_PRESENT_MODE_FIFO_RELAXED_KHR},
+        {"mailbox", RHI_PRESENT_MODE_MAILBOX_KHR},
+        {"immediate", RHI_PRESENT_MODE_IMMEDIATE_KHR},
+    };
+
+    static const char* presentModeName(RHIPresentMode present_mode) {
+        for (const auto& mode : k_present_modes) {
+            if (mode.second == present_mode) {
+                return mode.first;
+            }
+        }
+        return "unknown";
+    }
+
+    static BenchConfig parseArguments(int argc, char** argv) {
+        BenchConfig config;
+        for (int i = 1; i < argc; ++i) {
+            bool has_value = i + 1 < argc;
+            if (strcmp(argv[i], "--frames") == 0 && has_value) {
+                config.frames = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+                config.warmup_frames = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--meshes") == 0 && has_value) {
+                config.mesh_count = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--materials") == 0 && has_value) {
+                config.material_count = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--lights") == 0 && has_value) {
+                config.light_count = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--output") == 0 && has_value) {
+                config.output_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--windowed") == 0) {
+                config.headless = false;
+            }
+            else if (strcmp(argv[i], "--no-bindless") == 0) {
+                config.bindless = false;
+            }
+            else if (strcmp(argv[i], "--record-threads") == 0 && has_value) {
+                config.record_threads = std::max((uint32_t)atoi(argv[++i]), 1u);
+            }
+            else if (strcmp(argv[i], "--job-threads") == 0 && has_value) {
+                config.job_threads = std::max(atoi(argv[++i]), 0);
+            }
+            else if (strcmp(argv[i], "--frames-in-flight") == 0 && has_value) {
+                config.frames_in_flight = std::max((uint32_t)atoi(argv[++i]), 1u);
+            }
+            else if (strcmp(argv[i], "--present-mode") == 0 && has_value) {
+                const char* name = argv[++i];
+                bool known = false;
+                for (const auto& mode : k_present_modes) {
+                    if (strcmp(name, mode.first) == 0) {
+                        config.present_mode = mode.second;
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    fprintf(stderr, "unknown present mode: %s\n", name);
+                }
+            }
+            else if (strcmp(argv[i], "--no-dynamic-rendering") == 0) {
+                config.dynamic_rendering = false;
+            }
+            else if (strcmp(argv[i], "--resize-every") == 0 && has_value) {
+                config.resize_every = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--translation-calls") == 0 && has_value) {
+                config.translation_calls = (uint32_t)atoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--import-obj") == 0 && has_value) {
+                config.import_obj_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--load-mesh") == 0 && has_value) {
+                config.load_mesh_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--cluster-cull") == 0) {
+                config.cluster_cull = true;
+            }
+            else if (strcmp(argv[i], "--assert-allocation-free") == 0) {
+                config.assert_allocation_free = true;
+            }
+            else if (strcmp(argv[i], "--self-check") == 0) {
+                config.self_check = true;
+            }
+            else if (strcmp(argv[i], "--fps-limit") == 0 && has_value) {
+                config.fps_limit = std::max(atof(argv[++i]), 0.0);
+            }
+            else {
+                fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            }
+        }
+        return config;
+    }
+
+    static int runBenchmark(const BenchConfig& config) {
+        BenchApp app(config);
+        app.startup(config.headless);
+        app.setFrameRateLimit(config.fps_limit);
+        app.setupScene();
+
+        ObjImporter importer;
+        MeshData imported_mesh;
+        bool imported = false;
+        double import_ms = 0.0;
+        if (!config.import_obj_path.empty()) {
+            auto import_begin = std::chrono::steady_clock::now();
+            imported = importer.import(config.import_obj_path, imported_mesh, &app.getJobSystem());
+            import_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - import_begin).count();
+        }
+
+        AuraMeshFile mesh_file;
+        GpuMesh gpu_mesh;
+        bool mesh_loaded = false;
+        double mesh_load_ms = 0.0;
+        uint32_t mesh_vertices = 0, mesh_vertex_stride = 0, mesh_indices = 0, mesh_index_size = 0;
+        uint64_t mesh_bytes = 0;
+        uint32_t mesh_meshlets = 0;
+        bool cluster_cull = false;
+        if (!config.load_mesh_path.empty()) {
+            auto load_begin = std::chrono::steady_clock::now();
+            RHIUploadTicket ticket;
+            mesh_loaded = mesh_file.open(config.load_mesh_path) && gpu_mesh.upload(app.getRHI(), mesh_file, ticket);
+            if (mesh_loaded) {
+                mesh_vertices = mesh_file.getHeader().vertex_count;
+                mesh_vertex_stride = mesh_file.getHeader().vertex_stride;
+                mesh_indices = mesh_file.getHeader().index_count;
+                mesh_index_size = mesh_file.getHeader().index_size;
+                mesh_bytes = mesh_file.getHeader().file_size;
+                mesh_meshlets = mesh_file.getHeader().meshlet_count;
+                float bounds_min[3], bounds_max[3];
+                memcpy(bounds_min, mesh_file.getHeader().bounds_min, sizeof(bounds_min));
+                memcpy(bounds_max, mesh_file.getHeader().bounds_max, sizeof(bounds_max));
+                mesh_file.close();
+                app.getRHI()->flushUploads();
+                app.getRHI()->waitForUpload(ticket);
+                mesh_load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_begin).count();
+                if (config.cluster_cull) {
+                    cluster_cull = app.setupClusterCull(gpu_mesh, bounds_min, bounds_max);
+                }
+            }
+            else {
+                mesh_load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_begin).count();
+            }
+        }
+
+        for (uint32_t i = 0; i < config.warmup_frames; ++i) {
+            app.updateLights(i);
+            app.drawFrame();
+        }
+
+        app.getRHI()->m_assert_allocation_free_frames = config.assert_allocation_free;
+        uint64_t scratch_heap_allocations = 0;
+        uint64_t frame_heap_allocations = 0;
+        // per measured frame, from the cull that completed by its waitForFences
+        double visible_triangles = 0.0;
+        uint32_t visible_triangle_frames = 0;
+
+        std::vector<double> cpu_frame_ms, wait_for_fences_ms, limiter_ms, prepare_before_pass_ms, record_ms, submit_ms, gpu_frame_ms;
+        std::vector<double> latency_ms, input_to_present_ms;
+        // the frames right after a resize, a drain on recreation shows up here as a multi-frame spike
+        std::vector<double> after_resize_ms;
+        const uint32_t after_resize_window = 3;
+        uint32_t frames_since_resize = after_resize_window;
+        uint32_t resize_count = 0;
+        cpu_frame_ms.reserve(config.frames);
+        wait_for_fences_ms.reserve(config.frames);
+        prepare_before_pass_ms.reserve(config.frames);
+        record_ms.reserve(config.frames);
+        submit_ms.reserve(config.frames);
+        gpu_frame_ms.reserve(config.frames);
+        latency_ms.reserve(config.frames);
+        limiter_ms.reserve(config.frames);
+        input_to_present_ms.reserve(config.frames);
+        std::map<std::string, std::vector<double>> gpu_pass_ms;
+
+        auto bench_begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < config.frames; ++i) {
+            if (!config.headless && config.resize_every > 0 && i > 0 && i % config.resize_every == 0) {
+                bool grow = (resize_count++ % 2) == 0;
+                glfwSetWindowSize(app.getRHI()->m_window, grow ? WIDTH + WIDTH / 4 : WIDTH, grow ? HEIGHT + HEIGHT / 4 : HEIGHT);
+                frames_since_resize = 0;
+            }
+            app.updateLights(config.warmup_frames + i);
+            app.drawFrame();
+
+            const FrameTimings& timings = app.getLastFrameTimings();
+            cpu_frame_ms.push_back(timings.total_ms);
+            if (frames_since_resize < after_resize_window) {
+                after_resize_ms.push_back(timings.total_ms);
+                ++frames_since_resize;
+            }
+            wait_for_fences_ms.push_back(timings.wait_for_fences_ms);
+            scratch_heap_allocations += app.getRHI()->m_frame_scratch_heap_allocations;
+            frame_heap_allocations += app.getRHI()->m_frame_heap_allocations;
+            if (cluster_cull && app.getVisibleClusterTriangles() >= 0) {
+                visible_triangles += (double)app.getVisibleClusterTriangles();
+                ++visible_triangle_frames;
+            }
+            limiter_ms.push_back(timings.limiter_ms);
+            prepare_before_pass_ms.push_back(timings.prepare_before_pass_ms);
+            record_ms.push_back(timings.record_ms);
+            submit_ms.push_back(timings.submit_ms);
+            // reported after waitForFences, so it lags the cpu frame by the frames in flight
+            if (app.getRHI()->m_gpu_frame_time_ms >= 0.0f) {
+                gpu_frame_ms.push_back(app.getRHI()->m_gpu_frame_time_ms);
+            }
+            if (app.getRHI()->m_cpu_to_gpu_latency_ms >= 0.0f) {
+                latency_ms.push_back(app.getRHI()->m_cpu_to_gpu_latency_ms);
+            }
+            if (app.getRHI()->m_input_to_present_ms >= 0.0f) {
+                input_to_present_ms.push_back(app.getRHI()->m_input_to_present_ms);
+            }
+            for (const GpuPassTiming& pass : app.getRHI()->m_gpu_pass_timings) {
+                if (pass.depth > 0) {
+                    gpu_pass_ms[pass.name].push_back(pass.ms);
+                }
+            }
+        }
+        double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - bench_begin).count();
+        app.getRHI()->m_assert_allocation_free_frames = false;
+
+        TranslationCallRates arena_rates, heap_rates;
+        if (config.translation_calls > 0) {
+            arena_rates = app.measureTranslationCalls(config.translation_calls, false);
+            heap_rates = app.measureTranslationCalls(config.translation_calls, true);
+        }
+        app.shutdownClusterCull();
+        gpu_mesh.destroy();
+        app.shutdown();
+
+        std::ostringstream out;
+        out << "{\n";
+        out << "  \"scene\": {\"meshes\": " << config.mesh_count << ", \"materials\": " << config.material_count
+            << ", \"lights\": " << config.light_count << "},\n";
+        out << "  \"frames\": " << config.frames << ",\n";
+        out << "  \"warmup_frames\": " << config.warmup_frames << ",\n";
+        out << "  \"headless\": " << (config.headless ? "true" : "false") << ",\n";
+        out << "  \"record_threads\": " << config.record_threads << ",\n";
+        out << "  \"frames_in_flight\": " << app.getRHI()->m_frames_in_flight << ",\n";
+        out << "  \"present_mode\": \"" << (config.headless ? "none" : presentModeName(app.getRHI()->m_active_present_mode)) << "\",\n";
+        out << "  \"fps_limit\": " << config.fps_limit << ",\n";
+        out << "  \"resizes\": " << resize_count << ",\n";
+        out << "  \"swapchain_recreations\": " << app.getRHI()->m_swapchain_recreate_count << ",\n";
+        out << "  \"present_wait\": " << (app.getRHI()->m_present_wait_supported ? "true" : "false") << ",\n";
+        out << "  \"timeline_semaphore\": " << (app.getRHI()->m_timeline_semaphore_supported ? "true" : "false") << ",\n";
+        out << "  \"jobs\": {\"threads\": " << app.getJobSystem().getThreadCount()
+            << ", \"executed\": " << app.getJobSystem().m_executed_count.load()
+            << ", \"stolen\": " << app.getJobSystem().m_stolen_count.load() << "},\n";
+        const RenderGraphStats& graph_stats = app.getRenderGraph().getStats();
+        out << "  \"render_graph\": {\"passes\": " << graph_stats.pass_count << ", \"culled\": " << graph_stats.culled_pass_count
+            << ", \"render_passes\": " << graph_stats.render_pass_count << ", \"dynamic_rendering\": " << graph_stats.dynamic_rendering_count
+            << ", \"dependencies\": " << graph_stats.dependency_count
+            << ", \"transient_images\": " << graph_stats.transient_image_count
+            << ", \"transient_bytes\": " << graph_stats.transient_memory_bytes
+            << ", \"transient_unaliased_bytes\": " << graph_stats.transient_unaliased_bytes
+            << ", \"lazy_images\": " << graph_stats.lazy_image_count
+            << ", \"lazily_allocated_bytes\": " << graph_stats.lazily_allocated_bytes << "},\n";
+        out << "  \"lazily_allocated_memory\": " << (app.getRHI()->m_lazily_allocated_memory_supported ? "true" : "false") << ",\n";
+        out << "  \"bindless\": " << (app.isBindless() ? "true" : "false") << ",\n";
+        out << "  \"scratch_heap_allocations\": " << scratch_heap_allocations << ",\n";
+        out << "  \"frame_heap_allocations\": " << frame_heap_allocations << ",\n";
+        if (!config.import_obj_path.empty()) {
+            const ObjImportStats& import_stats = importer.getStats();
+            out << "  \"obj_import\": {\"ok\": " << (imported ? "true" : "false") << ", \"bytes\": " << import_stats.file_bytes
+                << ", \"ms\": " << import_ms << ", \"map_ms\": " << import_stats.map_ms << ", \"parse_ms\": " << import_stats.parse_ms
+                << ", \"emit_ms\": " << import_stats.emit_ms << ", \"vertices\": " << imported_mesh.vertices.size()
+                << ", \"indices\": " << imported_mesh.indices.size() << ", \"submeshes\": " << imported_mesh.submeshes.size() << "},\n";
+        }
+        if (!config.load_mesh_path.empty()) {
+            out << "  \"auramesh_load\": {\"ok\": " << (mesh_loaded ? "true" : "false") << ", \"bytes\": " << mesh_bytes
+                << ", \"ms\": " << mesh_load_ms << ", \"vertices\": " << mesh_vertices
+                << ", \"vertex_layout\": \"" << VertexEncoder::getLayoutInfo(gpu_mesh.getVertexLayout()).name
+                << "\", \"vertex_stride\": " << mesh_vertex_stride
+                << ", \"indices\": " << mesh_indices << ", \"index_size\": " << mesh_index_size
+                << ", \"meshlets\": " << mesh_meshlets << ", \"cluster_cull\": " << (cluster_cull ? "true" : "false");
+            if (cluster_cull) {
+                out << ", \"submitted_triangles\": " << mesh_indices / 3 << ", \"visible_triangles\": "
+                    << (visible_triangle_frames > 0 ? visible_triangles / visible_triangle_frames : 0.0);
+            }
+            out << "},\n";
+        }
+        if (config.translation_calls > 0) {
+            auto writeTranslationRates = [&](const char* name, const TranslationCallRates& rates, bool last) {
+                out << "    \"" << name << "\": {\"update_descriptor_sets\": " << rates.update_descriptor_sets
+                    << ", \"create_render_pass\": " << rates.create_render_pass
+                    << ", \"scratch_heap_allocations\": " << rates.scratch_heap_allocations << "}" << (last ? "\n" : ",\n");
+            };
+            out << "  \"translation_calls_per_s\": {\n";
+            out << "    \"calls\": " << config.translation_calls << ",\n";
+            writeTranslationRates("scratch_arena", arena_rates, false);
+            writeTranslationRates("heap", heap_rates, true);
+            out << "  },\n";
+        }
+        out << "  \"wall_ms\": " << wall_ms << ",\n";
+        out << "  \"fps\": " << (wall_ms > 0.0 ? 1000.0 * config.frames / wall_ms : 0.0) << ",\n";
+        out << "  \"ms\": {\n";
+        writePercentiles(out, "cpu_frame", cpu_frame_ms);
+        writePercentiles(out, "cpu_frame_after_resize", after_resize_ms);
+        writePercentiles(out, "gpu_frame", gpu_frame_ms);
+        writePercentiles(out, "cpu_to_gpu_latency", latency_ms);
+        writePercentiles(out, "input_to_present", input_to_present_ms);
+        writePercentiles(out, "wait_for_fences", wait_for_fences_ms);
+        writePercentiles(out, "limiter", limiter_ms);
+        writePercentiles(out, "prepare_before_pass", prepare_before_pass_ms);
+        writePercentiles(out, "record", record_ms);
+        writePercentiles(out, "submit", submit_ms, true);
+        out << "  },\n";
+        out << "  \"gpu_passes_ms\": {\n";
+        size_t pass_index = 0;
+        for (const auto& pass : gpu_pass_ms) {
+            writePercentiles(out, pass.first.c_str(), pass.second, ++pass_index == gpu_pass_ms.size());
+        }
+        out << "  },\n";
+
+        RHIDescriptorAllocatorStats persistent_descriptors, transient_descriptors;
+        app.getRHI()->getDescriptorAllocatorStats(persistent_descriptors, transient_descriptors);
+        auto writeDescriptorStats = [&](const char* name, const RHIDescriptorAllocatorStats& stats, bool last) {
+            out << "    \"" << name << "\": {\"pools\": " << stats.poolCount << ", \"free_pools\": " << stats.freePoolCount
+                << ", \"live_sets\": " << stats.liveSetCount << ", \"allocations\": " << stats.allocationCount
+                << ", \"pool_exhausted\": " << stats.poolExhaustedCount << ", \"failed\": " << stats.failedAllocationCount
+                << ", \"resets\": " << stats.resetCount << "}" << (last ? "\n" : ",\n");
+        };
+        out << "  \"descriptor_pools\": {\n";
+        writeDescriptorStats("persistent", persistent_descriptors, false);
+        writeDescriptorStats("transient", transient_descriptors, true);
+        out << "  },\n";
+
+        RHIObjectCacheStats render_pass_cache, framebuffer_cache, set_layout_cache, sampler_cache;
+        app.getRHI()->getObjectCacheStats(render_pass_cache, framebuffer_cache, set_layout_cache, sampler_cache);
+        auto writeObjectCacheStats = [&](const char* name, const RHIObjectCacheStats& stats, bool last) {
+            out << "    \"" << name << "\": {\"hits\": " << stats.hitCount << ", \"misses\": " << stats.missCount
+                << ", \"objects\": " << stats.objectCount << "}" << (last ? "\n" : ",\n");
+        };
+        out << "  \"object_caches\": {\n";
+        writeObjectCacheStats("render_passes", render_pass_cache, false);
+        writeObjectCacheStats("framebuffers", framebuffer_cache, false);
+        writeObjectCacheStats("descriptor_set_layouts", set_layout_cache, false);
+        writeObjectCacheStats("samplers", sampler_cache, true);
+        out << "  },\n";
+
+        std::vector<RHIMemoryHeapStats> heap_stats;
+        app.getRHI()->getMemoryHeapStats(heap_stats);
+        out << "  \"memory_heaps\": [\n";
+        for (size_t i = 0; i < heap_stats.size(); ++i) {
+            const RHIMemoryHeapStats& heap = heap_stats[i];
+            out << "    {\"device_local\": " << ((heap.flags & RHI_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false")
+                << ", \"size\": " << heap.size << ", \"budget\": " << heap.budget << ", \"usage\": " << heap.usage
+                << ", \"blocks\": " << heap.blockCount << ", \"block_bytes\": " << heap.blockBytes
+                << ", \"allocations\": " << heap.allocationCount << ", \"allocation_bytes\": " << heap.allocationBytes << "}"
+                << (i + 1 == heap_stats.size() ? "\n" : ",\n");
+        }
+        out << "  ]\n";
+        out << "}\n";
+
+        if (config.output_path.empty()) {
+            fputs(out.str().c_str(), stdout);
+        }
+        else {
+            std::ofstream file(config.output_path);
+            if (!file) {
+                fprintf(stderr, "failed to open %s\n", config.output_path.c_str());
+                return 1;
+            }
+            file << out.str();
+        }
+        // release builds compile the per-frame assert out, fail the run instead
+        if (config.assert_allocation_free && (scratch_heap_allocations > 0 || frame_heap_allocations > 0)) {
+            fprintf(stderr, "--assert-allocation-free: %llu scratch blocks and %llu operator new calls in measured frames\n",
+                    (unsigned long long)scratch_heap_allocations, (unsigned long long)frame_heap_allocations);
+            return 1;
+        }
+        return 0;
+    }
+#define SELF_CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "self-check failed (%s:%d): ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            return false; \
+        } \
+    } while (0)
+
+    // a dead chain that only feeds itself, then a chain of three sampled transients where the first and the
+    // last are never alive together and can share one block
+    static bool checkRenderGraph(VulkanRHI* rhi) {
+        RenderGraph graph;
+        graph.initialize(rhi);
+        RenderGraphImageDesc desc;
+        desc.format = RHI_FORMAT_R8G8B8A8_UNORM;
+        desc.extent = {256, 256};
+        auto record = [](RHICommandBuffer) {};
+
+        RenderGraphResource dead_a = graph.createImage("dead_a", desc);
+        RenderGraphResource dead_b = graph.createImage("dead_b", desc);
+        RenderGraphResource first = graph.createImage("first", desc);
+        RenderGraphResource second = graph.createImage("second", desc);
+        RenderGraphResource third = graph.createImage("third", desc);
+        RenderGraphResource output = graph.createImage("output", desc);
+        uint32_t dead_producer = graph.addPass("dead_producer", record).writeColor(dead_a).getPass();
+        uint32_t dead_consumer = graph.addPass("dead_consumer", record).readTexture(dead_a).writeColor(dead_b).getPass();
+        uint32_t write_first = graph.addPass("write_first", record).writeColor(first).getPass();
+        uint32_t write_second = graph.addPass("write_second", record).readTexture(first).writeColor(second).getPass();
+        uint32_t write_third = graph.addPass("write_third", record).readTexture(second).writeColor(third).getPass();
+        uint32_t write_output = graph.addPass("write_output", record).readTexture(third).writeColor(output).setSideEffect().getPass();
+
+        SELF_CHECK(graph.compile(), "compile failed");
+        const RenderGraphStats& stats = graph.getStats();
+        SELF_CHECK(graph.isPassCulled(dead_producer) && graph.isPassCulled(dead_consumer), "the dead chain was kept");
+        SELF_CHECK(!graph.isPassCulled(write_first) && !graph.isPassCulled(write_second) && !graph.isPassCulled(write_third) &&
+                   !graph.isPassCulled(write_output), "a pass feeding the side effect was culled");
+        SELF_CHECK(stats.pass_count == 6 && stats.culled_pass_count == 2, "%u of %u passes culled, expected 2 of 6",
+                   stats.culled_pass_count, stats.pass_count);
+        SELF_CHECK(graph.getImageView(dead_a) == nullptr && graph.getImageView(dead_b) == nullptr, "the dead chain's images were created");
+        SELF_CHECK(graph.getImageView(first) != nullptr && graph.getImageView(second) != nullptr && graph.getImageView(third) != nullptr,
+                   "a sampled transient has no image");
+        // output never leaves its render pass, so it is the only tile-memory image
+        SELF_CHECK(stats.transient_image_count == 4 && stats.lazy_image_count == 1, "%u transients with %u lazy images, expected 4 with 1",
+                   stats.transient_image_count, stats.lazy_image_count);
+        SELF_CHECK(stats.render_pass_count == 4, "%u render passes, sampling must end each pass's render pass", stats.render_pass_count);
+        SELF_CHECK(stats.transient_memory_block_count == 2, "%u memory blocks for three transients, first and third must alias",
+                   stats.transient_memory_block_count);
+        // the lazy image is counted in lazily_allocated_bytes instead where the device has lazily allocated memory
+        SELF_CHECK(stats.transient_memory_bytes + stats.lazily_allocated_bytes < stats.transient_unaliased_bytes,
+                   "aliasing saved nothing: %llu of %llu bytes",
+                   (unsigned long long)(stats.transient_memory_bytes + stats.lazily_allocated_bytes),
+                   (unsigned long long)stats.transient_unaliased_bytes);
+
+        graph.m_alias_transients = false;
+        SELF_CHECK(graph.compile(), "compile without aliasing failed");
+        SELF_CHECK(stats.transient_memory_block_count == 3 &&
+                   stats.transient_memory_bytes + stats.lazily_allocated_bytes == stats.transient_unaliased_bytes,
+                   "without aliasing %u blocks take %llu of %llu bytes", stats.transient_memory_block_count,
+                   (unsigned long long)(stats.transient_memory_bytes + stats.lazily_allocated_bytes),
+                   (unsigned long long)stats.transient_unaliased_bytes);
+        graph.shutdown();
+        return true;
+    }
+
+    static int runSelfCheck(const BenchConfig& config) {
+        BenchApp app(config);
+        app.startup(true);
+        bool render_graph_ok = checkRenderGraph(app.getRHI());
+        app.shutdown();
+        if (!render_graph_ok) {
+            fprintf(stderr, "self-check render graph: FAILED\n");
+            return 1;
+        }
+        printf("self-check render graph: ok\n");
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Aura::BenchConfig config = Aura::parseArguments(argc, argv);
+    return config.self_check ? Aura::runSelfCheck(config) : Aura::runBenchmark(config);
+}
@@ -7,11 +7,22 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 #include <unordered_map>
-int main() {
-
+#include <cstring>
+#include <cstdlib>
+int main(int argc, char** argv) {
+    bool headless = false;
+    uint32_t frame_count = 1000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_count = (uint32_t)atoi(argv[++i]);
+        }
+    }
 
     Aura::Aura aura;
-    aura.run();
+    aura.run(headless, frame_count);
     printf("hello world \n");
     return 0;
 }
\ No newline at end of file
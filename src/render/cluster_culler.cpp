@@ -0,0 +1,313 @@
+#include "cluster_culler.h"
+#include "../util/mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+
+// set by the build next to the compiled spir-v
+#ifndef AURA_SHADER_DIR
+#define AURA_SHADER_DIR "shaders"
+#endif
+
+namespace Aura
+{
+    static_assert(sizeof(ClusterCuller::CullConstants) == 112, "must match the push constants of cluster_cull.comp");
+
+    // the smallest maxComputeWorkGroupCount vulkan allows, larger dispatches spill into y
+    static uint32_t const k_max_group_count_x {65535};
+
+    bool ClusterCuller::initialize(VulkanRHI* rhi)
+    {
+        m_rhi = rhi;
+
+        std::string path = std::string(AURA_SHADER_DIR) + "/cluster_cull.comp.spv";
+        MappedFile  file;
+        if (!file.open(path) || file.getSize() == 0)
+        {
+            LOG_ERROR("failed to open " << path);
+            return false;
+        }
+        std::vector<unsigned char> code(file.getData(), file.getData() + file.getSize());
+        RHIShader                  shader = rhi->createShaderModule(code);
+        if (shader == nullptr)
+        {
+            return false;
+        }
+
+        RHIDescriptorSetLayoutBinding bindings[k_binding_count] {};
+        for (uint32_t i = 0; i < k_binding_count; ++i)
+        {
+            bindings[i].binding         = i;
+            bindings[i].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags      = RHI_SHADER_STAGE_COMPUTE_BIT;
+        }
+        RHIDescriptorSetLayoutCreateInfo set_layout_info {};
+        set_layout_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        set_layout_info.bindingCount = k_binding_count;
+        set_layout_info.pBindings    = bindings;
+
+        RHIPushConstantRange push_constant_range {};
+        push_constant_range.stageFlags = RHI_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.size       = sizeof(CullConstants);
+
+        bool created = rhi->createDescriptorSetLayout(&set_layout_info, m_descriptor_set_layout);
+        if (created)
+        {
+            RHIPipelineLayoutCreateInfo layout_info {};
+            layout_info.sType                  = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            layout_info.setLayoutCount         = 1;
+            layout_info.pSetLayouts            = &m_descriptor_set_layout;
+            layout_info.pushConstantRangeCount = 1;
+            layout_info.pPushConstantRanges    = &push_constant_range;
+            created                            = rhi->createPipelineLayout(&layout_info, m_pipeline_layout);
+        }
+        if (created)
+        {
+            RHIComputePipelineCreateInfo pipeline_info {};
+            pipeline_info.sType        = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipeline_info.stage.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            pipeline_info.stage.stage  = RHI_SHADER_STAGE_COMPUTE_BIT;
+            pipeline_info.stage.module = shader;
+            pipeline_info.stage.pName  = "main";
+            pipeline_info.layout       = m_pipeline_layout;
+            created                    = rhi->createComputePipeline(&pipeline_info, m_pipeline);
+        }
+        rhi->destroyShaderModule(shader);
+        if (!created)
+        {
+            LOG_ERROR("failed to create the cluster cull pipeline");
+            shutdown();
+            return false;
+        }
+        return true;
+    }
+
+    void ClusterCuller::shutdown()
+    {
+        if (m_rhi == nullptr)
+        {
+            return;
+        }
+        VulkanRHI*              rhi             = m_rhi;
+        RHIDescriptorSetLayout  set_layout      = m_descriptor_set_layout;
+        RHIPipelineLayout       pipeline_layout = m_pipeline_layout;
+        RHIPipeline             pipeline        = m_pipeline;
+        rhi->deferDestroy([rhi, set_layout, pipeline_layout, pipeline]() {
+            if (pipeline != nullptr)
+            {
+                rhi->destroyPipeline(pipeline);
+            }
+            if (pipeline_layout != nullptr)
+            {
+                rhi->destroyPipelineLayout(pipeline_layout);
+            }
+            if (set_layout != nullptr)
+            {
+                rhi->destroyDescriptorSetLayout(set_layout);
+            }
+        });
+        m_rhi                   = nullptr;
+        m_descriptor_set_layout = nullptr;
+        m_pipeline_layout       = nullptr;
+        m_pipeline              = nullptr;
+    }
+
+    bool ClusterCuller::createTarget(const GpuMesh& mesh, ClusterCullTarget& target, RHIUploadTicket& ticket)
+    {
+        if (mesh.getMeshletCount() == 0)
+        {
+            LOG_ERROR("cluster culling a mesh cooked without meshlets");
+            return false;
+        }
+
+        const std::vector<AuraMeshSubmesh>&      submeshes = mesh.getSubmeshes();
+        std::vector<VkDrawIndexedIndirectCommand> draws(submeshes.size());
+        for (size_t i = 0; i < submeshes.size(); ++i)
+        {
+            draws[i].indexCount    = 0;
+            draws[i].instanceCount = 1;
+            draws[i].firstIndex    = submeshes[i].first_index;
+            draws[i].vertexOffset  = 0;
+            draws[i].firstInstance = 0;
+        }
+        RHIDeviceSize draws_size   = draws.size() * sizeof(VkDrawIndexedIndirectCommand);
+        RHIDeviceSize indices_size = (RHIDeviceSize)mesh.getIndexCount() * sizeof(uint32_t);
+
+        target.mesh = &mesh;
+        if (!m_rhi->createBuffer(draws_size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 target.draw_template_buffer,
+                                 target.draw_template_buffer_memory,
+                                 true))
+        {
+            LOG_ERROR("failed to create the cluster cull draw template");
+            destroyTarget(target);
+            return false;
+        }
+
+        target.frames.resize(VulkanRHI::getMaxFramesInFlight());
+        for (ClusterCullTarget::Frame& frame : target.frames)
+        {
+            if (!m_rhi->createBuffer(draws_size,
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                     frame.draw_buffer,
+                                     frame.draw_buffer_memory,
+                                     true) ||
+                !m_rhi->createBuffer(indices_size,
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                     frame.index_buffer,
+                                     frame.index_buffer_memory,
+                                     true) ||
+                !m_rhi->createBuffer(draws_size,
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                     frame.readback_buffer,
+                                     frame.readback_buffer_memory) ||
+                !m_rhi->mapMemory(frame.readback_buffer_memory, 0, draws_size, &frame.readback_data))
+            {
+                LOG_ERROR("failed to create the cluster cull output buffers");
+                destroyTarget(target);
+                return false;
+            }
+
+            RHIDescriptorSetAllocateInfo allocate_info {};
+            allocate_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocate_info.descriptorPool     = m_rhi->m_descriptor_pool;
+            allocate_info.descriptorSetCount = 1;
+            allocate_info.pSetLayouts        = &m_descriptor_set_layout;
+            if (!m_rhi->allocateDescriptorSets(&allocate_info, frame.descriptor_set))
+            {
+                LOG_ERROR("failed to allocate a cluster cull descriptor set");
+                destroyTarget(target);
+                return false;
+            }
+
+            const RHIBuffer buffers[k_binding_count] = {
+                mesh.getMeshletBuffer(), mesh.getMeshletVertexBuffer(), mesh.getMeshletTriangleBuffer(), frame.draw_buffer, frame.index_buffer};
+            RHIDescriptorBufferInfo buffer_infos[k_binding_count] {};
+            RHIWriteDescriptorSet   writes[k_binding_count] {};
+            for (uint32_t i = 0; i < k_binding_count; ++i)
+            {
+                buffer_infos[i].buffer    = buffers[i];
+                buffer_infos[i].offset    = 0;
+                buffer_infos[i].range     = VK_WHOLE_SIZE;
+                writes[i].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet          = frame.descriptor_set;
+                writes[i].dstBinding      = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo     = &buffer_infos[i];
+            }
+            m_rhi->updateDescriptorSets(k_binding_count, writes, 0, nullptr);
+        }
+        // queued last so no failure above can leave a copy into a released buffer
+        ticket = m_rhi->uploadBuffer(target.draw_template_buffer, 0, draws.data(), draws_size);
+        return true;
+    }
+
+    void ClusterCuller::destroyTarget(ClusterCullTarget& target)
+    {
+        VulkanRHI*        rhi    = m_rhi;
+        ClusterCullTarget doomed = target;
+        rhi->deferDestroy([rhi, doomed]() mutable {
+            // a target whose creation failed part of the way has null entries
+            for (ClusterCullTarget::Frame& frame : doomed.frames)
+            {
+                if (frame.descriptor_set != nullptr)
+                {
+                    rhi->freeDescriptorSet(frame.descriptor_set);
+                }
+                if (frame.draw_buffer != nullptr)
+                {
+                    rhi->destroyBuffer(frame.draw_buffer, frame.draw_buffer_memory);
+                }
+                if (frame.index_buffer != nullptr)
+                {
+                    rhi->destroyBuffer(frame.index_buffer, frame.index_buffer_memory);
+                }
+                if (frame.readback_buffer != nullptr)
+                {
+                    rhi->destroyBuffer(frame.readback_buffer, frame.readback_buffer_memory);
+                }
+            }
+            if (doomed.draw_template_buffer != nullptr)
+            {
+                rhi->destroyBuffer(doomed.draw_template_buffer, doomed.draw_template_buffer_memory);
+            }
+        });
+        target = ClusterCullTarget();
+    }
+
+    void ClusterCuller::cull(ClusterCullTarget& target, const float planes[6][4], const float camera_position[3])
+    {
+        RHICommandBuffer          command_buffer = m_rhi->getCurrentComputeCommandBuffer();
+        ClusterCullTarget::Frame& frame          = target.frames[m_rhi->getCurrentFrameIndex()];
+        uint32_t                  meshlet_count  = target.mesh->getMeshletCount();
+        uint32_t                  draw_count     = (uint32_t)target.mesh->getSubmeshes().size();
+        RHIDeviceSize             draws_size     = draw_count * sizeof(VkDrawIndexedIndirectCommand);
+
+        // the frame that last used this slot has completed
+        if (frame.readback_pending)
+        {
+            const VkDrawIndexedIndirectCommand* draws         = (const VkDrawIndexedIndirectCommand*)frame.readback_data;
+            int64_t                             visible_count = 0;
+            for (uint32_t i = 0; i < draw_count; ++i)
+            {
+                visible_count += draws[i].indexCount;
+            }
+            target.visible_triangles = visible_count / 3;
+        }
+
+        // the shader appends to the draws' index counts, start them from the template again
+        m_rhi->cmdCopyBuffer(command_buffer, target.draw_template_buffer, frame.draw_buffer, 0, 0, draws_size);
+        m_rhi->cmdMemoryBarrier(command_buffer,
+                                RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                RHI_ACCESS_TRANSFER_WRITE_BIT,
+                                RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT);
+
+        CullConstants constants {};
+        memcpy(constants.planes, planes, sizeof(constants.planes));
+        memcpy(constants.camera_position, camera_position, sizeof(constants.camera_position));
+        constants.meshlet_count = meshlet_count;
+
+        m_rhi->cmdBindPipeline(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        m_rhi->cmdBindDescriptorSets(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_pipeline_layout, 0, 1, &frame.descriptor_set, 0, nullptr);
+        m_rhi->cmdPushConstants(command_buffer, m_pipeline_layout, RHI_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        uint32_t group_count_x = std::min(meshlet_count, k_max_group_count_x);
+        m_rhi->cmdDispatch(command_buffer, group_count_x, (meshlet_count + group_count_x - 1) / group_count_x, 1);
+
+        // only reads the draws, so it runs next to the graphics queue consuming them as indirect arguments
+        m_rhi->cmdMemoryBarrier(command_buffer,
+                                RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                RHI_ACCESS_SHADER_WRITE_BIT,
+                                RHI_ACCESS_TRANSFER_READ_BIT);
+        m_rhi->cmdCopyBuffer(command_buffer, frame.draw_buffer, frame.readback_buffer, 0, 0, draws_size);
+        m_rhi->cmdMemoryBarrier(command_buffer,
+                                RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                RHI_PIPELINE_STAGE_HOST_BIT,
+                                RHI_ACCESS_TRANSFER_WRITE_BIT,
+                                RHI_ACCESS_HOST_READ_BIT);
+        frame.readback_pending = true;
+    }
+
+    void ClusterCuller::cmdDraw(RHICommandBuffer command_buffer, const ClusterCullTarget& target)
+    {
+        const ClusterCullTarget::Frame& frame = target.frames[m_rhi->getCurrentFrameIndex()];
+        m_rhi->cmdBindIndexBuffer(command_buffer, frame.index_buffer, 0, RHI_INDEX_TYPE_UINT32);
+        // one draw per call, several need the multiDrawIndirect feature
+        for (uint32_t i = 0; i < (uint32_t)target.mesh->getSubmeshes().size(); ++i)
+        {
+            m_rhi->cmdDrawIndexedIndirect(command_buffer, frame.draw_buffer, i * sizeof(VkDrawIndexedIndirectCommand), 1, sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+} // namespace Aura
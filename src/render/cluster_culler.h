@@ -0,0 +1,73 @@
+#pragma once
+#include "gpu_mesh.h"
+
+#include <vector>
+namespace Aura
+{
+    // the culled form of one GpuMesh. every frame in flight has its own draws and compacted indices, so a frame's
+    // cull never writes what an earlier frame may still be drawing from
+    struct ClusterCullTarget
+    {
+        struct Frame
+        {
+            RHIBuffer         draw_buffer {nullptr};
+            RHIDeviceMemory   draw_buffer_memory {nullptr};
+            RHIBuffer         index_buffer {nullptr};
+            RHIDeviceMemory   index_buffer_memory {nullptr};
+            RHIDescriptorSet  descriptor_set {nullptr};
+            // host-visible copy of draw_buffer taken after the cull, read once the frame slot comes around again
+            RHIBuffer         readback_buffer {nullptr};
+            RHIDeviceMemory   readback_buffer_memory {nullptr};
+            void*             readback_data {nullptr};
+            bool              readback_pending {false};
+        };
+
+        const GpuMesh*     mesh {nullptr};
+        // copied over the frame's draws before every cull, each submesh's draw with no indices yet
+        RHIBuffer          draw_template_buffer {nullptr};
+        RHIDeviceMemory    draw_template_buffer_memory {nullptr};
+        std::vector<Frame> frames;
+        // triangles kept by the latest cull whose frame has completed, -1 until one has
+        int64_t            visible_triangles {-1};
+    };
+
+    // culls the meshlets of cooked meshes on m_compute_queue by frustum and normal cone, see cluster_cull.comp,
+    // and draws what survives with one indexed indirect draw per submesh. the survivors' triangles are written
+    // into a 32-bit index buffer that replaces the mesh's own, the vertex buffer is drawn as it is
+    class ClusterCuller
+    {
+    public:
+        bool initialize(VulkanRHI* rhi);
+        // the pipeline and layouts go once the frames that may still use them have completed
+        void shutdown();
+
+        // the mesh must have been cooked with meshlets, flush and wait on ticket before the first cull
+        bool createTarget(const GpuMesh& mesh, ClusterCullTarget& target, RHIUploadTicket& ticket);
+        // deferred like shutdown()
+        void destroyTarget(ClusterCullTarget& target);
+
+        // records the current frame's cull into the compute command buffer. planes face inwards, xyz normalized
+        // and w the distance, and like the camera position are in the mesh's own space. the slot's previous cull
+        // has completed by then, its draws are read back into target.visible_triangles first
+        void cull(ClusterCullTarget& target, const float planes[6][4], const float camera_position[3]);
+        // binds the frame's compacted indices and draws every submesh. the pipeline, vertex buffer and descriptor
+        // sets are the caller's. the frame's graphics submit waits on the cull, see VulkanAsyncCompute
+        void cmdDraw(RHICommandBuffer command_buffer, const ClusterCullTarget& target);
+
+        // the shader's push constants
+        struct CullConstants
+        {
+            float    planes[6][4];
+            float    camera_position[3];
+            uint32_t meshlet_count;
+        };
+
+    private:
+        static uint32_t const k_binding_count {5};
+
+        VulkanRHI*              m_rhi {nullptr};
+        RHIDescriptorSetLayout  m_descriptor_set_layout {nullptr};
+        RHIPipelineLayout       m_pipeline_layout {nullptr};
+        RHIPipeline             m_pipeline {nullptr};
+    };
+} // namespace Aura
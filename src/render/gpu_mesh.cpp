@@ -0,0 +1,159 @@
+#include "gpu_mesh.h"
+
+#include <cstring>
+#include <iostream>
+
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+
+namespace Aura
+{
+    static RHIFormat getAttributeFormat(VertexAttributeEncoding encoding)
+    {
+        switch (encoding)
+        {
+            case VERTEX_ATTRIBUTE_FLOAT32X2:
+                return RHI_FORMAT_R32G32_SFLOAT;
+            case VERTEX_ATTRIBUTE_FLOAT32X3:
+                return RHI_FORMAT_R32G32B32_SFLOAT;
+            case VERTEX_ATTRIBUTE_FLOAT16X2:
+                return RHI_FORMAT_R16G16_SFLOAT;
+            case VERTEX_ATTRIBUTE_FLOAT16X4:
+                return RHI_FORMAT_R16G16B16A16_SFLOAT;
+            case VERTEX_ATTRIBUTE_SNORM16X4:
+                return RHI_FORMAT_R16G16B16A16_SNORM;
+            case VERTEX_ATTRIBUTE_SNORM8X4:
+                return RHI_FORMAT_R8G8B8A8_SNORM;
+        }
+        return RHI_FORMAT_UNDEFINED;
+    }
+
+    VertexInputDescription GpuMesh::getVertexInputDescription(VertexLayout layout, uint32_t binding)
+    {
+        const VertexLayoutInfo&   info          = VertexEncoder::getLayoutInfo(layout);
+        const VertexAttributeInfo attributes[3] = {info.position, info.normal, info.texcoord};
+
+        VertexInputDescription description {};
+        description.binding.binding   = binding;
+        description.binding.stride    = info.stride;
+        description.binding.inputRate = RHI_VERTEX_INPUT_RATE_VERTEX;
+        for (uint32_t location = 0; location < 3; ++location)
+        {
+            description.attributes[location].location = location;
+            description.attributes[location].binding  = binding;
+            description.attributes[location].format   = getAttributeFormat(attributes[location].encoding);
+            description.attributes[location].offset   = attributes[location].offset;
+        }
+        description.attribute_count = 3;
+        return description;
+    }
+
+    bool GpuMesh::upload(VulkanRHI* rhi, const AuraMeshFile& file, RHIUploadTicket& ticket)
+    {
+        destroy();
+        if (!file.isOpen())
+        {
+            LOG_ERROR("uploading a mesh file that is not open");
+            return false;
+        }
+
+        m_rhi           = rhi;
+        m_index_type    = file.getHeader().index_size == 2 ? RHI_INDEX_TYPE_UINT16 : RHI_INDEX_TYPE_UINT32;
+        m_index_count   = file.getHeader().index_count;
+        m_vertex_layout = (VertexLayout)file.getHeader().vertex_layout;
+        memcpy(m_quantization.position_offset, file.getHeader().position_offset, sizeof(m_quantization.position_offset));
+        memcpy(m_quantization.position_scale, file.getHeader().position_scale, sizeof(m_quantization.position_scale));
+        // every buffer exists before the first copy is queued, a failure must not leave copies into freed buffers
+        const AuraMeshHeader& header = file.getHeader();
+        m_submeshes.assign(file.getSubmeshes(), file.getSubmeshes() + header.submesh_count);
+        m_meshlet_count = header.meshlet_count;
+        if (!rhi->createBuffer(file.getVertexDataSize(),
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                               m_vertex_buffer,
+                               m_vertex_buffer_memory) ||
+            !rhi->createBuffer(file.getIndexDataSize(),
+                               VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                               m_index_buffer,
+                               m_index_buffer_memory))
+        {
+            LOG_ERROR("failed to create the mesh buffers");
+            destroy();
+            return false;
+        }
+
+        const void*   sources[3] = {file.getMeshlets(), file.getMeshletVertices(), file.getMeshletTriangles()};
+        RHIDeviceSize sizes[3]   = {(RHIDeviceSize)header.meshlet_count * sizeof(AuraMeshMeshlet),
+                                    (RHIDeviceSize)header.meshlet_vertex_count * sizeof(uint32_t),
+                                    (RHIDeviceSize)header.meshlet_triangle_count * sizeof(uint32_t)};
+        RHIBuffer*       buffers[3]  = {&m_meshlet_buffer, &m_meshlet_vertex_buffer, &m_meshlet_triangle_buffer};
+        RHIDeviceMemory* memories[3] = {&m_meshlet_buffer_memory, &m_meshlet_vertex_buffer_memory, &m_meshlet_triangle_buffer_memory};
+        for (uint32_t i = 0; i < 3 && m_meshlet_count != 0; ++i)
+        {
+            if (!rhi->createBuffer(sizes[i],
+                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                   *buffers[i],
+                                   *memories[i],
+                                   true))
+            {
+                LOG_ERROR("failed to create the meshlet buffers");
+                destroy();
+                return false;
+            }
+        }
+
+        rhi->uploadBuffer(m_vertex_buffer, 0, file.getVertexData(), file.getVertexDataSize());
+        ticket = rhi->uploadBuffer(m_index_buffer, 0, file.getIndexData(), file.getIndexDataSize());
+        for (uint32_t i = 0; i < 3 && m_meshlet_count != 0; ++i)
+        {
+            ticket = rhi->uploadBuffer(*buffers[i], 0, sources[i], sizes[i]);
+        }
+        return true;
+    }
+
+    void GpuMesh::destroy()
+    {
+        if (m_rhi == nullptr)
+        {
+            return;
+        }
+        // frames or cull dispatches still in flight may read the buffers, they go once those completed.
+        // a failed upload leaves the buffers after the one that could not be created null
+        struct Buffers
+        {
+            RHIBuffer        buffers[5];
+            RHIDeviceMemory  memories[5];
+        };
+        Buffers doomed = {{m_vertex_buffer, m_index_buffer, m_meshlet_buffer, m_meshlet_vertex_buffer, m_meshlet_triangle_buffer},
+                          {m_vertex_buffer_memory,
+                           m_index_buffer_memory,
+                           m_meshlet_buffer_memory,
+                           m_meshlet_vertex_buffer_memory,
+                           m_meshlet_triangle_buffer_memory}};
+        VulkanRHI* rhi = m_rhi;
+        rhi->deferDestroy([rhi, doomed]() mutable {
+            for (uint32_t i = 0; i < 5; ++i)
+            {
+                if (doomed.buffers[i] != nullptr)
+                {
+                    rhi->destroyBuffer(doomed.buffers[i], doomed.memories[i]);
+                }
+            }
+        });
+        m_vertex_buffer                  = nullptr;
+        m_vertex_buffer_memory           = nullptr;
+        m_index_buffer                   = nullptr;
+        m_index_buffer_memory            = nullptr;
+        m_meshlet_buffer                 = nullptr;
+        m_meshlet_buffer_memory          = nullptr;
+        m_meshlet_vertex_buffer          = nullptr;
+        m_meshlet_vertex_buffer_memory   = nullptr;
+        m_meshlet_triangle_buffer        = nullptr;
+        m_meshlet_triangle_buffer_memory = nullptr;
+        m_rhi           = nullptr;
+        m_index_count   = 0;
+        m_meshlet_count = 0;
+        m_submeshes.clear();
+    }
+} // namespace Aura
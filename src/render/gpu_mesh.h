@@ -0,0 +1,64 @@
+#pragma once
+#include "interface/vulkan_rhi/vulkan_rhi.h"
+#include "../asset/auramesh_file.h"
+#include "../asset/vertex_layout.h"
+
+#include <vector>
+namespace Aura
+{
+    // vertex input state for a cooked vertex layout on one binding: location 0 position, 1 normal (and tangent
+    // in the quantized layouts), 2 texcoord
+    struct VertexInputDescription
+    {
+        RHIVertexInputBindingDescription   binding;
+        RHIVertexInputAttributeDescription attributes[3];
+        uint32_t                           attribute_count;
+    };
+
+    // device-local vertex and index buffers of a cooked mesh, plus its meshlets as storage buffers the cluster
+    // culler reads on the compute queue
+    class GpuMesh
+    {
+    public:
+        // the sections are copied from the file's mapping straight into the staging ring, so the file may be
+        // closed once this returns. the copies are only queued, flush and wait on ticket before the first draw
+        bool upload(VulkanRHI* rhi, const AuraMeshFile& file, RHIUploadTicket& ticket);
+        // the buffers are released once the frames submitted so far completed
+        void destroy();
+
+        RHIBuffer    getVertexBuffer() const { return m_vertex_buffer; }
+        RHIBuffer    getIndexBuffer() const { return m_index_buffer; }
+        RHIIndexType getIndexType() const { return m_index_type; }
+        uint32_t     getIndexCount() const { return m_index_count; }
+        VertexLayout getVertexLayout() const { return m_vertex_layout; }
+        // scale and offset the vertex shader applies to quantized positions
+        const VertexQuantization& getQuantization() const { return m_quantization; }
+        const std::vector<AuraMeshSubmesh>& getSubmeshes() const { return m_submeshes; }
+        // 0 when the mesh was cooked without meshlets, the buffers are null then
+        uint32_t   getMeshletCount() const { return m_meshlet_count; }
+        RHIBuffer  getMeshletBuffer() const { return m_meshlet_buffer; }
+        RHIBuffer  getMeshletVertexBuffer() const { return m_meshlet_vertex_buffer; }
+        RHIBuffer  getMeshletTriangleBuffer() const { return m_meshlet_triangle_buffer; }
+
+        static VertexInputDescription getVertexInputDescription(VertexLayout layout, uint32_t binding = 0);
+
+    private:
+        VulkanRHI*         m_rhi {nullptr};
+        RHIBuffer          m_vertex_buffer {nullptr};
+        RHIDeviceMemory    m_vertex_buffer_memory {nullptr};
+        RHIBuffer          m_index_buffer {nullptr};
+        RHIDeviceMemory    m_index_buffer_memory {nullptr};
+        RHIIndexType       m_index_type {RHI_INDEX_TYPE_UINT32};
+        uint32_t           m_index_count {0};
+        VertexLayout       m_vertex_layout {VERTEX_LAYOUT_FLOAT32};
+        VertexQuantization m_quantization;
+        std::vector<AuraMeshSubmesh> m_submeshes;
+        uint32_t           m_meshlet_count {0};
+        RHIBuffer          m_meshlet_buffer {nullptr};
+        RHIDeviceMemory    m_meshlet_buffer_memory {nullptr};
+        RHIBuffer          m_meshlet_vertex_buffer {nullptr};
+        RHIDeviceMemory    m_meshlet_vertex_buffer_memory {nullptr};
+        RHIBuffer          m_meshlet_triangle_buffer {nullptr};
+        RHIDeviceMemory    m_meshlet_triangle_buffer_memory {nullptr};
+    };
+} // namespace Aura
@@ -4,31 +4,36 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "../render_type.h"
+#include "../../util/object_pool.hpp"
 namespace Aura {
-    class RHIQueue { };
-    class RHIDeviceMemory { };
-    class RHICommandPool { };
-    class RHICommandBuffer { };
-    class RHIDescriptorPool { };
-    class RHISemaphore { };
-    class RHIFence { };
-    class RHIImageView { };
-    class RHIImage { };
-    class RHIRenderPass { };
-    class RHIFramebuffer { };
-    class RHIDescriptorSetLayout { };
-    class RHISampler { };
-    class RHIBufferView { };
-    class RHIDescriptorSet { };
-    class RHIBuffer { };
+    // every rhi object is a 32-bit handle into one of VulkanRHI's tables, nullptr is the invalid handle
+    typedef ObjectHandle<struct RHIQueueTag>               RHIQueue;
+    typedef ObjectHandle<struct RHIDeviceMemoryTag>        RHIDeviceMemory;
+    typedef ObjectHandle<struct RHICommandPoolTag>         RHICommandPool;
+    typedef ObjectHandle<struct RHICommandBufferTag>       RHICommandBuffer;
+    typedef ObjectHandle<struct RHIDescriptorPoolTag>      RHIDescriptorPool;
+    typedef ObjectHandle<struct RHISemaphoreTag>           RHISemaphore;
+    typedef ObjectHandle<struct RHIFenceTag>               RHIFence;
+    typedef ObjectHandle<struct RHIImageViewTag>           RHIImageView;
+    typedef ObjectHandle<struct RHIImageTag>               RHIImage;
+    typedef ObjectHandle<struct RHIRenderPassTag>          RHIRenderPass;
+    typedef ObjectHandle<struct RHIFramebufferTag>         RHIFramebuffer;
+    typedef ObjectHandle<struct RHIDescriptorSetLayoutTag> RHIDescriptorSetLayout;
+    typedef ObjectHandle<struct RHISamplerTag>             RHISampler;
+    typedef ObjectHandle<struct RHIBufferViewTag>          RHIBufferView;
+    typedef ObjectHandle<struct RHIDescriptorSetTag>       RHIDescriptorSet;
+    typedef ObjectHandle<struct RHIBufferTag>              RHIBuffer;
+    typedef ObjectHandle<struct RHIShaderTag>              RHIShader;
+    typedef ObjectHandle<struct RHIPipelineLayoutTag>      RHIPipelineLayout;
+    typedef ObjectHandle<struct RHIPipelineTag>            RHIPipeline;
     struct RHIDescriptorImageInfo {
-        RHISampler* sampler;
-        RHIImageView* imageView;
+        RHISampler sampler;
+        RHIImageView imageView;
         RHIImageLayout imageLayout;
     };
 
     struct RHIDescriptorBufferInfo {
-        RHIBuffer* buffer;
+        RHIBuffer buffer;
         RHIDeviceSize offset;
         RHIDeviceSize range;
     };
@@ -36,22 +41,22 @@ namespace Aura {
     {
         RHIStructureType sType;
         const void* pNext;
-        RHIDescriptorSet* dstSet;
+        RHIDescriptorSet dstSet;
         uint32_t dstBinding;
         uint32_t dstArrayElement;
         uint32_t descriptorCount;
         RHIDescriptorType descriptorType;
         RHIDescriptorImageInfo* pImageInfo = nullptr;
         RHIDescriptorBufferInfo* pBufferInfo = nullptr;
-        RHIBufferView* pTexelBufferView = nullptr;
+        const RHIBufferView* pTexelBufferView = nullptr;
     };
     struct RHICopyDescriptorSet {
         RHIStructureType sType;
         const void* pNext;
-        RHIDescriptorSet* srcSet;
+        RHIDescriptorSet srcSet;
         uint32_t srcBinding;
         uint32_t srcArrayElement;
-        RHIDescriptorSet* dstSet;
+        RHIDescriptorSet dstSet;
         uint32_t dstBinding;
         uint32_t dstArrayElement;
         uint32_t descriptorCount;
@@ -60,9 +65,9 @@ namespace Aura {
     {
         RHIStructureType sType;
         const void* pNext;
-        RHIDescriptorPool* descriptorPool;
+        RHIDescriptorPool descriptorPool;
         uint32_t descriptorSetCount;
-        const RHIDescriptorSetLayout* const* pSetLayouts;
+        const RHIDescriptorSetLayout* pSetLayouts;
     };
     struct RHIDescriptorSetLayoutBinding
     {
@@ -70,7 +75,7 @@ namespace Aura {
         RHIDescriptorType descriptorType;
         uint32_t descriptorCount;
         RHIShaderStageFlags stageFlags;
-        RHISampler* const* pImmutableSamplers = nullptr;
+        const RHISampler* pImmutableSamplers = nullptr;
     };
     struct RHIDescriptorSetLayoutCreateInfo
     {
@@ -125,9 +130,9 @@ namespace Aura {
         RHIStructureType sType;
         const void* pNext;
         RHIFramebufferCreateFlags flags;
-        RHIRenderPass* renderPass;
+        RHIRenderPass renderPass;
         uint32_t attachmentCount;
-        RHIImageView* const* pAttachments;
+        const RHIImageView* pAttachments;
         uint32_t width;
         uint32_t height;
         uint32_t layers;
@@ -157,6 +162,346 @@ namespace Aura {
         RHIOffset2D offset;
         RHIExtent2D extent;
     };
+    union RHIClearColorValue
+    {
+        float float32[4];
+        int32_t int32[4];
+        uint32_t uint32[4];
+    };
+    struct RHIClearDepthStencilValue
+    {
+        float depth;
+        uint32_t stencil;
+    };
+    union RHIClearValue
+    {
+        RHIClearColorValue color;
+        RHIClearDepthStencilValue depthStencil;
+    };
+    struct RHIRenderPassBeginInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIRenderPass renderPass;
+        RHIFramebuffer framebuffer;
+        RHIRect2D renderArea;
+        uint32_t clearValueCount;
+        const RHIClearValue* pClearValues;
+    };
+    struct RHIRenderingAttachmentInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIImageView imageView;
+        RHIImageLayout imageLayout;
+        RHIAttachmentLoadOp loadOp;
+        RHIAttachmentStoreOp storeOp;
+        RHIClearValue clearValue;
+    };
+    struct RHIRenderingInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIRenderingFlags flags;
+        RHIRect2D renderArea;
+        uint32_t layerCount;
+        uint32_t viewMask;
+        uint32_t colorAttachmentCount;
+        const RHIRenderingAttachmentInfo* pColorAttachments;
+        const RHIRenderingAttachmentInfo* pDepthAttachment;
+        const RHIRenderingAttachmentInfo* pStencilAttachment;
+    };
+    // laid out like VkPipelineRenderingCreateInfo, chained as is into RHIGraphicsPipelineCreateInfo::pNext
+    // when the pipeline is used with dynamic rendering
+    struct RHIPipelineRenderingCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        uint32_t viewMask;
+        uint32_t colorAttachmentCount;
+        const RHIFormat* pColorAttachmentFormats;
+        RHIFormat depthAttachmentFormat;
+        RHIFormat stencilAttachmentFormat;
+    };
+    struct RHIImageSubresourceRange
+    {
+        RHIImageAspectFlags aspectMask;
+        uint32_t baseMipLevel;
+        uint32_t levelCount;
+        uint32_t baseArrayLayer;
+        uint32_t layerCount;
+    };
+    // no queue family ownership transfers, both sides are VK_QUEUE_FAMILY_IGNORED
+    struct RHIImageMemoryBarrier
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIAccessFlags srcAccessMask;
+        RHIAccessFlags dstAccessMask;
+        RHIImageLayout oldLayout;
+        RHIImageLayout newLayout;
+        RHIImage image;
+        RHIImageSubresourceRange subresourceRange;
+    };
+    struct RHISamplerCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHISamplerCreateFlags flags;
+        RHIFilter magFilter;
+        RHIFilter minFilter;
+        RHISamplerMipmapMode mipmapMode;
+        RHISamplerAddressMode addressModeU;
+        RHISamplerAddressMode addressModeV;
+        RHISamplerAddressMode addressModeW;
+        float mipLodBias;
+        RHIBool32 anisotropyEnable;
+        float maxAnisotropy;
+        RHIBool32 compareEnable;
+        RHICompareOp compareOp;
+        float minLod;
+        float maxLod;
+        RHIBorderColor borderColor;
+        RHIBool32 unnormalizedCoordinates;
+    };
+    struct RHIPushConstantRange
+    {
+        RHIShaderStageFlags stageFlags;
+        uint32_t offset;
+        uint32_t size;
+    };
+    struct RHIPipelineLayoutCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineLayoutCreateFlags flags;
+        uint32_t setLayoutCount;
+        const RHIDescriptorSetLayout* pSetLayouts;
+        uint32_t pushConstantRangeCount;
+        const RHIPushConstantRange* pPushConstantRanges;
+    };
+    struct RHISpecializationMapEntry
+    {
+        uint32_t constantID;
+        uint32_t offset;
+        size_t size;
+    };
+    struct RHISpecializationInfo
+    {
+        uint32_t mapEntryCount;
+        const RHISpecializationMapEntry* pMapEntries;
+        size_t dataSize;
+        const void* pData;
+    };
+    struct RHIPipelineShaderStageCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineShaderStageCreateFlags flags;
+        RHIShaderStageFlagBits stage;
+        RHIShader module;
+        const char* pName;
+        const RHISpecializationInfo* pSpecializationInfo;
+    };
+    struct RHIVertexInputBindingDescription
+    {
+        uint32_t binding;
+        uint32_t stride;
+        RHIVertexInputRate inputRate;
+    };
+    struct RHIVertexInputAttributeDescription
+    {
+        uint32_t location;
+        uint32_t binding;
+        RHIFormat format;
+        uint32_t offset;
+    };
+    struct RHIPipelineVertexInputStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineVertexInputStateCreateFlags flags;
+        uint32_t vertexBindingDescriptionCount;
+        const RHIVertexInputBindingDescription* pVertexBindingDescriptions;
+        uint32_t vertexAttributeDescriptionCount;
+        const RHIVertexInputAttributeDescription* pVertexAttributeDescriptions;
+    };
+    struct RHIPipelineInputAssemblyStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineInputAssemblyStateCreateFlags flags;
+        RHIPrimitiveTopology topology;
+        RHIBool32 primitiveRestartEnable;
+    };
+    struct RHIViewport
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+        float minDepth;
+        float maxDepth;
+    };
+    struct RHIPipelineViewportStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineViewportStateCreateFlags flags;
+        uint32_t viewportCount;
+        const RHIViewport* pViewports;
+        uint32_t scissorCount;
+        const RHIRect2D* pScissors;
+    };
+    struct RHIPipelineRasterizationStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineRasterizationStateCreateFlags flags;
+        RHIBool32 depthClampEnable;
+        RHIBool32 rasterizerDiscardEnable;
+        RHIPolygonMode polygonMode;
+        RHICullModeFlags cullMode;
+        RHIFrontFace frontFace;
+        RHIBool32 depthBiasEnable;
+        float depthBiasConstantFactor;
+        float depthBiasClamp;
+        float depthBiasSlopeFactor;
+        float lineWidth;
+    };
+    struct RHIPipelineMultisampleStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineMultisampleStateCreateFlags flags;
+        RHISampleCountFlagBits rasterizationSamples;
+        RHIBool32 sampleShadingEnable;
+        float minSampleShading;
+        const RHISampleMask* pSampleMask;
+        RHIBool32 alphaToCoverageEnable;
+        RHIBool32 alphaToOneEnable;
+    };
+    struct RHIStencilOpState
+    {
+        RHIStencilOp failOp;
+        RHIStencilOp passOp;
+        RHIStencilOp depthFailOp;
+        RHICompareOp compareOp;
+        uint32_t compareMask;
+        uint32_t writeMask;
+        uint32_t reference;
+    };
+    struct RHIPipelineDepthStencilStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineDepthStencilStateCreateFlags flags;
+        RHIBool32 depthTestEnable;
+        RHIBool32 depthWriteEnable;
+        RHICompareOp depthCompareOp;
+        RHIBool32 depthBoundsTestEnable;
+        RHIBool32 stencilTestEnable;
+        RHIStencilOpState front;
+        RHIStencilOpState back;
+        float minDepthBounds;
+        float maxDepthBounds;
+    };
+    struct RHIPipelineColorBlendAttachmentState
+    {
+        RHIBool32 blendEnable;
+        RHIBlendFactor srcColorBlendFactor;
+        RHIBlendFactor dstColorBlendFactor;
+        RHIBlendOp colorBlendOp;
+        RHIBlendFactor srcAlphaBlendFactor;
+        RHIBlendFactor dstAlphaBlendFactor;
+        RHIBlendOp alphaBlendOp;
+        RHIColorComponentFlags colorWriteMask;
+    };
+    struct RHIPipelineColorBlendStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineColorBlendStateCreateFlags flags;
+        RHIBool32 logicOpEnable;
+        RHILogicOp logicOp;
+        uint32_t attachmentCount;
+        const RHIPipelineColorBlendAttachmentState* pAttachments;
+        float blendConstants[4];
+    };
+    struct RHIPipelineDynamicStateCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineDynamicStateCreateFlags flags;
+        uint32_t dynamicStateCount;
+        const RHIDynamicState* pDynamicStates;
+    };
+    struct RHIGraphicsPipelineCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineCreateFlags flags;
+        uint32_t stageCount;
+        const RHIPipelineShaderStageCreateInfo* pStages;
+        const RHIPipelineVertexInputStateCreateInfo* pVertexInputState;
+        const RHIPipelineInputAssemblyStateCreateInfo* pInputAssemblyState;
+        const RHIPipelineViewportStateCreateInfo* pViewportState;
+        const RHIPipelineRasterizationStateCreateInfo* pRasterizationState;
+        const RHIPipelineMultisampleStateCreateInfo* pMultisampleState;
+        const RHIPipelineDepthStencilStateCreateInfo* pDepthStencilState;
+        const RHIPipelineColorBlendStateCreateInfo* pColorBlendState;
+        const RHIPipelineDynamicStateCreateInfo* pDynamicState;
+        RHIPipelineLayout layout;
+        RHIRenderPass renderPass;
+        uint32_t subpass;
+        RHIPipeline basePipelineHandle;
+        int32_t basePipelineIndex;
+    };
+    struct RHIComputePipelineCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineCreateFlags flags;
+        RHIPipelineShaderStageCreateInfo stage;
+        RHIPipelineLayout layout;
+        RHIPipeline basePipelineHandle;
+        int32_t basePipelineIndex;
+    };
+    // one entry per memory heap, budget/usage are estimates unless VK_EXT_memory_budget is available
+    struct RHIMemoryHeapStats
+    {
+        RHIMemoryHeapFlags flags;
+        RHIDeviceSize size;
+        RHIDeviceSize budget;
+        RHIDeviceSize usage;
+        RHIDeviceSize blockBytes;
+        RHIDeviceSize allocationBytes;
+        uint32_t blockCount;
+        uint32_t allocationCount;
+    };
+    struct RHIMemoryRequirements
+    {
+        RHIDeviceSize size;
+        RHIDeviceSize alignment;
+        uint32_t memoryTypeBits;
+    };
+    // hits are requests served by an existing object, objectCount what the cache holds right now
+    struct RHIObjectCacheStats
+    {
+        uint64_t hitCount;
+        uint64_t missCount;
+        uint32_t objectCount;
+    };
+    struct RHIDescriptorAllocatorStats
+    {
+        uint32_t poolCount;
+        uint32_t freePoolCount;
+        uint32_t liveSetCount;
+        uint64_t allocationCount;
+        uint64_t poolExhaustedCount;
+        uint64_t failedAllocationCount;
+        uint64_t resetCount;
+    };
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphics_family;
         std::optional<uint32_t> present_family;
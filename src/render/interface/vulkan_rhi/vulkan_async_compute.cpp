@@ -0,0 +1,100 @@
+#include "vulkan_async_compute.h"
+
+#include <iostream>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    void VulkanAsyncCompute::initialize(VkDevice device, VkQueue queue, uint32_t queue_family_index, uint32_t frame_count)
+    {
+        m_device = device;
+        m_queue  = queue;
+        m_command_buffers.assign(frame_count, VK_NULL_HANDLE);
+        m_semaphores.assign(frame_count, VK_NULL_HANDLE);
+        m_recording.assign(frame_count, 0);
+
+        VkCommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_create_info.queueFamilyIndex = queue_family_index;
+        if (vkCreateCommandPool(m_device, &command_pool_create_info, nullptr, &m_command_pool) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk create compute command pool");
+        }
+
+        VkCommandBufferAllocateInfo command_buffer_allocate_info {};
+        command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = m_command_pool;
+        command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = frame_count;
+        if (vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, m_command_buffers.data()) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk allocate compute command buffers");
+        }
+
+        VkSemaphoreCreateInfo semaphore_create_info {};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        for (uint32_t i = 0; i < frame_count; ++i)
+        {
+            if (vkCreateSemaphore(m_device, &semaphore_create_info, nullptr, &m_semaphores[i]) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk create compute semaphore");
+            }
+        }
+    }
+
+    void VulkanAsyncCompute::shutdown()
+    {
+        for (VkSemaphore semaphore : m_semaphores)
+        {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+        m_semaphores.clear();
+        m_command_buffers.clear();
+        vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+        m_command_pool = VK_NULL_HANDLE;
+    }
+
+    VkCommandBuffer VulkanAsyncCompute::getCommandBuffer(uint32_t frame_index)
+    {
+        if (!m_recording[frame_index])
+        {
+            VkCommandBufferBeginInfo begin_info {};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            if (vkBeginCommandBuffer(m_command_buffers[frame_index], &begin_info) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk begin compute command buffer");
+            }
+            m_recording[frame_index] = 1;
+        }
+        return m_command_buffers[frame_index];
+    }
+
+    VkSemaphore VulkanAsyncCompute::submit(uint32_t frame_index)
+    {
+        if (!m_recording[frame_index])
+        {
+            return VK_NULL_HANDLE;
+        }
+        m_recording[frame_index] = 0;
+        if (vkEndCommandBuffer(m_command_buffers[frame_index]) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk end compute command buffer");
+            return VK_NULL_HANDLE;
+        }
+
+        VkSubmitInfo submit_info {};
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount   = 1;
+        submit_info.pCommandBuffers      = &m_command_buffers[frame_index];
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores    = &m_semaphores[frame_index];
+        if (vkQueueSubmit(m_queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk submit compute");
+            return VK_NULL_HANDLE;
+        }
+        ++m_submit_count;
+        return m_semaphores[frame_index];
+    }
+} // namespace Aura
@@ -0,0 +1,31 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include <vector>
+namespace Aura
+{
+    // one primary per frame in flight on the compute queue. a frame's compute work is submitted just ahead
+    // of its graphics work, which waits on the binary semaphore it signals. the wait orders the two frames'
+    // completion, so the frame fence also retires the compute command buffer and no fence of its own is needed
+    class VulkanAsyncCompute
+    {
+    public:
+        void initialize(VkDevice device, VkQueue queue, uint32_t queue_family_index, uint32_t frame_count);
+        void shutdown();
+
+        // begun on the first call of the frame
+        VkCommandBuffer getCommandBuffer(uint32_t frame_index);
+        // VK_NULL_HANDLE when nothing was recorded for the frame, otherwise the semaphore its submit signals
+        VkSemaphore submit(uint32_t frame_index);
+
+        uint64_t m_submit_count {0};
+
+    private:
+        VkDevice                     m_device {VK_NULL_HANDLE};
+        VkQueue                      m_queue {VK_NULL_HANDLE};
+        VkCommandPool                m_command_pool {VK_NULL_HANDLE};
+        std::vector<VkCommandBuffer> m_command_buffers;
+        std::vector<VkSemaphore>     m_semaphores;
+        std::vector<uint8_t>         m_recording;
+    };
+} // namespace Aura
@@ -0,0 +1,169 @@
+#include "vulkan_descriptor_allocator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    void VulkanDescriptorAllocator::initialize(VkDevice                                 device,
+                                               const std::vector<VkDescriptorPoolSize>& pool_sizes,
+                                               uint32_t                                 max_sets,
+                                               VkDescriptorPoolCreateFlags              flags)
+    {
+        m_device     = device;
+        m_pool_sizes = pool_sizes;
+        m_max_sets   = max_sets;
+        m_flags      = flags;
+
+        if (!createPool())
+        {
+            throw std::runtime_error("create descriptor pool");
+        }
+        m_current_pool = 0;
+    }
+
+    bool VulkanDescriptorAllocator::createPool()
+    {
+        uint32_t scale = m_next_pool_scale;
+        m_next_pool_scale = std::min(m_next_pool_scale * 2, k_max_pool_scale);
+
+        std::vector<VkDescriptorPoolSize> pool_sizes = m_pool_sizes;
+        for (VkDescriptorPoolSize& pool_size : pool_sizes)
+        {
+            pool_size.descriptorCount *= scale;
+        }
+
+        VkDescriptorPoolCreateInfo pool_info {};
+        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags         = m_flags;
+        pool_info.maxSets       = m_max_sets * scale;
+        pool_info.poolSizeCount = (uint32_t)pool_sizes.size();
+        pool_info.pPoolSizes    = pool_sizes.data();
+
+        Pool pool;
+        if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &pool.pool) != VK_SUCCESS)
+        {
+            LOG_ERROR("create descriptor pool");
+            return false;
+        }
+        m_pools.push_back(pool);
+        return true;
+    }
+
+    bool VulkanDescriptorAllocator::nextPool()
+    {
+        ++m_pool_exhausted_count;
+        if (!m_free_pools.empty())
+        {
+            m_current_pool = m_free_pools.back();
+            m_free_pools.pop_back();
+            return true;
+        }
+        if (!createPool())
+        {
+            return false;
+        }
+        m_current_pool = (uint32_t)m_pools.size() - 1;
+        return true;
+    }
+
+    bool VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout layout, const void* next, VkDescriptorSet& descriptor_set)
+    {
+        VkDescriptorSetAllocateInfo allocate_info {};
+        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.pNext              = next;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts        = &layout;
+
+        // one retry in a fresh pool, a set that does not fit an empty pool never will
+        uint32_t previous_pool = m_current_pool;
+        for (uint32_t attempt = 0; attempt < 2; ++attempt)
+        {
+            allocate_info.descriptorPool = m_pools[m_current_pool].pool;
+            VkResult result = vkAllocateDescriptorSets(m_device, &allocate_info, &descriptor_set);
+            if (result == VK_SUCCESS)
+            {
+                ++m_pools[m_current_pool].live_set_count;
+                ++m_live_set_count;
+                ++m_allocation_count;
+                if (m_flags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+                {
+                    m_set_owners[descriptor_set] = m_current_pool;
+                }
+                return true;
+            }
+            if ((result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) || !nextPool())
+            {
+                break;
+            }
+        }
+
+        // the fresh pool stayed empty, keep filling the old one instead of growing the chain on every oversized set
+        if (m_current_pool != previous_pool && m_pools[m_current_pool].live_set_count == 0)
+        {
+            m_free_pools.push_back(m_current_pool);
+            m_current_pool = previous_pool;
+        }
+        ++m_failed_allocation_count;
+        LOG_ERROR("vkAllocateDescriptorSets failed!");
+        return false;
+    }
+
+    void VulkanDescriptorAllocator::free(VkDescriptorSet descriptor_set)
+    {
+        auto owner = m_set_owners.find(descriptor_set);
+        if (owner == m_set_owners.end())
+        {
+            LOG_ERROR("free unknown descriptor set");
+            return;
+        }
+        uint32_t pool_index = owner->second;
+        m_set_owners.erase(owner);
+        --m_live_set_count;
+
+        Pool& pool = m_pools[pool_index];
+        if (--pool.live_set_count == 0 && pool_index != m_current_pool)
+        {
+            // resetting an empty pool undoes any fragmentation left by single frees
+            vkResetDescriptorPool(m_device, pool.pool, 0);
+            m_free_pools.push_back(pool_index);
+        }
+        else
+        {
+            vkFreeDescriptorSets(m_device, pool.pool, 1, &descriptor_set);
+        }
+    }
+
+    void VulkanDescriptorAllocator::reset()
+    {
+        m_free_pools.clear();
+        for (uint32_t i = 0; i < m_pools.size(); ++i)
+        {
+            if (m_pools[i].live_set_count > 0)
+            {
+                vkResetDescriptorPool(m_device, m_pools[i].pool, 0);
+                m_pools[i].live_set_count = 0;
+            }
+            if (i != 0)
+            {
+                m_free_pools.push_back(i);
+            }
+        }
+        m_current_pool   = 0;
+        m_live_set_count = 0;
+        m_set_owners.clear();
+        ++m_reset_count;
+    }
+
+    void VulkanDescriptorAllocator::getStats(RHIDescriptorAllocatorStats& stats) const
+    {
+        stats.poolCount             = (uint32_t)m_pools.size();
+        stats.freePoolCount         = (uint32_t)m_free_pools.size();
+        stats.liveSetCount          = m_live_set_count;
+        stats.allocationCount       = m_allocation_count;
+        stats.poolExhaustedCount    = m_pool_exhausted_count;
+        stats.failedAllocationCount = m_failed_allocation_count;
+        stats.resetCount            = m_reset_count;
+    }
+} // namespace Aura
@@ -0,0 +1,60 @@
+#pragma once
+#include "../rhi_struct.h"
+#include <vulkan/vulkan.h>
+#include <unordered_map>
+#include <vector>
+namespace Aura
+{
+    // hands out descriptor sets from a chain of pools. when the current pool is exhausted the next
+    // one is taken from the free list or created twice as large, so allocation never fails for good.
+    // transient allocators are reset wholesale, persistent ones may free single sets and recycle a
+    // pool as soon as its last set is gone
+    class VulkanDescriptorAllocator
+    {
+    public:
+        void initialize(VkDevice                                 device,
+                        const std::vector<VkDescriptorPoolSize>& pool_sizes,
+                        uint32_t                                 max_sets,
+                        VkDescriptorPoolCreateFlags              flags);
+
+        bool allocate(VkDescriptorSetLayout layout, const void* next, VkDescriptorSet& descriptor_set);
+        // requires VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        void free(VkDescriptorSet descriptor_set);
+        // every set allocated so far becomes invalid
+        void reset();
+
+        VkDescriptorPool getFirstPool() const { return m_pools.empty() ? VK_NULL_HANDLE : m_pools[0].pool; }
+        void getStats(RHIDescriptorAllocatorStats& stats) const;
+
+    private:
+        // growth stops here, pools after that are all the same size
+        static constexpr uint32_t k_max_pool_scale {16};
+
+        struct Pool
+        {
+            VkDescriptorPool pool {VK_NULL_HANDLE};
+            uint32_t         live_set_count {0};
+        };
+
+        bool createPool();
+        bool nextPool();
+
+        VkDevice                          m_device {VK_NULL_HANDLE};
+        std::vector<VkDescriptorPoolSize> m_pool_sizes;
+        uint32_t                          m_max_sets {0};
+        VkDescriptorPoolCreateFlags       m_flags {0};
+        uint32_t                          m_next_pool_scale {1};
+
+        std::vector<Pool>     m_pools;
+        std::vector<uint32_t> m_free_pools;
+        uint32_t              m_current_pool {0};
+        // only tracked when single sets can be freed
+        std::unordered_map<VkDescriptorSet, uint32_t> m_set_owners;
+
+        uint32_t m_live_set_count {0};
+        uint64_t m_allocation_count {0};
+        uint64_t m_pool_exhausted_count {0};
+        uint64_t m_failed_allocation_count {0};
+        uint64_t m_reset_count {0};
+    };
+} // namespace Aura
@@ -0,0 +1,58 @@
+#include "vulkan_frame_ring_buffer.h"
+#include "vulkan_util.h"
+
+#include <algorithm>
+#include <iostream>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    void VulkanFrameRingBuffer::initialize(VmaAllocator       allocator,
+                                           VkDeviceSize       region_size,
+                                           uint32_t           region_count,
+                                           VkDeviceSize       alignment,
+                                           VkBufferUsageFlags usage,
+                                           VulkanBufferTable* buffer_table)
+    {
+        m_alignment   = alignment;
+        m_region_size = (region_size + alignment - 1) / alignment * alignment;
+
+        VmaAllocationInfo allocation_info {};
+        VulkanUtil::createBuffer(allocator,
+                                 m_region_size * region_count,
+                                 usage,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 m_buffer,
+                                 m_allocation,
+                                 &allocation_info);
+        m_data = (uint8_t*)allocation_info.pMappedData;
+
+        m_rhi_buffer = buffer_table->create(m_buffer);
+    }
+
+    void VulkanFrameRingBuffer::beginFrame(uint32_t frame_index)
+    {
+        // failed allocations still advance the head, clamp to the region
+        VkDeviceSize used = std::min(m_head.load(), m_region_begin + m_region_size) - m_region_begin;
+        m_peak_bytes   = std::max(m_peak_bytes, used);
+        m_region_begin = m_region_size * frame_index;
+        m_head         = m_region_begin;
+    }
+
+    void* VulkanFrameRingBuffer::allocate(VkDeviceSize size, uint32_t& dynamic_offset)
+    {
+        // the region start is aligned and every allocation is padded, so offsets stay aligned
+        VkDeviceSize aligned_size = (size + m_alignment - 1) / m_alignment * m_alignment;
+        VkDeviceSize offset       = m_head.fetch_add(aligned_size, std::memory_order_relaxed);
+        if (offset + size > m_region_begin + m_region_size)
+        {
+            if (!m_exhausted_logged.exchange(true))
+            {
+                LOG_ERROR("frame ring buffer exhausted, increase m_frame_ring_buffer_size");
+            }
+            return nullptr;
+        }
+
+        dynamic_offset = (uint32_t)offset;
+        return m_data + offset;
+    }
+} // namespace Aura
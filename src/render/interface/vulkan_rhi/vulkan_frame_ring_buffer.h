@@ -0,0 +1,47 @@
+#pragma once
+#include "../rhi_struct.h"
+#include "vulkan_rhi_resource.h"
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <atomic>
+#include <vector>
+namespace Aura
+{
+    // one persistently mapped buffer split into a region per frame in flight. allocations bump
+    // through the current frame's region and the whole region is recycled once that frame's
+    // fence signaled, so per-draw data costs a memcpy and a dynamic offset
+    class VulkanFrameRingBuffer
+    {
+    public:
+        // getBuffer()'s handle is taken from buffer_table
+        void initialize(VmaAllocator       allocator,
+                        VkDeviceSize       region_size,
+                        uint32_t           region_count,
+                        VkDeviceSize       alignment,
+                        VkBufferUsageFlags usage,
+                        VulkanBufferTable* buffer_table);
+
+        // the frame's previous contents must no longer be in use by the gpu
+        void beginFrame(uint32_t frame_index);
+        // returns nullptr when the region is exhausted, dynamic_offset is relative to the buffer start.
+        // safe to call from several recording threads at once
+        void* allocate(VkDeviceSize size, uint32_t& dynamic_offset);
+
+        RHIBuffer    getBuffer() const { return m_rhi_buffer; }
+        VkDeviceSize getAlignment() const { return m_alignment; }
+
+        // highest number of bytes used by any frame so far
+        VkDeviceSize m_peak_bytes {0};
+
+    private:
+        VkBuffer      m_buffer {VK_NULL_HANDLE};
+        VmaAllocation m_allocation {nullptr};
+        RHIBuffer     m_rhi_buffer {nullptr};
+        uint8_t*      m_data {nullptr};
+        VkDeviceSize  m_region_size {0};
+        VkDeviceSize  m_alignment {0};
+        VkDeviceSize  m_region_begin {0};
+        std::atomic<VkDeviceSize> m_head {0};
+        std::atomic<bool>         m_exhausted_logged {false};
+    };
+} // namespace Aura
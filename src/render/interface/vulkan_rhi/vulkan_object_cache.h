@@ -0,0 +1,124 @@
+#pragma once
+#include "../rhi_struct.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+namespace Aura
+{
+    // translated create info flattened to bytes. add fields one by one so padding never ends up in the key,
+    // and follow pointers instead of adding them
+    class VulkanObjectKey
+    {
+    public:
+        template<typename T>
+        VulkanObjectKey& add(const T& value)
+        {
+            m_bytes.append((const char*)&value, sizeof(T));
+            return *this;
+        }
+        // only for arrays of structs without padding
+        template<typename T>
+        VulkanObjectKey& addArray(const T* values, uint32_t count)
+        {
+            add(count);
+            if (count > 0)
+            {
+                m_bytes.append((const char*)values, sizeof(T) * count);
+            }
+            return *this;
+        }
+        const std::string& getBytes() const { return m_bytes; }
+
+    private:
+        std::string m_bytes;
+    };
+
+    // hash-consed immutable objects, equal create infos share one object and every acquire() is matched by a
+    // release(). keep_unreferenced holds on to objects nobody references for the next request, which is
+    // wrong for anything keyed on handles that may be destroyed and reused, like a framebuffer's views
+    template<typename Handle>
+    class VulkanObjectCache
+    {
+    public:
+        explicit VulkanObjectCache(bool keep_unreferenced) : m_keep_unreferenced(keep_unreferenced) {}
+
+        // create runs under the lock on a miss and returns nullptr on failure, which is not cached
+        Handle acquire(const VulkanObjectKey& key, const std::function<Handle()>& create)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto entry = m_entries.find(key.getBytes());
+            if (entry != m_entries.end())
+            {
+                ++entry->second.ref_count;
+                ++m_stats.hitCount;
+                return entry->second.handle;
+            }
+            ++m_stats.missCount;
+            Handle handle = create();
+            if (handle != nullptr)
+            {
+                m_entries.emplace(key.getBytes(), Entry {handle, 1});
+                m_keys.emplace(handle, key.getBytes());
+            }
+            return handle;
+        }
+
+        // true when the caller destroys the object, always for handles the cache never handed out
+        bool release(Handle handle)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto key = m_keys.find(handle);
+            if (key == m_keys.end())
+            {
+                return true;
+            }
+            Entry& entry = m_entries[key->second];
+            if (entry.ref_count > 0)
+            {
+                --entry.ref_count;
+            }
+            if (entry.ref_count > 0 || m_keep_unreferenced)
+            {
+                return false;
+            }
+            m_entries.erase(key->second);
+            m_keys.erase(key);
+            return true;
+        }
+
+        // hands every cached object to destroy, referenced or not
+        void clear(const std::function<void(Handle)>& destroy)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& entry : m_entries)
+            {
+                destroy(entry.second.handle);
+            }
+            m_entries.clear();
+            m_keys.clear();
+        }
+
+        RHIObjectCacheStats getStats()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            RHIObjectCacheStats stats = m_stats;
+            stats.objectCount         = (uint32_t)m_entries.size();
+            return stats;
+        }
+
+    private:
+        struct Entry
+        {
+            Handle   handle;
+            uint32_t ref_count;
+        };
+
+        bool                                    m_keep_unreferenced;
+        std::unordered_map<std::string, Entry>  m_entries;
+        std::unordered_map<Handle, std::string> m_keys;
+        RHIObjectCacheStats                     m_stats {};
+        std::mutex                              m_mutex;
+    };
+} // namespace Aura
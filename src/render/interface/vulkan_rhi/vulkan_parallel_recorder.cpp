@@ -0,0 +1,157 @@
+#include "vulkan_parallel_recorder.h"
+#include "../../../util/scratch_arena.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    void VulkanParallelRecorder::initialize(VkDevice                  device,
+                                            uint32_t                  queue_family_index,
+                                            JobSystem*                job_system,
+                                            uint32_t                  max_batches,
+                                            uint32_t                  frame_count,
+                                            VulkanCommandBufferTable* command_buffer_table)
+    {
+        m_device               = device;
+        m_job_system           = job_system;
+        m_command_buffer_table = command_buffer_table;
+        m_frame_count          = frame_count;
+
+        // a secondary is recorded by whichever job system thread picks its batch up
+        uint32_t thread_count = m_job_system != nullptr ? m_job_system->getThreadCount() : 1;
+        m_max_batches         = std::max(std::min(max_batches, thread_count), 1u);
+
+        VkCommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        command_pool_create_info.queueFamilyIndex = queue_family_index;
+
+        m_thread_frames.resize(thread_count * frame_count);
+        for (ThreadFrame& thread_frame : m_thread_frames)
+        {
+            if (vkCreateCommandPool(m_device, &command_pool_create_info, nullptr, &thread_frame.command_pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("create recording command pool");
+            }
+        }
+    }
+
+    void VulkanParallelRecorder::shutdown()
+    {
+        for (ThreadFrame& thread_frame : m_thread_frames)
+        {
+            vkDestroyCommandPool(m_device, thread_frame.command_pool, nullptr);
+            for (RHICommandBuffer rhi_command_buffer : thread_frame.rhi_command_buffers)
+            {
+                m_command_buffer_table->destroy(rhi_command_buffer);
+            }
+        }
+        m_thread_frames.clear();
+    }
+
+    bool VulkanParallelRecorder::beginFrame(uint32_t frame_index)
+    {
+        m_frame_index = frame_index;
+        for (uint32_t thread = 0; thread < m_thread_frames.size() / m_frame_count; ++thread)
+        {
+            ThreadFrame& thread_frame = m_thread_frames[thread * m_frame_count + frame_index];
+            if (vkResetCommandPool(m_device, thread_frame.command_pool, 0) != VK_SUCCESS)
+            {
+                LOG_ERROR("failed to reset recording command pool");
+                return false;
+            }
+            thread_frame.used = 0;
+        }
+        return true;
+    }
+
+    void VulkanParallelRecorder::record(VkCommandBuffer                       primary,
+                                        const VkCommandBufferInheritanceInfo& inheritance,
+                                        uint32_t                              item_count,
+                                        uint32_t                              min_items_per_batch,
+                                        const RecordFunction&                 record_function)
+    {
+        if (item_count == 0)
+        {
+            return;
+        }
+
+        // one batch per thread at most, fewer when the range is too small to be worth splitting
+        min_items_per_batch  = std::max(min_items_per_batch, 1u);
+        uint32_t batch_count = std::min(m_max_batches, (item_count + min_items_per_batch - 1) / min_items_per_batch);
+
+        m_batches.resize(batch_count);
+        for (uint32_t i = 0; i < batch_count; ++i)
+        {
+            m_batches[i].begin          = (uint32_t)((uint64_t)item_count * i / batch_count);
+            m_batches[i].end            = (uint32_t)((uint64_t)item_count * (i + 1) / batch_count);
+            m_batches[i].command_buffer = VK_NULL_HANDLE;
+        }
+        m_inheritance     = &inheritance;
+        m_record_function = &record_function;
+
+        JobCounter counter;
+        for (uint32_t i = 1; i < batch_count; ++i)
+        {
+            Batch* batch = &m_batches[i];
+            m_job_system->run([this, batch]() { recordBatch(*batch); }, &counter);
+        }
+        recordBatch(m_batches[0]);
+        if (batch_count > 1)
+        {
+            m_job_system->wait(counter);
+        }
+
+        ScratchScope     scratch;
+        VkCommandBuffer* secondaries = scratch.allocateArray<VkCommandBuffer>(batch_count);
+        for (uint32_t i = 0; i < batch_count; ++i)
+        {
+            secondaries[i] = m_batches[i].command_buffer;
+        }
+        vkCmdExecuteCommands(primary, batch_count, secondaries);
+        m_secondary_count += batch_count;
+    }
+
+    void VulkanParallelRecorder::recordBatch(Batch& batch)
+    {
+        uint32_t     thread_index = m_job_system != nullptr ? m_job_system->getThreadIndex() : 0;
+        ThreadFrame& thread_frame = m_thread_frames[thread_index * m_frame_count + m_frame_index];
+        if (thread_frame.used == thread_frame.command_buffers.size())
+        {
+            VkCommandBufferAllocateInfo command_buffer_allocate_info {};
+            command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_allocate_info.commandPool        = thread_frame.command_pool;
+            command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            command_buffer_allocate_info.commandBufferCount = 1U;
+
+            VkCommandBuffer vk_command_buffer;
+            if (vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, &vk_command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("allocate secondary command buffer");
+            }
+            thread_frame.command_buffers.push_back(vk_command_buffer);
+            RHICommandBuffer rhi_command_buffer = m_command_buffer_table->create(vk_command_buffer);
+            if (rhi_command_buffer == nullptr)
+            {
+                throw std::runtime_error("rhi object table exhausted");
+            }
+            thread_frame.rhi_command_buffers.push_back(rhi_command_buffer);
+        }
+        VkCommandBuffer  vk_command_buffer  = thread_frame.command_buffers[thread_frame.used];
+        RHICommandBuffer rhi_command_buffer = thread_frame.rhi_command_buffers[thread_frame.used];
+        ++thread_frame.used;
+
+        VkCommandBufferBeginInfo command_buffer_begin_info {};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags =
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        command_buffer_begin_info.pInheritanceInfo = m_inheritance;
+        vkBeginCommandBuffer(vk_command_buffer, &command_buffer_begin_info);
+        (*m_record_function)(rhi_command_buffer, batch.begin, batch.end);
+        vkEndCommandBuffer(vk_command_buffer);
+
+        batch.command_buffer = vk_command_buffer;
+    }
+} // namespace Aura
@@ -0,0 +1,73 @@
+#pragma once
+#include "../rhi_struct.h"
+#include "../../../util/job_system.h"
+#include "vulkan_rhi_resource.h"
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <vector>
+namespace Aura
+{
+    // splits a range of draws into jobs on the shared job system. every (thread, frame) pair owns a command
+    // pool, so secondaries are recorded without locks and the whole frame's pools are reset at once
+    class VulkanParallelRecorder
+    {
+    public:
+        typedef std::function<void(RHICommandBuffer command_buffer, uint32_t begin, uint32_t end)> RecordFunction;
+
+        // max_batches caps the secondaries per record() call, without a job system everything is recorded
+        // on the calling thread. the secondaries' handles are taken from command_buffer_table
+        void initialize(VkDevice                  device,
+                        uint32_t                  queue_family_index,
+                        JobSystem*                job_system,
+                        uint32_t                  max_batches,
+                        uint32_t                  frame_count,
+                        VulkanCommandBufferTable* command_buffer_table);
+        void shutdown();
+
+        // the frame's previous secondaries must no longer be in use by the gpu
+        bool beginFrame(uint32_t frame_index);
+        // records [0, item_count) into one secondary per batch and executes them in range order, the
+        // calling thread records the first batch and runs other jobs while the rest finish
+        void record(VkCommandBuffer                       primary,
+                    const VkCommandBufferInheritanceInfo& inheritance,
+                    uint32_t                              item_count,
+                    uint32_t                              min_items_per_batch,
+                    const RecordFunction&                 record_function);
+
+        uint32_t getThreadCount() const { return m_max_batches; }
+
+        uint64_t m_secondary_count {0};
+
+    private:
+        struct ThreadFrame
+        {
+            VkCommandPool                     command_pool {VK_NULL_HANDLE};
+            std::vector<VkCommandBuffer>      command_buffers;
+            std::vector<RHICommandBuffer>     rhi_command_buffers;
+            uint32_t                          used {0};
+        };
+
+        struct Batch
+        {
+            uint32_t        begin;
+            uint32_t        end;
+            VkCommandBuffer command_buffer;
+        };
+
+        void recordBatch(Batch& batch);
+
+        VkDevice                  m_device {VK_NULL_HANDLE};
+        JobSystem*                m_job_system {nullptr};
+        VulkanCommandBufferTable* m_command_buffer_table {nullptr};
+        uint32_t                  m_max_batches {1};
+        uint32_t                  m_frame_count {0};
+        uint32_t                  m_frame_index {0};
+        // indexed [job system thread * m_frame_count + frame]
+        std::vector<ThreadFrame> m_thread_frames;
+
+        // the job of the current record() call
+        std::vector<Batch>                    m_batches;
+        const VkCommandBufferInheritanceInfo* m_inheritance {nullptr};
+        const RecordFunction*                 m_record_function {nullptr};
+    };
+} // namespace Aura
@@ -0,0 +1,331 @@
+#include "vulkan_pipeline_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    // FNV-1a, only guards against truncated or corrupted files
+    static uint64_t hashData(const uint8_t* data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void VulkanPipelineCache::initialize(VkDevice device, VkPhysicalDevice physical_device, const std::string& path)
+    {
+        m_device = device;
+        m_path   = path;
+
+        VkPhysicalDeviceIDProperties id_properties {};
+        id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &id_properties;
+        vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+        m_vendor_id      = properties.properties.vendorID;
+        m_device_id      = properties.properties.deviceID;
+        m_driver_version = properties.properties.driverVersion;
+        memcpy(m_device_uuid, id_properties.deviceUUID, VK_UUID_SIZE);
+        memcpy(m_pipeline_cache_uuid, properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        std::vector<uint8_t> data;
+        m_loaded_from_disk = !m_path.empty() && loadFile(data);
+
+        VkPipelineCacheCreateInfo create_info {};
+        create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        create_info.initialDataSize = m_loaded_from_disk ? data.size() : 0;
+        create_info.pInitialData    = m_loaded_from_disk ? data.data() : nullptr;
+        if (vkCreatePipelineCache(m_device, &create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+        {
+            // the driver rejected the data after all, start empty
+            m_loaded_from_disk          = false;
+            create_info.initialDataSize = 0;
+            create_info.pInitialData    = nullptr;
+            if (vkCreatePipelineCache(m_device, &create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+            {
+                throw std::runtime_error("create pipeline cache");
+            }
+        }
+    }
+
+    void VulkanPipelineCache::fillHeader(FileHeader& header) const
+    {
+        memset(&header, 0, sizeof(header));
+        header.magic          = k_file_magic;
+        header.version        = k_file_version;
+        header.vendor_id      = m_vendor_id;
+        header.device_id      = m_device_id;
+        header.driver_version = m_driver_version;
+        memcpy(header.device_uuid, m_device_uuid, VK_UUID_SIZE);
+        memcpy(header.pipeline_cache_uuid, m_pipeline_cache_uuid, VK_UUID_SIZE);
+    }
+
+    bool VulkanPipelineCache::loadFile(std::vector<uint8_t>& data) const
+    {
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        FileHeader header;
+        FileHeader expected;
+        fillHeader(expected);
+        if (!file.read((char*)&header, sizeof(header)) || header.magic != expected.magic ||
+            header.version != expected.version || header.vendor_id != expected.vendor_id ||
+            header.device_id != expected.device_id || header.driver_version != expected.driver_version ||
+            memcmp(header.device_uuid, expected.device_uuid, VK_UUID_SIZE) != 0 ||
+            memcmp(header.pipeline_cache_uuid, expected.pipeline_cache_uuid, VK_UUID_SIZE) != 0)
+        {
+            LOG_ERROR("pipeline cache " << m_path << " is from another device or driver, ignoring it");
+            return false;
+        }
+
+        data.resize((size_t)header.data_size);
+        if (!file.read((char*)data.data(), (std::streamsize)data.size()) ||
+            hashData(data.data(), data.size()) != header.data_hash)
+        {
+            LOG_ERROR("pipeline cache " << m_path << " is corrupted, ignoring it");
+            data.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool VulkanPipelineCache::save()
+    {
+        if (m_pipeline_cache == VK_NULL_HANDLE || m_path.empty())
+        {
+            return false;
+        }
+
+        size_t data_size = 0;
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &data_size, nullptr) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkGetPipelineCacheData failed!");
+            return false;
+        }
+        std::vector<uint8_t> data(data_size);
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &data_size, data.data()) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkGetPipelineCacheData failed!");
+            return false;
+        }
+        data.resize(data_size);
+
+        FileHeader header;
+        fillHeader(header);
+        header.data_size = data.size();
+        header.data_hash = hashData(data.data(), data.size());
+
+        std::string temp_path = m_path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file || !file.write((const char*)&header, sizeof(header)) ||
+                !file.write((const char*)data.data(), (std::streamsize)data.size()))
+            {
+                LOG_ERROR("write pipeline cache " << temp_path);
+                return false;
+            }
+        }
+        std::remove(m_path.c_str());
+        if (std::rename(temp_path.c_str(), m_path.c_str()) != 0)
+        {
+            LOG_ERROR("rename pipeline cache " << temp_path);
+            return false;
+        }
+        return true;
+    }
+
+    void VulkanPipelineCache::destroy()
+    {
+        if (m_pipeline_cache != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+            m_pipeline_cache = VK_NULL_HANDLE;
+        }
+    }
+
+    // a chained struct of unknown type cannot be copied, the caller falls back to compiling synchronously
+    static bool copyStage(const RHIPipelineShaderStageCreateInfo& source,
+                          RHIPipelineShaderStageCreateInfo&       stage,
+                          std::string&                            name,
+                          RHISpecializationInfo&                  specialization,
+                          std::vector<RHISpecializationMapEntry>& map_entries,
+                          std::vector<uint8_t>&                   data)
+    {
+        stage = source;
+        if (source.pName != nullptr)
+        {
+            name        = source.pName;
+            stage.pName = name.c_str();
+        }
+        if (source.pSpecializationInfo != nullptr)
+        {
+            specialization = *source.pSpecializationInfo;
+            map_entries.assign(specialization.pMapEntries, specialization.pMapEntries + specialization.mapEntryCount);
+            data.assign((const uint8_t*)specialization.pData, (const uint8_t*)specialization.pData + specialization.dataSize);
+            specialization.pMapEntries = map_entries.data();
+            specialization.pData       = data.data();
+            stage.pSpecializationInfo  = &specialization;
+        }
+        return source.pNext == nullptr;
+    }
+
+    template<typename T>
+    const T* VulkanGraphicsPipelineCreateInfoCopy::copyState(const T* source, T& storage)
+    {
+        if (source == nullptr)
+        {
+            return nullptr;
+        }
+        storage    = *source;
+        m_complete = m_complete && source->pNext == nullptr;
+        return &storage;
+    }
+
+    template<typename T>
+    const T* VulkanGraphicsPipelineCreateInfoCopy::copyArray(const T* source, uint32_t count, std::vector<T>& storage)
+    {
+        if (source == nullptr)
+        {
+            return nullptr;
+        }
+        storage.assign(source, source + count);
+        return storage.data();
+    }
+
+    VulkanGraphicsPipelineCreateInfoCopy::VulkanGraphicsPipelineCreateInfoCopy(const RHIGraphicsPipelineCreateInfo& create_info)
+        : m_create_info(create_info)
+    {
+        // sized up front, the stages point into m_stage_data
+        m_stages.resize(create_info.stageCount);
+        m_stage_data.resize(create_info.stageCount);
+        for (uint32_t i = 0; i < create_info.stageCount; ++i)
+        {
+            Stage& stage = m_stage_data[i];
+            m_complete &= copyStage(create_info.pStages[i], m_stages[i], stage.name, stage.specialization, stage.map_entries, stage.data);
+        }
+        m_create_info.pStages = create_info.stageCount > 0 ? m_stages.data() : nullptr;
+
+        if (copyState(create_info.pVertexInputState, m_vertex_input) != nullptr)
+        {
+            m_vertex_input.pVertexBindingDescriptions =
+                copyArray(m_vertex_input.pVertexBindingDescriptions, m_vertex_input.vertexBindingDescriptionCount, m_vertex_bindings);
+            m_vertex_input.pVertexAttributeDescriptions =
+                copyArray(m_vertex_input.pVertexAttributeDescriptions, m_vertex_input.vertexAttributeDescriptionCount, m_vertex_attributes);
+            m_create_info.pVertexInputState = &m_vertex_input;
+        }
+        m_create_info.pInputAssemblyState = copyState(create_info.pInputAssemblyState, m_input_assembly);
+        if (copyState(create_info.pViewportState, m_viewport) != nullptr)
+        {
+            m_viewport.pViewports       = copyArray(m_viewport.pViewports, m_viewport.viewportCount, m_viewports);
+            m_viewport.pScissors        = copyArray(m_viewport.pScissors, m_viewport.scissorCount, m_scissors);
+            m_create_info.pViewportState = &m_viewport;
+        }
+        m_create_info.pRasterizationState = copyState(create_info.pRasterizationState, m_rasterization);
+        if (copyState(create_info.pMultisampleState, m_multisample) != nullptr)
+        {
+            // one mask word per 32 samples
+            m_multisample.pSampleMask       = copyArray(m_multisample.pSampleMask, ((uint32_t)m_multisample.rasterizationSamples + 31) / 32, m_sample_mask);
+            m_create_info.pMultisampleState = &m_multisample;
+        }
+        m_create_info.pDepthStencilState = copyState(create_info.pDepthStencilState, m_depth_stencil);
+        if (copyState(create_info.pColorBlendState, m_color_blend) != nullptr)
+        {
+            m_color_blend.pAttachments     = copyArray(m_color_blend.pAttachments, m_color_blend.attachmentCount, m_blend_attachments);
+            m_create_info.pColorBlendState = &m_color_blend;
+        }
+        if (copyState(create_info.pDynamicState, m_dynamic) != nullptr)
+        {
+            m_dynamic.pDynamicStates    = copyArray(m_dynamic.pDynamicStates, m_dynamic.dynamicStateCount, m_dynamic_states);
+            m_create_info.pDynamicState = &m_dynamic;
+        }
+
+        const RHIPipelineRenderingCreateInfo* rendering = (const RHIPipelineRenderingCreateInfo*)create_info.pNext;
+        if (rendering != nullptr && rendering->sType == RHI_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR)
+        {
+            m_rendering                         = *rendering;
+            m_rendering.pColorAttachmentFormats = copyArray(rendering->pColorAttachmentFormats, rendering->colorAttachmentCount, m_color_formats);
+            m_create_info.pNext                 = &m_rendering;
+            m_complete &= rendering->pNext == nullptr;
+        }
+        else
+        {
+            m_complete &= create_info.pNext == nullptr;
+        }
+    }
+
+    VulkanComputePipelineCreateInfoCopy::VulkanComputePipelineCreateInfoCopy(const RHIComputePipelineCreateInfo& create_info)
+        : m_create_info(create_info)
+    {
+        m_complete = create_info.pNext == nullptr &&
+                     copyStage(create_info.stage, m_create_info.stage, m_name, m_specialization, m_map_entries, m_data);
+    }
+
+    void VulkanPipelineCompileQueue::initialize(uint32_t worker_count)
+    {
+        m_stopping = false;
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back(&VulkanPipelineCompileQueue::workerLoop, this);
+        }
+    }
+
+    void VulkanPipelineCompileQueue::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    void VulkanPipelineCompileQueue::push(std::function<void()> job)
+    {
+        if (m_workers.empty())
+        {
+            job();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_condition.notify_one();
+    }
+
+    void VulkanPipelineCompileQueue::workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+} // namespace Aura
@@ -0,0 +1,145 @@
+#pragma once
+#include "../rhi_struct.h"
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+namespace Aura
+{
+    // VkPipelineCache persisted between runs. the file carries its own header so data written by
+    // another device or driver version is dropped instead of handed to the driver
+    class VulkanPipelineCache
+    {
+    public:
+        void initialize(VkDevice device, VkPhysicalDevice physical_device, const std::string& path);
+        // writes to a temporary file first so a crash never leaves a truncated cache behind
+        bool save();
+        void destroy();
+
+        VkPipelineCache getResource() const { return m_pipeline_cache; }
+
+        // the cache started from valid on-disk data
+        bool m_loaded_from_disk {false};
+
+    private:
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendor_id;
+            uint32_t device_id;
+            uint32_t driver_version;
+            uint8_t  device_uuid[VK_UUID_SIZE];
+            uint8_t  pipeline_cache_uuid[VK_UUID_SIZE];
+            uint64_t data_size;
+            uint64_t data_hash;
+        };
+
+        static uint32_t const k_file_magic {0x4F535041}; // "APSO"
+        static uint32_t const k_file_version {1};
+
+        void fillHeader(FileHeader& header) const;
+        bool loadFile(std::vector<uint8_t>& data) const;
+
+        VkDevice        m_device {VK_NULL_HANDLE};
+        VkPipelineCache m_pipeline_cache {VK_NULL_HANDLE};
+        std::string     m_path;
+        uint32_t        m_vendor_id {0};
+        uint32_t        m_device_id {0};
+        uint32_t        m_driver_version {0};
+        uint8_t         m_device_uuid[VK_UUID_SIZE] {};
+        uint8_t         m_pipeline_cache_uuid[VK_UUID_SIZE] {};
+    };
+
+    // a pipeline create info and everything it points to, owned so a compile can run after the caller returned.
+    // only RHIPipelineRenderingCreateInfo can be chained, isComplete() is false when any other pNext was dropped
+    class VulkanGraphicsPipelineCreateInfoCopy
+    {
+    public:
+        explicit VulkanGraphicsPipelineCreateInfoCopy(const RHIGraphicsPipelineCreateInfo& create_info);
+        VulkanGraphicsPipelineCreateInfoCopy(const VulkanGraphicsPipelineCreateInfoCopy&)            = delete;
+        VulkanGraphicsPipelineCreateInfoCopy& operator=(const VulkanGraphicsPipelineCreateInfoCopy&) = delete;
+
+        const RHIGraphicsPipelineCreateInfo* get() const { return &m_create_info; }
+        bool                                 isComplete() const { return m_complete; }
+
+    private:
+        struct Stage
+        {
+            std::string                            name;
+            RHISpecializationInfo                  specialization;
+            std::vector<RHISpecializationMapEntry> map_entries;
+            std::vector<uint8_t>                   data;
+        };
+
+        // copies *source into storage and returns it, nullptr stays nullptr
+        template<typename T>
+        const T* copyState(const T* source, T& storage);
+        template<typename T>
+        const T* copyArray(const T* source, uint32_t count, std::vector<T>& storage);
+
+        RHIGraphicsPipelineCreateInfo                    m_create_info;
+        bool                                             m_complete {true};
+        std::vector<RHIPipelineShaderStageCreateInfo>    m_stages;
+        std::vector<Stage>                               m_stage_data;
+        RHIPipelineVertexInputStateCreateInfo            m_vertex_input;
+        std::vector<RHIVertexInputBindingDescription>    m_vertex_bindings;
+        std::vector<RHIVertexInputAttributeDescription>  m_vertex_attributes;
+        RHIPipelineInputAssemblyStateCreateInfo          m_input_assembly;
+        RHIPipelineViewportStateCreateInfo               m_viewport;
+        std::vector<RHIViewport>                         m_viewports;
+        std::vector<RHIRect2D>                           m_scissors;
+        RHIPipelineRasterizationStateCreateInfo          m_rasterization;
+        RHIPipelineMultisampleStateCreateInfo            m_multisample;
+        std::vector<RHISampleMask>                       m_sample_mask;
+        RHIPipelineDepthStencilStateCreateInfo           m_depth_stencil;
+        RHIPipelineColorBlendStateCreateInfo             m_color_blend;
+        std::vector<RHIPipelineColorBlendAttachmentState> m_blend_attachments;
+        RHIPipelineDynamicStateCreateInfo                m_dynamic;
+        std::vector<RHIDynamicState>                     m_dynamic_states;
+        RHIPipelineRenderingCreateInfo                   m_rendering;
+        std::vector<RHIFormat>                           m_color_formats;
+    };
+
+    class VulkanComputePipelineCreateInfoCopy
+    {
+    public:
+        explicit VulkanComputePipelineCreateInfoCopy(const RHIComputePipelineCreateInfo& create_info);
+        VulkanComputePipelineCreateInfoCopy(const VulkanComputePipelineCreateInfoCopy&)            = delete;
+        VulkanComputePipelineCreateInfoCopy& operator=(const VulkanComputePipelineCreateInfoCopy&) = delete;
+
+        const RHIComputePipelineCreateInfo* get() const { return &m_create_info; }
+        bool                                isComplete() const { return m_complete; }
+
+    private:
+        RHIComputePipelineCreateInfo           m_create_info;
+        bool                                   m_complete {true};
+        std::string                            m_name;
+        RHISpecializationInfo                  m_specialization;
+        std::vector<RHISpecializationMapEntry> m_map_entries;
+        std::vector<uint8_t>                   m_data;
+    };
+
+    // worker threads for pipeline compilation, vkCreate*Pipelines may be called from any thread
+    class VulkanPipelineCompileQueue
+    {
+    public:
+        void initialize(uint32_t worker_count);
+        // runs every queued job before joining the workers
+        void shutdown();
+        void push(std::function<void()> job);
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread>          m_workers;
+        std::deque<std::function<void()>> m_jobs;
+        std::mutex                        m_mutex;
+        std::condition_variable           m_condition;
+        bool                              m_stopping {false};
+    };
+} // namespace Aura
@@ -1,28 +1,79 @@
 #include "vulkan_rhi.h"
+#include "../../../util/allocation_counter.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <chrono>
 
 #define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
 
 namespace Aura {
+    template<typename Handle, typename... Fields, typename... Args>
+    Handle VulkanRHI::createHandle(ObjectPool<Handle, Fields...>& table, const Args&... fields)
+    {
+        Handle handle = table.create(fields...);
+        if (handle == nullptr)
+        {
+            throw std::runtime_error("rhi object table exhausted");
+        }
+        return handle;
+    }
+
+    template<typename Handle, typename... Fields>
+    void VulkanRHI::destroyHandle(ObjectPool<Handle, Fields...>& table, Handle handle)
+    {
+        if (handle != nullptr && !table.destroy(handle))
+        {
+            LOG_ERROR("destroying an rhi object that is not alive");
+        }
+    }
+
     void VulkanRHI::initialize() {
         #ifdef NDEBUG
         m_enable_validation_Layers = false;
         #else
         m_enable_validation_Layers = true;
         #endif
-        initWindow();
+        // every per-frame resource is created for the maximum, so the count can change at runtime
+        m_frames_in_flight = std::max(std::min(m_frames_in_flight, (uint32_t)k_max_frames_in_flight), 1u);
+        if (m_headless)
+        {
+            // no surface to present to, so the swapchain extension is not required
+            m_device_extensions.clear();
+        }
+        else
+        {
+            initWindow();
+        }
         createInstance();
         initializeDebugMessenger();
-        createWindowSurface();
+        if (!m_headless)
+        {
+            createWindowSurface();
+        }
         initializePhysicalDevice();
         createLogicalDevice();
+        createAssetAllocator();
         createCommandPool();
+        createUploadManager();
+        createAsyncCompute();
+        createFrameRingBuffer();
+        createBindlessDescriptorSet();
+        createPipelineCache();
         createCommandBuffers();
         createDescriptorPool();
         createSyncPrimitives();
-        createSwapchain();
+        createTimestampQueryPools();
+        if (m_headless)
+        {
+            createOffscreenImages();
+        }
+        else
+        {
+            createSwapchain();
+        }
         createSwapchainImageViews();
         createFramebufferImageAndView();
-        createAssetAllocator();
         std::cout << "initialized" << std::endl;
 
     }
@@ -47,7 +98,7 @@ namespace Aura {
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "No Engine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_3;
+        appInfo.apiVersion = m_vulkan_api_version;
 
         VkInstanceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -100,6 +151,12 @@ namespace Aura {
             {
                 std::cout << "LOG:" << "failed to set up debug messenger!" << std::endl;
             }
+
+            // debug utils is only enabled alongside validation, profiling scopes skip the labels otherwise
+            _vkCmdBeginDebugUtilsLabelEXT =
+                (PFN_vkCmdBeginDebugUtilsLabelEXT)vkGetInstanceProcAddr(m_instance, "vkCmdBeginDebugUtilsLabelEXT");
+            _vkCmdEndDebugUtilsLabelEXT =
+                (PFN_vkCmdEndDebugUtilsLabelEXT)vkGetInstanceProcAddr(m_instance, "vkCmdEndDebugUtilsLabelEXT");
         }
     }
     void VulkanRHI::render_test() {
@@ -119,11 +176,15 @@ namespace Aura {
     }
     
     std::vector<const char*> VulkanRHI::getRequiredExtensions() {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char*> extensions;
+        if (!m_headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (m_enable_validation_Layers) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -226,8 +287,8 @@ namespace Aura {
     bool VulkanRHI::isDeviceSuitable(VkPhysicalDevice physicalm_device) {
         auto queue_indices           = findQueueFamilies(physicalm_device);
         bool is_extensions_supported = checkDeviceExtensionSupport(physicalm_device);
-        bool is_swapchain_adequate   = false;
-        if (is_extensions_supported)
+        bool is_swapchain_adequate   = m_headless;
+        if (is_extensions_supported && !m_headless)
         {
             SwapChainSupportDetails swapchain_support_details = querySwapChainSupport(physicalm_device);
             is_swapchain_adequate =
@@ -292,14 +353,22 @@ namespace Aura {
             }
 
 
-            VkBool32 is_present_support = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physicalm_device,
-                                                 i,
-                                                 m_surface,
-                                                 &is_present_support); // if support surface presentation
-            if (is_present_support)
+            if (m_headless)
+            {
+                // nothing is presented, the graphics queue stands in for the present queue
+                indices.present_family = indices.graphics_family;
+            }
+            else
             {
-                indices.present_family = i;
+                VkBool32 is_present_support = false;
+                vkGetPhysicalDeviceSurfaceSupportKHR(physicalm_device,
+                                                     i,
+                                                     m_surface,
+                                                     &is_present_support); // if support surface presentation
+                if (is_present_support)
+                {
+                    indices.present_family = i;
+                }
             }
 
             if (indices.isComplete())
@@ -311,6 +380,24 @@ namespace Aura {
         return indices;
     }
 
+    bool VulkanRHI::isDeviceExtensionAvailable(VkPhysicalDevice physicalm_device, const char* extension_name)
+    {
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(physicalm_device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(physicalm_device, nullptr, &extension_count, available_extensions.data());
+
+        for (const auto& extension : available_extensions)
+        {
+            if (strcmp(extension.extensionName, extension_name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool VulkanRHI::checkDeviceExtensionSupport(VkPhysicalDevice physicalm_device)
     {
         uint32_t extension_count;
@@ -396,11 +483,102 @@ namespace Aura {
             physical_device_features.geometryShader = VK_TRUE;
         }
 
+        // optional, lets VMA report real per-heap budgets instead of estimates
+        if (isDeviceExtensionAvailable(m_physical_device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+        {
+            m_device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            m_memory_budget_supported = true;
+        }
+
+        // descriptor indexing for the bindless set, core since 1.2
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+        VkPhysicalDeviceVulkan12Features vulkan12_features {};
+        vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        if (physical_device_properties.apiVersion >= VK_API_VERSION_1_2)
+        {
+            VkPhysicalDeviceVulkan12Features supported_vulkan12_features {};
+            supported_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            VkPhysicalDeviceFeatures2 supported_features {};
+            supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supported_features.pNext = &supported_vulkan12_features;
+            vkGetPhysicalDeviceFeatures2(m_physical_device, &supported_features);
+
+            m_bindless_supported = supported_vulkan12_features.descriptorIndexing &&
+                                   supported_vulkan12_features.runtimeDescriptorArray &&
+                                   supported_vulkan12_features.descriptorBindingPartiallyBound &&
+                                   supported_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind &&
+                                   supported_vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind &&
+                                   supported_vulkan12_features.descriptorBindingUpdateUnusedWhilePending &&
+                                   supported_vulkan12_features.shaderSampledImageArrayNonUniformIndexing &&
+                                   supported_vulkan12_features.shaderStorageBufferArrayNonUniformIndexing;
+            m_timeline_semaphore_supported = supported_vulkan12_features.timelineSemaphore;
+        }
+        // optional, measures input-to-present latency up to the display instead of the end of rendering
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features {};
+        present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_features {};
+        present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        present_id_features.pNext = &present_wait_features;
+        if (!m_headless && physical_device_properties.apiVersion >= VK_API_VERSION_1_1 &&
+            isDeviceExtensionAvailable(m_physical_device, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+            isDeviceExtensionAvailable(m_physical_device, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 supported_features {};
+            supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supported_features.pNext = &present_id_features;
+            vkGetPhysicalDeviceFeatures2(m_physical_device, &supported_features);
+            m_present_wait_supported = present_id_features.presentId && present_wait_features.presentWait;
+        }
+        if (m_present_wait_supported)
+        {
+            m_device_extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            m_device_extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+
+        // creation feedback reports pipeline cache hits, core since 1.3
+        m_pipeline_creation_feedback_supported = physical_device_properties.apiVersion >= VK_API_VERSION_1_3;
+
+        // render passes without render pass and framebuffer objects, core since 1.3
+        VkPhysicalDeviceVulkan13Features vulkan13_features {};
+        vulkan13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        if (physical_device_properties.apiVersion >= VK_API_VERSION_1_3)
+        {
+            VkPhysicalDeviceVulkan13Features supported_vulkan13_features {};
+            supported_vulkan13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            VkPhysicalDeviceFeatures2 supported_features {};
+            supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supported_features.pNext = &supported_vulkan13_features;
+            vkGetPhysicalDeviceFeatures2(m_physical_device, &supported_features);
+            m_dynamic_rendering_supported = supported_vulkan13_features.dynamicRendering;
+        }
+        vulkan13_features.dynamicRendering = m_dynamic_rendering_supported;
+
+        if (m_bindless_supported)
+        {
+            vulkan12_features.descriptorIndexing                            = VK_TRUE;
+            vulkan12_features.runtimeDescriptorArray                        = VK_TRUE;
+            vulkan12_features.descriptorBindingPartiallyBound               = VK_TRUE;
+            vulkan12_features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+            vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            vulkan12_features.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+            vulkan12_features.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+            vulkan12_features.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+        }
+        vulkan12_features.timelineSemaphore = m_timeline_semaphore_supported;
+        // the queried feature structs already hold VK_TRUE for what is enabled
+        vulkan13_features.pNext = m_present_wait_supported ? &present_id_features : nullptr;
+        vulkan12_features.pNext = m_dynamic_rendering_supported ? (void*)&vulkan13_features : vulkan13_features.pNext;
+        // the 1.2 struct is invalid in the chain of older devices, everything after it still applies
+        void* device_features_chain = physical_device_properties.apiVersion >= VK_API_VERSION_1_2 ? (void*)&vulkan12_features : vulkan12_features.pNext;
+
         // device create info
         VkDeviceCreateInfo device_create_info {};
         device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         device_create_info.pQueueCreateInfos       = queue_create_infos.data();
         device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
+        device_create_info.pNext                   = device_features_chain;
         device_create_info.pEnabledFeatures        = &physical_device_features;
         device_create_info.enabledExtensionCount   = static_cast<uint32_t>(m_device_extensions.size());
         device_create_info.ppEnabledExtensionNames = m_device_extensions.data();
@@ -414,15 +592,13 @@ namespace Aura {
         // initialize queues of this device
         VkQueue vk_graphics_queue;
         vkGetDeviceQueue(m_device, m_queue_indices.graphics_family.value(), 0, &vk_graphics_queue);
-        m_graphics_queue = new VulkanQueue();
-        ((VulkanQueue*)m_graphics_queue)->setResource(vk_graphics_queue);
+        m_graphics_queue = createHandle(m_queue_table, vk_graphics_queue);
 
         vkGetDeviceQueue(m_device, m_queue_indices.present_family.value(), 0, &m_present_queue);
 
         VkQueue vk_compute_queue;
         vkGetDeviceQueue(m_device, m_queue_indices.m_compute_family.value(), 0, &vk_compute_queue);
-        m_compute_queue = new VulkanQueue();
-        ((VulkanQueue*)m_compute_queue)->setResource(vk_compute_queue);
+        m_compute_queue = createHandle(m_queue_table, vk_compute_queue);
 
         std::cout << "queues:" << std::endl;
         std::cout << vk_graphics_queue << std::endl;
@@ -435,6 +611,11 @@ namespace Aura {
         _vkCmdBeginRenderPass    = (PFN_vkCmdBeginRenderPass)vkGetDeviceProcAddr(m_device, "vkCmdBeginRenderPass");
         _vkCmdNextSubpass        = (PFN_vkCmdNextSubpass)vkGetDeviceProcAddr(m_device, "vkCmdNextSubpass");
         _vkCmdEndRenderPass      = (PFN_vkCmdEndRenderPass)vkGetDeviceProcAddr(m_device, "vkCmdEndRenderPass");
+        if (m_dynamic_rendering_supported)
+        {
+            _vkCmdBeginRendering = (PFN_vkCmdBeginRendering)vkGetDeviceProcAddr(m_device, "vkCmdBeginRendering");
+            _vkCmdEndRendering   = (PFN_vkCmdEndRendering)vkGetDeviceProcAddr(m_device, "vkCmdEndRendering");
+        }
         _vkCmdBindPipeline       = (PFN_vkCmdBindPipeline)vkGetDeviceProcAddr(m_device, "vkCmdBindPipeline");
         _vkCmdSetViewport        = (PFN_vkCmdSetViewport)vkGetDeviceProcAddr(m_device, "vkCmdSetViewport");
         _vkCmdSetScissor         = (PFN_vkCmdSetScissor)vkGetDeviceProcAddr(m_device, "vkCmdSetScissor");
@@ -445,6 +626,10 @@ namespace Aura {
         _vkCmdBindIndexBuffer    = (PFN_vkCmdBindIndexBuffer)vkGetDeviceProcAddr(m_device, "vkCmdBindIndexBuffer");
         _vkCmdBindDescriptorSets = (PFN_vkCmdBindDescriptorSets)vkGetDeviceProcAddr(m_device, "vkCmdBindDescriptorSets");
         _vkCmdClearAttachments   = (PFN_vkCmdClearAttachments)vkGetDeviceProcAddr(m_device, "vkCmdClearAttachments");
+        if (m_present_wait_supported)
+        {
+            _vkWaitForPresentKHR = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR");
+        }
 
         m_depth_image_format = (RHIFormat)findDepthFormat();
     }
@@ -480,7 +665,6 @@ namespace Aura {
     {
         // default graphics command pool
         {
-            m_rhi_command_pool = new VulkanCommandPool();
             VkCommandPool vk_command_pool;
             VkCommandPoolCreateInfo command_pool_create_info {};
             command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -493,7 +677,7 @@ namespace Aura {
                 LOG_ERROR("vk create command pool");
             }
 
-            ((VulkanCommandPool*)m_rhi_command_pool)->setResource(vk_command_pool);
+            m_rhi_command_pool = createHandle(m_command_pool_table, vk_command_pool);
         }
 
         // other command pools
@@ -512,6 +696,14 @@ namespace Aura {
                 }
             }
         }
+
+        // per recording thread, per frame pools for secondaries
+        m_parallel_recorder.initialize(m_device,
+                                       m_queue_indices.graphics_family.value(),
+                                       m_job_system,
+                                       m_recording_worker_threads + 1,
+                                       k_max_frames_in_flight,
+                                       &m_command_buffer_table);
         LOG_ERROR("SUCCESS:vk create command pool ");
     }
 
@@ -531,8 +723,7 @@ namespace Aura {
                 LOG_ERROR("vk allocate command buffers");
             }
             m_vk_command_buffers[i] = vk_command_buffer;
-            m_command_buffers[i] = new VulkanCommandBuffer();
-            ((VulkanCommandBuffer*)m_command_buffers[i])->setResource(vk_command_buffer);
+            m_command_buffers[i] = createHandle(m_command_buffer_table, vk_command_buffer);
         }
     }
 
@@ -542,7 +733,7 @@ namespace Aura {
         // should be big enough, and thus we can sub-allocate DescriptorSet from
         // DescriptorPool merely as we sub-allocate Buffer/Image from DeviceMemory.
 
-        VkDescriptorPoolSize pool_sizes[7];
+        std::vector<VkDescriptorPoolSize> pool_sizes(7);
         pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
         pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
         pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -558,21 +749,35 @@ namespace Aura {
         pool_sizes[6].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
         pool_sizes[6].descriptorCount = 1;
 
-        VkDescriptorPoolCreateInfo pool_info {};
-        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
-        pool_info.pPoolSizes    = pool_sizes;
-        pool_info.maxSets =
+        uint32_t max_sets =
             1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1; // +skybox + axis descriptor set
-        pool_info.flags = 0U;
 
-        if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_vk_descriptor_pool) != VK_SUCCESS)
+        // the sizes above are the first pool, more pools are chained when it runs out
+        m_descriptor_allocator.initialize(m_device, pool_sizes, max_sets, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+        m_vk_descriptor_pool = m_descriptor_allocator.getFirstPool();
+
+        m_descriptor_pool = createHandle(m_descriptor_pool_table, m_vk_descriptor_pool);
+
+        // transient pools, sized for an average set
+        std::vector<VkDescriptorPoolSize> frame_pool_sizes(7);
+        frame_pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        frame_pool_sizes[0].descriptorCount = 1 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        frame_pool_sizes[1].descriptorCount = 1 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        frame_pool_sizes[2].descriptorCount = 2 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[3].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        frame_pool_sizes[3].descriptorCount = 1 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[4].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        frame_pool_sizes[4].descriptorCount = 4 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[5].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        frame_pool_sizes[5].descriptorCount = 1 * m_frame_descriptor_sets_per_pool;
+        frame_pool_sizes[6].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        frame_pool_sizes[6].descriptorCount = 1 * m_frame_descriptor_sets_per_pool;
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
         {
-            LOG_ERROR("create descriptor pool");
+            m_frame_descriptor_allocators[i].initialize(m_device, frame_pool_sizes, m_frame_descriptor_sets_per_pool, 0U);
         }
-
-        m_descriptor_pool = new VulkanDescriptorPool();
-        ((VulkanDescriptorPool*)m_descriptor_pool)->setResource(m_vk_descriptor_pool);
     }
 
 
@@ -587,7 +792,7 @@ namespace Aura {
 
         for (uint32_t i = 0; i < k_max_frames_in_flight; i++)
         {
-            m_image_available_for_texturescopy_semaphores[i] = new VulkanSemaphore();
+            VkSemaphore vk_texturescopy_semaphore;
             if (vkCreateSemaphore(
                     m_device, &semaphore_create_info, nullptr, &m_image_available_for_render_semaphores[i]) !=
                     VK_SUCCESS ||
@@ -595,19 +800,74 @@ namespace Aura {
                     m_device, &semaphore_create_info, nullptr, &m_image_finished_for_presentation_semaphores[i]) !=
                     VK_SUCCESS ||
                 vkCreateSemaphore(
-                    m_device, &semaphore_create_info, nullptr, &(((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[i])->getResource())) !=
+                    m_device, &semaphore_create_info, nullptr, &vk_texturescopy_semaphore) !=
                     VK_SUCCESS ||
                 vkCreateFence(m_device, &fence_create_info, nullptr, &m_is_frame_in_flight_fences[i]) != VK_SUCCESS)
             {
                 LOG_ERROR("vk create semaphore & fence");
             }
 
-            m_rhi_is_frame_in_flight_fences[i] = new VulkanFence();
-            ((VulkanFence*)m_rhi_is_frame_in_flight_fences[i])->setResource(m_is_frame_in_flight_fences[i]);
+            m_image_available_for_texturescopy_semaphores[i] = createHandle(m_semaphore_table, vk_texturescopy_semaphore);
+            m_rhi_is_frame_in_flight_fences[i]               = createHandle(m_fence_table, m_is_frame_in_flight_fences[i]);
+        }
+
+        if (m_timeline_semaphore_supported)
+        {
+            VkSemaphoreTypeCreateInfo semaphore_type_create_info {};
+            semaphore_type_create_info.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            semaphore_type_create_info.initialValue  = 0;
+
+            VkSemaphoreCreateInfo timeline_create_info {};
+            timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            timeline_create_info.pNext = &semaphore_type_create_info;
+            if (vkCreateSemaphore(m_device, &timeline_create_info, nullptr, &m_frame_timeline_semaphore) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk create timeline semaphore, falling back to fences");
+                m_frame_timeline_semaphore     = VK_NULL_HANDLE;
+                m_timeline_semaphore_supported = false;
+            }
+        }
+    }
+
+    void VulkanRHI::createTimestampQueryPools()
+    {
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, queue_families.data());
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+        uint32_t timestamp_valid_bits = queue_families[m_queue_indices.graphics_family.value()].timestampValidBits;
+        if (timestamp_valid_bits == 0 || physical_device_properties.limits.timestampPeriod == 0.0f)
+        {
+            LOG_ERROR("graphics queue does not support timestamps, gpu profiling disabled");
+            return;
+        }
+        m_timestamp_period     = physical_device_properties.limits.timestampPeriod;
+        m_timestamp_valid_mask = timestamp_valid_bits >= 64 ? ~0ull : ((1ull << timestamp_valid_bits) - 1);
+
+        VkQueryPoolCreateInfo query_pool_create_info {};
+        query_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_create_info.queryCount = 2 * k_max_gpu_profile_scopes;
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (vkCreateQueryPool(m_device, &query_pool_create_info, nullptr, &m_timestamp_query_pools[i]) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk create query pool");
+                m_timestamp_query_pools[i] = VK_NULL_HANDLE;
+            }
+            m_gpu_profile_scopes[i].reserve(k_max_gpu_profile_scopes);
         }
+        m_gpu_profile_scope_stack.reserve(k_max_gpu_profile_scopes);
+        m_timestamp_results.resize(2 * k_max_gpu_profile_scopes);
     }
 
-    void VulkanRHI::createSwapchain()
+    void VulkanRHI::createSwapchain(VkSwapchainKHR old_swapchain)
     {
         // query all supports of this physical device
         SwapChainSupportDetails swapchain_support_details = querySwapChainSupport(m_physical_device);
@@ -655,9 +915,11 @@ namespace Aura {
         createInfo.preTransform   = swapchain_support_details.capabilities.currentTransform;
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode    = chosen_presentMode;
+        m_active_present_mode     = (RHIPresentMode)chosen_presentMode;
         createInfo.clipped        = VK_TRUE;
 
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        // lets the driver hand resources over and keeps the old swapchain's queued presents valid
+        createInfo.oldSwapchain = old_swapchain;
 
         if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapchain) != VK_SUCCESS)
         {
@@ -694,14 +956,25 @@ namespace Aura {
     VkPresentModeKHR
     VulkanRHI::chooseSwapchainPresentModeFromDetails(const std::vector<VkPresentModeKHR>& available_present_modes)
     {
-        for (VkPresentModeKHR present_mode : available_present_modes)
+        // substitutes keep the tearing and blocking behaviour as close as possible, FIFO is always supported
+        std::vector<VkPresentModeKHR> candidates {(VkPresentModeKHR)m_present_mode};
+        if (m_present_mode == RHI_PRESENT_MODE_IMMEDIATE_KHR)
+        {
+            candidates.push_back(VK_PRESENT_MODE_MAILBOX_KHR);
+        }
+        else if (m_present_mode == RHI_PRESENT_MODE_FIFO_RELAXED_KHR)
+        {
+            candidates.push_back(VK_PRESENT_MODE_FIFO_KHR);
+        }
+
+        for (VkPresentModeKHR candidate : candidates)
         {
-            if (VK_PRESENT_MODE_MAILBOX_KHR == present_mode)
+            if (std::find(available_present_modes.begin(), available_present_modes.end(), candidate) !=
+                available_present_modes.end())
             {
-                return VK_PRESENT_MODE_MAILBOX_KHR;
+                return candidate;
             }
         }
-
         return VK_PRESENT_MODE_FIFO_KHR;
     }
 
@@ -730,6 +1003,7 @@ namespace Aura {
     void VulkanRHI::createSwapchainImageViews()
     {
         m_swapchain_imageviews.resize(m_swapchain_images.size());
+        m_swapchain_rhi_images.resize(m_swapchain_images.size());
 
         // create imageview (one for each this time) for all swapchain images
         for (size_t i = 0; i < m_swapchain_images.size(); i++)
@@ -742,30 +1016,77 @@ namespace Aura {
                                                                    VK_IMAGE_VIEW_TYPE_2D,
                                                                    1,
                                                                    1);
-            m_swapchain_imageviews[i] = new VulkanImageView();
-            ((VulkanImageView*)m_swapchain_imageviews[i])->setResource(vk_image_view);
+            m_swapchain_imageviews[i] = createHandle(m_image_view_table, vk_image_view);
+            m_swapchain_rhi_images[i] = createHandle(m_image_table, m_swapchain_images[i]);
+        }
+    }
+
+    void VulkanRHI::createOffscreenImages()
+    {
+        // one color target per frame in flight, so an image is only reused once its frame fence signaled
+        m_swapchain_image_format  = RHI_FORMAT_R8G8B8A8_UNORM;
+        m_swapchain_extent.width  = WIDTH;
+        m_swapchain_extent.height = HEIGHT;
+        m_scissor = {{0, 0}, {m_swapchain_extent.width, m_swapchain_extent.height}};
+
+        m_swapchain_images.resize(k_max_frames_in_flight);
+        m_offscreen_image_allocations.resize(k_max_frames_in_flight);
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            VulkanUtil::createImage(m_assets_allocator,
+                                    m_swapchain_extent.width,
+                                    m_swapchain_extent.height,
+                                    (VkFormat)m_swapchain_image_format,
+                                    VK_IMAGE_TILING_OPTIMAL,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    m_swapchain_images[i],
+                                    m_offscreen_image_allocations[i],
+                                    0,
+                                    1,
+                                    1);
         }
     }
 
     void VulkanRHI::createFramebufferImageAndView()
     {
-        VulkanUtil::createImage(m_physical_device,
-                                m_device,
-                                m_swapchain_extent.width,
-                                m_swapchain_extent.height,
-                                (VkFormat)m_depth_image_format,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
-                                VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                ((VulkanImage*)m_depth_image)->getResource(),
-                                m_depth_image_memory,
-                                0,
-                                1,
-                                1);
-
-        ((VulkanImageView*)m_depth_image_view)->setResource(
-            VulkanUtil::createImageView(m_device, ((VulkanImage*)m_depth_image)->getResource(), (VkFormat)m_depth_image_format, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1));
+        // depth is never stored past the render pass that clears it, so it can live in tile memory only.
+        // plain device local memory is the fallback when no lazily allocated type accepts the image
+        VkMemoryPropertyFlags depth_memory_properties[] = {
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+        VkImage vk_depth_image   = VK_NULL_HANDLE;
+        m_depth_image_allocation = nullptr;
+        for (uint32_t i = m_lazily_allocated_memory_supported ? 0 : 1; i < 2 && m_depth_image_allocation == nullptr; ++i)
+        {
+            VulkanUtil::createImage(m_assets_allocator,
+                                    m_swapchain_extent.width,
+                                    m_swapchain_extent.height,
+                                    (VkFormat)m_depth_image_format,
+                                    VK_IMAGE_TILING_OPTIMAL,
+                                    VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                    VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                                    depth_memory_properties[i],
+                                    vk_depth_image,
+                                    m_depth_image_allocation,
+                                    0,
+                                    1,
+                                    1);
+        }
+
+        VkImageView vk_depth_image_view = VulkanUtil::createImageView(
+            m_device, vk_depth_image, (VkFormat)m_depth_image_format, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+
+        // the handles outlive swapchain recreation, only the vulkan objects behind them are replaced
+        if (m_depth_image == nullptr)
+        {
+            m_depth_image      = createHandle(m_image_table, vk_depth_image);
+            m_depth_image_view = createHandle(m_image_view_table, vk_depth_image_view);
+        }
+        else
+        {
+            m_image_table.set(m_depth_image, vk_depth_image);
+            m_image_view_table.set(m_depth_image_view, vk_depth_image_view);
+        }
     }
     
     void VulkanRHI::createAssetAllocator()
@@ -774,175 +1095,1223 @@ namespace Aura {
         vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
         vulkanFunctions.vkGetDeviceProcAddr   = &vkGetDeviceProcAddr;
 
+        // VMA must not assume a newer core version than the device actually implements
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+        uint32_t allocator_api_version = std::min(m_vulkan_api_version, physical_device_properties.apiVersion);
+
         VmaAllocatorCreateInfo allocatorCreateInfo = {};
-        allocatorCreateInfo.vulkanApiVersion       = m_vulkan_api_version;
+        allocatorCreateInfo.vulkanApiVersion       = allocator_api_version;
         allocatorCreateInfo.physicalDevice         = m_physical_device;
         allocatorCreateInfo.device                 = m_device;
         allocatorCreateInfo.instance               = m_instance;
         allocatorCreateInfo.pVulkanFunctions       = &vulkanFunctions;
 
-        vmaCreateAllocator(&allocatorCreateInfo, &m_assets_allocator);
+        if (m_memory_budget_supported)
+        {
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
+
+        if (vmaCreateAllocator(&allocatorCreateInfo, &m_assets_allocator) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vmaCreateAllocator failed");
+        }
+
+        // tilers expose it, desktop gpus usually do not
+        VkPhysicalDeviceMemoryProperties memory_properties;
+        vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+        for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+        {
+            if (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+            {
+                m_lazily_allocated_memory_supported = true;
+            }
+        }
+    }
+
+    void VulkanRHI::createUploadManager()
+    {
+        m_upload_manager.initialize(m_device,
+                                    m_assets_allocator,
+                                    m_queue_table.get(m_graphics_queue),
+                                    m_queue_indices.graphics_family.value(),
+                                    m_upload_ring_size,
+                                    &m_buffer_table);
+
+        VkFenceCreateInfo fence_create_info {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(m_device, &fence_create_info, nullptr, &m_single_time_commands_fence) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk create single time commands fence");
+        }
     }
 
-    void VulkanRHI::waitForFences() {
-        VkResult res_wait_for_fences =
-            _vkWaitForFences(m_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index], VK_TRUE, UINT64_MAX);
-        if (VK_SUCCESS != res_wait_for_fences)
+    void VulkanRHI::createAsyncCompute()
+    {
+        m_async_compute.initialize(m_device,
+                                   m_queue_table.get(m_compute_queue),
+                                   m_queue_indices.m_compute_family.value(),
+                                   k_max_frames_in_flight);
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
         {
-            LOG_ERROR("failed to synchronize!");
+            m_compute_command_buffers[i] = createHandle(m_command_buffer_table, (VkCommandBuffer)VK_NULL_HANDLE);
         }
     }
 
-    void VulkanRHI::prepareBeforePass() {
-        VkResult acquire_image_result =
-            vkAcquireNextImageKHR(m_device,
-                                  m_swapchain,
-                                  UINT64_MAX,
-                                  m_image_available_for_render_semaphores[m_current_frame_index],
-                                  VK_NULL_HANDLE,
-                                  &m_current_swapchain_image_index);
+    void VulkanRHI::createFrameRingBuffer()
+    {
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+        VkDeviceSize alignment = std::max(physical_device_properties.limits.minUniformBufferOffsetAlignment,
+                                          physical_device_properties.limits.minStorageBufferOffsetAlignment);
+
+        m_frame_ring_buffer.initialize(m_assets_allocator,
+                                       m_frame_ring_buffer_size,
+                                       k_max_frames_in_flight,
+                                       alignment,
+                                       VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                       &m_buffer_table);
+    }
 
-        if (acquire_image_result == VK_ERROR_OUT_OF_DATE_KHR) {
-            recreateSwapChain();
+    void VulkanRHI::createBindlessDescriptorSet()
+    {
+        if (!m_bindless_supported)
+        {
+            LOG_ERROR("descriptor indexing not supported, bindless mode disabled");
             return;
-        } 
-        else if (acquire_image_result != VK_SUCCESS && acquire_image_result != VK_SUBOPTIMAL_KHR) {
-            throw std::runtime_error("failed to acquire swap chain image!");
         }
-        std::cout << "image success" << std::endl;
-        vkResetFences(m_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index]);
-        //vkResetCommandBuffer(m_vk_command_buffers[m_current_frame_index], /*VkCommandBufferResetFlagBits*/ 0);
-        VkSemaphore signalSemaphores[] = { m_image_finished_for_presentation_semaphores[m_current_frame_index] };
 
-        VkPresentInfoKHR presentInfo{};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        VkPhysicalDeviceDescriptorIndexingProperties descriptor_indexing_properties {};
+        descriptor_indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+        VkPhysicalDeviceProperties2 physical_device_properties {};
+        physical_device_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        physical_device_properties.pNext = &descriptor_indexing_properties;
+        vkGetPhysicalDeviceProperties2(m_physical_device, &physical_device_properties);
+
+        uint32_t texture_capacity =
+            std::min({m_max_bindless_textures,
+                      descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                      descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages});
+        uint32_t buffer_capacity =
+            std::min({m_max_bindless_buffers,
+                      descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                      descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+
+        VkDescriptorPoolSize pool_sizes[2];
+        pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_sizes[0].descriptorCount = texture_capacity;
+        pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_sizes[1].descriptorCount = buffer_capacity;
 
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
+        VkDescriptorPoolCreateInfo pool_info {};
+        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_info.maxSets       = 1;
+        pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
+        pool_info.pPoolSizes    = pool_sizes;
+        if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_bindless_descriptor_pool) != VK_SUCCESS)
+        {
+            LOG_ERROR("create bindless descriptor pool");
+            m_bindless_supported = false;
+            return;
+        }
 
-        VkSwapchainKHR swapChains[] = { m_swapchain };
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = swapChains;
+        // slots are written while the set is bound and unused slots are never touched by shaders
+        VkDescriptorBindingFlags binding_flags[2];
+        binding_flags[0] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        binding_flags[1] = binding_flags[0];
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info {};
+        binding_flags_create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_create_info.bindingCount  = sizeof(binding_flags) / sizeof(binding_flags[0]);
+        binding_flags_create_info.pBindingFlags = binding_flags;
+
+        RHIDescriptorSetLayoutBinding bindings[2];
+        bindings[0].binding            = k_bindless_texture_binding;
+        bindings[0].descriptorType     = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount    = texture_capacity;
+        bindings[0].stageFlags         = RHI_SHADER_STAGE_ALL;
+        bindings[0].pImmutableSamplers = nullptr;
+        bindings[1].binding            = k_bindless_buffer_binding;
+        bindings[1].descriptorType     = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount    = buffer_capacity;
+        bindings[1].stageFlags         = RHI_SHADER_STAGE_ALL;
+        bindings[1].pImmutableSamplers = nullptr;
+
+        RHIDescriptorSetLayoutCreateInfo layout_info {};
+        layout_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.pNext        = &binding_flags_create_info;
+        layout_info.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layout_info.bindingCount = sizeof(bindings) / sizeof(bindings[0]);
+        layout_info.pBindings    = bindings;
+        if (createDescriptorSetLayout(&layout_info, m_bindless_descriptor_set_layout) != RHI_SUCCESS)
+        {
+            m_bindless_supported = false;
+            return;
+        }
 
-        presentInfo.pImageIndices = &m_current_swapchain_image_index;
+        VkDescriptorSetLayout vk_layout = m_descriptor_set_layout_table.get(m_bindless_descriptor_set_layout);
+        VkDescriptorSetAllocateInfo allocate_info {};
+        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool     = m_bindless_descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts        = &vk_layout;
 
-        // 提交显示
-        VkResult result = vkQueuePresentKHR(m_present_queue, &presentInfo);
+        VkDescriptorSet vk_descriptor_set;
+        if (vkAllocateDescriptorSets(m_device, &allocate_info, &vk_descriptor_set) != VK_SUCCESS)
+        {
+            LOG_ERROR("allocate bindless descriptor set");
+            m_bindless_supported = false;
+            return;
+        }
+        m_bindless_descriptor_set = createHandle(m_descriptor_set_table, vk_descriptor_set);
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized) {
-            framebufferResized = false;
-            recreateSwapChain();
+        // popped from the back, so slot 0 is handed out first
+        m_bindless_free_textures.resize(texture_capacity);
+        for (uint32_t i = 0; i < texture_capacity; ++i)
+        {
+            m_bindless_free_textures[i] = texture_capacity - 1 - i;
         }
-        else if (result != VK_SUCCESS) {
-            throw std::runtime_error("failed to present swap chain image!");
+        m_bindless_free_buffers.resize(buffer_capacity);
+        for (uint32_t i = 0; i < buffer_capacity; ++i)
+        {
+            m_bindless_free_buffers[i] = buffer_capacity - 1 - i;
         }
-        m_current_frame_index = (m_current_frame_index + 1) % 2;
     }
 
-    void VulkanRHI::recreateSwapChain() {
-        int width  = 0;
-        int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) // minimized 0,0, pause for now
+    void VulkanRHI::createPipelineCache()
+    {
+        m_pipeline_cache.initialize(m_device, m_physical_device, m_pipeline_cache_path);
+        m_pipeline_compile_queue.initialize(m_pipeline_compile_threads);
+    }
+
+    void VulkanRHI::shutdown()
+    {
+        m_pipeline_compile_queue.shutdown();
+        vkDeviceWaitIdle(m_device);
+        runDeferredDestroys(m_submitted_frame_serial);
+        m_async_compute.shutdown();
+        // cached objects outlive their last reference, framebuffers go first since they name render passes
+        m_framebuffer_cache.clear([this](RHIFramebuffer framebuffer) {
+            vkDestroyFramebuffer(m_device, m_framebuffer_table.get(framebuffer), nullptr);
+            destroyHandle(m_framebuffer_table, framebuffer);
+        });
+        m_render_pass_cache.clear([this](RHIRenderPass render_pass) {
+            vkDestroyRenderPass(m_device, m_render_pass_table.get(render_pass), nullptr);
+            destroyHandle(m_render_pass_table, render_pass);
+        });
+        m_descriptor_set_layout_cache.clear([this](RHIDescriptorSetLayout set_layout) {
+            vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout_table.get(set_layout), nullptr);
+            destroyHandle(m_descriptor_set_layout_table, set_layout);
+        });
+        m_sampler_cache.clear([this](RHISampler sampler) {
+            vkDestroySampler(m_device, m_sampler_table.get(sampler), nullptr);
+            destroyHandle(m_sampler_table, sampler);
+        });
+        m_parallel_recorder.shutdown();
+        m_pipeline_cache.save();
+    }
+
+    void VulkanRHI::waitForFences() {
+        updateFrameLatency();
+        // help with queued jobs while the frame is still in flight, block only once there is nothing left to run
+        if (m_job_system != nullptr)
         {
-            glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            while (getCompletedFrameSerial() < m_frame_serials[m_current_frame_index] && m_job_system->runPendingJob())
+            {
+            }
         }
-
-        VkResult res_wait_for_fences =
-            _vkWaitForFences(m_device, k_max_frames_in_flight, m_is_frame_in_flight_fences, VK_TRUE, UINT64_MAX);
-        if (VK_SUCCESS != res_wait_for_fences)
+        if (!waitForFrameSerial(m_frame_serials[m_current_frame_index]))
         {
-            LOG_ERROR("_vkWaitForFences failed");
+            LOG_ERROR("failed to synchronize!");
             return;
         }
+        updateFrameLatency();
+        m_heap_allocation_mark = getGlobalNewCount();
+
+        m_upload_manager.update();
+        runDeferredDestroys(m_completed_frame_serial);
+        recycleFrame(m_current_frame_index);
+        m_frame_begin_times[m_current_frame_index] = std::chrono::steady_clock::now();
+        m_frame_input_times[m_current_frame_index] = m_frame_begin_times[m_current_frame_index];
+
+        uint64_t scratch_heap_allocations = ScratchArena::getHeapAllocationCount();
+        m_frame_scratch_heap_allocations  = scratch_heap_allocations - m_scratch_heap_allocation_mark;
+        m_scratch_heap_allocation_mark    = scratch_heap_allocations;
+        assert(!m_assert_allocation_free_frames || m_frame_scratch_heap_allocations == 0);
+    }
 
-        destroyImageView(m_depth_image_view);
-        vkDestroyImage(m_device, ((VulkanImage*)m_depth_image)->getResource(), NULL);
-        vkFreeMemory(m_device, m_depth_image_memory, NULL);
+    void VulkanRHI::deferDestroy(std::function<void()> destroy)
+    {
+        m_deferred_destroys.emplace_back(m_submitted_frame_serial, std::move(destroy));
+    }
 
-        for (auto imageview : m_swapchain_imageviews)
+    void VulkanRHI::runDeferredDestroys(uint64_t completed_serial)
+    {
+        while (!m_deferred_destroys.empty() && m_deferred_destroys.front().first <= completed_serial)
         {
-            vkDestroyImageView(m_device, ((VulkanImageView*)imageview)->getResource(), NULL);
+            m_deferred_destroys.front().second();
+            m_deferred_destroys.pop_front();
         }
-        vkDestroySwapchainKHR(m_device, m_swapchain, NULL);
-
-        createSwapchain();
-        createSwapchainImageViews();
-        createFramebufferImageAndView();
     }
 
-    void VulkanRHI::destroyImageView(RHIImageView* imageView) {
-        vkDestroyImageView(m_device, ((VulkanImageView*)imageView)->getResource(), nullptr);
+    void VulkanRHI::markInputSampled()
+    {
+        m_frame_input_times[m_current_frame_index] = std::chrono::steady_clock::now();
     }
 
-    bool VulkanRHI::createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass)
+    void VulkanRHI::setPresentMode(RHIPresentMode mode)
     {
-        // attachment convert
-        std::vector<VkAttachmentDescription> vk_attachments(pCreateInfo->attachmentCount);
-        for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i)
+        m_present_mode = mode;
+        if (!m_headless && m_swapchain != VK_NULL_HANDLE)
         {
-            const auto& rhi_desc = pCreateInfo->pAttachments[i];
-            auto& vk_desc = vk_attachments[i];
-
-            vk_desc.flags = (VkAttachmentDescriptionFlags)(rhi_desc).flags;
-            vk_desc.format = (VkFormat)(rhi_desc).format;
-            vk_desc.samples = (VkSampleCountFlagBits)(rhi_desc).samples;
-            vk_desc.loadOp = (VkAttachmentLoadOp)(rhi_desc).loadOp;
-            vk_desc.storeOp = (VkAttachmentStoreOp)(rhi_desc).storeOp;
-            vk_desc.stencilLoadOp = (VkAttachmentLoadOp)(rhi_desc).stencilLoadOp;
-            vk_desc.stencilStoreOp = (VkAttachmentStoreOp)(rhi_desc).stencilStoreOp;
-            vk_desc.initialLayout = (VkImageLayout)(rhi_desc).initialLayout;
-            vk_desc.finalLayout = (VkImageLayout)(rhi_desc).finalLayout;
-        };
+            m_present_mode_changed = true;
+        }
+    }
 
-        // subpass convert
-        int totalAttachmentRefenrence = 0;
-        for (uint32_t i = 0; i < pCreateInfo->subpassCount; i++)
+    void VulkanRHI::recycleFrame(uint32_t frame_index)
+    {
+        m_frame_ring_buffer.beginFrame(frame_index);
+
+        m_frame_descriptor_allocators[frame_index].reset();
+        m_frame_descriptor_set_handle_count[frame_index] = 0;
+
+        m_bindless_free_textures.insert(m_bindless_free_textures.end(),
+                                        m_bindless_retired_textures[frame_index].begin(),
+                                        m_bindless_retired_textures[frame_index].end());
+        m_bindless_retired_textures[frame_index].clear();
+        m_bindless_free_buffers.insert(m_bindless_free_buffers.end(),
+                                       m_bindless_retired_buffers[frame_index].begin(),
+                                       m_bindless_retired_buffers[frame_index].end());
+        m_bindless_retired_buffers[frame_index].clear();
+
+        // the frame has completed, so its timestamps are available without stalling
+        std::vector<GpuProfileScopeRecord>& scopes = m_gpu_profile_scopes[frame_index];
+        if (!scopes.empty())
         {
-            const auto& rhi_desc = pCreateInfo->pSubpasses[i];
-            totalAttachmentRefenrence += rhi_desc.inputAttachmentCount; // pInputAttachments
-            totalAttachmentRefenrence += rhi_desc.colorAttachmentCount; // pColorAttachments
-            if (rhi_desc.pDepthStencilAttachment != nullptr)
+            VkResult res_query_results = vkGetQueryPoolResults(m_device,
+                                                               m_timestamp_query_pools[frame_index],
+                                                               0,
+                                                               2 * (uint32_t)scopes.size(),
+                                                               sizeof(uint64_t) * 2 * scopes.size(),
+                                                               m_timestamp_results.data(),
+                                                               sizeof(uint64_t),
+                                                               VK_QUERY_RESULT_64_BIT);
+            if (VK_SUCCESS == res_query_results)
             {
-                totalAttachmentRefenrence += rhi_desc.colorAttachmentCount; // pDepthStencilAttachment
+                m_gpu_pass_timings.resize(scopes.size());
+                for (size_t i = 0; i < scopes.size(); ++i)
+                {
+                    uint64_t begin = m_timestamp_results[scopes[i].begin_query] & m_timestamp_valid_mask;
+                    uint64_t end   = m_timestamp_results[scopes[i].begin_query + 1] & m_timestamp_valid_mask;
+
+                    std::memcpy(m_gpu_pass_timings[i].name, scopes[i].name, sizeof(scopes[i].name));
+                    m_gpu_pass_timings[i].depth = scopes[i].depth;
+                    m_gpu_pass_timings[i].ms    = (float)((double)((end - begin) & m_timestamp_valid_mask) * m_timestamp_period / 1000000.0);
+                }
+                m_gpu_frame_time_ms = m_gpu_pass_timings[0].ms;
             }
-            if (rhi_desc.pResolveAttachments != nullptr)
+            scopes.clear();
+        }
+    }
+
+    uint64_t VulkanRHI::getCompletedFrameSerial()
+    {
+        if (m_timeline_semaphore_supported)
+        {
+            uint64_t value = 0;
+            if (vkGetSemaphoreCounterValue(m_device, m_frame_timeline_semaphore, &value) == VK_SUCCESS)
             {
-                totalAttachmentRefenrence += rhi_desc.colorAttachmentCount; // pResolveAttachments
+                m_completed_frame_serial = std::max(m_completed_frame_serial, value);
             }
+            return m_completed_frame_serial;
         }
-        std::vector<VkSubpassDescription> vk_subpass_description(pCreateInfo->subpassCount);
-        std::vector<VkAttachmentReference> vk_attachment_reference(totalAttachmentRefenrence);
-        int currentAttachmentRefence = 0;
-        for (uint32_t i = 0; i < pCreateInfo->subpassCount; ++i)
-        {
-            const auto& rhi_desc = pCreateInfo->pSubpasses[i];
-            auto& vk_desc = vk_subpass_description[i];
-
-            vk_desc.flags = (VkSubpassDescriptionFlags)(rhi_desc).flags;
-            vk_desc.pipelineBindPoint = (VkPipelineBindPoint)(rhi_desc).pipelineBindPoint;
-            vk_desc.preserveAttachmentCount = (rhi_desc).preserveAttachmentCount;
-            vk_desc.pPreserveAttachments = (const uint32_t*)(rhi_desc).pPreserveAttachments;
 
-            vk_desc.inputAttachmentCount = (rhi_desc).inputAttachmentCount;
-            vk_desc.pInputAttachments = &vk_attachment_reference[currentAttachmentRefence];
-            for (uint32_t i = 0; i < (rhi_desc).inputAttachmentCount; i++)
+        // frames complete in submit order, so any signaled fence covers every older frame
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (m_frame_serials[i] > m_completed_frame_serial &&
+                vkGetFenceStatus(m_device, m_is_frame_in_flight_fences[i]) == VK_SUCCESS)
             {
-                const auto& rhi_attachment_refence_input = (rhi_desc).pInputAttachments[i];
-                auto& vk_attachment_refence_input = vk_attachment_reference[currentAttachmentRefence];
-
-                vk_attachment_refence_input.attachment = rhi_attachment_refence_input.attachment;
-                vk_attachment_refence_input.layout = (VkImageLayout)(rhi_attachment_refence_input.layout);
+                m_completed_frame_serial = m_frame_serials[i];
+            }
+        }
+        return m_completed_frame_serial;
+    }
 
-                currentAttachmentRefence += 1;
-            };
+    bool VulkanRHI::waitForFrameSerial(uint64_t serial)
+    {
+        if (serial <= m_completed_frame_serial)
+        {
+            return true;
+        }
 
-            vk_desc.colorAttachmentCount = (rhi_desc).colorAttachmentCount;
-            vk_desc.pColorAttachments = &vk_attachment_reference[currentAttachmentRefence];
-            for (uint32_t i = 0; i < (rhi_desc).colorAttachmentCount; ++i)
+        if (m_timeline_semaphore_supported)
+        {
+            VkSemaphoreWaitInfo wait_info {};
+            wait_info.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.semaphoreCount = 1;
+            wait_info.pSemaphores    = &m_frame_timeline_semaphore;
+            wait_info.pValues        = &serial;
+            if (vkWaitSemaphores(m_device, &wait_info, UINT64_MAX) != VK_SUCCESS)
             {
-                const auto& rhi_attachment_refence_color = (rhi_desc).pColorAttachments[i];
+                return false;
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+            {
+                if (m_frame_serials[i] == serial)
+                {
+                    if (_vkWaitForFences(m_device, 1, &m_is_frame_in_flight_fences[i], VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        m_completed_frame_serial = serial;
+        return true;
+    }
+
+    void VulkanRHI::updateFrameLatency()
+    {
+        if (m_present_wait_supported)
+        {
+            updatePresentLatency();
+        }
+
+        // frames finishing between two polls are stamped at the later one, the blocking wait in
+        // waitForFences polls right after the gpu is done so the gpu-bound case is exact
+        uint64_t completed_serial = getCompletedFrameSerial();
+        if (completed_serial <= m_latency_frame_serial)
+        {
+            return;
+        }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (m_frame_serials[i] == completed_serial)
+            {
+                m_cpu_to_gpu_latency_ms =
+                    (float)std::chrono::duration<double, std::milli>(now - m_frame_begin_times[i]).count();
+                if (!m_present_wait_supported)
+                {
+                    m_input_to_present_ms =
+                        (float)std::chrono::duration<double, std::milli>(now - m_frame_input_times[i]).count();
+                }
+            }
+        }
+        m_latency_frame_serial = completed_serial;
+    }
+
+    void VulkanRHI::updatePresentLatency()
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        while (m_pending_present_count > 0)
+        {
+            // a zero timeout only polls, waiting for an id also covers every earlier one
+            const PendingPresent& pending = m_pending_presents[m_pending_present_first];
+            VkResult              result  = _vkWaitForPresentKHR(m_device, m_swapchain, pending.present_id, 0);
+            if (result == VK_TIMEOUT)
+            {
+                break;
+            }
+            if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+            {
+                m_pending_present_count = 0;
+                break;
+            }
+            m_input_to_present_ms = (float)std::chrono::duration<double, std::milli>(now - pending.input_time).count();
+            m_pending_present_first = (m_pending_present_first + 1) % k_max_pending_presents;
+            --m_pending_present_count;
+        }
+    }
+
+    void VulkanRHI::setFramesInFlight(uint32_t count)
+    {
+        count = std::max(std::min(count, (uint32_t)k_max_frames_in_flight), 1u);
+        if (count == m_frames_in_flight)
+        {
+            return;
+        }
+
+        // slots beyond the new count are never waited on again, so flush all of them now
+        waitForFrameSerial(m_submitted_frame_serial);
+        updateFrameLatency();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            recycleFrame(i);
+        }
+        m_frames_in_flight    = count;
+        m_current_frame_index = 0;
+    }
+
+    bool VulkanRHI::prepareBeforePass(const std::function<void()>& passUpdateAfterRecreateSwapchain) {
+        if (m_headless)
+        {
+            m_current_swapchain_image_index = m_current_frame_index;
+        }
+        else
+        {
+            VkResult acquire_image_result =
+                vkAcquireNextImageKHR(m_device,
+                                      m_swapchain,
+                                      UINT64_MAX,
+                                      m_image_available_for_render_semaphores[m_current_frame_index],
+                                      VK_NULL_HANDLE,
+                                      &m_current_swapchain_image_index);
+
+            if (acquire_image_result == VK_ERROR_OUT_OF_DATE_KHR) {
+                recreateSwapChain(passUpdateAfterRecreateSwapchain);
+                return false;
+            } 
+            else if (acquire_image_result != VK_SUCCESS && acquire_image_result != VK_SUBOPTIMAL_KHR) {
+                throw std::runtime_error("failed to acquire swap chain image!");
+            }
+        }
+        if (VK_SUCCESS != _vkResetCommandPool(m_device, m_command_pools[m_current_frame_index], 0))
+        {
+            LOG_ERROR("failed to reset command pool");
+            return false;
+        }
+        if (!m_parallel_recorder.beginFrame(m_current_frame_index))
+        {
+            return false;
+        }
+
+        VkCommandBufferBeginInfo command_buffer_begin_info {};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (VK_SUCCESS != _vkBeginCommandBuffer(m_vk_command_buffers[m_current_frame_index], &command_buffer_begin_info))
+        {
+            LOG_ERROR("failed to begin recording command buffer");
+            return false;
+        }
+
+        if (m_timestamp_query_pools[m_current_frame_index] != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(m_vk_command_buffers[m_current_frame_index], m_timestamp_query_pools[m_current_frame_index], 0, 2 * k_max_gpu_profile_scopes);
+        }
+        cmdBeginGpuProfileScope(m_command_buffers[m_current_frame_index], "frame");
+        return true;
+    }
+
+    void VulkanRHI::submitRendering(const std::function<void()>& passUpdateAfterRecreateSwapchain) {
+        if (m_gpu_profile_scope_stack.size() > 1)
+        {
+            LOG_ERROR("unbalanced gpu profile scopes at end of frame");
+            while (m_gpu_profile_scope_stack.size() > 1)
+            {
+                cmdEndGpuProfileScope(m_command_buffers[m_current_frame_index]);
+            }
+        }
+        cmdEndGpuProfileScope(m_command_buffers[m_current_frame_index]);
+
+        if (VK_SUCCESS != _vkEndCommandBuffer(m_vk_command_buffers[m_current_frame_index]))
+        {
+            LOG_ERROR("failed to record command buffer");
+        }
+
+        // uploads recorded while building this frame have to land before it executes
+        m_upload_manager.flush();
+        VkSemaphore compute_semaphore = m_async_compute.submit(m_current_frame_index);
+
+        uint64_t frame_serial = ++m_submitted_frame_serial;
+        m_frame_serials[m_current_frame_index] = frame_serial;
+
+        // the present semaphore is binary, its entry in the value array is ignored
+        VkSemaphore signal_semaphores[2];
+        uint64_t    signal_values[2];
+        uint32_t    signal_semaphore_count = 0;
+        if (!m_headless)
+        {
+            signal_semaphores[signal_semaphore_count] = m_image_finished_for_presentation_semaphores[m_current_frame_index];
+            signal_values[signal_semaphore_count++]   = 0;
+        }
+        if (m_timeline_semaphore_supported)
+        {
+            signal_semaphores[signal_semaphore_count] = m_frame_timeline_semaphore;
+            signal_values[signal_semaphore_count++]   = frame_serial;
+        }
+
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info {};
+        timeline_submit_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.signalSemaphoreValueCount = signal_semaphore_count;
+        timeline_submit_info.pSignalSemaphoreValues    = signal_values;
+
+        VkSemaphore          wait_semaphores[2];
+        VkPipelineStageFlags wait_stages[2];
+        uint32_t             wait_semaphore_count = 0;
+        if (!m_headless)
+        {
+            wait_semaphores[wait_semaphore_count] = m_image_available_for_render_semaphores[m_current_frame_index];
+            wait_stages[wait_semaphore_count++]   = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        }
+        if (compute_semaphore != VK_NULL_HANDLE)
+        {
+            // compute output is consumed as draw arguments and as vertex or index data
+            wait_semaphores[wait_semaphore_count] = compute_semaphore;
+            wait_stages[wait_semaphore_count++]   = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        }
+
+        VkSubmitInfo submit_info {};
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext                = m_timeline_semaphore_supported ? &timeline_submit_info : nullptr;
+        submit_info.commandBufferCount   = 1;
+        submit_info.pCommandBuffers      = &m_vk_command_buffers[m_current_frame_index];
+        submit_info.signalSemaphoreCount = signal_semaphore_count;
+        submit_info.pSignalSemaphores    = signal_semaphores;
+        submit_info.waitSemaphoreCount   = wait_semaphore_count;
+        submit_info.pWaitSemaphores      = wait_semaphores;
+        submit_info.pWaitDstStageMask    = wait_stages;
+
+        // reset only here, a frame that bails out before its submit must leave the fence signaled for the next wait
+        VkFence frame_fence = m_timeline_semaphore_supported ? VK_NULL_HANDLE : m_is_frame_in_flight_fences[m_current_frame_index];
+        if (frame_fence != VK_NULL_HANDLE)
+        {
+            _vkResetFences(m_device, 1, &frame_fence);
+        }
+        if (VK_SUCCESS != vkQueueSubmit(m_queue_table.get(m_graphics_queue), 1, &submit_info, frame_fence))
+        {
+            LOG_ERROR("failed to submit draw command buffer!");
+        }
+
+        VkResult present_result = VK_SUCCESS;
+        if (!m_headless)
+        {
+            VkSemaphore signalSemaphores[] = { m_image_finished_for_presentation_semaphores[m_current_frame_index] };
+
+            VkPresentInfoKHR presentInfo{};
+            presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
+            presentInfo.waitSemaphoreCount = 1;
+            presentInfo.pWaitSemaphores = signalSemaphores;
+
+            VkSwapchainKHR swapChains[] = { m_swapchain };
+            presentInfo.swapchainCount = 1;
+            presentInfo.pSwapchains = swapChains;
+
+            presentInfo.pImageIndices = &m_current_swapchain_image_index;
+
+            VkPresentIdKHR present_id_info {};
+            present_id_info.sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+            present_id_info.swapchainCount = 1;
+            present_id_info.pPresentIds    = &frame_serial;
+            if (m_present_wait_supported)
+            {
+                presentInfo.pNext = &present_id_info;
+            }
+
+            // 提交显示
+            present_result = vkQueuePresentKHR(m_present_queue, &presentInfo);
+            if (m_present_wait_supported && (present_result == VK_SUCCESS || present_result == VK_SUBOPTIMAL_KHR))
+            {
+                // a display that stops consuming presents overwrites the oldest entry
+                if (m_pending_present_count == k_max_pending_presents)
+                {
+                    m_pending_present_first = (m_pending_present_first + 1) % k_max_pending_presents;
+                    --m_pending_present_count;
+                }
+                m_pending_presents[(m_pending_present_first + m_pending_present_count++) % k_max_pending_presents] =
+                    PendingPresent {frame_serial, m_frame_input_times[m_current_frame_index]};
+            }
+        }
+
+        m_frame_heap_allocations = getGlobalNewCount() - m_heap_allocation_mark;
+        assert(!m_assert_allocation_free_frames || m_frame_heap_allocations == 0);
+
+        if (!m_headless)
+        {
+            if (present_result == VK_ERROR_OUT_OF_DATE_KHR || present_result == VK_SUBOPTIMAL_KHR || framebufferResized || m_present_mode_changed) {
+                framebufferResized = false;
+                recreateSwapChain(passUpdateAfterRecreateSwapchain);
+            }
+            else if (present_result != VK_SUCCESS) {
+                throw std::runtime_error("failed to present swap chain image!");
+            }
+        }
+        updateFrameLatency();
+        m_current_frame_index = (m_current_frame_index + 1) % m_frames_in_flight;
+    }
+
+    RHICommandBuffer VulkanRHI::getCurrentCommandBuffer() const
+    {
+        return m_command_buffers[m_current_frame_index];
+    }
+
+    RHICommandBuffer VulkanRHI::getCurrentComputeCommandBuffer()
+    {
+        // getCommandBuffer() begins recording on first use, so the handle is only pointed at it here
+        RHICommandBuffer command_buffer = m_compute_command_buffers[m_current_frame_index];
+        m_command_buffer_table.set(command_buffer, m_async_compute.getCommandBuffer(m_current_frame_index));
+        return command_buffer;
+    }
+
+    void VulkanRHI::cmdBeginRenderPass(RHICommandBuffer commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents)
+    {
+        ScratchScope scratch;
+        //clear_values
+        int clear_value_size = pRenderPassBegin->clearValueCount;
+        VkClearValue* vk_clear_value_list = scratch.allocateArray<VkClearValue>(clear_value_size);
+        for (int i = 0; i < clear_value_size; ++i)
+        {
+            const auto& rhi_clear_value_element = pRenderPassBegin->pClearValues[i];
+            auto& vk_clear_value_element = vk_clear_value_list[i];
+
+            memcpy(&vk_clear_value_element, &rhi_clear_value_element, sizeof(VkClearValue));
+        };
+
+        VkRenderPassBeginInfo vk_render_pass_begin_info{};
+        vk_render_pass_begin_info.sType = (VkStructureType)pRenderPassBegin->sType;
+        vk_render_pass_begin_info.pNext = pRenderPassBegin->pNext;
+        vk_render_pass_begin_info.renderPass = m_render_pass_table.get(pRenderPassBegin->renderPass);
+        vk_render_pass_begin_info.framebuffer = m_framebuffer_table.get(pRenderPassBegin->framebuffer);
+        vk_render_pass_begin_info.renderArea.offset.x = pRenderPassBegin->renderArea.offset.x;
+        vk_render_pass_begin_info.renderArea.offset.y = pRenderPassBegin->renderArea.offset.y;
+        vk_render_pass_begin_info.renderArea.extent.width = pRenderPassBegin->renderArea.extent.width;
+        vk_render_pass_begin_info.renderArea.extent.height = pRenderPassBegin->renderArea.extent.height;
+        vk_render_pass_begin_info.clearValueCount = pRenderPassBegin->clearValueCount;
+        vk_render_pass_begin_info.pClearValues = vk_clear_value_list;
+
+        _vkCmdBeginRenderPass(m_command_buffer_table.get(commandBuffer), &vk_render_pass_begin_info, (VkSubpassContents)contents);
+        m_current_render_pass = vk_render_pass_begin_info.renderPass;
+        m_current_framebuffer = vk_render_pass_begin_info.framebuffer;
+        m_current_subpass = 0;
+    }
+
+    void VulkanRHI::cmdNextSubpass(RHICommandBuffer commandBuffer, RHISubpassContents contents)
+    {
+        _vkCmdNextSubpass(m_command_buffer_table.get(commandBuffer), (VkSubpassContents)contents);
+        ++m_current_subpass;
+    }
+
+    void VulkanRHI::cmdBeginRendering(RHICommandBuffer commandBuffer, const RHIRenderingInfo* pRenderingInfo, const RHIPipelineRenderingCreateInfo* pFormats)
+    {
+        VkRenderingAttachmentInfo vk_attachments[k_max_rendering_attachments + 2] {};
+        if (pRenderingInfo->colorAttachmentCount > k_max_rendering_attachments)
+        {
+            LOG_ERROR("too many color attachments for dynamic rendering");
+            return;
+        }
+        auto convertAttachment = [this](const RHIRenderingAttachmentInfo* rhi_attachment, VkRenderingAttachmentInfo& vk_attachment) {
+            vk_attachment.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            vk_attachment.pNext       = rhi_attachment->pNext;
+            vk_attachment.imageView   = m_image_view_table.get(rhi_attachment->imageView);
+            vk_attachment.imageLayout = (VkImageLayout)rhi_attachment->imageLayout;
+            vk_attachment.resolveMode = VK_RESOLVE_MODE_NONE;
+            vk_attachment.loadOp      = (VkAttachmentLoadOp)rhi_attachment->loadOp;
+            vk_attachment.storeOp     = (VkAttachmentStoreOp)rhi_attachment->storeOp;
+            memcpy(&vk_attachment.clearValue, &rhi_attachment->clearValue, sizeof(VkClearValue));
+        };
+        for (uint32_t i = 0; i < pRenderingInfo->colorAttachmentCount; ++i)
+        {
+            convertAttachment(&pRenderingInfo->pColorAttachments[i], vk_attachments[i]);
+        }
+        VkRenderingAttachmentInfo* vk_depth_attachment   = &vk_attachments[k_max_rendering_attachments];
+        VkRenderingAttachmentInfo* vk_stencil_attachment = &vk_attachments[k_max_rendering_attachments + 1];
+        if (pRenderingInfo->pDepthAttachment != nullptr)
+        {
+            convertAttachment(pRenderingInfo->pDepthAttachment, *vk_depth_attachment);
+        }
+        if (pRenderingInfo->pStencilAttachment != nullptr)
+        {
+            convertAttachment(pRenderingInfo->pStencilAttachment, *vk_stencil_attachment);
+        }
+
+        VkRenderingInfo vk_rendering_info {};
+        vk_rendering_info.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        vk_rendering_info.pNext                = pRenderingInfo->pNext;
+        vk_rendering_info.flags                = (VkRenderingFlags)pRenderingInfo->flags;
+        vk_rendering_info.renderArea.offset.x  = pRenderingInfo->renderArea.offset.x;
+        vk_rendering_info.renderArea.offset.y  = pRenderingInfo->renderArea.offset.y;
+        vk_rendering_info.renderArea.extent.width  = pRenderingInfo->renderArea.extent.width;
+        vk_rendering_info.renderArea.extent.height = pRenderingInfo->renderArea.extent.height;
+        vk_rendering_info.layerCount           = pRenderingInfo->layerCount;
+        vk_rendering_info.viewMask             = pRenderingInfo->viewMask;
+        vk_rendering_info.colorAttachmentCount = pRenderingInfo->colorAttachmentCount;
+        vk_rendering_info.pColorAttachments    = vk_attachments;
+        vk_rendering_info.pDepthAttachment     = pRenderingInfo->pDepthAttachment != nullptr ? vk_depth_attachment : nullptr;
+        vk_rendering_info.pStencilAttachment   = pRenderingInfo->pStencilAttachment != nullptr ? vk_stencil_attachment : nullptr;
+
+        _vkCmdBeginRendering(m_command_buffer_table.get(commandBuffer), &vk_rendering_info);
+        m_current_render_pass = VK_NULL_HANDLE;
+        m_current_framebuffer = VK_NULL_HANDLE;
+        m_current_subpass     = 0;
+        m_current_color_formats.clear();
+        m_current_depth_format   = VK_FORMAT_UNDEFINED;
+        m_current_stencil_format = VK_FORMAT_UNDEFINED;
+        if (pFormats != nullptr)
+        {
+            for (uint32_t i = 0; i < pFormats->colorAttachmentCount; ++i)
+            {
+                m_current_color_formats.push_back((VkFormat)pFormats->pColorAttachmentFormats[i]);
+            }
+            m_current_depth_format   = (VkFormat)pFormats->depthAttachmentFormat;
+            m_current_stencil_format = (VkFormat)pFormats->stencilAttachmentFormat;
+        }
+    }
+
+    void VulkanRHI::cmdEndRendering(RHICommandBuffer commandBuffer)
+    {
+        _vkCmdEndRendering(m_command_buffer_table.get(commandBuffer));
+    }
+
+    void VulkanRHI::cmdPipelineBarrier(RHICommandBuffer commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers)
+    {
+        ScratchScope scratch;
+        VkImageMemoryBarrier* vk_barriers = scratch.allocateArray<VkImageMemoryBarrier>(imageMemoryBarrierCount);
+        for (uint32_t i = 0; i < imageMemoryBarrierCount; ++i)
+        {
+            const auto& rhi_barrier = pImageMemoryBarriers[i];
+            auto& vk_barrier = vk_barriers[i];
+
+            vk_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            vk_barrier.pNext               = rhi_barrier.pNext;
+            vk_barrier.srcAccessMask       = (VkAccessFlags)rhi_barrier.srcAccessMask;
+            vk_barrier.dstAccessMask       = (VkAccessFlags)rhi_barrier.dstAccessMask;
+            vk_barrier.oldLayout           = (VkImageLayout)rhi_barrier.oldLayout;
+            vk_barrier.newLayout           = (VkImageLayout)rhi_barrier.newLayout;
+            vk_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            vk_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            vk_barrier.image               = m_image_table.get(rhi_barrier.image);
+            vk_barrier.subresourceRange.aspectMask     = (VkImageAspectFlags)rhi_barrier.subresourceRange.aspectMask;
+            vk_barrier.subresourceRange.baseMipLevel   = rhi_barrier.subresourceRange.baseMipLevel;
+            vk_barrier.subresourceRange.levelCount     = rhi_barrier.subresourceRange.levelCount;
+            vk_barrier.subresourceRange.baseArrayLayer = rhi_barrier.subresourceRange.baseArrayLayer;
+            vk_barrier.subresourceRange.layerCount     = rhi_barrier.subresourceRange.layerCount;
+        }
+        vkCmdPipelineBarrier(m_command_buffer_table.get(commandBuffer),
+                             (VkPipelineStageFlags)srcStageMask,
+                             (VkPipelineStageFlags)dstStageMask,
+                             (VkDependencyFlags)dependencyFlags,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             imageMemoryBarrierCount,
+                             vk_barriers);
+    }
+
+    void VulkanRHI::cmdRecordParallel(RHICommandBuffer commandBuffer, uint32_t itemCount, uint32_t minItemsPerBatch, const VulkanParallelRecorder::RecordFunction& record)
+    {
+        // inside dynamic rendering there is no render pass to inherit, the attachment formats stand in for it
+        VkCommandBufferInheritanceRenderingInfo rendering_inheritance_info {};
+        rendering_inheritance_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        rendering_inheritance_info.colorAttachmentCount    = (uint32_t)m_current_color_formats.size();
+        rendering_inheritance_info.pColorAttachmentFormats = m_current_color_formats.data();
+        rendering_inheritance_info.depthAttachmentFormat   = m_current_depth_format;
+        rendering_inheritance_info.stencilAttachmentFormat = m_current_stencil_format;
+        rendering_inheritance_info.rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT;
+
+        VkCommandBufferInheritanceInfo inheritance_info {};
+        inheritance_info.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.pNext       = m_current_render_pass == VK_NULL_HANDLE ? &rendering_inheritance_info : nullptr;
+        inheritance_info.renderPass  = m_current_render_pass;
+        inheritance_info.subpass     = m_current_subpass;
+        inheritance_info.framebuffer = m_current_framebuffer;
+        m_parallel_recorder.record(m_command_buffer_table.get(commandBuffer), inheritance_info, itemCount, minItemsPerBatch, record);
+    }
+
+    uint32_t VulkanRHI::getRecordingThreadCount() const
+    {
+        return m_parallel_recorder.getThreadCount();
+    }
+
+    void VulkanRHI::cmdEndRenderPass(RHICommandBuffer commandBuffer)
+    {
+        _vkCmdEndRenderPass(m_command_buffer_table.get(commandBuffer));
+    }
+
+    void VulkanRHI::cmdBeginGpuProfileScope(RHICommandBuffer commandBuffer, const char* name)
+    {
+        VkCommandBuffer vk_command_buffer = m_command_buffer_table.get(commandBuffer);
+        if (_vkCmdBeginDebugUtilsLabelEXT != nullptr)
+        {
+            VkDebugUtilsLabelEXT label_info {};
+            label_info.sType      = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            label_info.pLabelName = name;
+            label_info.color[0]   = 1.0f;
+            label_info.color[1]   = 1.0f;
+            label_info.color[2]   = 1.0f;
+            label_info.color[3]   = 1.0f;
+            _vkCmdBeginDebugUtilsLabelEXT(vk_command_buffer, &label_info);
+        }
+
+        // scopes past the pool capacity keep their label but are not timed
+        std::vector<GpuProfileScopeRecord>& scopes = m_gpu_profile_scopes[m_current_frame_index];
+        VkQueryPool query_pool = m_timestamp_query_pools[m_current_frame_index];
+        if (query_pool == VK_NULL_HANDLE || scopes.size() >= k_max_gpu_profile_scopes)
+        {
+            m_gpu_profile_scope_stack.push_back(UINT32_MAX);
+            return;
+        }
+
+        GpuProfileScopeRecord record;
+        std::strncpy(record.name, name, sizeof(record.name) - 1);
+        record.name[sizeof(record.name) - 1] = '\0';
+        record.depth       = (uint32_t)m_gpu_profile_scope_stack.size();
+        record.begin_query = 2 * (uint32_t)scopes.size();
+        vkCmdWriteTimestamp(vk_command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, record.begin_query);
+
+        m_gpu_profile_scope_stack.push_back((uint32_t)scopes.size());
+        scopes.push_back(std::move(record));
+    }
+
+    void VulkanRHI::cmdEndGpuProfileScope(RHICommandBuffer commandBuffer)
+    {
+        if (m_gpu_profile_scope_stack.empty())
+        {
+            LOG_ERROR("cmdEndGpuProfileScope without matching begin");
+            return;
+        }
+        VkCommandBuffer vk_command_buffer = m_command_buffer_table.get(commandBuffer);
+
+        uint32_t scope_index = m_gpu_profile_scope_stack.back();
+        m_gpu_profile_scope_stack.pop_back();
+        if (scope_index != UINT32_MAX)
+        {
+            const GpuProfileScopeRecord& record = m_gpu_profile_scopes[m_current_frame_index][scope_index];
+            vkCmdWriteTimestamp(vk_command_buffer,
+                                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                m_timestamp_query_pools[m_current_frame_index],
+                                record.begin_query + 1);
+        }
+
+        if (_vkCmdEndDebugUtilsLabelEXT != nullptr)
+        {
+            _vkCmdEndDebugUtilsLabelEXT(vk_command_buffer);
+        }
+    }
+
+    void VulkanRHI::cmdBindVertexBuffers(RHICommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const RHIBuffer* pBuffers, const RHIDeviceSize* pOffsets)
+    {
+        ScratchScope scratch;
+        //buffer
+        int buffer_size = bindingCount;
+        VkBuffer* vk_buffer_list = scratch.allocateArray<VkBuffer>(buffer_size);
+        for (int i = 0; i < buffer_size; ++i)
+        {
+            const auto& rhi_buffer_element = pBuffers[i];
+            auto& vk_buffer_element = vk_buffer_list[i];
+
+            vk_buffer_element = m_buffer_table.get(rhi_buffer_element);
+        };
+
+        _vkCmdBindVertexBuffers(m_command_buffer_table.get(commandBuffer), firstBinding, bindingCount, vk_buffer_list, (const VkDeviceSize*)pOffsets);
+    }
+
+    void VulkanRHI::cmdBindIndexBuffer(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, RHIIndexType indexType)
+    {
+        _vkCmdBindIndexBuffer(m_command_buffer_table.get(commandBuffer), m_buffer_table.get(buffer), (VkDeviceSize)offset, (VkIndexType)indexType);
+    }
+
+    void VulkanRHI::cmdBindPipeline(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline pipeline)
+    {
+        _vkCmdBindPipeline(m_command_buffer_table.get(commandBuffer), (VkPipelineBindPoint)pipelineBindPoint, m_pipeline_table.get(pipeline));
+    }
+
+    void VulkanRHI::cmdBindDescriptorSets(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const RHIDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+    {
+        ScratchScope scratch;
+        VkDescriptorSet* vk_descriptor_sets = scratch.allocateArray<VkDescriptorSet>(descriptorSetCount);
+        for (uint32_t i = 0; i < descriptorSetCount; ++i)
+        {
+            vk_descriptor_sets[i] = m_descriptor_set_table.get(pDescriptorSets[i]);
+        }
+        _vkCmdBindDescriptorSets(m_command_buffer_table.get(commandBuffer),
+                                 (VkPipelineBindPoint)pipelineBindPoint,
+                                 m_pipeline_layout_table.get(layout),
+                                 firstSet,
+                                 descriptorSetCount,
+                                 vk_descriptor_sets,
+                                 dynamicOffsetCount,
+                                 pDynamicOffsets);
+    }
+
+    void VulkanRHI::cmdPushConstants(RHICommandBuffer commandBuffer, RHIPipelineLayout layout, RHIShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues)
+    {
+        vkCmdPushConstants(m_command_buffer_table.get(commandBuffer), m_pipeline_layout_table.get(layout), (VkShaderStageFlags)stageFlags, offset, size, pValues);
+    }
+
+    void VulkanRHI::cmdDispatch(RHICommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    {
+        vkCmdDispatch(m_command_buffer_table.get(commandBuffer), groupCountX, groupCountY, groupCountZ);
+    }
+
+    void VulkanRHI::cmdCopyBuffer(RHICommandBuffer commandBuffer, RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    {
+        VkBufferCopy region {};
+        region.srcOffset = srcOffset;
+        region.dstOffset = dstOffset;
+        region.size      = size;
+        vkCmdCopyBuffer(m_command_buffer_table.get(commandBuffer), m_buffer_table.get(srcBuffer), m_buffer_table.get(dstBuffer), 1, &region);
+    }
+
+    void VulkanRHI::cmdMemoryBarrier(RHICommandBuffer commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIAccessFlags srcAccessMask, RHIAccessFlags dstAccessMask)
+    {
+        VkMemoryBarrier barrier {};
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = (VkAccessFlags)srcAccessMask;
+        barrier.dstAccessMask = (VkAccessFlags)dstAccessMask;
+        vkCmdPipelineBarrier(m_command_buffer_table.get(commandBuffer),
+                             (VkPipelineStageFlags)srcStageMask,
+                             (VkPipelineStageFlags)dstStageMask,
+                             0,
+                             1,
+                             &barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+    }
+
+    void VulkanRHI::cmdDrawIndexedIndirect(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndexedIndirect(m_command_buffer_table.get(commandBuffer), m_buffer_table.get(buffer), (VkDeviceSize)offset, drawCount, stride);
+    }
+
+    void VulkanRHI::cmdSetViewport(RHICommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
+    {
+        // RHIViewport and RHIRect2D match the vulkan layout
+        vkCmdSetViewport(m_command_buffer_table.get(commandBuffer), firstViewport, viewportCount, (const VkViewport*)pViewports);
+    }
+
+    void VulkanRHI::cmdSetScissor(RHICommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+    {
+        vkCmdSetScissor(m_command_buffer_table.get(commandBuffer), firstScissor, scissorCount, (const VkRect2D*)pScissors);
+    }
+
+    bool VulkanRHI::mapMemory(RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size, void** ppData)
+    {
+        void* mapped_data = m_device_memory_table.get<k_device_memory_field_mapped_data>(memory);
+        if (mapped_data != nullptr)
+        {
+            *ppData = (uint8_t*)mapped_data + offset;
+            return RHI_SUCCESS;
+        }
+
+        void*    data;
+        VkResult result = vmaMapMemory(m_assets_allocator, m_device_memory_table.get<k_device_memory_field_allocation>(memory), &data);
+        if (result == VK_SUCCESS)
+        {
+            *ppData = (uint8_t*)data + offset;
+            return RHI_SUCCESS;
+        }
+        else
+        {
+            LOG_ERROR("vmaMapMemory failed!");
+            return false;
+        }
+    }
+
+    void VulkanRHI::unmapMemory(RHIDeviceMemory memory)
+    {
+        // persistently mapped allocations stay mapped until destroyed
+        if (m_device_memory_table.get<k_device_memory_field_mapped_data>(memory) == nullptr)
+        {
+            vmaUnmapMemory(m_assets_allocator, m_device_memory_table.get<k_device_memory_field_allocation>(memory));
+        }
+    }
+
+    bool VulkanRHI::readbackOffscreenImage(uint32_t image_index, std::vector<uint8_t>& pixels)
+    {
+        // the image must have been rendered at least once, its render pass leaves it in TRANSFER_SRC_OPTIMAL
+        if (!m_headless || image_index >= m_swapchain_images.size())
+        {
+            LOG_ERROR("readbackOffscreenImage is only available for headless offscreen images");
+            return false;
+        }
+
+        VkDeviceSize   image_size = (VkDeviceSize)m_swapchain_extent.width * m_swapchain_extent.height * 4;
+        VkBuffer          readback_buffer;
+        VmaAllocation     readback_buffer_allocation;
+        VmaAllocationInfo readback_buffer_allocation_info;
+        if (!VulkanUtil::createBuffer(m_assets_allocator,
+                                      image_size,
+                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      readback_buffer,
+                                      readback_buffer_allocation,
+                                      &readback_buffer_allocation_info))
+        {
+            return false;
+        }
+
+        RHICommandBuffer  rhi_command_buffer = beginSingleTimeCommands();
+        VkCommandBuffer   command_buffer     = m_command_buffer_table.get(rhi_command_buffer);
+
+        VkImageMemoryBarrier barrier {};
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask                   = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = m_swapchain_images[image_index];
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &barrier);
+
+        VkBufferImageCopy region {};
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageExtent                     = {m_swapchain_extent.width, m_swapchain_extent.height, 1};
+        vkCmdCopyImageToBuffer(command_buffer,
+                               m_swapchain_images[image_index],
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               readback_buffer,
+                               1,
+                               &region);
+
+        endSingleTimeCommands(rhi_command_buffer);
+
+        pixels.resize((size_t)image_size);
+        memcpy(pixels.data(), readback_buffer_allocation_info.pMappedData, (size_t)image_size);
+
+        vmaDestroyBuffer(m_assets_allocator, readback_buffer, readback_buffer_allocation);
+        return true;
+    }
+
+    void VulkanRHI::recreateSwapChain(const std::function<void()>& passUpdateAfterRecreateSwapchain) {
+        int width  = 0;
+        int height = 0;
+        glfwGetFramebufferSize(m_window, &width, &height);
+        while (width == 0 || height == 0) // minimized 0,0, pause for now
+        {
+            glfwGetFramebufferSize(m_window, &width, &height);
+            glfwWaitEvents();
+        }
+
+        // present ids are per swapchain
+        m_pending_present_count = 0;
+        m_present_mode_changed = false;
+
+        // frames still in flight keep rendering into the old images, so everything they reference is
+        // retired behind the frames submitted so far instead of draining the gpu
+        VkSwapchainKHR             old_swapchain        = m_swapchain;
+        std::vector<RHIImageView> old_image_views      = m_swapchain_imageviews;
+        std::vector<RHIImage>     old_images           = m_swapchain_rhi_images;
+        VkImageView                old_depth_image_view = m_image_view_table.get(m_depth_image_view);
+        VkImage                    old_depth_image      = m_image_table.get(m_depth_image);
+        VmaAllocation              old_depth_allocation = m_depth_image_allocation;
+
+        createSwapchain(old_swapchain);
+        createSwapchainImageViews();
+        createFramebufferImageAndView();
+        ++m_swapchain_recreate_count;
+
+        deferDestroy([this, old_swapchain, old_image_views, old_images, old_depth_image_view, old_depth_image, old_depth_allocation]() {
+            vkDestroyImageView(m_device, old_depth_image_view, nullptr);
+            vmaDestroyImage(m_assets_allocator, old_depth_image, old_depth_allocation);
+            for (RHIImageView image_view : old_image_views)
+            {
+                vkDestroyImageView(m_device, m_image_view_table.get(image_view), nullptr);
+                destroyHandle(m_image_view_table, image_view);
+            }
+            for (RHIImage image : old_images)
+            {
+                destroyHandle(m_image_table, image);
+            }
+            vkDestroySwapchainKHR(m_device, old_swapchain, nullptr);
+        });
+
+        if (passUpdateAfterRecreateSwapchain)
+        {
+            passUpdateAfterRecreateSwapchain();
+        }
+    }
+
+    void VulkanRHI::destroyImageView(RHIImageView imageView) {
+        vkDestroyImageView(m_device, m_image_view_table.get(imageView), nullptr);
+        destroyHandle(m_image_view_table, imageView);
+    }
+
+    bool VulkanRHI::createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass &pRenderPass)
+    {
+        ScratchScope scratch;
+        // attachment convert
+        VkAttachmentDescription* vk_attachments = scratch.allocateArray<VkAttachmentDescription>(pCreateInfo->attachmentCount);
+        for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i)
+        {
+            const auto& rhi_desc = pCreateInfo->pAttachments[i];
+            auto& vk_desc = vk_attachments[i];
+
+            vk_desc.flags = (VkAttachmentDescriptionFlags)(rhi_desc).flags;
+            vk_desc.format = (VkFormat)(rhi_desc).format;
+            vk_desc.samples = (VkSampleCountFlagBits)(rhi_desc).samples;
+            vk_desc.loadOp = (VkAttachmentLoadOp)(rhi_desc).loadOp;
+            vk_desc.storeOp = (VkAttachmentStoreOp)(rhi_desc).storeOp;
+            vk_desc.stencilLoadOp = (VkAttachmentLoadOp)(rhi_desc).stencilLoadOp;
+            vk_desc.stencilStoreOp = (VkAttachmentStoreOp)(rhi_desc).stencilStoreOp;
+            vk_desc.initialLayout = (VkImageLayout)(rhi_desc).initialLayout;
+            vk_desc.finalLayout = (VkImageLayout)(rhi_desc).finalLayout;
+        };
+
+        // subpass convert
+        int totalAttachmentRefenrence = 0;
+        for (uint32_t i = 0; i < pCreateInfo->subpassCount; i++)
+        {
+            const auto& rhi_desc = pCreateInfo->pSubpasses[i];
+            totalAttachmentRefenrence += rhi_desc.inputAttachmentCount; // pInputAttachments
+            totalAttachmentRefenrence += rhi_desc.colorAttachmentCount; // pColorAttachments
+            if (rhi_desc.pDepthStencilAttachment != nullptr)
+            {
+                totalAttachmentRefenrence += 1; // pDepthStencilAttachment
+            }
+            if (rhi_desc.pResolveAttachments != nullptr)
+            {
+                totalAttachmentRefenrence += rhi_desc.colorAttachmentCount; // pResolveAttachments
+            }
+        }
+        VkSubpassDescription* vk_subpass_description = scratch.allocateArray<VkSubpassDescription>(pCreateInfo->subpassCount);
+        VkAttachmentReference* vk_attachment_reference = scratch.allocateArray<VkAttachmentReference>(totalAttachmentRefenrence);
+        int currentAttachmentRefence = 0;
+        for (uint32_t i = 0; i < pCreateInfo->subpassCount; ++i)
+        {
+            const auto& rhi_desc = pCreateInfo->pSubpasses[i];
+            auto& vk_desc = vk_subpass_description[i];
+
+            vk_desc.flags = (VkSubpassDescriptionFlags)(rhi_desc).flags;
+            vk_desc.pipelineBindPoint = (VkPipelineBindPoint)(rhi_desc).pipelineBindPoint;
+            vk_desc.preserveAttachmentCount = (rhi_desc).preserveAttachmentCount;
+            vk_desc.pPreserveAttachments = (const uint32_t*)(rhi_desc).pPreserveAttachments;
+
+            vk_desc.inputAttachmentCount = (rhi_desc).inputAttachmentCount;
+            vk_desc.pInputAttachments = &vk_attachment_reference[currentAttachmentRefence];
+            for (uint32_t i = 0; i < (rhi_desc).inputAttachmentCount; i++)
+            {
+                const auto& rhi_attachment_refence_input = (rhi_desc).pInputAttachments[i];
+                auto& vk_attachment_refence_input = vk_attachment_reference[currentAttachmentRefence];
+
+                vk_attachment_refence_input.attachment = rhi_attachment_refence_input.attachment;
+                vk_attachment_refence_input.layout = (VkImageLayout)(rhi_attachment_refence_input.layout);
+
+                currentAttachmentRefence += 1;
+            };
+
+            vk_desc.colorAttachmentCount = (rhi_desc).colorAttachmentCount;
+            vk_desc.pColorAttachments = &vk_attachment_reference[currentAttachmentRefence];
+            for (uint32_t i = 0; i < (rhi_desc).colorAttachmentCount; ++i)
+            {
+                const auto& rhi_attachment_refence_color = (rhi_desc).pColorAttachments[i];
                 auto& vk_attachment_refence_color = vk_attachment_reference[currentAttachmentRefence];
 
                 vk_attachment_refence_color.attachment = rhi_attachment_refence_color.attachment;
@@ -966,19 +2335,17 @@ namespace Aura {
                 };
             }
 
+            // a single reference, depth-only subpasses have no color attachments at all
             if (rhi_desc.pDepthStencilAttachment != nullptr)
             {
                 vk_desc.pDepthStencilAttachment = &vk_attachment_reference[currentAttachmentRefence];
-                for (uint32_t i = 0; i < (rhi_desc).colorAttachmentCount; ++i)
-                {
-                    const auto& rhi_attachment_refence_depth = (rhi_desc).pDepthStencilAttachment[i];
-                    auto& vk_attachment_refence_depth = vk_attachment_reference[currentAttachmentRefence];
+                const auto& rhi_attachment_refence_depth = *(rhi_desc).pDepthStencilAttachment;
+                auto& vk_attachment_refence_depth = vk_attachment_reference[currentAttachmentRefence];
 
-                    vk_attachment_refence_depth.attachment = rhi_attachment_refence_depth.attachment;
-                    vk_attachment_refence_depth.layout = (VkImageLayout)(rhi_attachment_refence_depth.layout);
+                vk_attachment_refence_depth.attachment = rhi_attachment_refence_depth.attachment;
+                vk_attachment_refence_depth.layout = (VkImageLayout)(rhi_attachment_refence_depth.layout);
 
-                    currentAttachmentRefence += 1;
-                };
+                currentAttachmentRefence += 1;
             };
         };
         if (currentAttachmentRefence != totalAttachmentRefenrence)
@@ -987,7 +2354,7 @@ namespace Aura {
             return false;
         }
 
-        std::vector<VkSubpassDependency> vk_subpass_depandecy(pCreateInfo->dependencyCount);
+        VkSubpassDependency* vk_subpass_depandecy = scratch.allocateArray<VkSubpassDependency>(pCreateInfo->dependencyCount);
         for (uint32_t i = 0; i < pCreateInfo->dependencyCount; ++i)
         {
             const auto& rhi_desc = pCreateInfo->pDependencies[i];
@@ -1007,73 +2374,255 @@ namespace Aura {
         create_info.pNext = (const void*)pCreateInfo->pNext;
         create_info.flags = (VkRenderPassCreateFlags)pCreateInfo->flags;
         create_info.attachmentCount = pCreateInfo->attachmentCount;
-        create_info.pAttachments = vk_attachments.data();
+        create_info.pAttachments = vk_attachments;
         create_info.subpassCount = pCreateInfo->subpassCount;
-        create_info.pSubpasses = vk_subpass_description.data();
+        create_info.pSubpasses = vk_subpass_description;
         create_info.dependencyCount = pCreateInfo->dependencyCount;
-        create_info.pDependencies = vk_subpass_depandecy.data();
+        create_info.pDependencies = vk_subpass_depandecy;
 
-        pRenderPass = new VulkanRenderPass();
-        VkRenderPass vk_render_pass;
-        VkResult result = vkCreateRenderPass(m_device, &create_info, nullptr, &vk_render_pass);
-        ((VulkanRenderPass*)pRenderPass)->setResource(vk_render_pass);
+        auto create = [this, &create_info]() -> RHIRenderPass {
+            VkRenderPass vk_render_pass;
+            if (vkCreateRenderPass(m_device, &create_info, nullptr, &vk_render_pass) != VK_SUCCESS)
+            {
+                LOG_ERROR("vkCreateRenderPass failed!");
+                return nullptr;
+            }
+            RHIRenderPass render_pass = createHandle(m_render_pass_table, vk_render_pass);
+            return render_pass;
+        };
 
-        if (result == VK_SUCCESS)
+        // a pNext chain is not part of the key, so those render passes are never shared
+        if (create_info.pNext != nullptr)
         {
-            return RHI_SUCCESS;
+            pRenderPass = create();
         }
         else
         {
-            LOG_ERROR("vkCreateRenderPass failed!");
-            return false;
+            VulkanObjectKey key;
+            // addArray prefixes each array with its count, the subpass records vary in length so they need theirs too
+            key.add(create_info.flags).addArray(vk_attachments, create_info.attachmentCount);
+            key.add(create_info.subpassCount);
+            for (uint32_t i = 0; i < create_info.subpassCount; ++i)
+            {
+                const VkSubpassDescription& subpass = vk_subpass_description[i];
+                key.add(subpass.flags).add(subpass.pipelineBindPoint);
+                key.addArray(subpass.pInputAttachments, subpass.inputAttachmentCount);
+                key.addArray(subpass.pColorAttachments, subpass.colorAttachmentCount);
+                key.addArray(subpass.pResolveAttachments, subpass.pResolveAttachments != nullptr ? subpass.colorAttachmentCount : 0);
+                key.addArray(subpass.pDepthStencilAttachment, subpass.pDepthStencilAttachment != nullptr ? 1 : 0);
+                key.addArray(subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+            }
+            key.addArray(vk_subpass_depandecy, create_info.dependencyCount);
+            pRenderPass = m_render_pass_cache.acquire(key, create);
         }
+        return pRenderPass != nullptr ? RHI_SUCCESS : false;
     }
 
-    bool VulkanRHI::createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer)
+    bool VulkanRHI::createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer &pFramebuffer)
     {
+        ScratchScope scratch;
         //image_view
         int image_view_size = pCreateInfo->attachmentCount;
-        std::vector<VkImageView> vk_image_view_list(image_view_size);
+        VkImageView* vk_image_view_list = scratch.allocateArray<VkImageView>(image_view_size);
         for (int i = 0; i < image_view_size; ++i)
         {
             const auto& rhi_image_view_element = pCreateInfo->pAttachments[i];
             auto& vk_image_view_element = vk_image_view_list[i];
 
-            vk_image_view_element = ((VulkanImageView*)rhi_image_view_element)->getResource();
+            vk_image_view_element = m_image_view_table.get(rhi_image_view_element);
         };
 
         VkFramebufferCreateInfo create_info{};
         create_info.sType = (VkStructureType)pCreateInfo->sType;
         create_info.pNext = (const void*)pCreateInfo->pNext;
         create_info.flags = (VkFramebufferCreateFlags)pCreateInfo->flags;
-        create_info.renderPass = ((VulkanRenderPass*)pCreateInfo->renderPass)->getResource();
+        create_info.renderPass = m_render_pass_table.get(pCreateInfo->renderPass);
         create_info.attachmentCount = pCreateInfo->attachmentCount;
-        create_info.pAttachments = vk_image_view_list.data();
+        create_info.pAttachments = vk_image_view_list;
         create_info.width = pCreateInfo->width;
         create_info.height = pCreateInfo->height;
         create_info.layers = pCreateInfo->layers;
 
-        pFramebuffer = new VulkanFramebuffer();
-        VkFramebuffer vk_framebuffer;
-        VkResult result = vkCreateFramebuffer(m_device, &create_info, nullptr, &vk_framebuffer);
-        ((VulkanFramebuffer*)pFramebuffer)->setResource(vk_framebuffer);
+        auto create = [this, &create_info]() -> RHIFramebuffer {
+            VkFramebuffer vk_framebuffer;
+            if (vkCreateFramebuffer(m_device, &create_info, nullptr, &vk_framebuffer) != VK_SUCCESS)
+            {
+                LOG_ERROR("vkCreateFramebuffer failed!");
+                return nullptr;
+            }
+            RHIFramebuffer framebuffer = createHandle(m_framebuffer_table, vk_framebuffer);
+            return framebuffer;
+        };
 
-        if (result == VK_SUCCESS)
+        if (create_info.pNext != nullptr)
+        {
+            pFramebuffer = create();
+        }
+        else
+        {
+            VulkanObjectKey key;
+            key.add(create_info.flags).add(create_info.renderPass).addArray(vk_image_view_list, create_info.attachmentCount);
+            key.add(create_info.width).add(create_info.height).add(create_info.layers);
+            pFramebuffer = m_framebuffer_cache.acquire(key, create);
+        }
+        return pFramebuffer != nullptr ? RHI_SUCCESS : false;
+    }
+
+    void VulkanRHI::destroyFramebuffer(RHIFramebuffer framebuffer)
+    {
+        if (!m_framebuffer_cache.release(framebuffer))
+        {
+            return;
+        }
+        deferDestroy([this, framebuffer]() {
+            vkDestroyFramebuffer(m_device, m_framebuffer_table.get(framebuffer), nullptr);
+            destroyHandle(m_framebuffer_table, framebuffer);
+        });
+    }
+
+    void VulkanRHI::destroyRenderPass(RHIRenderPass renderPass)
+    {
+        if (!m_render_pass_cache.release(renderPass))
+        {
+            return;
+        }
+        deferDestroy([this, renderPass]() {
+            vkDestroyRenderPass(m_device, m_render_pass_table.get(renderPass), nullptr);
+            destroyHandle(m_render_pass_table, renderPass);
+        });
+    }
+
+    bool VulkanRHI::createUnboundImage(uint32_t width, uint32_t height, RHIFormat format, RHIImageUsageFlags usage, RHIImage &pImage, RHIMemoryRequirements& requirements)
+    {
+        VkImageCreateInfo image_create_info {};
+        image_create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.imageType     = VK_IMAGE_TYPE_2D;
+        image_create_info.extent.width  = width;
+        image_create_info.extent.height = height;
+        image_create_info.extent.depth  = 1;
+        image_create_info.mipLevels     = 1;
+        image_create_info.arrayLayers   = 1;
+        image_create_info.format        = (VkFormat)format;
+        image_create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_create_info.usage         = (VkImageUsageFlags)usage;
+        image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+        image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkImage vk_image;
+        if (vkCreateImage(m_device, &image_create_info, nullptr, &vk_image) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkCreateImage failed!");
+            return false;
+        }
+        VkMemoryRequirements memory_requirements;
+        vkGetImageMemoryRequirements(m_device, vk_image, &memory_requirements);
+        requirements.size           = memory_requirements.size;
+        requirements.alignment      = memory_requirements.alignment;
+        requirements.memoryTypeBits = memory_requirements.memoryTypeBits;
+
+        pImage = createHandle(m_image_table, vk_image);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::allocateImageMemory(const RHIMemoryRequirements& requirements, bool prefer_lazily_allocated, RHIDeviceMemory &pMemory, bool* pLazilyAllocated)
+    {
+        VkMemoryRequirements memory_requirements;
+        memory_requirements.size           = requirements.size;
+        memory_requirements.alignment      = requirements.alignment;
+        memory_requirements.memoryTypeBits = requirements.memoryTypeBits;
+
+        VmaAllocation     allocation;
+        VmaAllocationInfo allocation_info;
+        bool              lazily_allocated = false;
+        if (prefer_lazily_allocated && m_lazily_allocated_memory_supported)
+        {
+            // only images created with transient attachment usage report the lazily allocated type as compatible
+            VmaAllocationCreateInfo allocation_create_info = VulkanUtil::chooseAllocationCreateInfo(
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, requirements.size, true);
+            lazily_allocated = vmaAllocateMemory(m_assets_allocator, &memory_requirements, &allocation_create_info, &allocation, &allocation_info) == VK_SUCCESS;
+        }
+        if (!lazily_allocated)
+        {
+            VmaAllocationCreateInfo allocation_create_info =
+                VulkanUtil::chooseAllocationCreateInfo(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, requirements.size, true);
+            if (vmaAllocateMemory(m_assets_allocator, &memory_requirements, &allocation_create_info, &allocation, &allocation_info) != VK_SUCCESS)
+            {
+                LOG_ERROR("vmaAllocateMemory failed!");
+                return false;
+            }
+        }
+        if (pLazilyAllocated != nullptr)
         {
-            return RHI_SUCCESS;
+            *pLazilyAllocated = lazily_allocated;
         }
-        else
+        pMemory = createHandle(m_device_memory_table, allocation_info.deviceMemory, allocation, allocation_info.pMappedData);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::bindImageMemory(RHIImage image, RHIDeviceMemory memory, RHIDeviceSize offset)
+    {
+        if (vmaBindImageMemory2(m_assets_allocator,
+                                m_device_memory_table.get<k_device_memory_field_allocation>(memory),
+                                (VkDeviceSize)offset,
+                                m_image_table.get(image),
+                                nullptr) != VK_SUCCESS)
         {
-            LOG_ERROR("vkCreateFramebuffer failed!");
+            LOG_ERROR("vmaBindImageMemory2 failed!");
             return false;
         }
+        return RHI_SUCCESS;
+    }
+
+    RHIImageView VulkanRHI::createAttachmentImageView(RHIImage image, RHIFormat format)
+    {
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        switch (format)
+        {
+            case RHI_FORMAT_D16_UNORM:
+            case RHI_FORMAT_D32_SFLOAT:
+                aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+                break;
+            case RHI_FORMAT_D16_UNORM_S8_UINT:
+            case RHI_FORMAT_D24_UNORM_S8_UINT:
+            case RHI_FORMAT_D32_SFLOAT_S8_UINT:
+                aspect = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+                break;
+            default:
+                break;
+        }
+        VkImage      vk_image   = m_image_table.get(image);
+        RHIImageView image_view = createHandle(m_image_view_table, VulkanUtil::createImageView(m_device, vk_image, (VkFormat)format, aspect, VK_IMAGE_VIEW_TYPE_2D, 1, 1));
+        return image_view;
+    }
+
+    void VulkanRHI::destroyImage(RHIImage image, RHIImageView imageView)
+    {
+        deferDestroy([this, image, imageView]() {
+            if (imageView != nullptr)
+            {
+                vkDestroyImageView(m_device, m_image_view_table.get(imageView), nullptr);
+                destroyHandle(m_image_view_table, imageView);
+            }
+            vkDestroyImage(m_device, m_image_table.get(image), nullptr);
+            destroyHandle(m_image_table, image);
+        });
+    }
+
+    void VulkanRHI::freeImageMemory(RHIDeviceMemory memory)
+    {
+        deferDestroy([this, memory]() {
+            vmaFreeMemory(m_assets_allocator, m_device_memory_table.get<k_device_memory_field_allocation>(memory));
+            destroyHandle(m_device_memory_table, memory);
+        });
     }
 
-    bool VulkanRHI::createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout)
+    bool VulkanRHI::createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout &pSetLayout)
     {
+        ScratchScope scratch;
         //descriptor_set_layout_binding
         int descriptor_set_layout_binding_size = pCreateInfo->bindingCount;
-        std::vector<VkDescriptorSetLayoutBinding> vk_descriptor_set_layout_binding_list(descriptor_set_layout_binding_size);
+        VkDescriptorSetLayoutBinding* vk_descriptor_set_layout_binding_list = scratch.allocateArray<VkDescriptorSetLayoutBinding>(descriptor_set_layout_binding_size);
 
         int sampler_count = 0;
         for (int i = 0; i < descriptor_set_layout_binding_size; ++i)
@@ -1084,7 +2633,7 @@ namespace Aura {
                 sampler_count += rhi_descriptor_set_layout_binding_element.descriptorCount;
             }
         }
-        std::vector<VkSampler> sampler_list(sampler_count);
+        VkSampler* sampler_list = scratch.allocateArray<VkSampler>(sampler_count);
         int sampler_current = 0;
 
         for (int i = 0; i < descriptor_set_layout_binding_size; ++i)
@@ -1102,7 +2651,7 @@ namespace Aura {
                     const auto& rhi_sampler_element = rhi_descriptor_set_layout_binding_element.pImmutableSamplers[i];
                     auto& vk_sampler_element = sampler_list[sampler_current];
 
-                    vk_sampler_element = ((VulkanSampler*)rhi_sampler_element)->getResource();
+                    vk_sampler_element = m_sampler_table.get(rhi_sampler_element);
 
                     sampler_current++;
                 };
@@ -1124,61 +2673,617 @@ namespace Aura {
         create_info.pNext = (const void*)pCreateInfo->pNext;
         create_info.flags = (VkDescriptorSetLayoutCreateFlags)pCreateInfo->flags;
         create_info.bindingCount = pCreateInfo->bindingCount;
-        create_info.pBindings = vk_descriptor_set_layout_binding_list.data();
+        create_info.pBindings = vk_descriptor_set_layout_binding_list;
 
-        pSetLayout = new VulkanDescriptorSetLayout();
-        VkDescriptorSetLayout vk_descriptorSetLayout;
-        VkResult result = vkCreateDescriptorSetLayout(m_device, &create_info, nullptr, &vk_descriptorSetLayout);
-        ((VulkanDescriptorSetLayout*)pSetLayout)->setResource(vk_descriptorSetLayout);
+        auto create = [this, &create_info]() -> RHIDescriptorSetLayout {
+            VkDescriptorSetLayout vk_descriptorSetLayout;
+            if (vkCreateDescriptorSetLayout(m_device, &create_info, nullptr, &vk_descriptorSetLayout) != VK_SUCCESS)
+            {
+                LOG_ERROR("vkCreateDescriptorSetLayout failed!");
+                return nullptr;
+            }
+            RHIDescriptorSetLayout set_layout = createHandle(m_descriptor_set_layout_table, vk_descriptorSetLayout);
+            return set_layout;
+        };
 
-        if (result == VK_SUCCESS)
+        // binding flags come in through pNext, the bindless layout is never shared
+        if (create_info.pNext != nullptr)
         {
-            return RHI_SUCCESS;
+            pSetLayout = create();
+        }
+        else
+        {
+            VulkanObjectKey key;
+            key.add(create_info.flags).add(create_info.bindingCount);
+            for (uint32_t i = 0; i < create_info.bindingCount; ++i)
+            {
+                const VkDescriptorSetLayoutBinding& binding = vk_descriptor_set_layout_binding_list[i];
+                key.add(binding.binding).add(binding.descriptorType).add(binding.descriptorCount).add(binding.stageFlags);
+                key.addArray(binding.pImmutableSamplers, binding.pImmutableSamplers != nullptr ? binding.descriptorCount : 0);
+            }
+            pSetLayout = m_descriptor_set_layout_cache.acquire(key, create);
+        }
+        return pSetLayout != nullptr ? RHI_SUCCESS : false;
+    }
+
+    void VulkanRHI::destroyDescriptorSetLayout(RHIDescriptorSetLayout setLayout)
+    {
+        if (!m_descriptor_set_layout_cache.release(setLayout))
+        {
+            return;
+        }
+        deferDestroy([this, setLayout]() {
+            vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout_table.get(setLayout), nullptr);
+            destroyHandle(m_descriptor_set_layout_table, setLayout);
+        });
+    }
+
+    bool VulkanRHI::createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler &pSampler)
+    {
+        VkSamplerCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkSamplerCreateFlags)pCreateInfo->flags;
+        create_info.magFilter = (VkFilter)pCreateInfo->magFilter;
+        create_info.minFilter = (VkFilter)pCreateInfo->minFilter;
+        create_info.mipmapMode = (VkSamplerMipmapMode)pCreateInfo->mipmapMode;
+        create_info.addressModeU = (VkSamplerAddressMode)pCreateInfo->addressModeU;
+        create_info.addressModeV = (VkSamplerAddressMode)pCreateInfo->addressModeV;
+        create_info.addressModeW = (VkSamplerAddressMode)pCreateInfo->addressModeW;
+        create_info.mipLodBias = pCreateInfo->mipLodBias;
+        create_info.anisotropyEnable = (VkBool32)pCreateInfo->anisotropyEnable;
+        create_info.maxAnisotropy = pCreateInfo->maxAnisotropy;
+        create_info.compareEnable = (VkBool32)pCreateInfo->compareEnable;
+        create_info.compareOp = (VkCompareOp)pCreateInfo->compareOp;
+        create_info.minLod = pCreateInfo->minLod;
+        create_info.maxLod = pCreateInfo->maxLod;
+        create_info.borderColor = (VkBorderColor)pCreateInfo->borderColor;
+        create_info.unnormalizedCoordinates = (VkBool32)pCreateInfo->unnormalizedCoordinates;
+
+        auto create = [this, &create_info]() -> RHISampler {
+            VkSampler vk_sampler;
+            if (vkCreateSampler(m_device, &create_info, nullptr, &vk_sampler) != VK_SUCCESS)
+            {
+                LOG_ERROR("vkCreateSampler failed!");
+                return nullptr;
+            }
+            RHISampler sampler = createHandle(m_sampler_table, vk_sampler);
+            return sampler;
+        };
+
+        if (create_info.pNext != nullptr)
+        {
+            pSampler = create();
         }
         else
         {
-            LOG_ERROR("vkCreateDescriptorSetLayout failed!");
+            VulkanObjectKey key;
+            key.add(create_info.flags).add(create_info.magFilter).add(create_info.minFilter).add(create_info.mipmapMode);
+            key.add(create_info.addressModeU).add(create_info.addressModeV).add(create_info.addressModeW);
+            key.add(create_info.mipLodBias).add(create_info.anisotropyEnable).add(create_info.maxAnisotropy);
+            key.add(create_info.compareEnable).add(create_info.compareOp).add(create_info.minLod).add(create_info.maxLod);
+            key.add(create_info.borderColor).add(create_info.unnormalizedCoordinates);
+            pSampler = m_sampler_cache.acquire(key, create);
+        }
+        return pSampler != nullptr ? RHI_SUCCESS : false;
+    }
+
+    void VulkanRHI::destroySampler(RHISampler sampler)
+    {
+        if (!m_sampler_cache.release(sampler))
+        {
+            return;
+        }
+        deferDestroy([this, sampler]() {
+            vkDestroySampler(m_device, m_sampler_table.get(sampler), nullptr);
+            destroyHandle(m_sampler_table, sampler);
+        });
+    }
+
+    void VulkanRHI::getObjectCacheStats(RHIObjectCacheStats& renderPasses,
+                                        RHIObjectCacheStats& framebuffers,
+                                        RHIObjectCacheStats& descriptorSetLayouts,
+                                        RHIObjectCacheStats& samplers)
+    {
+        renderPasses         = m_render_pass_cache.getStats();
+        framebuffers         = m_framebuffer_cache.getStats();
+        descriptorSetLayouts = m_descriptor_set_layout_cache.getStats();
+        samplers             = m_sampler_cache.getStats();
+    }
+
+    RHIShader VulkanRHI::createShaderModule(const std::vector<unsigned char>& shader_code)
+    {
+        VkShaderModuleCreateInfo shader_module_create_info {};
+        shader_module_create_info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        shader_module_create_info.codeSize = shader_code.size();
+        shader_module_create_info.pCode    = (const uint32_t*)shader_code.data();
+
+        VkShaderModule vk_shader_module;
+        if (vkCreateShaderModule(m_device, &shader_module_create_info, nullptr, &vk_shader_module) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkCreateShaderModule failed!");
+            return nullptr;
+        }
+        RHIShader shader = createHandle(m_shader_table, vk_shader_module);
+        return shader;
+    }
+
+    void VulkanRHI::destroyShaderModule(RHIShader shader)
+    {
+        vkDestroyShaderModule(m_device, m_shader_table.get(shader), nullptr);
+        destroyHandle(m_shader_table, shader);
+    }
+
+    bool VulkanRHI::createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout &pPipelineLayout)
+    {
+        ScratchScope scratch;
+        //descriptor_set_layout
+        VkDescriptorSetLayout* vk_descriptor_set_layout_list = scratch.allocateArray<VkDescriptorSetLayout>(pCreateInfo->setLayoutCount);
+        for (uint32_t i = 0; i < pCreateInfo->setLayoutCount; ++i)
+        {
+            vk_descriptor_set_layout_list[i] = m_descriptor_set_layout_table.get(pCreateInfo->pSetLayouts[i]);
+        };
+
+        //push_constant_range
+        VkPushConstantRange* vk_push_constant_range_list = scratch.allocateArray<VkPushConstantRange>(pCreateInfo->pushConstantRangeCount);
+        for (uint32_t i = 0; i < pCreateInfo->pushConstantRangeCount; ++i)
+        {
+            const auto& rhi_push_constant_range_element = pCreateInfo->pPushConstantRanges[i];
+            auto& vk_push_constant_range_element = vk_push_constant_range_list[i];
+
+            vk_push_constant_range_element.stageFlags = (VkShaderStageFlags)rhi_push_constant_range_element.stageFlags;
+            vk_push_constant_range_element.offset = rhi_push_constant_range_element.offset;
+            vk_push_constant_range_element.size = rhi_push_constant_range_element.size;
+        };
+
+        VkPipelineLayoutCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkPipelineLayoutCreateFlags)pCreateInfo->flags;
+        create_info.setLayoutCount = pCreateInfo->setLayoutCount;
+        create_info.pSetLayouts = vk_descriptor_set_layout_list;
+        create_info.pushConstantRangeCount = pCreateInfo->pushConstantRangeCount;
+        create_info.pPushConstantRanges = vk_push_constant_range_list;
+
+        VkPipelineLayout vk_pipeline_layout;
+        if (vkCreatePipelineLayout(m_device, &create_info, nullptr, &vk_pipeline_layout) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkCreatePipelineLayout failed!");
+            pPipelineLayout = nullptr;
+            return false;
+        }
+        pPipelineLayout = createHandle(m_pipeline_layout_table, vk_pipeline_layout);
+        return true;
+    }
+
+    void VulkanRHI::destroyPipelineLayout(RHIPipelineLayout pipelineLayout)
+    {
+        vkDestroyPipelineLayout(m_device, m_pipeline_layout_table.get(pipelineLayout), nullptr);
+        destroyHandle(m_pipeline_layout_table, pipelineLayout);
+    }
+
+    // converts one shader stage, specialization map entries live in the caller's scratch scope
+    static void convertShaderStage(const VulkanShaderTable& shader_table,
+                                   const RHIPipelineShaderStageCreateInfo& rhi_stage,
+                                   VkPipelineShaderStageCreateInfo& vk_stage,
+                                   VkSpecializationInfo& vk_specialization_info,
+                                   ScratchScope& scratch)
+    {
+        vk_stage.sType = (VkStructureType)rhi_stage.sType;
+        vk_stage.pNext = (const void*)rhi_stage.pNext;
+        vk_stage.flags = (VkPipelineShaderStageCreateFlags)rhi_stage.flags;
+        vk_stage.stage = (VkShaderStageFlagBits)rhi_stage.stage;
+        vk_stage.module = shader_table.get(rhi_stage.module);
+        vk_stage.pName = rhi_stage.pName;
+        vk_stage.pSpecializationInfo = nullptr;
+        if (rhi_stage.pSpecializationInfo != nullptr)
+        {
+            const RHISpecializationInfo& rhi_specialization_info = *rhi_stage.pSpecializationInfo;
+            VkSpecializationMapEntry* vk_map_entries = scratch.allocateArray<VkSpecializationMapEntry>(rhi_specialization_info.mapEntryCount);
+            for (uint32_t i = 0; i < rhi_specialization_info.mapEntryCount; ++i)
+            {
+                vk_map_entries[i].constantID = rhi_specialization_info.pMapEntries[i].constantID;
+                vk_map_entries[i].offset = rhi_specialization_info.pMapEntries[i].offset;
+                vk_map_entries[i].size = rhi_specialization_info.pMapEntries[i].size;
+            }
+            vk_specialization_info.mapEntryCount = rhi_specialization_info.mapEntryCount;
+            vk_specialization_info.pMapEntries = vk_map_entries;
+            vk_specialization_info.dataSize = rhi_specialization_info.dataSize;
+            vk_specialization_info.pData = rhi_specialization_info.pData;
+            vk_stage.pSpecializationInfo = &vk_specialization_info;
+        }
+    }
+
+    bool VulkanRHI::createGraphicsPipeline(const RHIGraphicsPipelineCreateInfo* pCreateInfo, RHIPipeline &pPipeline)
+    {
+        ScratchScope scratch;
+        pPipeline = nullptr;
+
+        //shader_stages
+        VkPipelineShaderStageCreateInfo* vk_stages = scratch.allocateArray<VkPipelineShaderStageCreateInfo>(pCreateInfo->stageCount);
+        VkSpecializationInfo* vk_specialization_infos = scratch.allocateArray<VkSpecializationInfo>(pCreateInfo->stageCount);
+        for (uint32_t i = 0; i < pCreateInfo->stageCount; ++i)
+        {
+            convertShaderStage(m_shader_table, pCreateInfo->pStages[i], vk_stages[i], vk_specialization_infos[i], scratch);
+        }
+
+        //vertex_input_state
+        const RHIPipelineVertexInputStateCreateInfo& rhi_vertex_input_state = *pCreateInfo->pVertexInputState;
+        VkVertexInputBindingDescription* vk_bindings = scratch.allocateArray<VkVertexInputBindingDescription>(rhi_vertex_input_state.vertexBindingDescriptionCount);
+        for (uint32_t i = 0; i < rhi_vertex_input_state.vertexBindingDescriptionCount; ++i)
+        {
+            const auto& rhi_binding = rhi_vertex_input_state.pVertexBindingDescriptions[i];
+            vk_bindings[i].binding = rhi_binding.binding;
+            vk_bindings[i].stride = rhi_binding.stride;
+            vk_bindings[i].inputRate = (VkVertexInputRate)rhi_binding.inputRate;
+        }
+        VkVertexInputAttributeDescription* vk_attributes = scratch.allocateArray<VkVertexInputAttributeDescription>(rhi_vertex_input_state.vertexAttributeDescriptionCount);
+        for (uint32_t i = 0; i < rhi_vertex_input_state.vertexAttributeDescriptionCount; ++i)
+        {
+            const auto& rhi_attribute = rhi_vertex_input_state.pVertexAttributeDescriptions[i];
+            vk_attributes[i].location = rhi_attribute.location;
+            vk_attributes[i].binding = rhi_attribute.binding;
+            vk_attributes[i].format = (VkFormat)rhi_attribute.format;
+            vk_attributes[i].offset = rhi_attribute.offset;
+        }
+        VkPipelineVertexInputStateCreateInfo vk_vertex_input_state{};
+        vk_vertex_input_state.sType = (VkStructureType)rhi_vertex_input_state.sType;
+        vk_vertex_input_state.pNext = (const void*)rhi_vertex_input_state.pNext;
+        vk_vertex_input_state.flags = (VkPipelineVertexInputStateCreateFlags)rhi_vertex_input_state.flags;
+        vk_vertex_input_state.vertexBindingDescriptionCount = rhi_vertex_input_state.vertexBindingDescriptionCount;
+        vk_vertex_input_state.pVertexBindingDescriptions = vk_bindings;
+        vk_vertex_input_state.vertexAttributeDescriptionCount = rhi_vertex_input_state.vertexAttributeDescriptionCount;
+        vk_vertex_input_state.pVertexAttributeDescriptions = vk_attributes;
+
+        //input_assembly_state
+        const RHIPipelineInputAssemblyStateCreateInfo& rhi_input_assembly_state = *pCreateInfo->pInputAssemblyState;
+        VkPipelineInputAssemblyStateCreateInfo vk_input_assembly_state{};
+        vk_input_assembly_state.sType = (VkStructureType)rhi_input_assembly_state.sType;
+        vk_input_assembly_state.pNext = (const void*)rhi_input_assembly_state.pNext;
+        vk_input_assembly_state.flags = (VkPipelineInputAssemblyStateCreateFlags)rhi_input_assembly_state.flags;
+        vk_input_assembly_state.topology = (VkPrimitiveTopology)rhi_input_assembly_state.topology;
+        vk_input_assembly_state.primitiveRestartEnable = (VkBool32)rhi_input_assembly_state.primitiveRestartEnable;
+
+        //viewport_state, RHIViewport and RHIRect2D match the vulkan layout
+        const RHIPipelineViewportStateCreateInfo& rhi_viewport_state = *pCreateInfo->pViewportState;
+        VkPipelineViewportStateCreateInfo vk_viewport_state{};
+        vk_viewport_state.sType = (VkStructureType)rhi_viewport_state.sType;
+        vk_viewport_state.pNext = (const void*)rhi_viewport_state.pNext;
+        vk_viewport_state.flags = (VkPipelineViewportStateCreateFlags)rhi_viewport_state.flags;
+        vk_viewport_state.viewportCount = rhi_viewport_state.viewportCount;
+        vk_viewport_state.pViewports = (const VkViewport*)rhi_viewport_state.pViewports;
+        vk_viewport_state.scissorCount = rhi_viewport_state.scissorCount;
+        vk_viewport_state.pScissors = (const VkRect2D*)rhi_viewport_state.pScissors;
+
+        //rasterization_state
+        const RHIPipelineRasterizationStateCreateInfo& rhi_rasterization_state = *pCreateInfo->pRasterizationState;
+        VkPipelineRasterizationStateCreateInfo vk_rasterization_state{};
+        vk_rasterization_state.sType = (VkStructureType)rhi_rasterization_state.sType;
+        vk_rasterization_state.pNext = (const void*)rhi_rasterization_state.pNext;
+        vk_rasterization_state.flags = (VkPipelineRasterizationStateCreateFlags)rhi_rasterization_state.flags;
+        vk_rasterization_state.depthClampEnable = (VkBool32)rhi_rasterization_state.depthClampEnable;
+        vk_rasterization_state.rasterizerDiscardEnable = (VkBool32)rhi_rasterization_state.rasterizerDiscardEnable;
+        vk_rasterization_state.polygonMode = (VkPolygonMode)rhi_rasterization_state.polygonMode;
+        vk_rasterization_state.cullMode = (VkCullModeFlags)rhi_rasterization_state.cullMode;
+        vk_rasterization_state.frontFace = (VkFrontFace)rhi_rasterization_state.frontFace;
+        vk_rasterization_state.depthBiasEnable = (VkBool32)rhi_rasterization_state.depthBiasEnable;
+        vk_rasterization_state.depthBiasConstantFactor = rhi_rasterization_state.depthBiasConstantFactor;
+        vk_rasterization_state.depthBiasClamp = rhi_rasterization_state.depthBiasClamp;
+        vk_rasterization_state.depthBiasSlopeFactor = rhi_rasterization_state.depthBiasSlopeFactor;
+        vk_rasterization_state.lineWidth = rhi_rasterization_state.lineWidth;
+
+        //multisample_state
+        const RHIPipelineMultisampleStateCreateInfo& rhi_multisample_state = *pCreateInfo->pMultisampleState;
+        VkPipelineMultisampleStateCreateInfo vk_multisample_state{};
+        vk_multisample_state.sType = (VkStructureType)rhi_multisample_state.sType;
+        vk_multisample_state.pNext = (const void*)rhi_multisample_state.pNext;
+        vk_multisample_state.flags = (VkPipelineMultisampleStateCreateFlags)rhi_multisample_state.flags;
+        vk_multisample_state.rasterizationSamples = (VkSampleCountFlagBits)rhi_multisample_state.rasterizationSamples;
+        vk_multisample_state.sampleShadingEnable = (VkBool32)rhi_multisample_state.sampleShadingEnable;
+        vk_multisample_state.minSampleShading = rhi_multisample_state.minSampleShading;
+        vk_multisample_state.pSampleMask = (const VkSampleMask*)rhi_multisample_state.pSampleMask;
+        vk_multisample_state.alphaToCoverageEnable = (VkBool32)rhi_multisample_state.alphaToCoverageEnable;
+        vk_multisample_state.alphaToOneEnable = (VkBool32)rhi_multisample_state.alphaToOneEnable;
+
+        //depth_stencil_state, optional
+        VkPipelineDepthStencilStateCreateInfo vk_depth_stencil_state{};
+        if (pCreateInfo->pDepthStencilState != nullptr)
+        {
+            const RHIPipelineDepthStencilStateCreateInfo& rhi_depth_stencil_state = *pCreateInfo->pDepthStencilState;
+            auto convert_stencil_op_state = [](const RHIStencilOpState& rhi_state, VkStencilOpState& vk_state) {
+                vk_state.failOp = (VkStencilOp)rhi_state.failOp;
+                vk_state.passOp = (VkStencilOp)rhi_state.passOp;
+                vk_state.depthFailOp = (VkStencilOp)rhi_state.depthFailOp;
+                vk_state.compareOp = (VkCompareOp)rhi_state.compareOp;
+                vk_state.compareMask = rhi_state.compareMask;
+                vk_state.writeMask = rhi_state.writeMask;
+                vk_state.reference = rhi_state.reference;
+            };
+            vk_depth_stencil_state.sType = (VkStructureType)rhi_depth_stencil_state.sType;
+            vk_depth_stencil_state.pNext = (const void*)rhi_depth_stencil_state.pNext;
+            vk_depth_stencil_state.flags = (VkPipelineDepthStencilStateCreateFlags)rhi_depth_stencil_state.flags;
+            vk_depth_stencil_state.depthTestEnable = (VkBool32)rhi_depth_stencil_state.depthTestEnable;
+            vk_depth_stencil_state.depthWriteEnable = (VkBool32)rhi_depth_stencil_state.depthWriteEnable;
+            vk_depth_stencil_state.depthCompareOp = (VkCompareOp)rhi_depth_stencil_state.depthCompareOp;
+            vk_depth_stencil_state.depthBoundsTestEnable = (VkBool32)rhi_depth_stencil_state.depthBoundsTestEnable;
+            vk_depth_stencil_state.stencilTestEnable = (VkBool32)rhi_depth_stencil_state.stencilTestEnable;
+            convert_stencil_op_state(rhi_depth_stencil_state.front, vk_depth_stencil_state.front);
+            convert_stencil_op_state(rhi_depth_stencil_state.back, vk_depth_stencil_state.back);
+            vk_depth_stencil_state.minDepthBounds = rhi_depth_stencil_state.minDepthBounds;
+            vk_depth_stencil_state.maxDepthBounds = rhi_depth_stencil_state.maxDepthBounds;
+        }
+
+        //color_blend_state
+        const RHIPipelineColorBlendStateCreateInfo& rhi_color_blend_state = *pCreateInfo->pColorBlendState;
+        VkPipelineColorBlendAttachmentState* vk_blend_attachments = scratch.allocateArray<VkPipelineColorBlendAttachmentState>(rhi_color_blend_state.attachmentCount);
+        for (uint32_t i = 0; i < rhi_color_blend_state.attachmentCount; ++i)
+        {
+            const auto& rhi_attachment = rhi_color_blend_state.pAttachments[i];
+            auto& vk_attachment = vk_blend_attachments[i];
+            vk_attachment.blendEnable = (VkBool32)rhi_attachment.blendEnable;
+            vk_attachment.srcColorBlendFactor = (VkBlendFactor)rhi_attachment.srcColorBlendFactor;
+            vk_attachment.dstColorBlendFactor = (VkBlendFactor)rhi_attachment.dstColorBlendFactor;
+            vk_attachment.colorBlendOp = (VkBlendOp)rhi_attachment.colorBlendOp;
+            vk_attachment.srcAlphaBlendFactor = (VkBlendFactor)rhi_attachment.srcAlphaBlendFactor;
+            vk_attachment.dstAlphaBlendFactor = (VkBlendFactor)rhi_attachment.dstAlphaBlendFactor;
+            vk_attachment.alphaBlendOp = (VkBlendOp)rhi_attachment.alphaBlendOp;
+            vk_attachment.colorWriteMask = (VkColorComponentFlags)rhi_attachment.colorWriteMask;
+        }
+        VkPipelineColorBlendStateCreateInfo vk_color_blend_state{};
+        vk_color_blend_state.sType = (VkStructureType)rhi_color_blend_state.sType;
+        vk_color_blend_state.pNext = (const void*)rhi_color_blend_state.pNext;
+        vk_color_blend_state.flags = (VkPipelineColorBlendStateCreateFlags)rhi_color_blend_state.flags;
+        vk_color_blend_state.logicOpEnable = (VkBool32)rhi_color_blend_state.logicOpEnable;
+        vk_color_blend_state.logicOp = (VkLogicOp)rhi_color_blend_state.logicOp;
+        vk_color_blend_state.attachmentCount = rhi_color_blend_state.attachmentCount;
+        vk_color_blend_state.pAttachments = vk_blend_attachments;
+        for (int i = 0; i < 4; ++i)
+        {
+            vk_color_blend_state.blendConstants[i] = rhi_color_blend_state.blendConstants[i];
+        }
+
+        //dynamic_state, optional
+        VkPipelineDynamicStateCreateInfo vk_dynamic_state{};
+        if (pCreateInfo->pDynamicState != nullptr)
+        {
+            const RHIPipelineDynamicStateCreateInfo& rhi_dynamic_state = *pCreateInfo->pDynamicState;
+            vk_dynamic_state.sType = (VkStructureType)rhi_dynamic_state.sType;
+            vk_dynamic_state.pNext = (const void*)rhi_dynamic_state.pNext;
+            vk_dynamic_state.flags = (VkPipelineDynamicStateCreateFlags)rhi_dynamic_state.flags;
+            vk_dynamic_state.dynamicStateCount = rhi_dynamic_state.dynamicStateCount;
+            vk_dynamic_state.pDynamicStates = (const VkDynamicState*)rhi_dynamic_state.pDynamicStates;
+        }
+
+        VkPipelineCreationFeedback feedback{};
+        VkPipelineCreationFeedbackCreateInfo feedback_create_info{};
+        feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+        feedback_create_info.pNext = (const void*)pCreateInfo->pNext;
+        feedback_create_info.pPipelineCreationFeedback = &feedback;
+
+        VkGraphicsPipelineCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = m_pipeline_creation_feedback_supported ? (const void*)&feedback_create_info : (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkPipelineCreateFlags)pCreateInfo->flags;
+        create_info.stageCount = pCreateInfo->stageCount;
+        create_info.pStages = vk_stages;
+        create_info.pVertexInputState = &vk_vertex_input_state;
+        create_info.pInputAssemblyState = &vk_input_assembly_state;
+        create_info.pTessellationState = nullptr;
+        create_info.pViewportState = &vk_viewport_state;
+        create_info.pRasterizationState = &vk_rasterization_state;
+        create_info.pMultisampleState = &vk_multisample_state;
+        create_info.pDepthStencilState = pCreateInfo->pDepthStencilState != nullptr ? &vk_depth_stencil_state : nullptr;
+        create_info.pColorBlendState = &vk_color_blend_state;
+        create_info.pDynamicState = pCreateInfo->pDynamicState != nullptr ? &vk_dynamic_state : nullptr;
+        create_info.layout = m_pipeline_layout_table.get(pCreateInfo->layout);
+        create_info.renderPass = pCreateInfo->renderPass != nullptr ? m_render_pass_table.get(pCreateInfo->renderPass) : VK_NULL_HANDLE;
+        create_info.subpass = pCreateInfo->subpass;
+        create_info.basePipelineHandle = pCreateInfo->basePipelineHandle != nullptr ? m_pipeline_table.get(pCreateInfo->basePipelineHandle) : VK_NULL_HANDLE;
+        create_info.basePipelineIndex = pCreateInfo->basePipelineIndex;
+
+        auto compile_begin = std::chrono::steady_clock::now();
+        VkPipeline vk_pipeline;
+        if (vkCreateGraphicsPipelines(m_device, m_pipeline_cache.getResource(), 1, &create_info, nullptr, &vk_pipeline) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkCreateGraphicsPipelines failed!");
+            return false;
+        }
+        recordPipelineFeedback(feedback, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - compile_begin).count());
+
+        pPipeline = createHandle(m_pipeline_table, vk_pipeline);
+        return true;
+    }
+
+    bool VulkanRHI::createComputePipeline(const RHIComputePipelineCreateInfo* pCreateInfo, RHIPipeline &pPipeline)
+    {
+        ScratchScope scratch;
+        pPipeline = nullptr;
+
+        VkSpecializationInfo vk_specialization_info{};
+
+        VkPipelineCreationFeedback feedback{};
+        VkPipelineCreationFeedbackCreateInfo feedback_create_info{};
+        feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+        feedback_create_info.pNext = (const void*)pCreateInfo->pNext;
+        feedback_create_info.pPipelineCreationFeedback = &feedback;
+
+        VkComputePipelineCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = m_pipeline_creation_feedback_supported ? (const void*)&feedback_create_info : (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkPipelineCreateFlags)pCreateInfo->flags;
+        convertShaderStage(m_shader_table, pCreateInfo->stage, create_info.stage, vk_specialization_info, scratch);
+        create_info.layout = m_pipeline_layout_table.get(pCreateInfo->layout);
+        create_info.basePipelineHandle = pCreateInfo->basePipelineHandle != nullptr ? m_pipeline_table.get(pCreateInfo->basePipelineHandle) : VK_NULL_HANDLE;
+        create_info.basePipelineIndex = pCreateInfo->basePipelineIndex;
+
+        auto compile_begin = std::chrono::steady_clock::now();
+        VkPipeline vk_pipeline;
+        if (vkCreateComputePipelines(m_device, m_pipeline_cache.getResource(), 1, &create_info, nullptr, &vk_pipeline) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkCreateComputePipelines failed!");
             return false;
         }
+        recordPipelineFeedback(feedback, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - compile_begin).count());
+
+        pPipeline = createHandle(m_pipeline_table, vk_pipeline);
+        return true;
+    }
+
+    void VulkanRHI::recordPipelineFeedback(const VkPipelineCreationFeedback& feedback, uint64_t compile_us)
+    {
+        m_pipeline_compile_count++;
+        m_pipeline_compile_us += compile_us;
+        if ((feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT) &&
+            (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT))
+        {
+            m_pipeline_cache_hit_count++;
+        }
+    }
+
+    std::future<RHIPipeline> VulkanRHI::createGraphicsPipelineAsync(const RHIGraphicsPipelineCreateInfo* pCreateInfo)
+    {
+        auto create_info = std::make_shared<VulkanGraphicsPipelineCreateInfoCopy>(*pCreateInfo);
+        auto task        = std::make_shared<std::packaged_task<RHIPipeline()>>([this, create_info]() {
+            RHIPipeline  pipeline;
+            createGraphicsPipeline(create_info->get(), pipeline);
+            return pipeline;
+        });
+        std::future<RHIPipeline> result = task->get_future();
+        if (create_info->isComplete())
+        {
+            m_pipeline_compile_queue.push([task]() { (*task)(); });
+        }
+        else
+        {
+            // a pNext chain the copy could not take along is only valid during this call
+            (*task)();
+        }
+        return result;
+    }
+
+    std::future<RHIPipeline> VulkanRHI::createComputePipelineAsync(const RHIComputePipelineCreateInfo* pCreateInfo)
+    {
+        auto create_info = std::make_shared<VulkanComputePipelineCreateInfoCopy>(*pCreateInfo);
+        auto task        = std::make_shared<std::packaged_task<RHIPipeline()>>([this, create_info]() {
+            RHIPipeline  pipeline;
+            createComputePipeline(create_info->get(), pipeline);
+            return pipeline;
+        });
+        std::future<RHIPipeline> result = task->get_future();
+        if (create_info->isComplete())
+        {
+            m_pipeline_compile_queue.push([task]() { (*task)(); });
+        }
+        else
+        {
+            (*task)();
+        }
+        return result;
+    }
+
+    void VulkanRHI::destroyPipeline(RHIPipeline pipeline)
+    {
+        vkDestroyPipeline(m_device, m_pipeline_table.get(pipeline), nullptr);
+        destroyHandle(m_pipeline_table, pipeline);
     }
 
-    bool VulkanRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets)
+    bool VulkanRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet &pDescriptorSets)
     {
+        // pDescriptorSets holds a single set
+        if (pAllocateInfo->descriptorSetCount != 1)
+        {
+            LOG_ERROR("allocateDescriptorSets takes one set at a time");
+            pDescriptorSets = nullptr;
+            return false;
+        }
+        ScratchScope scratch;
         //descriptor_set_layout
         int descriptor_set_layout_size = pAllocateInfo->descriptorSetCount;
-        std::vector<VkDescriptorSetLayout> vk_descriptor_set_layout_list(descriptor_set_layout_size);
+        VkDescriptorSetLayout* vk_descriptor_set_layout_list = scratch.allocateArray<VkDescriptorSetLayout>(descriptor_set_layout_size);
         for (int i = 0; i < descriptor_set_layout_size; ++i)
         {
             const auto& rhi_descriptor_set_layout_element = pAllocateInfo->pSetLayouts[i];
             auto& vk_descriptor_set_layout_element = vk_descriptor_set_layout_list[i];
 
-            vk_descriptor_set_layout_element = ((VulkanDescriptorSetLayout*)rhi_descriptor_set_layout_element)->getResource();
-
-            VulkanDescriptorSetLayout* test = ((VulkanDescriptorSetLayout*)rhi_descriptor_set_layout_element);
-
-            test = nullptr;
+            vk_descriptor_set_layout_element = m_descriptor_set_layout_table.get(rhi_descriptor_set_layout_element);
         };
 
+        if (pAllocateInfo->descriptorPool == m_descriptor_pool)
+        {
+            VkDescriptorSet vk_descriptor_set;
+            if (!m_descriptor_allocator.allocate(vk_descriptor_set_layout_list[0], pAllocateInfo->pNext, vk_descriptor_set))
+            {
+                pDescriptorSets = nullptr;
+                return false;
+            }
+            pDescriptorSets = createHandle(m_descriptor_set_table, vk_descriptor_set);
+            return true;
+        }
+
         VkDescriptorSetAllocateInfo descriptorset_allocate_info{};
         descriptorset_allocate_info.sType = (VkStructureType)pAllocateInfo->sType;
         descriptorset_allocate_info.pNext = (const void*)pAllocateInfo->pNext;
-        descriptorset_allocate_info.descriptorPool = ((VulkanDescriptorPool*)(pAllocateInfo->descriptorPool))->getResource();
+        descriptorset_allocate_info.descriptorPool = m_descriptor_pool_table.get(pAllocateInfo->descriptorPool);
         descriptorset_allocate_info.descriptorSetCount = pAllocateInfo->descriptorSetCount;
-        descriptorset_allocate_info.pSetLayouts = vk_descriptor_set_layout_list.data();
+        descriptorset_allocate_info.pSetLayouts = vk_descriptor_set_layout_list;
+
+        VkDescriptorSet vk_descriptor_set;
+        if (vkAllocateDescriptorSets(m_device, &descriptorset_allocate_info, &vk_descriptor_set) != VK_SUCCESS)
+        {
+            LOG_ERROR("vkAllocateDescriptorSets failed!");
+            pDescriptorSets = nullptr;
+            return false;
+        }
+        pDescriptorSets = createHandle(m_descriptor_set_table, vk_descriptor_set);
+        return true;
+    }
+
+    void VulkanRHI::freeDescriptorSet(RHIDescriptorSet &descriptorSet)
+    {
+        m_descriptor_allocator.free(m_descriptor_set_table.get(descriptorSet));
+        destroyHandle(m_descriptor_set_table, descriptorSet);
+        descriptorSet = nullptr;
+    }
 
+    bool VulkanRHI::allocateFrameDescriptorSet(RHIDescriptorSetLayout layout, RHIDescriptorSet &descriptorSet)
+    {
         VkDescriptorSet vk_descriptor_set;
-        pDescriptorSets = new VulkanDescriptorSet;
-        VkResult result = vkAllocateDescriptorSets(m_device, &descriptorset_allocate_info, &vk_descriptor_set);
-        ((VulkanDescriptorSet*)pDescriptorSets)->setResource(vk_descriptor_set);
+        if (!m_frame_descriptor_allocators[m_current_frame_index].allocate(
+                m_descriptor_set_layout_table.get(layout), nullptr, vk_descriptor_set))
+        {
+            return false;
+        }
 
-        if (result == VK_SUCCESS)
+        // the wrappers are recycled with the frame as well
+        std::vector<RHIDescriptorSet>& handles = m_frame_descriptor_set_handles[m_current_frame_index];
+        uint32_t& handle_count = m_frame_descriptor_set_handle_count[m_current_frame_index];
+        if (handle_count == handles.size())
         {
-            return true;
+            handles.push_back(createHandle(m_descriptor_set_table, vk_descriptor_set));
         }
         else
         {
-            LOG_ERROR("vkAllocateDescriptorSets failed!");
-            return false;
+            m_descriptor_set_table.set(handles[handle_count], vk_descriptor_set);
+        }
+        descriptorSet = handles[handle_count++];
+        return true;
+    }
+
+    void VulkanRHI::getDescriptorAllocatorStats(RHIDescriptorAllocatorStats& persistent, RHIDescriptorAllocatorStats& transient) const
+    {
+        m_descriptor_allocator.getStats(persistent);
+        transient = {};
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            RHIDescriptorAllocatorStats frame_stats;
+            m_frame_descriptor_allocators[i].getStats(frame_stats);
+            transient.poolCount += frame_stats.poolCount;
+            transient.freePoolCount += frame_stats.freePoolCount;
+            transient.liveSetCount += frame_stats.liveSetCount;
+            transient.allocationCount += frame_stats.allocationCount;
+            transient.poolExhaustedCount += frame_stats.poolExhaustedCount;
+            transient.failedAllocationCount += frame_stats.failedAllocationCount;
+            transient.resetCount += frame_stats.resetCount;
         }
     }
 
@@ -1188,9 +3293,10 @@ namespace Aura {
         uint32_t descriptorCopyCount,
         const RHICopyDescriptorSet* pDescriptorCopies)
     {
+        ScratchScope scratch;
         //write_descriptor_set
         int write_descriptor_set_size = descriptorWriteCount;
-        std::vector<VkWriteDescriptorSet> vk_write_descriptor_set_list(write_descriptor_set_size);
+        VkWriteDescriptorSet* vk_write_descriptor_set_list = scratch.allocateArray<VkWriteDescriptorSet>(write_descriptor_set_size);
         int image_info_count = 0;
         int buffer_info_count = 0;
         for (int i = 0; i < write_descriptor_set_size; ++i)
@@ -1205,8 +3311,8 @@ namespace Aura {
                 buffer_info_count++;
             }
         }
-        std::vector<VkDescriptorImageInfo> vk_descriptor_image_info_list(image_info_count);
-        std::vector<VkDescriptorBufferInfo> vk_descriptor_buffer_info_list(buffer_info_count);
+        VkDescriptorImageInfo* vk_descriptor_image_info_list = scratch.allocateArray<VkDescriptorImageInfo>(image_info_count);
+        VkDescriptorBufferInfo* vk_descriptor_buffer_info_list = scratch.allocateArray<VkDescriptorBufferInfo>(buffer_info_count);
         int image_info_current = 0;
         int buffer_info_current = 0;
 
@@ -1225,9 +3331,9 @@ namespace Aura {
                 }
                 else
                 {
-                    vk_descriptor_image_info.sampler = ((VulkanSampler*)rhi_write_descriptor_set_element.pImageInfo->sampler)->getResource();
+                    vk_descriptor_image_info.sampler = m_sampler_table.get(rhi_write_descriptor_set_element.pImageInfo->sampler);
                 }
-                vk_descriptor_image_info.imageView = ((VulkanImageView*)rhi_write_descriptor_set_element.pImageInfo->imageView)->getResource();
+                vk_descriptor_image_info.imageView = m_image_view_table.get(rhi_write_descriptor_set_element.pImageInfo->imageView);
                 vk_descriptor_image_info.imageLayout = (VkImageLayout)rhi_write_descriptor_set_element.pImageInfo->imageLayout;
 
                 vk_descriptor_image_info_ptr = &vk_descriptor_image_info;
@@ -1238,7 +3344,7 @@ namespace Aura {
             if (rhi_write_descriptor_set_element.pBufferInfo != nullptr)
             {
                 auto& vk_descriptor_buffer_info = vk_descriptor_buffer_info_list[buffer_info_current];
-                vk_descriptor_buffer_info.buffer = ((VulkanBuffer*)rhi_write_descriptor_set_element.pBufferInfo->buffer)->getResource();
+                vk_descriptor_buffer_info.buffer = m_buffer_table.get(rhi_write_descriptor_set_element.pBufferInfo->buffer);
                 vk_descriptor_buffer_info.offset = (VkDeviceSize)rhi_write_descriptor_set_element.pBufferInfo->offset;
                 vk_descriptor_buffer_info.range = (VkDeviceSize)rhi_write_descriptor_set_element.pBufferInfo->range;
 
@@ -1248,7 +3354,7 @@ namespace Aura {
 
             vk_write_descriptor_set_element.sType = (VkStructureType)rhi_write_descriptor_set_element.sType;
             vk_write_descriptor_set_element.pNext = (const void*)rhi_write_descriptor_set_element.pNext;
-            vk_write_descriptor_set_element.dstSet = ((VulkanDescriptorSet*)rhi_write_descriptor_set_element.dstSet)->getResource();
+            vk_write_descriptor_set_element.dstSet = m_descriptor_set_table.get(rhi_write_descriptor_set_element.dstSet);
             vk_write_descriptor_set_element.dstBinding = rhi_write_descriptor_set_element.dstBinding;
             vk_write_descriptor_set_element.dstArrayElement = rhi_write_descriptor_set_element.dstArrayElement;
             vk_write_descriptor_set_element.descriptorCount = rhi_write_descriptor_set_element.descriptorCount;
@@ -1267,7 +3373,7 @@ namespace Aura {
 
         //copy_descriptor_set
         int copy_descriptor_set_size = descriptorCopyCount;
-        std::vector<VkCopyDescriptorSet> vk_copy_descriptor_set_list(copy_descriptor_set_size);
+        VkCopyDescriptorSet* vk_copy_descriptor_set_list = scratch.allocateArray<VkCopyDescriptorSet>(copy_descriptor_set_size);
         for (int i = 0; i < copy_descriptor_set_size; ++i)
         {
             const auto& rhi_copy_descriptor_set_element = pDescriptorCopies[i];
@@ -1275,44 +3381,191 @@ namespace Aura {
 
             vk_copy_descriptor_set_element.sType = (VkStructureType)rhi_copy_descriptor_set_element.sType;
             vk_copy_descriptor_set_element.pNext = (const void*)rhi_copy_descriptor_set_element.pNext;
-            vk_copy_descriptor_set_element.srcSet = ((VulkanDescriptorSet*)rhi_copy_descriptor_set_element.srcSet)->getResource();
+            vk_copy_descriptor_set_element.srcSet = m_descriptor_set_table.get(rhi_copy_descriptor_set_element.srcSet);
             vk_copy_descriptor_set_element.srcBinding = rhi_copy_descriptor_set_element.srcBinding;
             vk_copy_descriptor_set_element.srcArrayElement = rhi_copy_descriptor_set_element.srcArrayElement;
-            vk_copy_descriptor_set_element.dstSet = ((VulkanDescriptorSet*)rhi_copy_descriptor_set_element.dstSet)->getResource();
+            vk_copy_descriptor_set_element.dstSet = m_descriptor_set_table.get(rhi_copy_descriptor_set_element.dstSet);
             vk_copy_descriptor_set_element.dstBinding = rhi_copy_descriptor_set_element.dstBinding;
             vk_copy_descriptor_set_element.dstArrayElement = rhi_copy_descriptor_set_element.dstArrayElement;
             vk_copy_descriptor_set_element.descriptorCount = rhi_copy_descriptor_set_element.descriptorCount;
         };
 
-        vkUpdateDescriptorSets(m_device, descriptorWriteCount, vk_write_descriptor_set_list.data(), descriptorCopyCount, vk_copy_descriptor_set_list.data());
+        vkUpdateDescriptorSets(m_device, descriptorWriteCount, vk_write_descriptor_set_list, descriptorCopyCount, vk_copy_descriptor_set_list);
     }
 
-    void VulkanRHI::createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* & buffer, RHIDeviceMemory* & buffer_memory)
+    bool VulkanRHI::createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer & buffer, RHIDeviceMemory & buffer_memory, bool compute_shared)
     {
         VkBuffer vk_buffer;
-        VkDeviceMemory vk_device_memory;
-        
-        VulkanUtil::createBuffer(m_physical_device, m_device, size, usage, properties, vk_buffer, vk_device_memory);
+        VmaAllocation vk_allocation;
+        VmaAllocationInfo vk_allocation_info;
+
+        uint32_t queue_families[2] = {m_queue_indices.graphics_family.value(), m_queue_indices.m_compute_family.value()};
+        uint32_t queue_family_count = compute_shared && queue_families[0] != queue_families[1] ? 2 : 0;
+        if (!VulkanUtil::createBuffer(m_assets_allocator, size, usage, properties, vk_buffer, vk_allocation, &vk_allocation_info, queue_family_count, queue_families))
+        {
+            buffer = nullptr;
+            buffer_memory = nullptr;
+            return false;
+        }
+
+        buffer = createHandle(m_buffer_table, vk_buffer);
+        buffer_memory = createHandle(m_device_memory_table, vk_allocation_info.deviceMemory, vk_allocation, vk_allocation_info.pMappedData);
+        return true;
+    }
+
+    void VulkanRHI::destroyBuffer(RHIBuffer & buffer, RHIDeviceMemory & buffer_memory)
+    {
+        vmaDestroyBuffer(m_assets_allocator, m_buffer_table.get(buffer), m_device_memory_table.get<k_device_memory_field_allocation>(buffer_memory));
+        destroyHandle(m_buffer_table, buffer);
+        destroyHandle(m_device_memory_table, buffer_memory);
+        buffer = nullptr;
+        buffer_memory = nullptr;
+    }
+
+    void VulkanRHI::getMemoryHeapStats(std::vector<RHIMemoryHeapStats>& heap_stats)
+    {
+        const VkPhysicalDeviceMemoryProperties* memory_properties;
+        vmaGetMemoryProperties(m_assets_allocator, &memory_properties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_assets_allocator, budgets);
+
+        heap_stats.resize(memory_properties->memoryHeapCount);
+        for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i)
+        {
+            RHIMemoryHeapStats& stats = heap_stats[i];
+            stats.flags           = (RHIMemoryHeapFlags)memory_properties->memoryHeaps[i].flags;
+            stats.size            = memory_properties->memoryHeaps[i].size;
+            stats.budget          = budgets[i].budget;
+            stats.usage           = budgets[i].usage;
+            stats.blockBytes      = budgets[i].statistics.blockBytes;
+            stats.allocationBytes = budgets[i].statistics.allocationBytes;
+            stats.blockCount      = budgets[i].statistics.blockCount;
+            stats.allocationCount = budgets[i].statistics.allocationCount;
+        }
+    }
+
+    RHIUploadTicket VulkanRHI::copyBuffer(RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    {
+        return m_upload_manager.copyBuffer(srcBuffer, dstBuffer, srcOffset, dstOffset, size);
+    }
+
+    RHIUploadTicket VulkanRHI::uploadBuffer(RHIBuffer dstBuffer, RHIDeviceSize dstOffset, const void* pData, RHIDeviceSize size)
+    {
+        return m_upload_manager.uploadBuffer(dstBuffer, dstOffset, pData, size);
+    }
+
+    RHIUploadTicket VulkanRHI::flushUploads()
+    {
+        return m_upload_manager.flush();
+    }
+
+    void* VulkanRHI::allocateFrameData(RHIDeviceSize size, uint32_t& dynamicOffset)
+    {
+        return m_frame_ring_buffer.allocate(size, dynamicOffset);
+    }
+
+    RHIBuffer VulkanRHI::getFrameRingBuffer() const
+    {
+        return m_frame_ring_buffer.getBuffer();
+    }
+
+    RHIDescriptorSetLayout VulkanRHI::getBindlessDescriptorSetLayout() const
+    {
+        return m_bindless_descriptor_set_layout;
+    }
+
+    RHIDescriptorSet VulkanRHI::getBindlessDescriptorSet() const
+    {
+        return m_bindless_descriptor_set;
+    }
+
+    uint32_t VulkanRHI::registerBindlessTexture(RHIImageView imageView, RHISampler sampler, RHIImageLayout imageLayout)
+    {
+        if (!m_bindless_supported || m_bindless_free_textures.empty())
+        {
+            LOG_ERROR("no free bindless texture slot");
+            return RHI_INVALID_BINDLESS_INDEX;
+        }
+        uint32_t index = m_bindless_free_textures.back();
+        m_bindless_free_textures.pop_back();
+
+        VkDescriptorImageInfo image_info {};
+        image_info.sampler     = m_sampler_table.get(sampler);
+        image_info.imageView   = m_image_view_table.get(imageView);
+        image_info.imageLayout = (VkImageLayout)imageLayout;
+
+        VkWriteDescriptorSet write {};
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet          = m_descriptor_set_table.get(m_bindless_descriptor_set);
+        write.dstBinding      = k_bindless_texture_binding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo      = &image_info;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        return index;
+    }
 
-        buffer = new VulkanBuffer();
-        buffer_memory = new VulkanDeviceMemory();
-        ((VulkanBuffer*)buffer)->setResource(vk_buffer);
-        ((VulkanDeviceMemory*)buffer_memory)->setResource(vk_device_memory);
+    uint32_t VulkanRHI::registerBindlessBuffer(RHIBuffer buffer, RHIDeviceSize offset, RHIDeviceSize range)
+    {
+        if (!m_bindless_supported || m_bindless_free_buffers.empty())
+        {
+            LOG_ERROR("no free bindless buffer slot");
+            return RHI_INVALID_BINDLESS_INDEX;
+        }
+        uint32_t index = m_bindless_free_buffers.back();
+        m_bindless_free_buffers.pop_back();
+
+        VkDescriptorBufferInfo buffer_info {};
+        buffer_info.buffer = m_buffer_table.get(buffer);
+        buffer_info.offset = offset;
+        buffer_info.range  = range;
+
+        VkWriteDescriptorSet write {};
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet          = m_descriptor_set_table.get(m_bindless_descriptor_set);
+        write.dstBinding      = k_bindless_buffer_binding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo     = &buffer_info;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void VulkanRHI::releaseBindlessTexture(uint32_t index)
+    {
+        if (index != RHI_INVALID_BINDLESS_INDEX)
+        {
+            m_bindless_retired_textures[m_current_frame_index].push_back(index);
+        }
+    }
+
+    void VulkanRHI::releaseBindlessBuffer(uint32_t index)
+    {
+        if (index != RHI_INVALID_BINDLESS_INDEX)
+        {
+            m_bindless_retired_buffers[m_current_frame_index].push_back(index);
+        }
+    }
+
+    bool VulkanRHI::isUploadComplete(RHIUploadTicket ticket)
+    {
+        return m_upload_manager.isComplete(ticket);
     }
 
-    void VulkanRHI::copyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    void VulkanRHI::waitForUpload(RHIUploadTicket ticket)
     {
-        VkBuffer vk_src_buffer = ((VulkanBuffer*)srcBuffer)->getResource();
-        VkBuffer vk_dst_buffer = ((VulkanBuffer*)dstBuffer)->getResource();
-        VulkanUtil::copyBuffer(this, vk_src_buffer, vk_dst_buffer, srcOffset, dstOffset, size);
+        m_upload_manager.wait(ticket);
     }
 
-    RHICommandBuffer* VulkanRHI::beginSingleTimeCommands()
+    RHICommandBuffer VulkanRHI::beginSingleTimeCommands()
     {
         VkCommandBufferAllocateInfo allocInfo {};
         allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool        = ((VulkanCommandPool*)m_rhi_command_pool)->getResource();
+        allocInfo.commandPool        = m_command_pool_table.get(m_rhi_command_pool);
         allocInfo.commandBufferCount = 1;
 
         VkCommandBuffer command_buffer;
@@ -1324,14 +3577,13 @@ namespace Aura {
 
         _vkBeginCommandBuffer(command_buffer, &beginInfo);
 
-        RHICommandBuffer* rhi_command_buffer = new VulkanCommandBuffer();
-        ((VulkanCommandBuffer*)rhi_command_buffer)->setResource(command_buffer);
+        RHICommandBuffer rhi_command_buffer = createHandle(m_command_buffer_table, command_buffer);
         return rhi_command_buffer;
     }
 
-    void VulkanRHI::endSingleTimeCommands(RHICommandBuffer* command_buffer)
+    void VulkanRHI::endSingleTimeCommands(RHICommandBuffer command_buffer)
     {
-        VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)command_buffer)->getResource();
+        VkCommandBuffer vk_command_buffer = m_command_buffer_table.get(command_buffer);
         _vkEndCommandBuffer(vk_command_buffer);
 
         VkSubmitInfo submitInfo {};
@@ -1339,10 +3591,12 @@ namespace Aura {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers    = &vk_command_buffer;
 
-        vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(((VulkanQueue*)m_graphics_queue)->getResource());
+        // only wait for this submission, not for everything else queued on the graphics queue
+        vkResetFences(m_device, 1, &m_single_time_commands_fence);
+        vkQueueSubmit(m_queue_table.get(m_graphics_queue), 1, &submitInfo, m_single_time_commands_fence);
+        vkWaitForFences(m_device, 1, &m_single_time_commands_fence, VK_TRUE, UINT64_MAX);
 
-        vkFreeCommandBuffers(m_device, ((VulkanCommandPool*)m_rhi_command_pool)->getResource(), 1, &vk_command_buffer);
-        delete(command_buffer);
+        vkFreeCommandBuffers(m_device, m_command_pool_table.get(m_rhi_command_pool), 1, &vk_command_buffer);
+        destroyHandle(m_command_buffer_table, command_buffer);
     }
 }
\ No newline at end of file
@@ -8,10 +8,25 @@
 #include <vector>
 #include <algorithm>
 #include <set>
+#include <string>
 #include "../rhi_struct.h"
 #include "vulkan_rhi_resource.h"
 #include "../../render_type.h"
 #include "vulkan_util.h"
+#include "vulkan_upload_manager.h"
+#include "vulkan_async_compute.h"
+#include "vulkan_frame_ring_buffer.h"
+#include "vulkan_descriptor_allocator.h"
+#include "vulkan_pipeline_cache.h"
+#include "vulkan_parallel_recorder.h"
+#include "vulkan_object_cache.h"
+#include "../../../util/object_pool.hpp"
+#include "../../../util/scratch_arena.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
 #include <vk_mem_alloc.h>
 
 
@@ -22,6 +37,17 @@ const uint32_t HEIGHT = 600;
 
 
 namespace Aura {
+    // gpu time of one profiling scope, depth 0 is the whole frame
+    // names are truncated copies, a std::string would allocate for every long pass name every frame
+    static uint32_t const k_max_gpu_profile_name_length {64};
+
+    struct GpuPassTiming
+    {
+        char        name[k_max_gpu_profile_name_length];
+        uint32_t    depth;
+        float       ms;
+    };
+
     class VulkanRHI : public RHI {
         public:
             virtual void initialize();
@@ -29,6 +55,71 @@ namespace Aura {
             
             static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
             bool framebufferResized = false;
+            // headless mode: no window, surface or swapchain, frames are rendered into
+            // RHI-owned offscreen color images, must be set before initialize()
+            bool m_headless = false;
+            // gpu time of the most recently completed frame, negative until one is available
+            float m_gpu_frame_time_ms = -1.0f;
+            // frames the cpu may record ahead of the gpu, 1 for the lowest latency up to 3 for throughput.
+            // must be set before initialize(), use setFramesInFlight() afterwards
+            uint32_t m_frames_in_flight = 3;
+            // time from the cpu starting a frame to the gpu finishing it, negative until a frame has completed
+            float m_cpu_to_gpu_latency_ms = -1.0f;
+            // frame pacing runs on one timeline semaphore, otherwise on a binary fence per frame
+            bool m_timeline_semaphore_supported = false;
+            // preferred present mode, a missing one falls back to its closest substitute and finally FIFO.
+            // set before initialize() or through setPresentMode()
+            RHIPresentMode m_present_mode = RHI_PRESENT_MODE_MAILBOX_KHR;
+            // the mode the current swapchain was created with
+            RHIPresentMode m_active_present_mode = RHI_PRESENT_MODE_FIFO_KHR;
+            // time from markInputSampled() until the frame reached the display, or until its rendering
+            // finished without VK_KHR_present_wait. negative until measured
+            float m_input_to_present_ms = -1.0f;
+            bool m_present_wait_supported = false;
+            // swapchain recreations so far, the old swapchain is handed to the new one instead of draining the gpu
+            uint32_t m_swapchain_recreate_count = 0;
+            // size of the persistently mapped staging ring used by uploadBuffer, must be set before initialize()
+            RHIDeviceSize m_upload_ring_size = 64 * 1024 * 1024;
+            // per frame in flight share of the dynamic uniform/storage ring, must be set before initialize()
+            RHIDeviceSize m_frame_ring_buffer_size = 4 * 1024 * 1024;
+            // sets per transient pool, later pools in the chain grow from this
+            uint32_t m_frame_descriptor_sets_per_pool = 256;
+            // bindless array sizes, clamped to the device's update-after-bind limits, must be set before initialize()
+            uint32_t m_max_bindless_textures = 16384;
+            uint32_t m_max_bindless_buffers = 16384;
+            // the device has a lazily allocated memory type, attachments that never leave the render pass are
+            // only backed by tile memory then
+            bool m_lazily_allocated_memory_supported = false;
+            // vkCmdBeginRendering is available (1.3), render passes then need no render pass or framebuffer objects
+            bool m_dynamic_rendering_supported = false;
+            // descriptor indexing is available and the global bindless set was created
+            bool m_bindless_supported = false;
+            static uint32_t const k_bindless_texture_binding {0};
+            static uint32_t const k_bindless_buffer_binding {1};
+            // per-scope gpu times of the most recently completed frame, in begin order
+            std::vector<GpuPassTiming> m_gpu_pass_timings;
+            // loaded in initialize() and written back by shutdown(), empty disables persistence
+            std::string m_pipeline_cache_path = "aura_pipeline_cache.bin";
+            // shared worker pool, owned by the caller and set before initialize(). cmdRecordParallel fans out
+            // over it and waitForFences runs its jobs while the gpu is still busy
+            JobSystem* m_job_system = nullptr;
+            // secondaries recorded next to the main thread's in cmdRecordParallel, capped by the job system's threads
+            uint32_t m_recording_worker_threads = 3;
+            // worker threads for the *Async pipeline calls, 0 compiles on the calling thread
+            uint32_t m_pipeline_compile_threads = 2;
+            // pipeline creation counters, cache hits are only known on devices with creation feedback (1.3)
+            std::atomic<uint32_t> m_pipeline_compile_count {0};
+            std::atomic<uint32_t> m_pipeline_cache_hit_count {0};
+            std::atomic<uint64_t> m_pipeline_compile_us {0};
+            // heap blocks the scratch arenas of all threads took between the last two waitForFences. translation
+            // temporaries come from the arenas, so this drops to 0 once they have grown to what a frame needs
+            uint64_t m_frame_scratch_heap_allocations = 0;
+            // global operator new calls of all threads from the end of the fence wait in waitForFences to the
+            // present in submitRendering. a swapchain recreation after the present is not counted
+            uint64_t m_frame_heap_allocations = 0;
+            // debug builds assert that m_frame_scratch_heap_allocations and m_frame_heap_allocations stay 0, set it
+            // once the workload is warm
+            bool m_assert_allocation_free_frames = false;
 
         private:
             void createInstance();
@@ -44,12 +135,15 @@ namespace Aura {
             bool isDeviceSuitable(VkPhysicalDevice physicalm_device);
             QueueFamilyIndices VulkanRHI::findQueueFamilies(VkPhysicalDevice physicalm_device);
             bool checkDeviceExtensionSupport(VkPhysicalDevice physicalm_device);
+            bool isDeviceExtensionAvailable(VkPhysicalDevice physicalm_device, const char* extension_name);
             SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physicalm_device);
 
             void createLogicalDevice();
 
 
             static uint8_t const k_max_frames_in_flight {3};
+            static uint32_t const k_max_gpu_profile_scopes {64};
+            static uint32_t const k_max_rendering_attachments {8};
             uint32_t m_max_vertex_blending_mesh_count{ 256 };
             uint32_t m_max_material_count{ 256 };
             bool m_enable_validation_Layers{true};
@@ -58,24 +152,26 @@ namespace Aura {
             const std::vector<const char*> validationLayers = {
                 "VK_LAYER_KHRONOS_validation"
             };
-            uint32_t m_vulkan_api_version {VK_API_VERSION_1_0};
+            uint32_t m_vulkan_api_version {VK_API_VERSION_1_3};
             std::vector<char const*> m_device_extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+            bool m_memory_budget_supported {false};
+            bool m_pipeline_creation_feedback_supported {false};
         public:
             GLFWwindow*        m_window {nullptr};
             VkSurfaceKHR       m_surface {nullptr};
-            RHIQueue* m_graphics_queue{ nullptr };
-            RHIQueue* m_compute_queue{ nullptr };
+            RHIQueue  m_graphics_queue{ nullptr };
+            RHIQueue  m_compute_queue{ nullptr };
             VkDevice           m_device {nullptr};
             VkQueue            m_present_queue {nullptr};
             RHIFormat m_depth_image_format{ RHI_FORMAT_UNDEFINED };
-            RHIDescriptorPool* m_descriptor_pool = new VulkanDescriptorPool();
+            RHIDescriptorPool m_descriptor_pool {nullptr};
 
-            VmaAllocator m_assets_allocator;
+            VmaAllocator m_assets_allocator {nullptr};
 
             VkDescriptorPool m_vk_descriptor_pool;
                 // function pointers
-            PFN_vkCmdBeginDebugUtilsLabelEXT _vkCmdBeginDebugUtilsLabelEXT;
-            PFN_vkCmdEndDebugUtilsLabelEXT   _vkCmdEndDebugUtilsLabelEXT;
+            PFN_vkCmdBeginDebugUtilsLabelEXT _vkCmdBeginDebugUtilsLabelEXT {nullptr};
+            PFN_vkCmdEndDebugUtilsLabelEXT   _vkCmdEndDebugUtilsLabelEXT {nullptr};
             PFN_vkWaitForFences         _vkWaitForFences;
             PFN_vkResetFences           _vkResetFences;
             PFN_vkResetCommandPool      _vkResetCommandPool;
@@ -84,6 +180,8 @@ namespace Aura {
             PFN_vkCmdBeginRenderPass    _vkCmdBeginRenderPass;
             PFN_vkCmdNextSubpass        _vkCmdNextSubpass;
             PFN_vkCmdEndRenderPass      _vkCmdEndRenderPass;
+            PFN_vkCmdBeginRendering     _vkCmdBeginRendering {nullptr};
+            PFN_vkCmdEndRendering       _vkCmdEndRendering {nullptr};
             PFN_vkCmdBindPipeline       _vkCmdBindPipeline;
             PFN_vkCmdSetViewport        _vkCmdSetViewport;
             PFN_vkCmdSetScissor         _vkCmdSetScissor;
@@ -92,34 +190,134 @@ namespace Aura {
             PFN_vkCmdBindDescriptorSets _vkCmdBindDescriptorSets;
             PFN_vkCmdDrawIndexed        _vkCmdDrawIndexed;
             PFN_vkCmdClearAttachments   _vkCmdClearAttachments;
+            PFN_vkWaitForPresentKHR     _vkWaitForPresentKHR {nullptr};
 
             VkSemaphore          m_image_available_for_render_semaphores[k_max_frames_in_flight];
             VkSemaphore          m_image_finished_for_presentation_semaphores[k_max_frames_in_flight];
-            RHISemaphore*        m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight];
+            RHISemaphore         m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight];
             VkFence              m_is_frame_in_flight_fences[k_max_frames_in_flight];
-            RHIFence* m_rhi_is_frame_in_flight_fences[k_max_frames_in_flight];
+            RHIFence m_rhi_is_frame_in_flight_fences[k_max_frames_in_flight];
+            // signaled with the frame serial at the end of every frame's submit
+            VkSemaphore          m_frame_timeline_semaphore {VK_NULL_HANDLE};
 
             VkSwapchainKHR           m_swapchain {nullptr};
             std::vector<VkImage>     m_swapchain_images;
+            std::vector<VmaAllocation> m_offscreen_image_allocations;
             RHIFormat m_swapchain_image_format{ RHI_FORMAT_UNDEFINED };
             RHIExtent2D m_swapchain_extent;
             RHIRect2D m_scissor;
-            std::vector<RHIImageView*> m_swapchain_imageviews;
+            std::vector<RHIImageView> m_swapchain_imageviews;
+            // m_swapchain_images wrapped for barriers, not owned
+            std::vector<RHIImage> m_swapchain_rhi_images;
 
-            RHIImage*        m_depth_image = new VulkanImage();
-            VkDeviceMemory m_depth_image_memory {nullptr};
-            RHIImageView* m_depth_image_view = new VulkanImageView();
+            RHIImage      m_depth_image {nullptr};
+            VmaAllocation m_depth_image_allocation {nullptr};
+            RHIImageView  m_depth_image_view {nullptr};
+
+            // the vulkan objects behind every handle handed out. a destroy with a handle that is no longer live
+            // is reported instead of freeing twice, and a lookup with one reads null instead of a reused slot
+            VulkanBufferTable              m_buffer_table;
+            VulkanDeviceMemoryTable        m_device_memory_table;
+            VulkanImageTable               m_image_table;
+            VulkanImageViewTable           m_image_view_table;
+            VulkanSamplerTable             m_sampler_table;
+            VulkanRenderPassTable          m_render_pass_table;
+            VulkanFramebufferTable         m_framebuffer_table;
+            VulkanDescriptorSetLayoutTable m_descriptor_set_layout_table;
+            VulkanDescriptorSetTable       m_descriptor_set_table;
+            VulkanDescriptorPoolTable      m_descriptor_pool_table;
+            VulkanShaderTable              m_shader_table;
+            VulkanPipelineLayoutTable      m_pipeline_layout_table;
+            VulkanPipelineTable            m_pipeline_table;
+            VulkanQueueTable               m_queue_table;
+            VulkanCommandPoolTable         m_command_pool_table;
+            VulkanCommandBufferTable       m_command_buffer_table;
+            VulkanSemaphoreTable           m_semaphore_table;
+            VulkanFenceTable               m_fence_table;
 
             uint32_t m_current_swapchain_image_index;
         private:
             VkInstance m_instance;
             VkPhysicalDevice m_physical_device;
             QueueFamilyIndices m_queue_indices;
-            VulkanCommandPool* m_rhi_command_pool;
+            RHICommandPool       m_rhi_command_pool {nullptr};
+            VkFence              m_single_time_commands_fence {VK_NULL_HANDLE};
+            VulkanUploadManager  m_upload_manager;
+            VulkanAsyncCompute   m_async_compute;
+            RHICommandBuffer     m_compute_command_buffers[k_max_frames_in_flight] {};
+            VulkanFrameRingBuffer m_frame_ring_buffer;
+            // m_descriptor_pool allocations go to the persistent chain, frame sets die with their frame
+            VulkanDescriptorAllocator m_descriptor_allocator;
+            VulkanDescriptorAllocator m_frame_descriptor_allocators[k_max_frames_in_flight];
+            std::vector<RHIDescriptorSet> m_frame_descriptor_set_handles[k_max_frames_in_flight];
+            uint32_t             m_frame_descriptor_set_handle_count[k_max_frames_in_flight] {};
+            VulkanParallelRecorder m_parallel_recorder;
+            // inherited by the secondaries of cmdRecordParallel
+            VkRenderPass         m_current_render_pass {VK_NULL_HANDLE};
+            VkFramebuffer        m_current_framebuffer {VK_NULL_HANDLE};
+            uint32_t             m_current_subpass {0};
+            // attachment formats of the current dynamic rendering scope, m_current_render_pass is null inside one
+            std::vector<VkFormat> m_current_color_formats;
+            VkFormat             m_current_depth_format {VK_FORMAT_UNDEFINED};
+            VkFormat             m_current_stencil_format {VK_FORMAT_UNDEFINED};
+            VulkanPipelineCache  m_pipeline_cache;
+            // only framebuffers die with their last reference, they are keyed on image view handles
+            VulkanObjectCache<RHIRenderPass>          m_render_pass_cache {true};
+            VulkanObjectCache<RHIFramebuffer>         m_framebuffer_cache {false};
+            VulkanObjectCache<RHIDescriptorSetLayout> m_descriptor_set_layout_cache {true};
+            VulkanObjectCache<RHISampler>             m_sampler_cache {true};
+            VulkanPipelineCompileQueue m_pipeline_compile_queue;
+            template<typename Handle, typename... Fields, typename... Args>
+            Handle createHandle(ObjectPool<Handle, Fields...>& table, const Args&... fields);
+            template<typename Handle, typename... Fields>
+            void destroyHandle(ObjectPool<Handle, Fields...>& table, Handle handle);
+            VkDescriptorPool     m_bindless_descriptor_pool {VK_NULL_HANDLE};
+            RHIDescriptorSetLayout m_bindless_descriptor_set_layout {nullptr};
+            RHIDescriptorSet     m_bindless_descriptor_set {nullptr};
+            std::vector<uint32_t> m_bindless_free_textures;
+            std::vector<uint32_t> m_bindless_free_buffers;
+            // released indices wait for the frame that released them before they are handed out again
+            std::vector<uint32_t> m_bindless_retired_textures[k_max_frames_in_flight];
+            std::vector<uint32_t> m_bindless_retired_buffers[k_max_frames_in_flight];
             VkCommandPool        m_command_pools[k_max_frames_in_flight];
             VkCommandBuffer      m_vk_command_buffers[k_max_frames_in_flight];
-            RHICommandBuffer* m_command_buffers[k_max_frames_in_flight];
+            RHICommandBuffer m_command_buffers[k_max_frames_in_flight];
             uint8_t              m_current_frame_index {0};
+            // serial 0 is never submitted, so a slot that has not been used yet counts as complete
+            uint64_t             m_submitted_frame_serial {0};
+            uint64_t             m_completed_frame_serial {0};
+            uint64_t             m_latency_frame_serial {0};
+            uint64_t             m_frame_serials[k_max_frames_in_flight] {};
+            uint64_t             m_scratch_heap_allocation_mark {0};
+            uint64_t             m_heap_allocation_mark {0};
+            std::chrono::steady_clock::time_point m_frame_begin_times[k_max_frames_in_flight];
+            std::chrono::steady_clock::time_point m_frame_input_times[k_max_frames_in_flight];
+            // presents not yet seen on the display, a ring in present id (frame serial) order
+            struct PendingPresent
+            {
+                uint64_t                              present_id;
+                std::chrono::steady_clock::time_point input_time;
+            };
+            static uint32_t const k_max_pending_presents {2 * k_max_frames_in_flight};
+            PendingPresent       m_pending_presents[k_max_pending_presents] {};
+            uint32_t             m_pending_present_first {0};
+            uint32_t             m_pending_present_count {0};
+            bool                 m_present_mode_changed {false};
+            // run once the frame serial they were queued at has completed
+            std::deque<std::pair<uint64_t, std::function<void()>>> m_deferred_destroys;
+            struct GpuProfileScopeRecord
+            {
+                char     name[k_max_gpu_profile_name_length];
+                uint32_t depth;
+                uint32_t begin_query;
+            };
+            // one timestamp pool per frame in flight so the previous frames' results are read without stalling
+            VkQueryPool          m_timestamp_query_pools[k_max_frames_in_flight] {};
+            float                m_timestamp_period {0.0f};
+            uint64_t             m_timestamp_valid_mask {0};
+            std::vector<GpuProfileScopeRecord> m_gpu_profile_scopes[k_max_frames_in_flight];
+            std::vector<uint32_t> m_gpu_profile_scope_stack;
+            std::vector<uint64_t> m_timestamp_results;
             void initWindow();
             void createWindowSurface();
             VkFormat findDepthFormat();
@@ -131,27 +329,184 @@ namespace Aura {
             void createCommandBuffers();
             void createDescriptorPool();
             void createSyncPrimitives();
-            void createSwapchain();
+            void createTimestampQueryPools();
+            void createSwapchain(VkSwapchainKHR old_swapchain = VK_NULL_HANDLE);
             VkSurfaceFormatKHR chooseSwapchainSurfaceFormatFromDetails(const std::vector<VkSurfaceFormatKHR>& available_surface_formats);
             VkPresentModeKHR VulkanRHI::chooseSwapchainPresentModeFromDetails(const std::vector<VkPresentModeKHR>& available_present_modes);
             VkExtent2D chooseSwapchainExtentFromDetails(const VkSurfaceCapabilitiesKHR& capabilities);
             void createSwapchainImageViews();
+            void createOffscreenImages();
             void createFramebufferImageAndView();
             void createAssetAllocator();
-            void recreateSwapChain();
+            void createUploadManager();
+            void createAsyncCompute();
+            void createFrameRingBuffer();
+            void createBindlessDescriptorSet();
+            void createPipelineCache();
+            void recordPipelineFeedback(const VkPipelineCreationFeedback& feedback, uint64_t compile_us);
+            void recreateSwapChain(const std::function<void()>& passUpdateAfterRecreateSwapchain);
+            void runDeferredDestroys(uint64_t completed_serial);
+            bool waitForFrameSerial(uint64_t serial);
+            // recycles everything the frame in this slot released once the gpu is done with it
+            void recycleFrame(uint32_t frame_index);
+            void updateFrameLatency();
+            void updatePresentLatency();
             
-            void destroyImageView(RHIImageView* imageView);
+            void destroyImageView(RHIImageView imageView);
         public:
+            // finishes queued pipeline compiles and persists the pipeline cache
+            void shutdown();
             void waitForFences();
-            void prepareBeforePass();
-            bool createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass);
-            bool createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer);
-            bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout);
-            bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets);
+            // between frames only, waits for the gpu to drain before switching
+            void setFramesInFlight(uint32_t count);
+            // the swapchain is recreated with the new mode after the next present
+            void setPresentMode(RHIPresentMode mode);
+            // call right after polling input for the current frame, waitForFences() stands in otherwise
+            void markInputSampled();
+            // frames are numbered from 1 in submit order, whatever a frame released may be reused once
+            // getCompletedFrameSerial() has reached its serial
+            uint64_t getSubmittedFrameSerial() const { return m_submitted_frame_serial; }
+            uint64_t getCompletedFrameSerial();
+            // both may recreate the swapchain, passUpdateAfterRecreateSwapchain then rebuilds whatever
+            // references the swapchain images or depth image
+            bool prepareBeforePass(const std::function<void()>& passUpdateAfterRecreateSwapchain);
+            void submitRendering(const std::function<void()>& passUpdateAfterRecreateSwapchain);
+            // destroy runs once every frame submitted so far has completed, or at shutdown()
+            void deferDestroy(std::function<void()> destroy);
+            RHICommandBuffer getCurrentCommandBuffer() const;
+            // recorded for m_compute_queue between waitForFences() and submitRendering(), which submits it ahead of
+            // the frame's graphics work. that waits for it at the draw indirect and vertex input stages
+            RHICommandBuffer getCurrentComputeCommandBuffer();
+            // per-frame resources are indexed by this, sized for getMaxFramesInFlight()
+            uint32_t getCurrentFrameIndex() const { return m_current_frame_index; }
+            static uint32_t getMaxFramesInFlight() { return k_max_frames_in_flight; }
+            void cmdBeginRenderPass(RHICommandBuffer commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents);
+            void cmdNextSubpass(RHICommandBuffer commandBuffer, RHISubpassContents contents);
+            void cmdEndRenderPass(RHICommandBuffer commandBuffer);
+            // only when m_dynamic_rendering_supported. nothing transitions the attachments, the caller puts them into
+            // their attachment layouts beforehand. pFormats describes the attachments to the secondaries of
+            // cmdRecordParallel and is required when the contents are recorded there
+            void cmdBeginRendering(RHICommandBuffer commandBuffer, const RHIRenderingInfo* pRenderingInfo, const RHIPipelineRenderingCreateInfo* pFormats);
+            void cmdEndRendering(RHICommandBuffer commandBuffer);
+            void cmdPipelineBarrier(RHICommandBuffer commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers);
+            // records [0, itemCount) on the recording threads into secondaries that continue the current render
+            // pass, which must have been begun with RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS or
+            // RHI_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT. bound state is
+            // not inherited, and the record function must not open gpu profile scopes
+            void cmdRecordParallel(RHICommandBuffer commandBuffer, uint32_t itemCount, uint32_t minItemsPerBatch, const VulkanParallelRecorder::RecordFunction& record);
+            uint32_t getRecordingThreadCount() const;
+            // scopes nest and must be closed on the same command buffer, results land in m_gpu_pass_timings
+            // once the frame has completed
+            void cmdBeginGpuProfileScope(RHICommandBuffer commandBuffer, const char* name);
+            void cmdEndGpuProfileScope(RHICommandBuffer commandBuffer);
+            void cmdBindVertexBuffers(RHICommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const RHIBuffer* pBuffers, const RHIDeviceSize* pOffsets);
+            void cmdBindIndexBuffer(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, RHIIndexType indexType);
+            void cmdBindPipeline(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline pipeline);
+            void cmdBindDescriptorSets(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const RHIDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets);
+            void cmdPushConstants(RHICommandBuffer commandBuffer, RHIPipelineLayout layout, RHIShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues);
+            void cmdDispatch(RHICommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+            void cmdCopyBuffer(RHICommandBuffer commandBuffer, RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size);
+            // a global memory barrier, for buffers that cmdPipelineBarrier has no barriers for
+            void cmdMemoryBarrier(RHICommandBuffer commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIAccessFlags srcAccessMask, RHIAccessFlags dstAccessMask);
+            void cmdDrawIndexedIndirect(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride);
+            // dynamic state is not inherited, a secondary that draws sets it again
+            void cmdSetViewport(RHICommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports);
+            void cmdSetScissor(RHICommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors);
+            bool mapMemory(RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size, void** ppData);
+            void unmapMemory(RHIDeviceMemory memory);
+            bool readbackOffscreenImage(uint32_t image_index, std::vector<uint8_t>& pixels);
+            // render passes, framebuffers, descriptor set layouts and samplers are shared between equal create infos
+            // without a pNext chain, each create is matched by one destroy
+            bool createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass &pRenderPass);
+            bool createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer &pFramebuffer);
+            // deferred until the frames that may still use it have completed
+            void destroyFramebuffer(RHIFramebuffer framebuffer);
+            void destroyRenderPass(RHIRenderPass renderPass);
+            // optimal tiling 2d attachment image with no memory behind it yet, so images that are never alive at
+            // the same time can be bound into one allocation
+            bool createUnboundImage(uint32_t width, uint32_t height, RHIFormat format, RHIImageUsageFlags usage, RHIImage &pImage, RHIMemoryRequirements& requirements);
+            // prefer_lazily_allocated falls back to plain device local memory when the device has no lazily
+            // allocated type that fits, pLazilyAllocated tells which one was used
+            bool allocateImageMemory(const RHIMemoryRequirements& requirements, bool prefer_lazily_allocated, RHIDeviceMemory &pMemory, bool* pLazilyAllocated = nullptr);
+            bool bindImageMemory(RHIImage image, RHIDeviceMemory memory, RHIDeviceSize offset);
+            // the aspect follows the format
+            RHIImageView createAttachmentImageView(RHIImage image, RHIFormat format);
+            // both deferred like destroyFramebuffer
+            void destroyImage(RHIImage image, RHIImageView imageView);
+            void freeImageMemory(RHIDeviceMemory memory);
+            bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout &pSetLayout);
+            void destroyDescriptorSetLayout(RHIDescriptorSetLayout setLayout);
+            bool createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler &pSampler);
+            void destroySampler(RHISampler sampler);
+            void getObjectCacheStats(RHIObjectCacheStats& renderPasses,
+                                     RHIObjectCacheStats& framebuffers,
+                                     RHIObjectCacheStats& descriptorSetLayouts,
+                                     RHIObjectCacheStats& samplers);
+            RHIShader createShaderModule(const std::vector<unsigned char>& shader_code);
+            void destroyShaderModule(RHIShader shader);
+            bool createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout &pPipelineLayout);
+            void destroyPipelineLayout(RHIPipelineLayout pipelineLayout);
+            // pipeline creation goes through the persistent pipeline cache and may be called from any thread
+            bool createGraphicsPipeline(const RHIGraphicsPipelineCreateInfo* pCreateInfo, RHIPipeline &pPipeline);
+            bool createComputePipeline(const RHIComputePipelineCreateInfo* pCreateInfo, RHIPipeline &pPipeline);
+            // compiled on a worker thread from a copy of the create info, the caller's structs can go away right
+            // after the call, the shader modules, layout and render pass it names must live until the future is ready.
+            // pNext chains other than RHIPipelineRenderingCreateInfo compile on the calling thread.
+            // the result is nullptr on failure
+            std::future<RHIPipeline> createGraphicsPipelineAsync(const RHIGraphicsPipelineCreateInfo* pCreateInfo);
+            std::future<RHIPipeline> createComputePipelineAsync(const RHIComputePipelineCreateInfo* pCreateInfo);
+            void destroyPipeline(RHIPipeline pipeline);
+            bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet &pDescriptorSets);
+            // only for sets allocated from m_descriptor_pool
+            void freeDescriptorSet(RHIDescriptorSet &descriptorSet);
+            // valid until this frame index comes around again, never free it
+            bool allocateFrameDescriptorSet(RHIDescriptorSetLayout layout, RHIDescriptorSet &descriptorSet);
+            // transient stats are summed over all frames in flight
+            void getDescriptorAllocatorStats(RHIDescriptorAllocatorStats& persistent, RHIDescriptorAllocatorStats& transient) const;
             void updateDescriptorSets(uint32_t descriptorWriteCount,const RHIWriteDescriptorSet* pDescriptorWrites,uint32_t descriptorCopyCount,const RHICopyDescriptorSet* pDescriptorCopies);
-            void createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* & buffer, RHIDeviceMemory* & buffer_memory);
-            void copyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size);
-            RHICommandBuffer* beginSingleTimeCommands();
-            void endSingleTimeCommands(RHICommandBuffer* command_buffer);
+            // compute_shared buffers are also accessed on m_compute_queue. when its family differs from the graphics
+            // family they are shared concurrently, so no ownership transfers are needed
+            // false leaves buffer and buffer_memory null
+            bool createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer & buffer, RHIDeviceMemory & buffer_memory, bool compute_shared = false);
+            void destroyBuffer(RHIBuffer & buffer, RHIDeviceMemory & buffer_memory);
+            void getMemoryHeapStats(std::vector<RHIMemoryHeapStats>& heap_stats);
+            // copies are batched and submitted before the next frame, srcBuffer must outlive the returned ticket
+            RHIUploadTicket copyBuffer(RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size);
+            RHIUploadTicket uploadBuffer(RHIBuffer dstBuffer, RHIDeviceSize dstOffset, const void* pData, RHIDeviceSize size);
+            RHIUploadTicket flushUploads();
+            bool isUploadComplete(RHIUploadTicket ticket);
+            void waitForUpload(RHIUploadTicket ticket);
+            // per-draw data valid for the current frame only, bind getFrameRingBuffer() once as a
+            // *_DYNAMIC descriptor and pass dynamicOffset when binding. returns nullptr when the frame's region is full
+            void* allocateFrameData(RHIDeviceSize size, uint32_t& dynamicOffset);
+            RHIBuffer getFrameRingBuffer() const;
+            // bindless mode, only valid when m_bindless_supported. one global set holds every registered
+            // texture and storage buffer, shaders index it with the returned slot
+            RHIDescriptorSetLayout getBindlessDescriptorSetLayout() const;
+            RHIDescriptorSet getBindlessDescriptorSet() const;
+            uint32_t registerBindlessTexture(RHIImageView imageView, RHISampler sampler, RHIImageLayout imageLayout);
+            uint32_t registerBindlessBuffer(RHIBuffer buffer, RHIDeviceSize offset, RHIDeviceSize range);
+            void releaseBindlessTexture(uint32_t index);
+            void releaseBindlessBuffer(uint32_t index);
+            RHICommandBuffer beginSingleTimeCommands();
+            void endSingleTimeCommands(RHICommandBuffer command_buffer);
     };      
+
+    class GpuProfileScope
+    {
+    public:
+        GpuProfileScope(VulkanRHI* rhi, RHICommandBuffer command_buffer, const char* name)
+            : m_rhi(rhi), m_command_buffer(command_buffer)
+        {
+            m_rhi->cmdBeginGpuProfileScope(m_command_buffer, name);
+        }
+        ~GpuProfileScope() { m_rhi->cmdEndGpuProfileScope(m_command_buffer); }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        VulkanRHI*        m_rhi;
+        RHICommandBuffer  m_command_buffer;
+    };
 } 
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "vulkan_upload_manager.h"
+#include "vulkan_util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    void VulkanUploadManager::initialize(VkDevice           device,
+                                         VmaAllocator       allocator,
+                                         VkQueue            queue,
+                                         uint32_t           queue_family_index,
+                                         VkDeviceSize       ring_size,
+                                         VulkanBufferTable* buffer_table)
+    {
+        m_device       = device;
+        m_queue        = queue;
+        m_ring_size    = ring_size;
+        m_buffer_table = buffer_table;
+
+        VmaAllocationInfo ring_allocation_info {};
+        VulkanUtil::createBuffer(allocator,
+                                 m_ring_size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 m_ring_buffer,
+                                 m_ring_allocation,
+                                 &ring_allocation_info);
+        m_ring_data = (uint8_t*)ring_allocation_info.pMappedData;
+
+        VkCommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_create_info.queueFamilyIndex = queue_family_index;
+        if (vkCreateCommandPool(m_device, &command_pool_create_info, nullptr, &m_command_pool) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk create upload command pool");
+        }
+
+        VkCommandBufferAllocateInfo command_buffer_allocate_info {};
+        command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = m_command_pool;
+        command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        VkFenceCreateInfo fence_create_info {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        for (uint32_t i = 0; i < k_batch_count; ++i)
+        {
+            if (vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, &m_batches[i].command_buffer) != VK_SUCCESS ||
+                vkCreateFence(m_device, &fence_create_info, nullptr, &m_batches[i].fence) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk create upload batch");
+            }
+        }
+    }
+
+    RHIUploadTicket VulkanUploadManager::uploadBuffer(RHIBuffer     dst_buffer,
+                                                      RHIDeviceSize dst_offset,
+                                                      const void*   data,
+                                                      RHIDeviceSize size)
+    {
+        // chunks of at most half the ring always fit once the in-flight batches retired
+        const VkDeviceSize max_chunk_size = m_ring_size / 2;
+        const uint8_t*     src            = (const uint8_t*)data;
+
+        RHIUploadTicket ticket = m_completed_ticket;
+        for (VkDeviceSize copied = 0; copied < size;)
+        {
+            VkDeviceSize chunk_size = std::min<VkDeviceSize>(size - copied, max_chunk_size);
+            uint64_t     ring_offset;
+            if (!allocateStaging(chunk_size, ring_offset))
+            {
+                LOG_ERROR("upload staging ring exhausted");
+                return ticket;
+            }
+            memcpy(m_ring_data + ring_offset, src + copied, (size_t)chunk_size);
+
+            VkBufferCopy copy_region = {ring_offset, dst_offset + copied, chunk_size};
+            vkCmdCopyBuffer(beginBatch(), m_ring_buffer, m_buffer_table->get(dst_buffer), 1, &copy_region);
+            m_batches[m_recording_batch].copy_count++;
+
+            ticket = m_batches[m_recording_batch].ticket;
+            copied += chunk_size;
+        }
+        m_uploaded_bytes += size;
+        return ticket;
+    }
+
+    RHIUploadTicket VulkanUploadManager::copyBuffer(RHIBuffer     src_buffer,
+                                                    RHIBuffer     dst_buffer,
+                                                    RHIDeviceSize src_offset,
+                                                    RHIDeviceSize dst_offset,
+                                                    RHIDeviceSize size)
+    {
+        VkBufferCopy copy_region = {src_offset, dst_offset, size};
+        vkCmdCopyBuffer(beginBatch(),
+                        m_buffer_table->get(src_buffer),
+                        m_buffer_table->get(dst_buffer),
+                        1,
+                        &copy_region);
+        m_batches[m_recording_batch].copy_count++;
+        return m_batches[m_recording_batch].ticket;
+    }
+
+    RHIUploadTicket VulkanUploadManager::flush()
+    {
+        UploadBatch& batch = m_batches[m_recording_batch];
+        if (batch.copy_count == 0)
+        {
+            return m_next_ticket - 1;
+        }
+
+        // later submissions on this queue read the uploaded data as vertices, indices, uniforms or storage
+        VkMemoryBarrier barrier {};
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(batch.command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             1,
+                             &barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (vkEndCommandBuffer(batch.command_buffer) != VK_SUCCESS)
+        {
+            LOG_ERROR("failed to record upload command buffer");
+        }
+
+        VkSubmitInfo submit_info {};
+        submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers    = &batch.command_buffer;
+        if (vkQueueSubmit(m_queue, 1, &submit_info, batch.fence) != VK_SUCCESS)
+        {
+            LOG_ERROR("failed to submit upload batch");
+        }
+
+        batch.ring_end   = m_ring_head;
+        batch.copy_count = 0;
+        batch.in_flight  = true;
+        m_in_flight_count++;
+        m_submitted_batch_count++;
+        m_next_ticket++;
+        m_recording_batch = (m_recording_batch + 1) % k_batch_count;
+        return batch.ticket;
+    }
+
+    void VulkanUploadManager::update()
+    {
+        while (m_in_flight_count > 0 && retireOldestBatch(false))
+        {
+        }
+    }
+
+    bool VulkanUploadManager::isComplete(RHIUploadTicket ticket)
+    {
+        update();
+        return ticket <= m_completed_ticket;
+    }
+
+    void VulkanUploadManager::wait(RHIUploadTicket ticket)
+    {
+        if (ticket >= m_next_ticket)
+        {
+            flush();
+        }
+        while (m_completed_ticket < ticket && m_in_flight_count > 0)
+        {
+            retireOldestBatch(true);
+        }
+    }
+
+    VkCommandBuffer VulkanUploadManager::beginBatch()
+    {
+        UploadBatch& batch = m_batches[m_recording_batch];
+        if (batch.copy_count > 0)
+        {
+            return batch.command_buffer;
+        }
+
+        // every slot is in flight, the open batch reuses the oldest one
+        if (batch.in_flight)
+        {
+            retireOldestBatch(true);
+        }
+
+        vkResetFences(m_device, 1, &batch.fence);
+        vkResetCommandBuffer(batch.command_buffer, 0);
+
+        VkCommandBufferBeginInfo command_buffer_begin_info {};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.command_buffer, &command_buffer_begin_info);
+
+        batch.ticket = m_next_ticket;
+        return batch.command_buffer;
+    }
+
+    bool VulkanUploadManager::allocateStaging(VkDeviceSize size, uint64_t& ring_offset)
+    {
+        if (size > m_ring_size)
+        {
+            return false;
+        }
+
+        for (;;)
+        {
+            uint64_t start = (m_ring_head + k_ring_alignment - 1) & ~(uint64_t)(k_ring_alignment - 1);
+            // a copy source must be contiguous, skip the remainder of the ring instead of wrapping
+            if (start % m_ring_size + size > m_ring_size)
+            {
+                start += m_ring_size - start % m_ring_size;
+            }
+            if (start + size - m_ring_tail <= m_ring_size)
+            {
+                m_ring_head = start + size;
+                ring_offset = start % m_ring_size;
+                return true;
+            }
+
+            // the ring is full of data still being read by the gpu, free the oldest batch
+            m_ring_full_waits++;
+            if (m_batches[m_recording_batch].copy_count > 0)
+            {
+                flush();
+            }
+            if (m_in_flight_count == 0)
+            {
+                m_ring_tail = m_ring_head;
+                continue;
+            }
+            retireOldestBatch(true);
+        }
+    }
+
+    bool VulkanUploadManager::retireOldestBatch(bool block)
+    {
+        UploadBatch& batch = m_batches[m_oldest_batch];
+        if (!batch.in_flight)
+        {
+            return false;
+        }
+
+        if (block)
+        {
+            if (vkWaitForFences(m_device, 1, &batch.fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+            {
+                LOG_ERROR("failed to wait for upload batch");
+                return false;
+            }
+        }
+        else if (vkGetFenceStatus(m_device, batch.fence) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        m_ring_tail        = batch.ring_end;
+        m_completed_ticket = batch.ticket;
+        batch.in_flight    = false;
+        m_oldest_batch     = (m_oldest_batch + 1) % k_batch_count;
+        m_in_flight_count--;
+        return true;
+    }
+} // namespace Aura
@@ -0,0 +1,76 @@
+#pragma once
+#include "../rhi_struct.h"
+#include "vulkan_rhi_resource.h"
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+namespace Aura
+{
+    // streams buffer data through a persistently mapped staging ring. copies are batched into
+    // one command buffer per ticket, each batch completes on its own fence so nothing ever
+    // waits for the whole queue
+    class VulkanUploadManager
+    {
+    public:
+        // destination and source buffer handles are resolved through buffer_table
+        void initialize(VkDevice           device,
+                        VmaAllocator       allocator,
+                        VkQueue            queue,
+                        uint32_t           queue_family_index,
+                        VkDeviceSize       ring_size,
+                        VulkanBufferTable* buffer_table);
+
+        // stages data and records the copy into the open batch, returns the batch ticket
+        RHIUploadTicket uploadBuffer(RHIBuffer dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size);
+        // device to device copy recorded into the open batch, src must stay alive until the ticket completes
+        RHIUploadTicket copyBuffer(RHIBuffer src_buffer, RHIBuffer dst_buffer, RHIDeviceSize src_offset, RHIDeviceSize dst_offset, RHIDeviceSize size);
+
+        // submits the open batch if it has any copies, returns the last submitted ticket
+        RHIUploadTicket flush();
+        // retires finished batches without blocking
+        void update();
+        bool isComplete(RHIUploadTicket ticket);
+        void wait(RHIUploadTicket ticket);
+
+        uint64_t m_submitted_batch_count {0};
+        uint64_t m_uploaded_bytes {0};
+        uint64_t m_ring_full_waits {0};
+
+    private:
+        static uint32_t const k_batch_count {8};
+        static VkDeviceSize const k_ring_alignment {16};
+
+        struct UploadBatch
+        {
+            VkCommandBuffer command_buffer {VK_NULL_HANDLE};
+            VkFence         fence {VK_NULL_HANDLE};
+            RHIUploadTicket ticket {0};
+            uint64_t        ring_end {0};
+            uint32_t        copy_count {0};
+            bool            in_flight {false};
+        };
+
+        VkCommandBuffer beginBatch();
+        bool            allocateStaging(VkDeviceSize size, uint64_t& ring_offset);
+        bool            retireOldestBatch(bool block);
+
+        VkDevice           m_device {VK_NULL_HANDLE};
+        VkQueue            m_queue {VK_NULL_HANDLE};
+        VkCommandPool      m_command_pool {VK_NULL_HANDLE};
+        VulkanBufferTable* m_buffer_table {nullptr};
+
+        VkBuffer        m_ring_buffer {VK_NULL_HANDLE};
+        VmaAllocation   m_ring_allocation {nullptr};
+        uint8_t*        m_ring_data {nullptr};
+        VkDeviceSize    m_ring_size {0};
+        // monotonic byte positions, the ring slot is position % m_ring_size
+        uint64_t        m_ring_head {0};
+        uint64_t        m_ring_tail {0};
+
+        UploadBatch     m_batches[k_batch_count];
+        uint32_t        m_recording_batch {0};
+        uint32_t        m_oldest_batch {0};
+        uint32_t        m_in_flight_count {0};
+        RHIUploadTicket m_next_ticket {1};
+        RHIUploadTicket m_completed_ticket {0};
+    };
+} // namespace Aura
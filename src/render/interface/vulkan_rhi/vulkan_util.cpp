@@ -4,8 +4,7 @@
 #define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
 namespace Aura
 {
-    void VulkanUtil::createImage(VkPhysicalDevice      physical_device,
-                                 VkDevice              device,
+    void VulkanUtil::createImage(VmaAllocator          allocator,
                                  uint32_t              image_width,
                                  uint32_t              image_height,
                                  VkFormat              format,
@@ -13,7 +12,7 @@ namespace Aura
                                  VkImageUsageFlags     image_usage_flags,
                                  VkMemoryPropertyFlags memory_property_flags,
                                  VkImage&              image,
-                                 VkDeviceMemory&       memory,
+                                 VmaAllocation&        allocation,
                                  VkImageCreateFlags    image_create_flags,
                                  uint32_t              array_layers,
                                  uint32_t              miplevels)
@@ -34,28 +33,19 @@ namespace Aura
         image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
         image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateImage(device, &image_create_info, nullptr, &image) != VK_SUCCESS)
-        {
-            LOG_ERROR("failed to create image!");
-            return;
-        }
-
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, image, &memRequirements);
+        // render targets get their own VkDeviceMemory, they are recreated on resize and drivers
+        // can only apply framebuffer compression to dedicated allocations on some hardware
+        bool is_render_target = (image_usage_flags & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                      VK_IMAGE_USAGE_STORAGE_BIT)) != 0;
+        VmaAllocationCreateInfo allocation_create_info =
+            chooseAllocationCreateInfo(memory_property_flags, 0, is_render_target);
 
-        VkMemoryAllocateInfo allocInfo {};
-        allocInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = 
-            findMemoryType(physical_device, memRequirements.memoryTypeBits, memory_property_flags);
-
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        if (vmaCreateImage(allocator, &image_create_info, &allocation_create_info, &image, &allocation, nullptr) != VK_SUCCESS)
         {
-            LOG_ERROR("failed to allocate image memory!");
+            LOG_ERROR("failed to create image!");
             return;
         }
-
-        vkBindImageMemory(device, image, memory, 0);
     }
 
 
@@ -106,44 +96,62 @@ namespace Aura
         return 0;
     }
 
-    void VulkanUtil::createBuffer(VkPhysicalDevice      physical_device,
-                                  VkDevice              device,
+    bool VulkanUtil::createBuffer(VmaAllocator          allocator,
                                   VkDeviceSize          size,
                                   VkBufferUsageFlags    usage,
                                   VkMemoryPropertyFlags properties,
                                   VkBuffer&             buffer,
-                                  VkDeviceMemory&       buffer_memory)
+                                  VmaAllocation&        allocation,
+                                  VmaAllocationInfo*    allocation_info,
+                                  uint32_t              queue_family_index_count,
+                                  const uint32_t*       queue_family_indices)
     {
         VkBufferCreateInfo buffer_create_info {};
         buffer_create_info.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         buffer_create_info.size        = size;
         buffer_create_info.usage       = usage;                     // use as a vertex/staging/index buffer
         buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // not sharing among queue families
+        if (queue_family_index_count > 1)
+        {
+            buffer_create_info.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+            buffer_create_info.queueFamilyIndexCount = queue_family_index_count;
+            buffer_create_info.pQueueFamilyIndices   = queue_family_indices;
+        }
+
+        VmaAllocationCreateInfo allocation_create_info = chooseAllocationCreateInfo(properties, size, false);
 
-        if (vkCreateBuffer(device, &buffer_create_info, nullptr, &buffer) != VK_SUCCESS)
+        if (vmaCreateBuffer(allocator, &buffer_create_info, &allocation_create_info, &buffer, &allocation, allocation_info) != VK_SUCCESS)
         {
-            LOG_ERROR("vkCreateBuffer failed!");
-            return;
+            LOG_ERROR("vmaCreateBuffer failed!");
+            buffer     = VK_NULL_HANDLE;
+            allocation = VK_NULL_HANDLE;
+            return false;
         }
+        return true;
+    }
 
-        VkMemoryRequirements buffer_memory_requirements; // for allocate_info.allocationSize and
-                                                         // allocate_info.memoryTypeIndex
-        vkGetBufferMemoryRequirements(device, buffer, &buffer_memory_requirements);
+    VmaAllocationCreateInfo VulkanUtil::chooseAllocationCreateInfo(VkMemoryPropertyFlags properties,
+                                                                   VkDeviceSize          size,
+                                                                   bool                  prefer_dedicated)
+    {
+        // large resources would pin most of a 256MB block, give them their own allocation instead
+        static const VkDeviceSize k_dedicated_allocation_threshold = 32ull * 1024 * 1024;
 
-        VkMemoryAllocateInfo buffer_memory_allocate_info {};
-        buffer_memory_allocate_info.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        buffer_memory_allocate_info.allocationSize = buffer_memory_requirements.size;
-        buffer_memory_allocate_info.memoryTypeIndex =
-            VulkanUtil::findMemoryType(physical_device, buffer_memory_requirements.memoryTypeBits, properties);
+        VmaAllocationCreateInfo allocation_create_info {};
+        allocation_create_info.usage         = VMA_MEMORY_USAGE_UNKNOWN;
+        allocation_create_info.requiredFlags = properties;
 
-        if (vkAllocateMemory(device, &buffer_memory_allocate_info, nullptr, &buffer_memory) != VK_SUCCESS)
+        if (prefer_dedicated || size >= k_dedicated_allocation_threshold)
         {
-            LOG_ERROR("vkAllocateMemory failed!");
-            return;
+            allocation_create_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
         }
 
-        // bind buffer with buffer memory
-        vkBindBufferMemory(device, buffer, buffer_memory, 0); // offset = 0
+        // host visible memory stays mapped for its whole lifetime, mapMemory just offsets into it
+        if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            allocation_create_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        }
+        return allocation_create_info;
     }
     
     void VulkanUtil::copyBuffer(RHI*         rhi,
@@ -159,8 +167,8 @@ namespace Aura
             return;
         }
 
-        RHICommandBuffer* rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
-        VkCommandBuffer command_buffer = ((VulkanCommandBuffer*)rhi_command_buffer)->getResource();
+        RHICommandBuffer rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
+        VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->m_command_buffer_table.get(rhi_command_buffer);
 
         VkBufferCopy copyRegion = {srcOffset, dstOffset, size};
         vkCmdCopyBuffer(command_buffer, srcBuffer, dstBuffer, 1, &copyRegion);
@@ -7,8 +7,7 @@ namespace Aura
 {
     class VulkanUtil {
         public:
-        static void createImage(VkPhysicalDevice      physical_device,
-                                          VkDevice              device,
+        static void createImage(VmaAllocator          allocator,
                                           uint32_t              image_width,
                                           uint32_t              image_height,
                                           VkFormat              format,
@@ -16,7 +15,7 @@ namespace Aura
                                           VkImageUsageFlags     image_usage_flags,
                                           VkMemoryPropertyFlags memory_property_flags,
                                           VkImage&              image,
-                                          VkDeviceMemory&       memory,
+                                          VmaAllocation&        allocation,
                                           VkImageCreateFlags    image_create_flags,
                                           uint32_t              array_layers,
                                           uint32_t              miplevels);
@@ -30,13 +29,19 @@ namespace Aura
         static uint32_t    findMemoryType(VkPhysicalDevice      physical_device,
                                         uint32_t              type_filter,
                                         VkMemoryPropertyFlags properties_flag);
-        static void createBuffer(VkPhysicalDevice      physical_device,
-                                  VkDevice              device,
+        // false leaves buffer and allocation null
+        static bool createBuffer(VmaAllocator          allocator,
                                   VkDeviceSize          size,
                                   VkBufferUsageFlags    usage,
                                   VkMemoryPropertyFlags properties,
                                   VkBuffer&             buffer,
-                                  VkDeviceMemory&       buffer_memory);
+                                  VmaAllocation&        allocation,
+                                  VmaAllocationInfo*    allocation_info = nullptr,
+                                  uint32_t              queue_family_index_count = 0,
+                                  const uint32_t*       queue_family_indices = nullptr);
+        static VmaAllocationCreateInfo chooseAllocationCreateInfo(VkMemoryPropertyFlags properties,
+                                                                  VkDeviceSize          size,
+                                                                  bool                  prefer_dedicated);
         static void copyBuffer(RHI*         rhi,
                                 VkBuffer     srcBuffer,
                                 VkBuffer     dstBuffer,
@@ -0,0 +1,1135 @@
+#include "render_graph.h"
+#include "../util/scratch_arena.h"
+
+#include <algorithm>
+#include <iostream>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    static bool isWrite(RHIAccessFlags access_mask)
+    {
+        return (access_mask & (RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                               RHI_ACCESS_SHADER_WRITE_BIT)) != 0;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::writeColor(RenderGraphResource resource,
+                                                               RHIAttachmentLoadOp load_op,
+                                                               RHIClearColorValue  clear_value)
+    {
+        RenderGraph::Access access {};
+        access.resource          = resource;
+        access.type              = RenderGraph::ACCESS_COLOR;
+        access.load_op           = load_op;
+        access.clear_value.color = clear_value;
+        m_graph->m_passes[m_pass].accesses.push_back(access);
+        return *this;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::writeDepth(RenderGraphResource       resource,
+                                                               RHIAttachmentLoadOp       load_op,
+                                                               RHIClearDepthStencilValue clear_value)
+    {
+        RenderGraph::Access access {};
+        access.resource                 = resource;
+        access.type                     = RenderGraph::ACCESS_DEPTH;
+        access.load_op                  = load_op;
+        access.clear_value.depthStencil = clear_value;
+        m_graph->m_passes[m_pass].accesses.push_back(access);
+        return *this;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::readInputAttachment(RenderGraphResource resource)
+    {
+        RenderGraph::Access access {};
+        access.resource = resource;
+        access.type     = RenderGraph::ACCESS_INPUT_ATTACHMENT;
+        access.load_op  = RHI_ATTACHMENT_LOAD_OP_LOAD;
+        m_graph->m_passes[m_pass].accesses.push_back(access);
+        return *this;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::readTexture(RenderGraphResource resource, RHIPipelineStageFlags stages)
+    {
+        RenderGraph::Access access {};
+        access.resource       = resource;
+        access.type           = RenderGraph::ACCESS_TEXTURE;
+        access.load_op        = RHI_ATTACHMENT_LOAD_OP_LOAD;
+        access.texture_stages = stages;
+        m_graph->m_passes[m_pass].accesses.push_back(access);
+        return *this;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::setSideEffect()
+    {
+        m_graph->m_passes[m_pass].side_effect = true;
+        return *this;
+    }
+
+    RenderGraphPassBuilder& RenderGraphPassBuilder::setRecordsInParallel()
+    {
+        m_graph->m_passes[m_pass].parallel = true;
+        return *this;
+    }
+
+    void RenderGraph::initialize(VulkanRHI* rhi)
+    {
+        m_rhi = rhi;
+    }
+
+    void RenderGraph::shutdown()
+    {
+        releaseCompiled();
+        m_resources.clear();
+        m_passes.clear();
+    }
+
+    RenderGraphResource RenderGraph::createImage(const std::string& name, const RenderGraphImageDesc& desc)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        m_resources.push_back(resource);
+        m_compiled = false;
+        return (RenderGraphResource)m_resources.size() - 1;
+    }
+
+    RenderGraphResource RenderGraph::importImage(const std::string&          name,
+                                                 const RenderGraphImageDesc& desc,
+                                                 RHIImageLayout              initial_layout,
+                                                 RHIImageLayout              final_layout)
+    {
+        Resource resource;
+        resource.name           = name;
+        resource.desc           = desc;
+        resource.imported       = true;
+        resource.initial_layout = initial_layout;
+        resource.final_layout   = final_layout;
+        m_resources.push_back(resource);
+        m_compiled = false;
+        return (RenderGraphResource)m_resources.size() - 1;
+    }
+
+    void RenderGraph::setImportedImage(RenderGraphResource resource, RHIImage image, RHIImageView view)
+    {
+        m_resources[resource].image = image;
+        m_resources[resource].view  = view;
+    }
+
+    RenderGraphPassBuilder RenderGraph::addPass(const std::string& name, ExecuteFunction execute)
+    {
+        Pass pass;
+        pass.name    = name;
+        pass.execute = std::move(execute);
+        m_passes.push_back(pass);
+        m_compiled = false;
+        return RenderGraphPassBuilder(this, (uint32_t)m_passes.size() - 1);
+    }
+
+    RHIRenderPass RenderGraph::getRenderPass(uint32_t pass) const
+    {
+        const Pass& graph_pass = m_passes[pass];
+        return graph_pass.group < m_groups.size() ? m_groups[graph_pass.group].render_pass : nullptr;
+    }
+
+    uint32_t RenderGraph::getSubpass(uint32_t pass) const
+    {
+        return m_passes[pass].subpass;
+    }
+
+    const RHIPipelineRenderingCreateInfo* RenderGraph::getPipelineRenderingCreateInfo(uint32_t pass) const
+    {
+        const Pass& graph_pass = m_passes[pass];
+        if (graph_pass.group >= m_groups.size() || !m_groups[graph_pass.group].dynamic)
+        {
+            return nullptr;
+        }
+        return &m_groups[graph_pass.group].rendering_formats;
+    }
+
+    RHIImageView RenderGraph::getImageView(RenderGraphResource resource) const
+    {
+        return m_resources[resource].view;
+    }
+
+    bool RenderGraph::isPassCulled(uint32_t pass) const
+    {
+        return m_passes[pass].culled;
+    }
+
+    bool RenderGraph::compile()
+    {
+        releaseCompiled();
+        m_stats            = RenderGraphStats {};
+        m_stats.pass_count = (uint32_t)m_passes.size();
+
+        for (Resource& resource : m_resources)
+        {
+            resource.usage             = 0;
+            resource.first_load_op     = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
+            resource.lazy              = false;
+            resource.first_group       = ~0U;
+            resource.last_group        = 0;
+            resource.memory_block      = ~0U;
+            resource.alias_predecessor = k_invalid_render_graph_resource;
+            resource.end_stages        = 0;
+            resource.end_access        = 0;
+            resource.last_stages       = 0;
+            resource.last_access       = 0;
+            resource.layout            = resource.imported ? resource.initial_layout : RHI_IMAGE_LAYOUT_UNDEFINED;
+        }
+        for (Pass& pass : m_passes)
+        {
+            pass.culled  = false;
+            pass.group   = ~0U;
+            pass.subpass = 0;
+        }
+
+        cullPasses();
+        buildGroups();
+        if (!allocateTransients())
+        {
+            releaseCompiled();
+            return false;
+        }
+        for (uint32_t i = 0; i < m_groups.size(); ++i)
+        {
+            if (!createRenderPass(i))
+            {
+                releaseCompiled();
+                return false;
+            }
+            m_stats.dynamic_rendering_count += m_groups[i].dynamic ? 1 : 0;
+        }
+        m_stats.render_pass_count = (uint32_t)m_groups.size();
+        m_compiled                = true;
+        return true;
+    }
+
+    void RenderGraph::invalidate()
+    {
+        releaseCompiled();
+    }
+
+    void RenderGraph::execute(RHICommandBuffer command_buffer)
+    {
+        if (!m_compiled && !compile())
+        {
+            LOG_ERROR("render graph compile failed");
+            return;
+        }
+
+        ScratchScope scratch;
+        for (Group& group : m_groups)
+        {
+            // timestamps may not be written inside a render pass whose contents are secondaries
+            GpuProfileScope scope(m_rhi, command_buffer, group.name.c_str());
+            if (group.dynamic)
+            {
+                if (!executeDynamicRendering(group, command_buffer))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            uint32_t       view_count = (uint32_t)group.attachments.size();
+            RHIImageView* views      = scratch.allocateArray<RHIImageView>(view_count);
+            for (uint32_t i = 0; i < view_count; ++i)
+            {
+                views[i] = m_resources[group.attachments[i]].view;
+                if (views[i] == nullptr)
+                {
+                    LOG_ERROR("render graph image " << m_resources[group.attachments[i]].name << " has no view");
+                    return;
+                }
+            }
+
+            // imported views change from frame to frame, one framebuffer per combination seen so far
+            RHIFramebuffer framebuffer = nullptr;
+            for (const Framebuffer& cached : group.framebuffers)
+            {
+                if (std::equal(views, views + view_count, cached.views.begin()))
+                {
+                    framebuffer = cached.framebuffer;
+                    break;
+                }
+            }
+            if (framebuffer == nullptr)
+            {
+                RHIFramebufferCreateInfo framebuffer_create_info {};
+                framebuffer_create_info.sType           = RHI_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                framebuffer_create_info.renderPass      = group.render_pass;
+                framebuffer_create_info.attachmentCount = view_count;
+                framebuffer_create_info.pAttachments    = views;
+                framebuffer_create_info.width           = group.extent.width;
+                framebuffer_create_info.height          = group.extent.height;
+                framebuffer_create_info.layers          = 1;
+                if (m_rhi->createFramebuffer(&framebuffer_create_info, framebuffer) != RHI_SUCCESS)
+                {
+                    return;
+                }
+                group.framebuffers.push_back(Framebuffer {std::vector<RHIImageView>(views, views + view_count), framebuffer});
+            }
+
+            RHIRenderPassBeginInfo renderpass_begin_info {};
+            renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderpass_begin_info.renderPass        = group.render_pass;
+            renderpass_begin_info.framebuffer       = framebuffer;
+            renderpass_begin_info.renderArea.offset = {0, 0};
+            renderpass_begin_info.renderArea.extent = group.extent;
+            renderpass_begin_info.clearValueCount   = (uint32_t)group.clear_values.size();
+            renderpass_begin_info.pClearValues      = group.clear_values.data();
+
+            for (uint32_t i = 0; i < group.passes.size(); ++i)
+            {
+                Pass&              pass     = m_passes[group.passes[i]];
+                RHISubpassContents contents = pass.parallel ? RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : RHI_SUBPASS_CONTENTS_INLINE;
+                if (i == 0)
+                {
+                    m_rhi->cmdBeginRenderPass(command_buffer, &renderpass_begin_info, contents);
+                }
+                else
+                {
+                    m_rhi->cmdNextSubpass(command_buffer, contents);
+                }
+                pass.execute(command_buffer);
+            }
+            m_rhi->cmdEndRenderPass(command_buffer);
+        }
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        // walks back from the passes with visible results, a pass survives when a later survivor or the
+        // outside world reads something it writes
+        std::vector<bool> needed(m_resources.size(), false);
+        for (uint32_t i = (uint32_t)m_passes.size(); i-- > 0;)
+        {
+            Pass& pass  = m_passes[i];
+            bool  alive = pass.side_effect;
+            for (const Access& access : pass.accesses)
+            {
+                bool write = access.type == ACCESS_COLOR || access.type == ACCESS_DEPTH;
+                if (write && (m_resources[access.resource].imported || needed[access.resource]))
+                {
+                    alive = true;
+                }
+            }
+            if (!alive)
+            {
+                pass.culled = true;
+                ++m_stats.culled_pass_count;
+                continue;
+            }
+
+            // a write that does not load ends the chain, what came before it is overwritten
+            for (const Access& access : pass.accesses)
+            {
+                bool write = access.type == ACCESS_COLOR || access.type == ACCESS_DEPTH;
+                if (write && access.load_op != RHI_ATTACHMENT_LOAD_OP_LOAD)
+                {
+                    needed[access.resource] = false;
+                }
+            }
+            for (const Access& access : pass.accesses)
+            {
+                if (access.load_op == RHI_ATTACHMENT_LOAD_OP_LOAD)
+                {
+                    needed[access.resource] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::buildGroups()
+    {
+        m_groups.clear();
+        std::vector<RenderGraphResource> group_textures;
+        for (uint32_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+        {
+            Pass& pass = m_passes[pass_index];
+            if (pass.culled)
+            {
+                continue;
+            }
+
+            RHIExtent2D extent = m_rhi->m_swapchain_extent;
+            for (const Access& access : pass.accesses)
+            {
+                if (access.type != ACCESS_TEXTURE)
+                {
+                    extent = getExtent(m_resources[access.resource]);
+                    break;
+                }
+            }
+
+            // a sampled read needs the writer's render pass to have ended, and an attachment cannot be
+            // sampled by an earlier subpass of its own render pass
+            bool merge = m_merge_passes && !m_groups.empty() && m_groups.back().extent.width == extent.width &&
+                         m_groups.back().extent.height == extent.height;
+            for (const Access& access : pass.accesses)
+            {
+                if (!merge)
+                {
+                    break;
+                }
+                const std::vector<RenderGraphResource>& attachments = m_groups.back().attachments;
+                bool in_attachments = std::find(attachments.begin(), attachments.end(), access.resource) != attachments.end();
+                bool in_textures    = std::find(group_textures.begin(), group_textures.end(), access.resource) != group_textures.end();
+                merge = access.type == ACCESS_TEXTURE ? !in_attachments : !in_textures;
+            }
+            if (!merge)
+            {
+                m_groups.emplace_back();
+                m_groups.back().extent = extent;
+                group_textures.clear();
+            }
+
+            Group&   group       = m_groups.back();
+            uint32_t group_index = (uint32_t)m_groups.size() - 1;
+            pass.group           = group_index;
+            pass.subpass         = (uint32_t)group.passes.size();
+            group.name += group.passes.empty() ? pass.name : "+" + pass.name;
+            group.passes.push_back(pass_index);
+
+            for (const Access& access : pass.accesses)
+            {
+                Resource& resource = m_resources[access.resource];
+                if (access.type == ACCESS_TEXTURE)
+                {
+                    group_textures.push_back(access.resource);
+                }
+                else if (std::find(group.attachments.begin(), group.attachments.end(), access.resource) == group.attachments.end())
+                {
+                    group.attachments.push_back(access.resource);
+                }
+
+                switch (access.type)
+                {
+                    case ACCESS_COLOR:
+                        resource.usage |= RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+                        break;
+                    case ACCESS_DEPTH:
+                        resource.usage |= RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+                        break;
+                    case ACCESS_INPUT_ATTACHMENT:
+                        resource.usage |= RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+                        break;
+                    case ACCESS_TEXTURE:
+                        resource.usage |= RHI_IMAGE_USAGE_SAMPLED_BIT;
+                        break;
+                }
+                if (resource.first_group == ~0U)
+                {
+                    resource.first_load_op = access.load_op;
+                }
+                resource.first_group = std::min(resource.first_group, group_index);
+                resource.last_group  = std::max(resource.last_group, group_index);
+                getAccessMasks(access, resource.end_stages, resource.end_access);
+            }
+        }
+    }
+
+    bool RenderGraph::allocateTransients()
+    {
+        std::vector<RenderGraphResource> transients;
+        for (RenderGraphResource i = 0; i < m_resources.size(); ++i)
+        {
+            Resource& resource = m_resources[i];
+            if (resource.imported || resource.first_group == ~0U)
+            {
+                continue;
+            }
+
+            // neither loaded, stored nor sampled, so the contents never leave the render pass
+            resource.lazy = resource.first_group == resource.last_group && resource.first_load_op != RHI_ATTACHMENT_LOAD_OP_LOAD &&
+                            (resource.usage & RHI_IMAGE_USAGE_SAMPLED_BIT) == 0;
+            if (resource.lazy)
+            {
+                resource.usage |= RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+                RHIExtent2D extent = getExtent(resource);
+                uint32_t    pool   = 0;
+                for (; m_alias_transients && pool < m_pooled_images.size(); ++pool)
+                {
+                    PooledImage& pooled_image = m_pooled_images[pool];
+                    if (pooled_image.format == resource.desc.format && pooled_image.extent.width == extent.width &&
+                        pooled_image.extent.height == extent.height && !isAliveWith(resource, pooled_image.resources))
+                    {
+                        break;
+                    }
+                }
+                if (pool == m_pooled_images.size())
+                {
+                    m_pooled_images.emplace_back();
+                    m_pooled_images.back().format = resource.desc.format;
+                    m_pooled_images.back().extent = extent;
+                }
+                m_pooled_images[pool].usage |= resource.usage;
+                m_pooled_images[pool].resources.push_back(i);
+                ++m_stats.transient_image_count;
+                continue;
+            }
+
+            RHIExtent2D extent = getExtent(resource);
+            if (m_rhi->createUnboundImage(extent.width, extent.height, resource.desc.format, resource.usage, resource.image, resource.requirements) != RHI_SUCCESS)
+            {
+                return false;
+            }
+            transients.push_back(i);
+            ++m_stats.transient_image_count;
+            m_stats.transient_unaliased_bytes += resource.requirements.size;
+        }
+
+        // largest first, each image goes into the first block whose images are all dead while it is alive
+        std::sort(transients.begin(), transients.end(), [this](RenderGraphResource a, RenderGraphResource b) {
+            return m_resources[a].requirements.size > m_resources[b].requirements.size;
+        });
+        for (RenderGraphResource i : transients)
+        {
+            Resource& resource = m_resources[i];
+            uint32_t  block    = 0;
+            for (; m_alias_transients && block < m_memory_blocks.size(); ++block)
+            {
+                MemoryBlock& memory_block = m_memory_blocks[block];
+                if ((memory_block.requirements.memoryTypeBits & resource.requirements.memoryTypeBits) != 0 &&
+                    !isAliveWith(resource, memory_block.resources))
+                {
+                    break;
+                }
+            }
+            if (block == m_memory_blocks.size())
+            {
+                m_memory_blocks.emplace_back();
+                m_memory_blocks.back().requirements.memoryTypeBits = ~0U;
+            }
+
+            MemoryBlock& memory_block              = m_memory_blocks[block];
+            memory_block.requirements.size         = std::max(memory_block.requirements.size, resource.requirements.size);
+            memory_block.requirements.alignment    = std::max(memory_block.requirements.alignment, resource.requirements.alignment);
+            memory_block.requirements.memoryTypeBits &= resource.requirements.memoryTypeBits;
+            memory_block.resources.push_back(i);
+            resource.memory_block = block;
+        }
+
+        for (MemoryBlock& memory_block : m_memory_blocks)
+        {
+            if (m_rhi->allocateImageMemory(memory_block.requirements, false, memory_block.memory) != RHI_SUCCESS)
+            {
+                return false;
+            }
+            ++m_stats.transient_memory_block_count;
+            m_stats.transient_memory_bytes += memory_block.requirements.size;
+
+            // every image starts where the previous one in frame order left the memory, the first one after
+            // the last one of the previous frame
+            std::sort(memory_block.resources.begin(), memory_block.resources.end(), [this](RenderGraphResource a, RenderGraphResource b) {
+                return m_resources[a].first_group < m_resources[b].first_group;
+            });
+            for (uint32_t i = 0; i < memory_block.resources.size(); ++i)
+            {
+                Resource& resource = m_resources[memory_block.resources[i]];
+                resource.alias_predecessor =
+                    memory_block.resources[(i + memory_block.resources.size() - 1) % memory_block.resources.size()];
+                if (m_rhi->bindImageMemory(resource.image, memory_block.memory, 0) != RHI_SUCCESS)
+                {
+                    return false;
+                }
+                resource.view = m_rhi->createAttachmentImageView(resource.image, resource.desc.format);
+            }
+        }
+        return allocatePooledImages();
+    }
+
+    bool RenderGraph::allocatePooledImages()
+    {
+        for (PooledImage& pooled_image : m_pooled_images)
+        {
+            RHIMemoryRequirements requirements;
+            if (m_rhi->createUnboundImage(pooled_image.extent.width, pooled_image.extent.height, pooled_image.format, pooled_image.usage,
+                                          pooled_image.image, requirements) != RHI_SUCCESS)
+            {
+                return false;
+            }
+            bool lazily_allocated = false;
+            if (m_rhi->allocateImageMemory(requirements, true, pooled_image.memory, &lazily_allocated) != RHI_SUCCESS ||
+                m_rhi->bindImageMemory(pooled_image.image, pooled_image.memory, 0) != RHI_SUCCESS)
+            {
+                return false;
+            }
+            pooled_image.view = m_rhi->createAttachmentImageView(pooled_image.image, pooled_image.format);
+
+            ++m_stats.lazy_image_count;
+            m_stats.transient_unaliased_bytes += requirements.size * pooled_image.resources.size();
+            if (lazily_allocated)
+            {
+                m_stats.lazily_allocated_bytes += requirements.size;
+            }
+            else
+            {
+                m_stats.transient_memory_bytes += requirements.size;
+            }
+
+            // users take the image over from each other like images sharing a memory block
+            std::sort(pooled_image.resources.begin(), pooled_image.resources.end(), [this](RenderGraphResource a, RenderGraphResource b) {
+                return m_resources[a].first_group < m_resources[b].first_group;
+            });
+            for (uint32_t i = 0; i < pooled_image.resources.size(); ++i)
+            {
+                Resource& resource = m_resources[pooled_image.resources[i]];
+                resource.image     = pooled_image.image;
+                resource.view      = pooled_image.view;
+                resource.alias_predecessor =
+                    pooled_image.resources[(i + pooled_image.resources.size() - 1) % pooled_image.resources.size()];
+            }
+        }
+        return true;
+    }
+
+    bool RenderGraph::isAliveWith(const Resource& resource, const std::vector<RenderGraphResource>& others) const
+    {
+        for (RenderGraphResource other : others)
+        {
+            if (m_resources[other].first_group <= resource.last_group && resource.first_group <= m_resources[other].last_group)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RenderGraph::createRenderPass(uint32_t group_index)
+    {
+        Group&   group         = m_groups[group_index];
+        uint32_t subpass_count = (uint32_t)group.passes.size();
+
+        // input attachments need subpasses, a lone pass does without render pass objects
+        group.dynamic = m_dynamic_rendering && m_rhi->m_dynamic_rendering_supported && subpass_count == 1;
+        for (const Access& access : m_passes[group.passes[0]].accesses)
+        {
+            group.dynamic &= access.type != ACCESS_INPUT_ATTACHMENT;
+        }
+
+        // first and last subpass that references each attachment
+        std::vector<uint32_t> first_subpass(group.attachments.size(), ~0U);
+        std::vector<uint32_t> last_subpass(group.attachments.size(), 0);
+        std::vector<const Access*> first_access(group.attachments.size(), nullptr);
+        std::vector<const Access*> last_access(group.attachments.size(), nullptr);
+        for (uint32_t subpass = 0; subpass < subpass_count; ++subpass)
+        {
+            for (const Access& access : m_passes[group.passes[subpass]].accesses)
+            {
+                if (access.type == ACCESS_TEXTURE)
+                {
+                    continue;
+                }
+                uint32_t k = (uint32_t)(std::find(group.attachments.begin(), group.attachments.end(), access.resource) - group.attachments.begin());
+                if (first_access[k] == nullptr)
+                {
+                    first_access[k]  = &access;
+                    first_subpass[k] = subpass;
+                }
+                last_access[k]  = &access;
+                last_subpass[k] = subpass;
+            }
+        }
+
+        std::map<std::pair<uint32_t, uint32_t>, RHISubpassDependency> dependencies;
+        auto addDependency = [&dependencies](uint32_t src_subpass, uint32_t dst_subpass, RHIPipelineStageFlags src_stages, RHIAccessFlags src_access,
+                                             RHIPipelineStageFlags dst_stages, RHIAccessFlags dst_access, bool by_region) {
+            RHISubpassDependency& dependency = dependencies[std::make_pair(src_subpass, dst_subpass)];
+            dependency.srcSubpass = src_subpass;
+            dependency.dstSubpass = dst_subpass;
+            dependency.srcStageMask |= src_stages;
+            dependency.srcAccessMask |= src_access;
+            dependency.dstStageMask |= dst_stages;
+            dependency.dstAccessMask |= dst_access;
+            if (by_region)
+            {
+                dependency.dependencyFlags |= RHI_DEPENDENCY_BY_REGION_BIT;
+            }
+        };
+        auto addBarrier = [this](ImageBarriers& image_barriers, RenderGraphResource resource, RHIPipelineStageFlags src_stages, RHIAccessFlags src_access,
+                                 RHIPipelineStageFlags dst_stages, RHIAccessFlags dst_access, RHIImageLayout old_layout, RHIImageLayout new_layout) {
+            RHIFormat format = m_resources[resource].desc.format;
+            RHIImageMemoryBarrier barrier {};
+            barrier.sType                       = RHI_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask               = src_access;
+            barrier.dstAccessMask               = dst_access;
+            barrier.oldLayout                   = old_layout;
+            barrier.newLayout                   = new_layout;
+            barrier.subresourceRange.aspectMask = !isDepthFormat(format) ? RHI_IMAGE_ASPECT_COLOR_BIT
+                                                  : isStencilFormat(format) ? RHI_IMAGE_ASPECT_DEPTH_BIT | RHI_IMAGE_ASPECT_STENCIL_BIT
+                                                                            : RHI_IMAGE_ASPECT_DEPTH_BIT;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.layerCount = 1;
+            image_barriers.barriers.push_back(barrier);
+            image_barriers.resources.push_back(resource);
+            image_barriers.src_stages |= src_stages != 0 ? src_stages : RHI_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            image_barriers.dst_stages |= dst_stages;
+        };
+
+        std::vector<RHIAttachmentDescription> attachments(group.attachments.size());
+        group.clear_values.assign(group.attachments.size(), RHIClearValue {});
+        for (uint32_t k = 0; k < group.attachments.size(); ++k)
+        {
+            Resource&     resource   = m_resources[group.attachments[k]];
+            const Access& access     = *first_access[k];
+            bool          depth      = isDepthFormat(resource.desc.format);
+            bool          write      = access.type == ACCESS_COLOR || access.type == ACCESS_DEPTH;
+            RHIImageLayout attachment_layout = depth ? RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+            RHIAttachmentLoadOp load_op = write ? access.load_op : RHI_ATTACHMENT_LOAD_OP_LOAD;
+            // anything a later render pass or the outside world does not read stays in tile memory
+            bool stored = resource.imported || resource.last_group > group_index;
+
+            // where the image goes next decides the layout it is left in
+            RHIImageLayout final_layout = attachment_layout;
+            if (resource.imported && resource.last_group == group_index)
+            {
+                final_layout = resource.final_layout;
+            }
+            for (uint32_t g = group_index + 1; g <= resource.last_group && final_layout == attachment_layout; ++g)
+            {
+                bool found = false;
+                for (uint32_t pass_index : m_groups[g].passes)
+                {
+                    for (const Access& next : m_passes[pass_index].accesses)
+                    {
+                        if (next.resource == group.attachments[k])
+                        {
+                            if (next.type == ACCESS_TEXTURE)
+                            {
+                                final_layout = depth ? RHI_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                            }
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (found)
+                    {
+                        break;
+                    }
+                }
+                if (found)
+                {
+                    break;
+                }
+            }
+
+            RHIAttachmentDescription& description = attachments[k];
+            description.format         = resource.desc.format;
+            description.samples        = RHI_SAMPLE_COUNT_1_BIT;
+            description.loadOp         = load_op;
+            description.storeOp        = stored ? RHI_ATTACHMENT_STORE_OP_STORE : RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.stencilLoadOp  = depth ? load_op : RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.stencilStoreOp = depth ? description.storeOp : RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+            // an undefined initial layout skips the transition whenever the contents are not kept
+            description.initialLayout  = load_op == RHI_ATTACHMENT_LOAD_OP_LOAD ? resource.layout : RHI_IMAGE_LAYOUT_UNDEFINED;
+            description.finalLayout    = final_layout;
+            group.clear_values[k]      = access.clear_value;
+
+            // the incoming dependency, waits for the last use of the image or whatever held its memory before
+            RHIPipelineStageFlags dst_stages;
+            RHIAccessFlags        dst_access;
+            getAccessMasks(access, dst_stages, dst_access);
+            RHIPipelineStageFlags src_stages = resource.last_stages;
+            RHIAccessFlags        src_access = resource.last_access;
+            if (resource.first_group == group_index)
+            {
+                if (resource.imported)
+                {
+                    // the swapchain acquire semaphore is waited on at color output, a depth image was last written
+                    // by the previous frame's tests
+                    src_stages = depth ? (RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT)
+                                       : RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    src_access = depth ? RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : 0;
+                }
+                else
+                {
+                    const Resource& predecessor = m_resources[resource.alias_predecessor];
+                    src_stages                  = predecessor.end_stages;
+                    src_access                  = predecessor.end_access;
+                }
+            }
+            bool layout_change = description.initialLayout != RHI_IMAGE_LAYOUT_UNDEFINED && description.initialLayout != attachment_layout;
+            if (group.dynamic)
+            {
+                // nothing transitions the attachment on its way in, the barrier always does
+                addBarrier(group.begin_barriers, group.attachments[k], src_stages, src_access, dst_stages, dst_access,
+                           description.initialLayout, attachment_layout);
+            }
+            else if (isWrite(src_access) || write || layout_change)
+            {
+                addDependency(RHI_SUBPASS_EXTERNAL, first_subpass[k], src_stages, src_access, dst_stages, dst_access, false);
+            }
+
+            // the outgoing dependency, only sampled reads in later render passes need more than the implicit one.
+            // dynamic rendering has no implicit one and needs a barrier for any layout change
+            bool sampled_later = final_layout == RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL || final_layout == RHI_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            if (sampled_later || (group.dynamic && final_layout != attachment_layout))
+            {
+                RHIPipelineStageFlags next_stages = RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+                RHIAccessFlags        next_access = RHI_ACCESS_MEMORY_READ_BIT;
+                if (sampled_later)
+                {
+                    next_stages = 0;
+                    next_access = RHI_ACCESS_SHADER_READ_BIT;
+                    for (uint32_t g = group_index + 1; g <= resource.last_group; ++g)
+                    {
+                        for (uint32_t pass_index : m_groups[g].passes)
+                        {
+                            for (const Access& next : m_passes[pass_index].accesses)
+                            {
+                                if (next.resource == group.attachments[k] && next.type == ACCESS_TEXTURE)
+                                {
+                                    next_stages |= next.texture_stages;
+                                }
+                            }
+                        }
+                    }
+                }
+                else if (final_layout == RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+                {
+                    // the present waits on the submit's semaphore, which covers visibility
+                    next_stages = RHI_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+                    next_access = 0;
+                }
+                RHIPipelineStageFlags last_stages;
+                RHIAccessFlags        last_access_mask;
+                getAccessMasks(*last_access[k], last_stages, last_access_mask);
+                if (group.dynamic)
+                {
+                    addBarrier(group.end_barriers, group.attachments[k], last_stages, last_access_mask, next_stages, next_access,
+                               attachment_layout, final_layout);
+                }
+                else
+                {
+                    addDependency(last_subpass[k], RHI_SUBPASS_EXTERNAL, last_stages, last_access_mask, next_stages, next_access, false);
+                }
+            }
+        }
+
+        // subpass references, the arrays must stay put until the render pass is created
+        std::vector<std::vector<RHIAttachmentReference>> color_references(subpass_count);
+        std::vector<std::vector<RHIAttachmentReference>> input_references(subpass_count);
+        std::vector<RHIAttachmentReference>              depth_references(subpass_count);
+        std::vector<std::vector<uint32_t>>               preserve_references(subpass_count);
+        std::vector<RHISubpassDescription>               subpasses(subpass_count);
+        for (uint32_t subpass = 0; subpass < subpass_count; ++subpass)
+        {
+            const Pass& pass      = m_passes[group.passes[subpass]];
+            bool        has_depth = false;
+            for (const Access& access : pass.accesses)
+            {
+                if (access.type == ACCESS_TEXTURE)
+                {
+                    continue;
+                }
+                uint32_t k     = (uint32_t)(std::find(group.attachments.begin(), group.attachments.end(), access.resource) - group.attachments.begin());
+                bool     depth = isDepthFormat(m_resources[access.resource].desc.format);
+                switch (access.type)
+                {
+                    case ACCESS_COLOR:
+                        color_references[subpass].push_back({k, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+                        break;
+                    case ACCESS_DEPTH:
+                        depth_references[subpass] = {k, RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+                        has_depth                 = true;
+                        break;
+                    default:
+                        input_references[subpass].push_back(
+                            {k, depth ? RHI_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+                        break;
+                }
+
+                // against the closest earlier subpass that touched the same attachment, reads after reads need nothing
+                for (uint32_t earlier = subpass; earlier-- > first_subpass[k];)
+                {
+                    const Access* previous = nullptr;
+                    for (const Access& candidate : m_passes[group.passes[earlier]].accesses)
+                    {
+                        if (candidate.resource == access.resource)
+                        {
+                            previous = &candidate;
+                        }
+                    }
+                    if (previous == nullptr)
+                    {
+                        continue;
+                    }
+                    RHIPipelineStageFlags src_stages, dst_stages;
+                    RHIAccessFlags        src_access, dst_access;
+                    getAccessMasks(*previous, src_stages, src_access);
+                    getAccessMasks(access, dst_stages, dst_access);
+                    if (isWrite(src_access) || isWrite(dst_access))
+                    {
+                        addDependency(earlier, subpass, src_stages, src_access, dst_stages, dst_access, true);
+                    }
+                    break;
+                }
+            }
+
+            // attachments an earlier subpass wrote and a later one reads live through this one untouched
+            for (uint32_t k = 0; k < group.attachments.size(); ++k)
+            {
+                if (first_subpass[k] >= subpass || last_subpass[k] <= subpass)
+                {
+                    continue;
+                }
+                bool referenced = false;
+                for (const Access& access : pass.accesses)
+                {
+                    referenced |= access.resource == group.attachments[k];
+                }
+                if (!referenced)
+                {
+                    preserve_references[subpass].push_back(k);
+                }
+            }
+
+            RHISubpassDescription& description  = subpasses[subpass];
+            description.pipelineBindPoint       = RHI_PIPELINE_BIND_POINT_GRAPHICS;
+            description.inputAttachmentCount    = (uint32_t)input_references[subpass].size();
+            description.pInputAttachments       = input_references[subpass].data();
+            description.colorAttachmentCount    = (uint32_t)color_references[subpass].size();
+            description.pColorAttachments       = color_references[subpass].data();
+            description.pDepthStencilAttachment = has_depth ? &depth_references[subpass] : nullptr;
+            description.preserveAttachmentCount = (uint32_t)preserve_references[subpass].size();
+            description.pPreserveAttachments    = preserve_references[subpass].data();
+        }
+
+        std::vector<RHISubpassDependency> dependency_list;
+        for (const auto& dependency : dependencies)
+        {
+            dependency_list.push_back(dependency.second);
+        }
+        m_stats.dependency_count += (uint32_t)dependency_list.size();
+
+        if (group.dynamic)
+        {
+            m_stats.dependency_count += (uint32_t)(group.begin_barriers.barriers.size() + group.end_barriers.barriers.size());
+            setupDynamicRendering(group, attachments);
+        }
+        else
+        {
+            RHIRenderPassCreateInfo renderpass_create_info {};
+            renderpass_create_info.sType           = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderpass_create_info.attachmentCount = (uint32_t)attachments.size();
+            renderpass_create_info.pAttachments    = attachments.data();
+            renderpass_create_info.subpassCount    = (uint32_t)subpasses.size();
+            renderpass_create_info.pSubpasses      = subpasses.data();
+            renderpass_create_info.dependencyCount = (uint32_t)dependency_list.size();
+            renderpass_create_info.pDependencies   = dependency_list.data();
+            if (m_rhi->createRenderPass(&renderpass_create_info, group.render_pass) != RHI_SUCCESS)
+            {
+                LOG_ERROR("failed to create render pass " << group.name);
+                return false;
+            }
+        }
+
+        // carry the state over to the render passes built after this one
+        for (uint32_t k = 0; k < group.attachments.size(); ++k)
+        {
+            Resource& resource = m_resources[group.attachments[k]];
+            resource.layout    = attachments[k].finalLayout;
+            getAccessMasks(*last_access[k], resource.last_stages, resource.last_access);
+        }
+        for (uint32_t pass_index : group.passes)
+        {
+            for (const Access& access : m_passes[pass_index].accesses)
+            {
+                if (access.type == ACCESS_TEXTURE)
+                {
+                    Resource& resource   = m_resources[access.resource];
+                    resource.last_stages = access.texture_stages;
+                    resource.last_access = RHI_ACCESS_SHADER_READ_BIT;
+                }
+            }
+        }
+        return true;
+    }
+
+    void RenderGraph::setupDynamicRendering(Group& group, const std::vector<RHIAttachmentDescription>& attachments)
+    {
+        // same attachment order as the subpass of a render pass, so pipelines see the same locations
+        for (uint32_t k = 0; k < group.attachments.size(); ++k)
+        {
+            RHIRenderingAttachmentInfo attachment {};
+            attachment.sType      = RHI_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+            attachment.loadOp     = attachments[k].loadOp;
+            attachment.storeOp    = attachments[k].storeOp;
+            attachment.clearValue = group.clear_values[k];
+            if (isDepthFormat(attachments[k].format))
+            {
+                attachment.imageLayout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                group.depth_attachment = attachment;
+                group.depth_resource   = group.attachments[k];
+            }
+            else
+            {
+                attachment.imageLayout = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                group.color_attachments.push_back(attachment);
+                group.color_resources.push_back(group.attachments[k]);
+                group.color_formats.push_back(attachments[k].format);
+            }
+        }
+
+        RHIPipelineRenderingCreateInfo& rendering_formats = group.rendering_formats;
+        rendering_formats.sType                   = RHI_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        rendering_formats.colorAttachmentCount    = (uint32_t)group.color_formats.size();
+        rendering_formats.pColorAttachmentFormats = group.color_formats.data();
+        if (group.depth_resource != k_invalid_render_graph_resource)
+        {
+            RHIFormat depth_format                    = m_resources[group.depth_resource].desc.format;
+            rendering_formats.depthAttachmentFormat   = depth_format;
+            rendering_formats.stencilAttachmentFormat = isStencilFormat(depth_format) ? depth_format : RHI_FORMAT_UNDEFINED;
+        }
+    }
+
+    bool RenderGraph::executeDynamicRendering(Group& group, RHICommandBuffer command_buffer)
+    {
+        for (RenderGraphResource resource : group.attachments)
+        {
+            if (m_resources[resource].image == nullptr || m_resources[resource].view == nullptr)
+            {
+                LOG_ERROR("render graph image " << m_resources[resource].name << " has no image");
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < group.color_attachments.size(); ++i)
+        {
+            group.color_attachments[i].imageView = m_resources[group.color_resources[i]].view;
+        }
+        bool has_depth = group.depth_resource != k_invalid_render_graph_resource;
+        if (has_depth)
+        {
+            group.depth_attachment.imageView = m_resources[group.depth_resource].view;
+        }
+
+        RHIRenderingInfo rendering_info {};
+        rendering_info.sType                = RHI_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        rendering_info.flags                = m_passes[group.passes[0]].parallel ? RHI_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+        rendering_info.renderArea.offset    = {0, 0};
+        rendering_info.renderArea.extent    = group.extent;
+        rendering_info.layerCount           = 1;
+        rendering_info.colorAttachmentCount = (uint32_t)group.color_attachments.size();
+        rendering_info.pColorAttachments    = group.color_attachments.data();
+        rendering_info.pDepthAttachment     = has_depth ? &group.depth_attachment : nullptr;
+        rendering_info.pStencilAttachment   = group.rendering_formats.stencilAttachmentFormat != RHI_FORMAT_UNDEFINED ? &group.depth_attachment : nullptr;
+
+        recordBarriers(group.begin_barriers, command_buffer);
+        m_rhi->cmdBeginRendering(command_buffer, &rendering_info, &group.rendering_formats);
+        m_passes[group.passes[0]].execute(command_buffer);
+        m_rhi->cmdEndRendering(command_buffer);
+        recordBarriers(group.end_barriers, command_buffer);
+        return true;
+    }
+
+    void RenderGraph::recordBarriers(ImageBarriers& image_barriers, RHICommandBuffer command_buffer)
+    {
+        if (image_barriers.barriers.empty())
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < image_barriers.barriers.size(); ++i)
+        {
+            image_barriers.barriers[i].image = m_resources[image_barriers.resources[i]].image;
+        }
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  image_barriers.src_stages,
+                                  image_barriers.dst_stages,
+                                  0,
+                                  (uint32_t)image_barriers.barriers.size(),
+                                  image_barriers.barriers.data());
+    }
+
+    void RenderGraph::releaseCompiled()
+    {
+        for (Group& group : m_groups)
+        {
+            for (Framebuffer& framebuffer : group.framebuffers)
+            {
+                m_rhi->destroyFramebuffer(framebuffer.framebuffer);
+            }
+            if (group.render_pass != nullptr)
+            {
+                m_rhi->destroyRenderPass(group.render_pass);
+            }
+        }
+        m_groups.clear();
+
+        for (Resource& resource : m_resources)
+        {
+            if (!resource.imported && !resource.lazy && resource.image != nullptr)
+            {
+                m_rhi->destroyImage(resource.image, resource.view);
+            }
+            if (!resource.imported)
+            {
+                resource.image = nullptr;
+                resource.view  = nullptr;
+            }
+        }
+        for (PooledImage& pooled_image : m_pooled_images)
+        {
+            if (pooled_image.image != nullptr)
+            {
+                m_rhi->destroyImage(pooled_image.image, pooled_image.view);
+            }
+            if (pooled_image.memory != nullptr)
+            {
+                m_rhi->freeImageMemory(pooled_image.memory);
+            }
+        }
+        m_pooled_images.clear();
+        for (MemoryBlock& memory_block : m_memory_blocks)
+        {
+            if (memory_block.memory != nullptr)
+            {
+                m_rhi->freeImageMemory(memory_block.memory);
+            }
+        }
+        m_memory_blocks.clear();
+        m_compiled = false;
+    }
+
+    RHIExtent2D RenderGraph::getExtent(const Resource& resource) const
+    {
+        return resource.desc.extent.width == 0 ? m_rhi->m_swapchain_extent : resource.desc.extent;
+    }
+
+    bool RenderGraph::isDepthFormat(RHIFormat format)
+    {
+        return format == RHI_FORMAT_D16_UNORM || format == RHI_FORMAT_X8_D24_UNORM_PACK32 || format == RHI_FORMAT_D32_SFLOAT ||
+               format == RHI_FORMAT_D16_UNORM_S8_UINT || format == RHI_FORMAT_D24_UNORM_S8_UINT ||
+               format == RHI_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    bool RenderGraph::isStencilFormat(RHIFormat format)
+    {
+        return format == RHI_FORMAT_D16_UNORM_S8_UINT || format == RHI_FORMAT_D24_UNORM_S8_UINT || format == RHI_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    void RenderGraph::getAccessMasks(const Access& access, RHIPipelineStageFlags& stages, RHIAccessFlags& access_mask)
+    {
+        switch (access.type)
+        {
+            case ACCESS_COLOR:
+                stages      = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                access_mask = RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT | RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                break;
+            case ACCESS_DEPTH:
+                stages      = RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                access_mask = RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                break;
+            case ACCESS_INPUT_ATTACHMENT:
+                stages      = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                access_mask = RHI_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+                break;
+            case ACCESS_TEXTURE:
+                stages      = access.texture_stages;
+                access_mask = RHI_ACCESS_SHADER_READ_BIT;
+                break;
+        }
+    }
+} // namespace Aura
@@ -0,0 +1,268 @@
+#pragma once
+#include "interface/vulkan_rhi/vulkan_rhi.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+namespace Aura
+{
+    typedef uint32_t RenderGraphResource;
+    static RenderGraphResource const k_invalid_render_graph_resource {~0U};
+
+    // a 0 extent follows the swapchain and is rebuilt when it is recreated
+    struct RenderGraphImageDesc
+    {
+        RHIFormat   format {RHI_FORMAT_UNDEFINED};
+        RHIExtent2D extent {0, 0};
+    };
+
+    // counters of the last compile()
+    struct RenderGraphStats
+    {
+        uint32_t      pass_count {0};
+        uint32_t      culled_pass_count {0};
+        uint32_t      render_pass_count {0};
+        // render passes recorded with dynamic rendering, they need no render pass or framebuffer objects
+        uint32_t      dynamic_rendering_count {0};
+        // subpass dependencies, and image barriers around dynamic rendering
+        uint32_t      dependency_count {0};
+        uint32_t      transient_image_count {0};
+        uint32_t      transient_memory_block_count {0};
+        RHIDeviceSize transient_memory_bytes {0};
+        // what the transients would take without aliasing
+        RHIDeviceSize transient_unaliased_bytes {0};
+        // transients that never leave their render pass share one lazily allocated image per format and extent
+        uint32_t      lazy_image_count {0};
+        RHIDeviceSize lazily_allocated_bytes {0};
+    };
+
+    class RenderGraph;
+
+    // declares what a pass reads and writes, returned by RenderGraph::addPass()
+    class RenderGraphPassBuilder
+    {
+    public:
+        RenderGraphPassBuilder(RenderGraph* graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+        // LOAD keeps what earlier passes wrote, the other ops discard it
+        RenderGraphPassBuilder& writeColor(RenderGraphResource resource,
+                                           RHIAttachmentLoadOp load_op     = RHI_ATTACHMENT_LOAD_OP_CLEAR,
+                                           RHIClearColorValue  clear_value = {{0.0f, 0.0f, 0.0f, 1.0f}});
+        RenderGraphPassBuilder& writeDepth(RenderGraphResource       resource,
+                                           RHIAttachmentLoadOp       load_op     = RHI_ATTACHMENT_LOAD_OP_CLEAR,
+                                           RHIClearDepthStencilValue clear_value = {1.0f, 0});
+        // read in the same pixel, lets the pass merge with the writer into one render pass
+        RenderGraphPassBuilder& readInputAttachment(RenderGraphResource resource);
+        // sampled anywhere, the writer has to finish its render pass first
+        RenderGraphPassBuilder& readTexture(RenderGraphResource   resource,
+                                            RHIPipelineStageFlags stages = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        // kept even if nothing reads its outputs
+        RenderGraphPassBuilder& setSideEffect();
+        // the execute function only calls cmdRecordParallel
+        RenderGraphPassBuilder& setRecordsInParallel();
+        uint32_t                getPass() const { return m_pass; }
+
+    private:
+        RenderGraph* m_graph;
+        uint32_t     m_pass;
+    };
+
+    // passes are declared once in execution order, compile() then culls the ones whose outputs are never
+    // used, merges neighbours that share an extent into subpasses of one render pass and packs transient
+    // images with disjoint lifetimes into shared memory. a transient that is neither loaded, stored nor
+    // sampled only exists in tile memory and goes to lazily allocated memory where the device has it.
+    // synchronization is expressed as subpass dependencies and attachment layouts, batched to one
+    // dependency per subpass pair. a render pass holding a single pass that reads no input attachments is
+    // recorded with dynamic rendering where the device has it, with image barriers in place of the
+    // dependencies, and only merged passes still create render pass and framebuffer objects
+    class RenderGraph
+    {
+    public:
+        typedef std::function<void(RHICommandBuffer command_buffer)> ExecuteFunction;
+
+        void initialize(VulkanRHI* rhi);
+        // releases everything compile() created, deferred past the frames still using it
+        void shutdown();
+
+        // owned by the graph and only valid while a pass that touches it runs
+        RenderGraphResource createImage(const std::string& name, const RenderGraphImageDesc& desc);
+        // owned outside, the image is set with setImportedImage() before every execute(). initial_layout is
+        // what the image holds when the frame starts, final_layout what it is left in
+        RenderGraphResource importImage(const std::string& name,
+                                        const RenderGraphImageDesc& desc,
+                                        RHIImageLayout initial_layout,
+                                        RHIImageLayout final_layout);
+        void setImportedImage(RenderGraphResource resource, RHIImage image, RHIImageView view);
+
+        RenderGraphPassBuilder addPass(const std::string& name, ExecuteFunction execute);
+
+        // only needed once passes have been added or the swapchain extent changed, execute() calls it then
+        bool compile();
+        // drops everything compile() created, call it when the swapchain was recreated. the next execute()
+        // compiles again
+        void invalidate();
+        void execute(RHICommandBuffer command_buffer);
+
+        // render pass and subpass a pass records into, for pipeline creation. valid after compile()
+        RHIRenderPass  getRenderPass(uint32_t pass) const;
+        uint32_t       getSubpass(uint32_t pass) const;
+        // attachment formats of a pass recorded with dynamic rendering, chained into the pipeline create info
+        // in place of the render pass. nullptr when getRenderPass() is set
+        const RHIPipelineRenderingCreateInfo* getPipelineRenderingCreateInfo(uint32_t pass) const;
+        // nullptr for transients before compile() and for culled ones
+        RHIImageView  getImageView(RenderGraphResource resource) const;
+        bool          isPassCulled(uint32_t pass) const;
+        const RenderGraphStats& getStats() const { return m_stats; }
+
+        // turned off, every pass gets its own render pass
+        bool m_merge_passes {true};
+        bool m_alias_transients {true};
+        // turned off, every render pass goes through render pass and framebuffer objects
+        bool m_dynamic_rendering {true};
+
+    private:
+        friend class RenderGraphPassBuilder;
+
+        enum AccessType
+        {
+            ACCESS_COLOR,
+            ACCESS_DEPTH,
+            ACCESS_INPUT_ATTACHMENT,
+            ACCESS_TEXTURE
+        };
+
+        struct Access
+        {
+            RenderGraphResource   resource;
+            AccessType            type;
+            RHIAttachmentLoadOp   load_op;
+            RHIClearValue         clear_value;
+            RHIPipelineStageFlags texture_stages;
+        };
+
+        struct Resource
+        {
+            std::string          name;
+            RenderGraphImageDesc desc;
+            bool                 imported {false};
+            RHIImageLayout       initial_layout {RHI_IMAGE_LAYOUT_UNDEFINED};
+            RHIImageLayout       final_layout {RHI_IMAGE_LAYOUT_UNDEFINED};
+            RHIImage             image {nullptr};
+            RHIImageView         view {nullptr};
+            // compile state
+            RHIImageUsageFlags    usage {0};
+            RHIAttachmentLoadOp   first_load_op {RHI_ATTACHMENT_LOAD_OP_DONT_CARE};
+            // the image belongs to a pooled image instead of the resource
+            bool                  lazy {false};
+            uint32_t              first_group {~0U};
+            uint32_t              last_group {0};
+            uint32_t              memory_block {~0U};
+            RHIMemoryRequirements requirements {};
+            // the resource whose memory this one takes over, itself in the previous frame when nothing else
+            // shares the block
+            RenderGraphResource   alias_predecessor {k_invalid_render_graph_resource};
+            // last use in the whole frame, what the next owner of the memory waits for
+            RHIPipelineStageFlags end_stages {0};
+            RHIAccessFlags        end_access {0};
+            // last use among the render passes built so far
+            RHIPipelineStageFlags last_stages {0};
+            RHIAccessFlags        last_access {0};
+            RHIImageLayout        layout {RHI_IMAGE_LAYOUT_UNDEFINED};
+        };
+
+        struct Pass
+        {
+            std::string         name;
+            ExecuteFunction     execute;
+            std::vector<Access> accesses;
+            bool                side_effect {false};
+            bool                parallel {false};
+            bool                culled {false};
+            uint32_t            group {~0U};
+            uint32_t            subpass {0};
+        };
+
+        // the images are filled in by execute(), imported ones change from frame to frame
+        struct ImageBarriers
+        {
+            std::vector<RHIImageMemoryBarrier> barriers;
+            std::vector<RenderGraphResource>   resources;
+            RHIPipelineStageFlags              src_stages {0};
+            RHIPipelineStageFlags              dst_stages {0};
+        };
+
+        // one per combination of views seen so far, found by a linear search so execute() never builds a key
+        struct Framebuffer
+        {
+            std::vector<RHIImageView> views;
+            RHIFramebuffer            framebuffer {nullptr};
+        };
+
+        // one render pass, its subpasses are the merged passes in order
+        struct Group
+        {
+            std::string                         name;
+            std::vector<uint32_t>               passes;
+            std::vector<RenderGraphResource>    attachments;
+            std::vector<RHIClearValue>          clear_values;
+            RHIExtent2D                         extent {0, 0};
+            RHIRenderPass                       render_pass {nullptr};
+            std::vector<Framebuffer>            framebuffers;
+            // dynamic rendering instead of render_pass, the views are filled in by execute()
+            bool                                    dynamic {false};
+            std::vector<RHIRenderingAttachmentInfo> color_attachments;
+            std::vector<RenderGraphResource>        color_resources;
+            RHIRenderingAttachmentInfo              depth_attachment {};
+            RenderGraphResource                     depth_resource {k_invalid_render_graph_resource};
+            std::vector<RHIFormat>                  color_formats;
+            RHIPipelineRenderingCreateInfo          rendering_formats {};
+            ImageBarriers                           begin_barriers;
+            ImageBarriers                           end_barriers;
+        };
+
+        // one lazily allocated image shared by transients of the same format and extent that are never
+        // alive at the same time
+        struct PooledImage
+        {
+            RHIFormat                        format {RHI_FORMAT_UNDEFINED};
+            RHIExtent2D                      extent {0, 0};
+            RHIImageUsageFlags               usage {0};
+            std::vector<RenderGraphResource> resources;
+            RHIImage                         image {nullptr};
+            RHIImageView                     view {nullptr};
+            RHIDeviceMemory                  memory {nullptr};
+        };
+
+        struct MemoryBlock
+        {
+            RHIMemoryRequirements            requirements {};
+            std::vector<RenderGraphResource> resources;
+            RHIDeviceMemory                  memory {nullptr};
+        };
+
+        void     cullPasses();
+        void     buildGroups();
+        bool     allocateTransients();
+        bool     allocatePooledImages();
+        bool     isAliveWith(const Resource& resource, const std::vector<RenderGraphResource>& others) const;
+        bool     createRenderPass(uint32_t group_index);
+        void     setupDynamicRendering(Group& group, const std::vector<RHIAttachmentDescription>& attachments);
+        bool     executeDynamicRendering(Group& group, RHICommandBuffer command_buffer);
+        void     recordBarriers(ImageBarriers& image_barriers, RHICommandBuffer command_buffer);
+        void     releaseCompiled();
+        RHIExtent2D getExtent(const Resource& resource) const;
+        static bool isDepthFormat(RHIFormat format);
+        static bool isStencilFormat(RHIFormat format);
+        static void getAccessMasks(const Access& access, RHIPipelineStageFlags& stages, RHIAccessFlags& access_mask);
+
+        VulkanRHI*               m_rhi {nullptr};
+        std::vector<Resource>    m_resources;
+        std::vector<Pass>        m_passes;
+        std::vector<Group>       m_groups;
+        std::vector<MemoryBlock> m_memory_blocks;
+        std::vector<PooledImage> m_pooled_images;
+        RenderGraphStats         m_stats;
+        bool                     m_compiled {false};
+    };
+} // namespace Aura
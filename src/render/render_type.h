@@ -4,6 +4,7 @@ namespace Aura
 {
     #define RHI_SUCCESS                        true
     #define RHI_SUBPASS_EXTERNAL               (~0U)
+    #define RHI_INVALID_BINDLESS_INDEX         (~0U)
 
     typedef uint32_t RHIRenderPassCreateFlags;
     typedef uint32_t RHIPipelineStageFlags;
@@ -17,7 +18,67 @@ namespace Aura
     typedef uint64_t RHIDeviceSize;
     typedef uint32_t RHIBufferUsageFlags;
     typedef uint32_t RHIMemoryPropertyFlags;
+    typedef uint32_t RHIMemoryHeapFlags;
+    typedef uint64_t RHIUploadTicket;
+    typedef uint32_t RHIBool32;
+    typedef uint32_t RHISampleMask;
+    typedef uint32_t RHIPipelineCreateFlags;
+    typedef uint32_t RHIPipelineLayoutCreateFlags;
+    typedef uint32_t RHIPipelineShaderStageCreateFlags;
+    typedef uint32_t RHIPipelineVertexInputStateCreateFlags;
+    typedef uint32_t RHIPipelineInputAssemblyStateCreateFlags;
+    typedef uint32_t RHIPipelineViewportStateCreateFlags;
+    typedef uint32_t RHIPipelineRasterizationStateCreateFlags;
+    typedef uint32_t RHIPipelineMultisampleStateCreateFlags;
+    typedef uint32_t RHIPipelineDepthStencilStateCreateFlags;
+    typedef uint32_t RHIPipelineColorBlendStateCreateFlags;
+    typedef uint32_t RHIPipelineDynamicStateCreateFlags;
+    typedef uint32_t RHICullModeFlags;
+    typedef uint32_t RHIColorComponentFlags;
+    typedef uint32_t RHIImageUsageFlags;
+    typedef uint32_t RHIImageAspectFlags;
+    typedef uint32_t RHIRenderingFlags;
+    typedef uint32_t RHISamplerCreateFlags;
     
+    enum RHIMemoryHeapFlagBits : int
+    {
+        RHI_MEMORY_HEAP_DEVICE_LOCAL_BIT = 0x00000001,
+        RHI_MEMORY_HEAP_MULTI_INSTANCE_BIT = 0x00000002,
+        RHI_MEMORY_HEAP_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIImageUsageFlagBits : int
+    {
+        RHI_IMAGE_USAGE_TRANSFER_SRC_BIT = 0x00000001,
+        RHI_IMAGE_USAGE_TRANSFER_DST_BIT = 0x00000002,
+        RHI_IMAGE_USAGE_SAMPLED_BIT = 0x00000004,
+        RHI_IMAGE_USAGE_STORAGE_BIT = 0x00000008,
+        RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT = 0x00000010,
+        RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT = 0x00000020,
+        RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT = 0x00000040,
+        RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT = 0x00000080,
+        RHI_IMAGE_USAGE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIImageAspectFlagBits : int
+    {
+        RHI_IMAGE_ASPECT_COLOR_BIT = 0x00000001,
+        RHI_IMAGE_ASPECT_DEPTH_BIT = 0x00000002,
+        RHI_IMAGE_ASPECT_STENCIL_BIT = 0x00000004,
+        RHI_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIRenderingFlagBits : int
+    {
+        RHI_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT = 0x00000001,
+        RHI_RENDERING_SUSPENDING_BIT = 0x00000002,
+        RHI_RENDERING_RESUMING_BIT = 0x00000004,
+        RHI_RENDERING_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIDependencyFlagBits : int
+    {
+        RHI_DEPENDENCY_BY_REGION_BIT = 0x00000001,
+        RHI_DEPENDENCY_DEVICE_GROUP_BIT = 0x00000004,
+        RHI_DEPENDENCY_VIEW_LOCAL_BIT = 0x00000002,
+        RHI_DEPENDENCY_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
     enum RHIDescriptorType : int
     {
         RHI_DESCRIPTOR_TYPE_SAMPLER = 0,
@@ -201,6 +262,203 @@ namespace Aura
         RHI_PIPELINE_BIND_POINT_RAY_TRACING_NV = RHI_PIPELINE_BIND_POINT_RAY_TRACING_KHR,
         RHI_PIPELINE_BIND_POINT_MAX_ENUM = 0x7FFFFFFF
     };
+    enum RHIIndexType : int
+    {
+        RHI_INDEX_TYPE_UINT16 = 0,
+        RHI_INDEX_TYPE_UINT32 = 1,
+        RHI_INDEX_TYPE_NONE_KHR = 1000165000,
+        RHI_INDEX_TYPE_UINT8_EXT = 1000265000,
+        RHI_INDEX_TYPE_NONE_NV = RHI_INDEX_TYPE_NONE_KHR,
+        RHI_INDEX_TYPE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHISubpassContents : int
+    {
+        RHI_SUBPASS_CONTENTS_INLINE = 0,
+        RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS = 1,
+        RHI_SUBPASS_CONTENTS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIPresentMode : int
+    {
+        RHI_PRESENT_MODE_IMMEDIATE_KHR = 0,
+        RHI_PRESENT_MODE_MAILBOX_KHR = 1,
+        RHI_PRESENT_MODE_FIFO_KHR = 2,
+        RHI_PRESENT_MODE_FIFO_RELAXED_KHR = 3,
+        RHI_PRESENT_MODE_MAX_ENUM_KHR = 0x7FFFFFFF
+    };
+    enum RHIVertexInputRate : int
+    {
+        RHI_VERTEX_INPUT_RATE_VERTEX = 0,
+        RHI_VERTEX_INPUT_RATE_INSTANCE = 1,
+        RHI_VERTEX_INPUT_RATE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIPrimitiveTopology : int
+    {
+        RHI_PRIMITIVE_TOPOLOGY_POINT_LIST = 0,
+        RHI_PRIMITIVE_TOPOLOGY_LINE_LIST = 1,
+        RHI_PRIMITIVE_TOPOLOGY_LINE_STRIP = 2,
+        RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST = 3,
+        RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP = 4,
+        RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN = 5,
+        RHI_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY = 6,
+        RHI_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY = 7,
+        RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST_WITH_ADJACENCY = 8,
+        RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY = 9,
+        RHI_PRIMITIVE_TOPOLOGY_PATCH_LIST = 10,
+        RHI_PRIMITIVE_TOPOLOGY_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIPolygonMode : int
+    {
+        RHI_POLYGON_MODE_FILL = 0,
+        RHI_POLYGON_MODE_LINE = 1,
+        RHI_POLYGON_MODE_POINT = 2,
+        RHI_POLYGON_MODE_FILL_RECTANGLE_NV = 1000153000,
+        RHI_POLYGON_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHICullModeFlagBits : int
+    {
+        RHI_CULL_MODE_NONE = 0,
+        RHI_CULL_MODE_FRONT_BIT = 0x00000001,
+        RHI_CULL_MODE_BACK_BIT = 0x00000002,
+        RHI_CULL_MODE_FRONT_AND_BACK = 0x00000003,
+        RHI_CULL_MODE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIFrontFace : int
+    {
+        RHI_FRONT_FACE_COUNTER_CLOCKWISE = 0,
+        RHI_FRONT_FACE_CLOCKWISE = 1,
+        RHI_FRONT_FACE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHICompareOp : int
+    {
+        RHI_COMPARE_OP_NEVER = 0,
+        RHI_COMPARE_OP_LESS = 1,
+        RHI_COMPARE_OP_EQUAL = 2,
+        RHI_COMPARE_OP_LESS_OR_EQUAL = 3,
+        RHI_COMPARE_OP_GREATER = 4,
+        RHI_COMPARE_OP_NOT_EQUAL = 5,
+        RHI_COMPARE_OP_GREATER_OR_EQUAL = 6,
+        RHI_COMPARE_OP_ALWAYS = 7,
+        RHI_COMPARE_OP_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIFilter : int
+    {
+        RHI_FILTER_NEAREST = 0,
+        RHI_FILTER_LINEAR = 1,
+        RHI_FILTER_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHISamplerMipmapMode : int
+    {
+        RHI_SAMPLER_MIPMAP_MODE_NEAREST = 0,
+        RHI_SAMPLER_MIPMAP_MODE_LINEAR = 1,
+        RHI_SAMPLER_MIPMAP_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHISamplerAddressMode : int
+    {
+        RHI_SAMPLER_ADDRESS_MODE_REPEAT = 0,
+        RHI_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT = 1,
+        RHI_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE = 2,
+        RHI_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER = 3,
+        RHI_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE = 4,
+        RHI_SAMPLER_ADDRESS_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIBorderColor : int
+    {
+        RHI_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK = 0,
+        RHI_BORDER_COLOR_INT_TRANSPARENT_BLACK = 1,
+        RHI_BORDER_COLOR_FLOAT_OPAQUE_BLACK = 2,
+        RHI_BORDER_COLOR_INT_OPAQUE_BLACK = 3,
+        RHI_BORDER_COLOR_FLOAT_OPAQUE_WHITE = 4,
+        RHI_BORDER_COLOR_INT_OPAQUE_WHITE = 5,
+        RHI_BORDER_COLOR_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIStencilOp : int
+    {
+        RHI_STENCIL_OP_KEEP = 0,
+        RHI_STENCIL_OP_ZERO = 1,
+        RHI_STENCIL_OP_REPLACE = 2,
+        RHI_STENCIL_OP_INCREMENT_AND_CLAMP = 3,
+        RHI_STENCIL_OP_DECREMENT_AND_CLAMP = 4,
+        RHI_STENCIL_OP_INVERT = 5,
+        RHI_STENCIL_OP_INCREMENT_AND_WRAP = 6,
+        RHI_STENCIL_OP_DECREMENT_AND_WRAP = 7,
+        RHI_STENCIL_OP_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHILogicOp : int
+    {
+        RHI_LOGIC_OP_CLEAR = 0,
+        RHI_LOGIC_OP_AND = 1,
+        RHI_LOGIC_OP_AND_REVERSE = 2,
+        RHI_LOGIC_OP_COPY = 3,
+        RHI_LOGIC_OP_AND_INVERTED = 4,
+        RHI_LOGIC_OP_NO_OP = 5,
+        RHI_LOGIC_OP_XOR = 6,
+        RHI_LOGIC_OP_OR = 7,
+        RHI_LOGIC_OP_NOR = 8,
+        RHI_LOGIC_OP_EQUIVALENT = 9,
+        RHI_LOGIC_OP_INVERT = 10,
+        RHI_LOGIC_OP_OR_REVERSE = 11,
+        RHI_LOGIC_OP_COPY_INVERTED = 12,
+        RHI_LOGIC_OP_OR_INVERTED = 13,
+        RHI_LOGIC_OP_NAND = 14,
+        RHI_LOGIC_OP_SET = 15,
+        RHI_LOGIC_OP_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIBlendFactor : int
+    {
+        RHI_BLEND_FACTOR_ZERO = 0,
+        RHI_BLEND_FACTOR_ONE = 1,
+        RHI_BLEND_FACTOR_SRC_COLOR = 2,
+        RHI_BLEND_FACTOR_ONE_MINUS_SRC_COLOR = 3,
+        RHI_BLEND_FACTOR_DST_COLOR = 4,
+        RHI_BLEND_FACTOR_ONE_MINUS_DST_COLOR = 5,
+        RHI_BLEND_FACTOR_SRC_ALPHA = 6,
+        RHI_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA = 7,
+        RHI_BLEND_FACTOR_DST_ALPHA = 8,
+        RHI_BLEND_FACTOR_ONE_MINUS_DST_ALPHA = 9,
+        RHI_BLEND_FACTOR_CONSTANT_COLOR = 10,
+        RHI_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR = 11,
+        RHI_BLEND_FACTOR_CONSTANT_ALPHA = 12,
+        RHI_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA = 13,
+        RHI_BLEND_FACTOR_SRC_ALPHA_SATURATE = 14,
+        RHI_BLEND_FACTOR_SRC1_COLOR = 15,
+        RHI_BLEND_FACTOR_ONE_MINUS_SRC1_COLOR = 16,
+        RHI_BLEND_FACTOR_SRC1_ALPHA = 17,
+        RHI_BLEND_FACTOR_ONE_MINUS_SRC1_ALPHA = 18,
+        RHI_BLEND_FACTOR_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIBlendOp : int
+    {
+        RHI_BLEND_OP_ADD = 0,
+        RHI_BLEND_OP_SUBTRACT = 1,
+        RHI_BLEND_OP_REVERSE_SUBTRACT = 2,
+        RHI_BLEND_OP_MIN = 3,
+        RHI_BLEND_OP_MAX = 4,
+        RHI_BLEND_OP_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIColorComponentFlagBits : int
+    {
+        RHI_COLOR_COMPONENT_R_BIT = 0x00000001,
+        RHI_COLOR_COMPONENT_G_BIT = 0x00000002,
+        RHI_COLOR_COMPONENT_B_BIT = 0x00000004,
+        RHI_COLOR_COMPONENT_A_BIT = 0x00000008,
+        RHI_COLOR_COMPONENT_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+    enum RHIDynamicState : int
+    {
+        RHI_DYNAMIC_STATE_VIEWPORT = 0,
+        RHI_DYNAMIC_STATE_SCISSOR = 1,
+        RHI_DYNAMIC_STATE_LINE_WIDTH = 2,
+        RHI_DYNAMIC_STATE_DEPTH_BIAS = 3,
+        RHI_DYNAMIC_STATE_BLEND_CONSTANTS = 4,
+        RHI_DYNAMIC_STATE_DEPTH_BOUNDS = 5,
+        RHI_DYNAMIC_STATE_STENCIL_COMPARE_MASK = 6,
+        RHI_DYNAMIC_STATE_STENCIL_WRITE_MASK = 7,
+        RHI_DYNAMIC_STATE_STENCIL_REFERENCE = 8,
+        RHI_DYNAMIC_STATE_CULL_MODE = 1000267000,
+        RHI_DYNAMIC_STATE_FRONT_FACE = 1000267001,
+        RHI_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY = 1000267002,
+        RHI_DYNAMIC_STATE_MAX_ENUM = 0x7FFFFFFF
+    };
     enum RHIStructureType : int
     {
         RHI_STRUCTURE_TYPE_APPLICATION_INFO = 0,
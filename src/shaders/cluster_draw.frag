@@ -0,0 +1,12 @@
+#version 450
+
+// flat shaded from the screen-space derivatives of the position, the culled draw has no normals bound
+layout(location = 0) in vec3 in_position;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    vec3 normal = normalize(cross(dFdx(in_position), dFdy(in_position)));
+    out_color   = vec4(vec3(0.2) + 0.8 * abs(normal.zzz), 1.0);
+}
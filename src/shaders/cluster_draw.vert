@@ -0,0 +1,21 @@
+#version 450
+
+// draws a cluster-culled mesh by position only. quantized layouts store positions normalized, the push constants
+// carry the scale and offset that decode them back into the mesh's own space before the view-projection
+layout(location = 0) in vec3 in_position;
+
+layout(push_constant) uniform DrawConstants
+{
+    mat4 view_projection;
+    vec4 position_offset;
+    vec4 position_scale;
+} constants;
+
+layout(location = 0) out vec3 out_position;
+
+void main()
+{
+    vec3 position = constants.position_offset.xyz + constants.position_scale.xyz * in_position;
+    out_position  = position;
+    gl_Position   = constants.view_projection * vec4(position, 1.0);
+}
@@ -0,0 +1,520 @@
+#include "../asset/auramesh_file.h"
+#include "../asset/mesh_cooker.h"
+#include "../asset/obj_importer.h"
+#include "../util/job_system.h"
+#include "../util/object_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Aura_mesh_cooker: imports a wavefront obj and writes the cooked .auramesh the
+// runtime maps instead of parsing text. the output defaults to the input path
+// with its extension replaced. --no-optimize keeps the obj's triangle order,
+// --no-meshlets leaves out the clusters the gpu culls, --layout writes the
+// named vertex layout instead of the smallest one within tolerance.
+// --self-check runs the job system, the object pool and a synthetic mesh
+// through cook and load and exits non-zero on the first mismatch, it writes
+// and removes aura_mesh_cooker_self_check.auramesh in the working directory.
+//
+//   Aura_mesh_cooker [--no-optimize] [--no-meshlets]
+//                    [--layout float32|snorm16|float16|snorm16_oct8]
+//                    input.obj [output.auramesh]
+//   Aura_mesh_cooker --self-check
+
+#define SELF_CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "self-check failed (%s:%d): ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            return false; \
+        } \
+    } while (0)
+
+namespace {
+    // the workers must steal what thread 0 queued, continuations must wait for every job of their counter
+    bool checkJobSystem() {
+        Aura::JobSystem job_system;
+        job_system.initialize(3);
+
+        // long enough that the sleeping workers wake up and take jobs off thread 0's deque
+        std::atomic<uint32_t> thread_mask {0};
+        Aura::JobCounter steal_counter;
+        for (uint32_t i = 0; i < 64; ++i) {
+            job_system.run([&job_system, &thread_mask]() {
+                thread_mask.fetch_or(1u << job_system.getThreadIndex());
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }, &steal_counter);
+        }
+        job_system.wait(steal_counter);
+        SELF_CHECK(steal_counter.getValue() == 0, "wait returned with %u jobs left", steal_counter.getValue());
+        SELF_CHECK(job_system.m_stolen_count.load() > 0, "no job was stolen");
+        SELF_CHECK((thread_mask.load() & ~1u) != 0, "only thread 0 ran jobs");
+
+        // a chain of continuations, each one must see every job of the counter it waited for
+        std::atomic<uint32_t> first_done {0};
+        std::atomic<uint32_t> second_done {0};
+        std::atomic<bool> ordered {true};
+        Aura::JobCounter first, second, third;
+        for (uint32_t i = 0; i < 32; ++i) {
+            job_system.run([&first_done]() { first_done.fetch_add(1); }, &first);
+        }
+        for (uint32_t i = 0; i < 8; ++i) {
+            job_system.runAfter(first, [&]() {
+                ordered = ordered && first_done.load() == 32;
+                second_done.fetch_add(1);
+            }, &second);
+        }
+        job_system.runAfter(second, [&]() { ordered = ordered && second_done.load() == 8; }, &third);
+        job_system.wait(third);
+        SELF_CHECK(ordered.load(), "a continuation ran before its dependency finished");
+        SELF_CHECK(first_done.load() == 32 && second_done.load() == 8, "%u and %u jobs ran, expected 32 and 8",
+                   first_done.load(), second_done.load());
+
+        // a dependency that already reached zero runs the job right away
+        bool immediate = false;
+        Aura::JobCounter done, immediate_counter;
+        job_system.runAfter(done, [&immediate]() { immediate = true; }, &immediate_counter);
+        job_system.wait(immediate_counter);
+        SELF_CHECK(immediate, "runAfter on a finished counter never ran");
+
+        std::vector<std::atomic<uint32_t>> visits(10000);
+        job_system.parallelFor((uint32_t)visits.size(), 16, [&visits](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                visits[i].fetch_add(1);
+            }
+        });
+        for (size_t i = 0; i < visits.size(); ++i) {
+            SELF_CHECK(visits[i].load() == 1, "parallelFor visited item %zu %u times", i, visits[i].load());
+        }
+
+        job_system.shutdown();
+        return true;
+    }
+
+    // a slot's generation runs 1..4095 and wraps back to 1, never to the invalid 0
+    bool checkObjectPool() {
+        typedef Aura::ObjectHandle<struct SelfCheckTag> Handle;
+        typedef Aura::ObjectPool<Handle, uint32_t, float> Pool;
+        Pool pool;
+
+        Handle first = pool.create(7u, 0.5f);
+        SELF_CHECK(first != nullptr && pool.isValid(first), "create returned an invalid handle");
+        SELF_CHECK(pool.get<0>(first) == 7u && pool.get<1>(first) == 0.5f, "fields do not read back");
+        SELF_CHECK(pool.set<1>(first, 2.0f) && pool.get<1>(first) == 2.0f, "set does not read back");
+        SELF_CHECK(pool.destroy(first) && !pool.destroy(first), "a handle was destroyed twice");
+        SELF_CHECK(!pool.isValid(first) && pool.get<0>(first) == 0u && !pool.set<0>(first, 1u), "a stale handle still reaches its slot");
+
+        Handle handle;
+        for (uint32_t reuse = 1; reuse <= Pool::k_generation_mask; ++reuse) {
+            handle = pool.create(reuse, 0.0f);
+            SELF_CHECK(handle != nullptr, "reuse %u returned the invalid handle", reuse);
+            SELF_CHECK((handle.getValue() & Pool::k_index_mask) == (first.getValue() & Pool::k_index_mask), "reuse %u took another slot", reuse);
+            SELF_CHECK((handle == first) == (reuse == Pool::k_generation_mask), "reuse %u has generation %u", reuse,
+                       handle.getValue() >> Pool::k_index_bits);
+            SELF_CHECK(pool.get<0>(handle) == reuse, "reuse %u reads %u", reuse, pool.get<0>(handle));
+            if (reuse < Pool::k_generation_mask) {
+                SELF_CHECK(!pool.isValid(first), "the first handle came back after %u reuses", reuse);
+                pool.destroy(handle);
+            }
+        }
+        SELF_CHECK(pool.isValid(first) && pool.getLiveCount() == 1, "the generation did not wrap around to the first handle");
+
+        // freed slots go to the back of the queue
+        Handle a = pool.create(1u, 0.0f);
+        Handle b = pool.create(2u, 0.0f);
+        pool.destroy(a);
+        pool.destroy(b);
+        Handle c = pool.create(3u, 0.0f);
+        SELF_CHECK((c.getValue() & Pool::k_index_mask) == (a.getValue() & Pool::k_index_mask), "freed slots are not reused oldest first");
+        pool.clear();
+        SELF_CHECK(pool.getLiveCount() == 0 && !pool.isValid(c) && !pool.isValid(first), "clear left live handles");
+        return true;
+    }
+
+    // a uv sphere off the origin split into two submeshes, the seam and the poles repeat positions
+    Aura::MeshData buildSphere() {
+        const uint32_t slices = 48, stacks = 24;
+        const float center[3] = {1.0f, 2.0f, 3.0f};
+        const float radius = 2.0f;
+        Aura::MeshData mesh;
+        for (uint32_t y = 0; y <= stacks; ++y) {
+            for (uint32_t x = 0; x <= slices; ++x) {
+                float theta = 3.14159265f * (float)y / (float)stacks;
+                float phi = 2.0f * 3.14159265f * (float)x / (float)slices;
+                Aura::MeshVertex vertex;
+                vertex.normal[0] = std::sin(theta) * std::cos(phi);
+                vertex.normal[1] = std::cos(theta);
+                vertex.normal[2] = std::sin(theta) * std::sin(phi);
+                for (uint32_t k = 0; k < 3; ++k) {
+                    vertex.position[k] = center[k] + radius * vertex.normal[k];
+                }
+                vertex.texcoord[0] = (float)x / (float)slices;
+                vertex.texcoord[1] = (float)y / (float)stacks;
+                mesh.vertices.push_back(vertex);
+            }
+        }
+        for (uint32_t y = 0; y < stacks; ++y) {
+            for (uint32_t x = 0; x < slices; ++x) {
+                uint32_t i0 = y * (slices + 1) + x, i1 = i0 + 1, i2 = i0 + slices + 1, i3 = i2 + 1;
+                uint32_t quad[6] = {i0, i2, i1, i1, i2, i3};
+                mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+            }
+        }
+        uint32_t half = (uint32_t)mesh.indices.size() / 6 * 3;
+        mesh.submeshes.push_back({0, half, 0});
+        mesh.submeshes.push_back({half, (uint32_t)mesh.indices.size() - half, 1});
+        mesh.material_names = {"upper", "lower"};
+        for (uint32_t k = 0; k < 3; ++k) {
+            mesh.bounds_min[k] = center[k] - radius;
+            mesh.bounds_max[k] = center[k] + radius;
+        }
+        return mesh;
+    }
+
+    float halfToFloat(uint16_t half) {
+        uint32_t exponent = (half >> 10) & 0x1F;
+        uint32_t mantissa = half & 0x3FF;
+        float value = exponent == 0 ? (float)mantissa / 16777216.0f : std::ldexp(1.0f + (float)mantissa / 1024.0f, (int)exponent - 15);
+        return (half & 0x8000) ? -value : value;
+    }
+
+    float snormToFloat(int32_t value, int32_t max) {
+        return std::max((float)value / (float)max, -1.0f);
+    }
+
+    // what cluster_draw.vert does with an attribute, independent of the encoder
+    void decodeVertex(const Aura::AuraMeshFile& file, uint32_t index, float position[3], float normal[3], float texcoord[2]) {
+        const Aura::AuraMeshHeader& header = file.getHeader();
+        const Aura::VertexLayoutInfo& info = Aura::VertexEncoder::getLayoutInfo((Aura::VertexLayout)header.vertex_layout);
+        const uint8_t* vertex = (const uint8_t*)file.getVertexData() + (size_t)index * header.vertex_stride;
+
+        float stored[3];
+        if (info.position.encoding == Aura::VERTEX_ATTRIBUTE_FLOAT32X3) {
+            memcpy(position, vertex + info.position.offset, sizeof(float) * 3);
+        }
+        else {
+            for (uint32_t k = 0; k < 3; ++k) {
+                if (info.position.encoding == Aura::VERTEX_ATTRIBUTE_SNORM16X4) {
+                    stored[k] = snormToFloat(((const int16_t*)(vertex + info.position.offset))[k], 32767);
+                }
+                else {
+                    stored[k] = halfToFloat(((const uint16_t*)(vertex + info.position.offset))[k]);
+                }
+                position[k] = header.position_offset[k] + header.position_scale[k] * stored[k];
+            }
+        }
+
+        if (info.normal.encoding == Aura::VERTEX_ATTRIBUTE_FLOAT32X3) {
+            memcpy(normal, vertex + info.normal.offset, sizeof(float) * 3);
+        }
+        else {
+            float oct[2];
+            for (uint32_t k = 0; k < 2; ++k) {
+                oct[k] = info.normal.encoding == Aura::VERTEX_ATTRIBUTE_SNORM16X4 ?
+                             snormToFloat(((const int16_t*)(vertex + info.normal.offset))[k], 32767) :
+                             snormToFloat(((const int8_t*)(vertex + info.normal.offset))[k], 127);
+            }
+            normal[0] = oct[0];
+            normal[1] = oct[1];
+            normal[2] = 1.0f - std::fabs(oct[0]) - std::fabs(oct[1]);
+            if (normal[2] < 0.0f) {
+                normal[0] = (1.0f - std::fabs(oct[1])) * (oct[0] < 0.0f ? -1.0f : 1.0f);
+                normal[1] = (1.0f - std::fabs(oct[0])) * (oct[1] < 0.0f ? -1.0f : 1.0f);
+            }
+            float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for (uint32_t k = 0; k < 3; ++k) {
+                normal[k] /= length;
+            }
+        }
+
+        if (info.texcoord.encoding == Aura::VERTEX_ATTRIBUTE_FLOAT32X2) {
+            memcpy(texcoord, vertex + info.texcoord.offset, sizeof(float) * 2);
+        }
+        else {
+            for (uint32_t k = 0; k < 2; ++k) {
+                texcoord[k] = halfToFloat(((const uint16_t*)(vertex + info.texcoord.offset))[k]);
+            }
+        }
+    }
+
+    uint32_t readIndex(const Aura::AuraMeshFile& file, uint32_t i) {
+        return file.getHeader().index_size == 2 ? ((const uint16_t*)file.getIndexData())[i] : ((const uint32_t*)file.getIndexData())[i];
+    }
+
+    struct RoundTripError {
+        float position {0.0f};
+        float normal_degrees {0.0f};
+        float texcoord {0.0f};
+    };
+
+    // decodes every index of the file against the vertex the source mesh has there, needs a cook that kept the
+    // triangle order
+    bool checkRoundTrip(const Aura::MeshData& mesh, const Aura::AuraMeshFile& file, RoundTripError& error) {
+        const Aura::AuraMeshHeader& header = file.getHeader();
+        SELF_CHECK(header.index_count == mesh.indices.size(), "%u indices loaded, %zu cooked", header.index_count, mesh.indices.size());
+        SELF_CHECK(header.index_size == (header.vertex_count <= 0x10000 ? 2u : 4u), "%u byte indices for %u vertices", header.index_size,
+                   header.vertex_count);
+        SELF_CHECK(header.submesh_count == mesh.submeshes.size(), "%u submeshes loaded, %zu cooked", header.submesh_count,
+                   mesh.submeshes.size());
+        SELF_CHECK(header.material_count == mesh.material_names.size(), "%u materials loaded, %zu cooked", header.material_count,
+                   mesh.material_names.size());
+        for (uint32_t i = 0; i < header.material_count; ++i) {
+            SELF_CHECK(mesh.material_names[i] == file.getMaterialName(i), "material %u reads back as %s", i, file.getMaterialName(i));
+        }
+        for (uint32_t i = 0; i < header.submesh_count; ++i) {
+            const Aura::AuraMeshSubmesh& submesh = file.getSubmeshes()[i];
+            SELF_CHECK(submesh.first_index == mesh.submeshes[i].first_index && submesh.index_count == mesh.submeshes[i].index_count &&
+                       submesh.material == mesh.submeshes[i].material, "submesh %u does not read back", i);
+        }
+
+        error = RoundTripError();
+        for (uint32_t i = 0; i < header.index_count; ++i) {
+            uint32_t index = readIndex(file, i);
+            SELF_CHECK(index < header.vertex_count, "index %u is %u of %u vertices", i, index, header.vertex_count);
+            const Aura::MeshVertex& source = mesh.vertices[mesh.indices[i]];
+            float position[3], normal[3], texcoord[2];
+            decodeVertex(file, index, position, normal, texcoord);
+            float distance = 0.0f, dot = 0.0f;
+            for (uint32_t k = 0; k < 3; ++k) {
+                distance += (position[k] - source.position[k]) * (position[k] - source.position[k]);
+                dot += normal[k] * source.normal[k];
+            }
+            // acos rounds the small angles away, atan2 of the cross product's length keeps them
+            const float* n = source.normal;
+            float cross[3] = {n[1] * normal[2] - n[2] * normal[1], n[2] * normal[0] - n[0] * normal[2], n[0] * normal[1] - n[1] * normal[0]};
+            float sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+            error.position = std::max(error.position, std::sqrt(distance));
+            error.normal_degrees = std::max(error.normal_degrees, std::atan2(sine, dot) * 57.2957795f);
+            for (uint32_t k = 0; k < 2; ++k) {
+                error.texcoord = std::max(error.texcoord, std::fabs(texcoord[k] - source.texcoord[k]));
+            }
+        }
+        return true;
+    }
+
+    // the meshlets of a submesh must hold exactly its triangles
+    bool checkMeshlets(const Aura::AuraMeshFile& file) {
+        const Aura::AuraMeshHeader& header = file.getHeader();
+        SELF_CHECK(header.meshlet_count > 0, "no meshlets were written");
+        uint32_t meshlet_total = 0;
+        for (uint32_t s = 0; s < header.submesh_count; ++s) {
+            const Aura::AuraMeshSubmesh& submesh = file.getSubmeshes()[s];
+            SELF_CHECK(submesh.first_meshlet == meshlet_total, "submesh %u starts at meshlet %u", s, submesh.first_meshlet);
+            meshlet_total += submesh.meshlet_count;
+            std::vector<uint64_t> from_indices, from_meshlets;
+            auto addTriangle = [](std::vector<uint64_t>& triangles, uint32_t a, uint32_t b, uint32_t c) {
+                // rotated to start at the smallest index, which keeps the winding
+                while (a > b || a > c) {
+                    uint32_t t = a;
+                    a = b;
+                    b = c;
+                    c = t;
+                }
+                triangles.push_back((uint64_t)a << 42 | (uint64_t)b << 21 | c);
+            };
+            for (uint32_t i = submesh.first_index; i < submesh.first_index + submesh.index_count; i += 3) {
+                addTriangle(from_indices, readIndex(file, i), readIndex(file, i + 1), readIndex(file, i + 2));
+            }
+            for (uint32_t m = submesh.first_meshlet; m < submesh.first_meshlet + submesh.meshlet_count; ++m) {
+                const Aura::AuraMeshMeshlet& meshlet = file.getMeshlets()[m];
+                SELF_CHECK(meshlet.submesh == s, "meshlet %u names submesh %u instead of %u", m, meshlet.submesh, s);
+                SELF_CHECK(meshlet.vertex_count <= Aura::MeshletBuilder::k_max_vertices &&
+                           meshlet.triangle_count <= Aura::MeshletBuilder::k_max_triangles &&
+                           meshlet.vertex_offset + meshlet.vertex_count <= header.meshlet_vertex_count &&
+                           meshlet.triangle_offset + meshlet.triangle_count <= header.meshlet_triangle_count,
+                           "meshlet %u is out of bounds", m);
+                const uint32_t* vertices = file.getMeshletVertices() + meshlet.vertex_offset;
+                for (uint32_t t = 0; t < meshlet.triangle_count; ++t) {
+                    uint32_t packed = file.getMeshletTriangles()[meshlet.triangle_offset + t];
+                    uint32_t local[3] = {packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF};
+                    SELF_CHECK(local[0] < meshlet.vertex_count && local[1] < meshlet.vertex_count && local[2] < meshlet.vertex_count,
+                               "meshlet %u triangle %u indexes past its vertices", m, t);
+                    addTriangle(from_meshlets, vertices[local[0]], vertices[local[1]], vertices[local[2]]);
+                }
+            }
+            std::sort(from_indices.begin(), from_indices.end());
+            std::sort(from_meshlets.begin(), from_meshlets.end());
+            SELF_CHECK(from_indices == from_meshlets, "the meshlets of submesh %u hold %zu triangles, not the %zu of its indices", s,
+                       from_meshlets.size(), from_indices.size());
+        }
+        SELF_CHECK(meshlet_total == header.meshlet_count, "submeshes cover %u of %u meshlets", meshlet_total, header.meshlet_count);
+        return true;
+    }
+
+    // every layout cooked without reordering must decode to the source within the error the cooker reported,
+    // and the picked layout within the tolerances
+    bool cookAndLoad(const char* path) {
+        Aura::MeshData mesh = buildSphere();
+
+        for (uint32_t layout = 0; layout < Aura::VERTEX_LAYOUT_COUNT; ++layout) {
+            const char* name = Aura::VertexEncoder::getLayoutInfo((Aura::VertexLayout)layout).name;
+            Aura::MeshCooker cooker;
+            cooker.m_optimize = false;
+            cooker.m_build_meshlets = false;
+            cooker.m_pick_vertex_layout = false;
+            cooker.m_vertex_layout = (Aura::VertexLayout)layout;
+            SELF_CHECK(cooker.cookToFile(mesh, path), "cooking the %s layout failed", name);
+            Aura::AuraMeshFile file;
+            SELF_CHECK(file.open(path), "loading the %s layout failed", name);
+            SELF_CHECK(file.getHeader().vertex_layout == layout, "%s was written as layout %u", name, file.getHeader().vertex_layout);
+            SELF_CHECK(file.getHeader().vertex_count == cooker.getStats().output_vertices, "%s: %u vertices loaded, %u cooked", name,
+                       file.getHeader().vertex_count, cooker.getStats().output_vertices);
+            SELF_CHECK(file.getHeader().meshlet_count == 0, "%s: meshlets were written without being asked for", name);
+
+            RoundTripError error;
+            if (!checkRoundTrip(mesh, file, error)) {
+                fprintf(stderr, "  while checking the %s layout\n", name);
+                return false;
+            }
+            // the reported error is over the same vertices, the slack is the decoders' float rounding
+            const Aura::VertexEncodingError& reported = cooker.getStats().vertex_error;
+            SELF_CHECK(error.position <= reported.position + 1e-5f, "%s: position error %g over the reported %g", name, error.position,
+                       reported.position);
+            SELF_CHECK(error.normal_degrees <= reported.normal_degrees + 0.05f, "%s: normal error %g deg over the reported %g", name,
+                       error.normal_degrees, reported.normal_degrees);
+            SELF_CHECK(error.texcoord <= reported.texcoord + 1e-6f, "%s: texcoord error %g over the reported %g", name, error.texcoord,
+                       reported.texcoord);
+            if (layout == Aura::VERTEX_LAYOUT_FLOAT32) {
+                SELF_CHECK(error.position == 0.0f && error.texcoord == 0.0f && error.normal_degrees < 0.05f, "float32 is not lossless");
+            }
+            else {
+                // half a step of each quantization, the position scale is the sphere's radius on every axis
+                float position_bound = layout == Aura::VERTEX_LAYOUT_FLOAT16 ? 2.0f * 1.7321f / 2048.0f : 2.0f * 1.7321f * 0.5f / 32767.0f;
+                float normal_bound = layout == Aura::VERTEX_LAYOUT_SNORM16_OCT8 ? 1.5f : 0.01f;
+                SELF_CHECK(error.position <= position_bound * 1.001f, "%s: position error %g over the bound %g", name, error.position,
+                           position_bound);
+                SELF_CHECK(error.normal_degrees <= normal_bound, "%s: normal error %g deg over the bound %g", name, error.normal_degrees,
+                           normal_bound);
+                SELF_CHECK(error.texcoord <= 1.0f / 2048.0f, "%s: texcoord error %g over half a half-float step", name, error.texcoord);
+            }
+            file.close();
+        }
+
+        // the defaults: picked layout, reordered for the cache and split into meshlets
+        Aura::MeshCooker cooker;
+        SELF_CHECK(cooker.cookToFile(mesh, path), "cooking with the defaults failed");
+        const Aura::MeshCookStats& stats = cooker.getStats();
+        float diagonal = 0.0f;
+        for (uint32_t k = 0; k < 3; ++k) {
+            diagonal += (mesh.bounds_max[k] - mesh.bounds_min[k]) * (mesh.bounds_max[k] - mesh.bounds_min[k]);
+        }
+        diagonal = std::sqrt(diagonal);
+        SELF_CHECK(stats.vertex_error.position <= cooker.m_position_tolerance * diagonal &&
+                   stats.vertex_error.normal_degrees <= cooker.m_normal_tolerance_degrees &&
+                   stats.vertex_error.tangent_degrees <= cooker.m_normal_tolerance_degrees &&
+                   stats.vertex_error.texcoord <= cooker.m_texcoord_tolerance,
+                   "the picked %s layout exceeds the tolerances", Aura::VertexEncoder::getLayoutInfo(stats.vertex_layout).name);
+        Aura::AuraMeshFile file;
+        SELF_CHECK(file.open(path), "loading the default cook failed");
+        SELF_CHECK(file.getHeader().vertex_layout == stats.vertex_layout && file.getHeader().meshlet_count == stats.meshlet_count &&
+                   file.getHeader().file_size == stats.file_bytes, "the header disagrees with the cook stats");
+        return checkMeshlets(file);
+    }
+
+    bool checkCookAndLoad() {
+        const char* path = "aura_mesh_cooker_self_check.auramesh";
+        bool ok = cookAndLoad(path);
+        std::remove(path);
+        return ok;
+    }
+
+    int runSelfCheck() {
+        struct Check {
+            const char* name;
+            bool (*function)();
+        };
+        const Check checks[] = {
+            {"job system", checkJobSystem},
+            {"object pool", checkObjectPool},
+            {"cook and load", checkCookAndLoad},
+        };
+        for (const Check& check : checks) {
+            if (!check.function()) {
+                fprintf(stderr, "self-check %s: FAILED\n", check.name);
+                return 1;
+            }
+            printf("self-check %s: ok\n", check.name);
+            fflush(stdout);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Aura::MeshCooker cooker;
+    std::string paths[2];
+    int path_count = 0;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--self-check") == 0) {
+            return runSelfCheck();
+        }
+        else if (strcmp(argv[i], "--no-optimize") == 0) {
+            cooker.m_optimize = false;
+        }
+        else if (strcmp(argv[i], "--no-meshlets") == 0) {
+            cooker.m_build_meshlets = false;
+        }
+        else if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            bool known = false;
+            for (uint32_t layout = 0; layout < Aura::VERTEX_LAYOUT_COUNT; ++layout) {
+                if (strcmp(name, Aura::VertexEncoder::getLayoutInfo((Aura::VertexLayout)layout).name) == 0) {
+                    cooker.m_vertex_layout = (Aura::VertexLayout)layout;
+                    cooker.m_pick_vertex_layout = false;
+                    known = true;
+                }
+            }
+            usage |= !known;
+        }
+        else if (argv[i][0] != '-' && path_count < 2) {
+            paths[path_count++] = argv[i];
+        }
+        else {
+            usage = true;
+        }
+    }
+    if (usage || path_count == 0) {
+        fprintf(stderr, "usage: %s [--no-optimize] [--no-meshlets] [--layout float32|snorm16|float16|snorm16_oct8] input.obj [output.auramesh]\n"
+                        "       %s --self-check\n", argv[0], argv[0]);
+        return 1;
+    }
+    std::string input = paths[0];
+    std::string output = path_count > 1 ? paths[1] : input.substr(0, input.find_last_of('.')) + ".auramesh";
+
+    Aura::JobSystem job_system;
+    job_system.initialize(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    Aura::ObjImporter importer;
+    Aura::MeshData mesh;
+    bool cooked = importer.import(input, mesh, &job_system) && cooker.cookToFile(mesh, output);
+    job_system.shutdown();
+    if (!cooked) {
+        return 1;
+    }
+
+    const Aura::ObjImportStats& import_stats = importer.getStats();
+    const Aura::MeshCookStats& cook_stats = cooker.getStats();
+    printf("%s: %u -> %u vertices, %zu indices of %u bytes, %zu submeshes, %llu bytes (import %.1f ms, cook %.1f ms)\n",
+           output.c_str(), cook_stats.input_vertices, cook_stats.output_vertices, mesh.indices.size(), cook_stats.index_size,
+           mesh.submeshes.size(), (unsigned long long)cook_stats.file_bytes,
+           import_stats.map_ms + import_stats.parse_ms + import_stats.emit_ms, cook_stats.cook_ms);
+    printf("vertex cache (fifo %u): acmr %.3f -> %.3f, atvr %.3f -> %.3f (reorder %.1f ms)\n", Aura::MeshOptimizer::k_cache_size,
+           cook_stats.cache_before.acmr, cook_stats.cache_after.acmr, cook_stats.cache_before.atvr, cook_stats.cache_after.atvr,
+           cook_stats.optimize_ms);
+    printf("vertex layout %s: %u bytes per vertex, error position %g, normal %.3f deg, tangent %.3f deg, texcoord %g\n",
+           Aura::VertexEncoder::getLayoutInfo(cook_stats.vertex_layout).name,
+           Aura::VertexEncoder::getLayoutInfo(cook_stats.vertex_layout).stride, cook_stats.vertex_error.position,
+           cook_stats.vertex_error.normal_degrees, cook_stats.vertex_error.tangent_degrees, cook_stats.vertex_error.texcoord);
+    if (cook_stats.meshlet_count != 0) {
+        printf("%u meshlets, %.1f triangles each (build %.1f ms)\n", cook_stats.meshlet_count,
+               (double)mesh.indices.size() / 3.0 / cook_stats.meshlet_count, cook_stats.meshlet_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+namespace Aura
+{
+    static std::atomic<uint64_t> s_global_new_count {0};
+
+    uint64_t getGlobalNewCount()
+    {
+        return s_global_new_count.load(std::memory_order_relaxed);
+    }
+
+    static void* countedAllocate(size_t size)
+    {
+        s_global_new_count.fetch_add(1, std::memory_order_relaxed);
+        return malloc(size == 0 ? 1 : size);
+    }
+} // namespace Aura
+
+void* operator new(size_t size)
+{
+    void* allocation = Aura::countedAllocate(size);
+    if (allocation == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return allocation;
+}
+
+void* operator new[](size_t size)
+{
+    void* allocation = Aura::countedAllocate(size);
+    if (allocation == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return allocation;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Aura::countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Aura::countedAllocate(size);
+}
+
+void operator delete(void* allocation) noexcept
+{
+    free(allocation);
+}
+
+void operator delete[](void* allocation) noexcept
+{
+    free(allocation);
+}
+
+void operator delete(void* allocation, size_t) noexcept
+{
+    free(allocation);
+}
+
+void operator delete[](void* allocation, size_t) noexcept
+{
+    free(allocation);
+}
+
+void operator delete(void* allocation, const std::nothrow_t&) noexcept
+{
+    free(allocation);
+}
+
+void operator delete[](void* allocation, const std::nothrow_t&) noexcept
+{
+    free(allocation);
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+namespace Aura
+{
+    // calls to the global operator new and new[] made by all threads so far. allocation_counter.cpp replaces
+    // the global operators with counting ones that forward to malloc, so std containers, std::function and
+    // strings all show up here. over-aligned news keep the default operators and are not counted
+    uint64_t getGlobalNewCount();
+} // namespace Aura
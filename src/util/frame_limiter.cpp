@@ -0,0 +1,51 @@
+#include "frame_limiter.h"
+
+#include <thread>
+namespace Aura
+{
+    void FrameLimiter::setTargetFps(double fps)
+    {
+        m_frame_period = fps > 0.0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(1.0 / fps))
+                                   : std::chrono::steady_clock::duration(0);
+        m_next_frame   = std::chrono::steady_clock::time_point {};
+    }
+
+    double FrameLimiter::getTargetFps() const
+    {
+        return m_frame_period.count() > 0 ? 1.0 / std::chrono::duration<double>(m_frame_period).count() : 0.0;
+    }
+
+    std::chrono::steady_clock::duration FrameLimiter::wait()
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (m_frame_period.count() <= 0)
+        {
+            return std::chrono::steady_clock::duration(0);
+        }
+        if (m_next_frame == std::chrono::steady_clock::time_point {})
+        {
+            m_next_frame = begin + m_frame_period;
+            return std::chrono::steady_clock::duration(0);
+        }
+
+        if (m_next_frame - begin > m_spin_window)
+        {
+            std::this_thread::sleep_for(m_next_frame - begin - m_spin_window);
+        }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        while (now < m_next_frame)
+        {
+            now = std::chrono::steady_clock::now();
+        }
+
+        // deadlines advance by whole periods so the average rate holds, but a frame that ran more than a
+        // period late starts a new schedule instead of letting the next ones run back to back
+        m_next_frame += m_frame_period;
+        if (m_next_frame < now)
+        {
+            m_next_frame = now + m_frame_period;
+        }
+        return now - begin;
+    }
+} // namespace Aura
@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+namespace Aura
+{
+    // paces a loop to a fixed rate. the os sleep only covers the part of the wait that is longer than
+    // m_spin_window, the rest is spun because sleep wakeups can overshoot by a millisecond or more
+    class FrameLimiter
+    {
+    public:
+        // 0 or less disables the limiter
+        void   setTargetFps(double fps);
+        double getTargetFps() const;
+
+        // blocks until the next frame may start and returns the time spent waiting
+        std::chrono::steady_clock::duration wait();
+
+        std::chrono::steady_clock::duration m_spin_window {std::chrono::microseconds(2000)};
+
+    private:
+        std::chrono::steady_clock::duration   m_frame_period {0};
+        std::chrono::steady_clock::time_point m_next_frame {};
+    };
+} // namespace Aura
@@ -0,0 +1,237 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <iostream>
+#define LOG_ERROR(msg) std::cout << "LOG:" << msg << std::endl;
+namespace Aura
+{
+    static thread_local const JobSystem* t_job_system {nullptr};
+    static thread_local uint32_t         t_thread_index {0};
+
+    void JobSystem::initialize(uint32_t worker_count)
+    {
+        m_stopping = false;
+        m_queues.clear();
+        for (uint32_t i = 0; i < worker_count + 1; ++i)
+        {
+            m_queues.emplace_back(new WorkerQueue());
+        }
+
+        t_job_system   = this;
+        t_thread_index = 0;
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+        }
+    }
+
+    void JobSystem::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stopping = true;
+        }
+        m_sleep_condition.notify_all();
+        while (runPendingJob())
+        {
+        }
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+        if (t_job_system == this)
+        {
+            t_job_system = nullptr;
+        }
+    }
+
+    uint32_t JobSystem::getThreadIndex() const
+    {
+        return t_job_system == this ? t_thread_index : 0;
+    }
+
+    void JobSystem::run(JobFunction function, JobCounter* counter)
+    {
+        if (counter != nullptr)
+        {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        push(Job {std::move(function), counter});
+    }
+
+    void JobSystem::runAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+    {
+        if (counter != nullptr)
+        {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            // the last job of dependency swaps the list out under the same lock, so nothing is left behind
+            std::lock_guard<std::mutex> lock(dependency.m_mutex);
+            if (dependency.m_value.load(std::memory_order_acquire) != 0)
+            {
+                dependency.m_continuations.push_back(Job {std::move(function), counter});
+                return;
+            }
+        }
+        push(Job {std::move(function), counter});
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t min_items_per_batch, const RangeFunction& function)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        min_items_per_batch  = std::max(min_items_per_batch, 1u);
+        uint32_t batch_count = std::min(getThreadCount(), (count + min_items_per_batch - 1) / min_items_per_batch);
+
+        JobCounter counter;
+        for (uint32_t i = 1; i < batch_count; ++i)
+        {
+            uint32_t begin = (uint32_t)((uint64_t)count * i / batch_count);
+            uint32_t end   = (uint32_t)((uint64_t)count * (i + 1) / batch_count);
+            run([&function, begin, end]() { function(begin, end); }, &counter);
+        }
+        function(0, (uint32_t)((uint64_t)count / batch_count));
+        wait(counter);
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        while (counter.getValue() != 0)
+        {
+            if (!runPendingJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+        // the thread finishing the last job may still hold the lock, the counter is only safe to drop after it
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+    }
+
+    bool JobSystem::runPendingJob()
+    {
+        Job job;
+        if (!popJob(getThreadIndex(), job))
+        {
+            return false;
+        }
+        execute(job);
+        return true;
+    }
+
+    void JobSystem::push(Job job)
+    {
+        m_queued_count.fetch_add(1, std::memory_order_release);
+        {
+            WorkerQueue& queue = *m_queues[getThreadIndex()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.count == queue.jobs.size())
+            {
+                std::vector<Job> jobs(std::max<size_t>(queue.jobs.size() * 2, 16));
+                for (size_t i = 0; i < queue.count; ++i)
+                {
+                    jobs[i] = std::move(queue.jobs[(queue.first + i) % queue.jobs.size()]);
+                }
+                queue.jobs.swap(jobs);
+                queue.first = 0;
+            }
+            queue.jobs[(queue.first + queue.count++) % queue.jobs.size()] = std::move(job);
+        }
+        // taking the lock orders the push against a worker that is about to sleep
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_sleep_condition.notify_one();
+    }
+
+    bool JobSystem::popJob(uint32_t thread_index, Job& job)
+    {
+        if (m_queued_count.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+
+        {
+            WorkerQueue& own_queue = *m_queues[thread_index];
+            std::lock_guard<std::mutex> lock(own_queue.mutex);
+            if (own_queue.count > 0)
+            {
+                Job& slot = own_queue.jobs[(own_queue.first + --own_queue.count) % own_queue.jobs.size()];
+                job       = std::move(slot);
+                slot      = Job();
+                m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        uint32_t queue_count = (uint32_t)m_queues.size();
+        for (uint32_t i = 1; i < queue_count; ++i)
+        {
+            WorkerQueue& victim = *m_queues[(thread_index + i) % queue_count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.count > 0)
+            {
+                // the oldest job, the owner keeps working on what it pushed last
+                Job& slot    = victim.jobs[victim.first];
+                job          = std::move(slot);
+                slot         = Job();
+                victim.first = (victim.first + 1) % victim.jobs.size();
+                --victim.count;
+                m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+                m_stolen_count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        job.function();
+        m_executed_count.fetch_add(1, std::memory_order_relaxed);
+
+        JobCounter* counter = job.counter;
+        if (counter == nullptr)
+        {
+            return;
+        }
+        std::vector<Job> continuations;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_mutex);
+            if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                continuations.swap(counter->m_continuations);
+            }
+        }
+        for (Job& continuation : continuations)
+        {
+            push(std::move(continuation));
+        }
+    }
+
+    void JobSystem::workerLoop(uint32_t thread_index)
+    {
+        t_job_system   = this;
+        t_thread_index = thread_index;
+        for (;;)
+        {
+            Job job;
+            if (popJob(thread_index, job))
+            {
+                execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleep_condition.wait(lock, [this]() { return m_stopping || m_queued_count.load(std::memory_order_acquire) != 0; });
+            if (m_stopping && m_queued_count.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+} // namespace Aura
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace Aura
+{
+    class JobCounter;
+
+    struct Job
+    {
+        std::function<void()> function;
+        // decremented once function has returned, may be null
+        JobCounter* counter {nullptr};
+    };
+
+    // number of unfinished jobs tied to it. jobs queued with runAfter() are held here until it drops to
+    // zero. a counter must not be destroyed before JobSystem::wait() on it has returned
+    class JobCounter
+    {
+    public:
+        uint32_t getValue() const { return m_value.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_value {0};
+        std::mutex            m_mutex;
+        std::vector<Job>      m_continuations;
+    };
+
+    // fixed pool of workers with one deque per thread. a thread pops its own deque from the back and
+    // steals from the front of the others once it runs dry, waiting threads keep running jobs
+    class JobSystem
+    {
+    public:
+        typedef std::function<void()>                             JobFunction;
+        typedef std::function<void(uint32_t begin, uint32_t end)> RangeFunction;
+
+        // worker_count excludes the calling thread, which becomes thread 0
+        void initialize(uint32_t worker_count);
+        // runs every queued job before joining the workers
+        void shutdown();
+
+        // queues on the calling thread's deque, counter is incremented now
+        void run(JobFunction function, JobCounter* counter = nullptr);
+        // queues once dependency reaches zero, right away if it already has
+        void runAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+        // splits [0, count) into at most one batch per thread, the caller runs the first one and waits for the rest
+        void parallelFor(uint32_t count, uint32_t min_items_per_batch, const RangeFunction& function);
+
+        // runs queued jobs until counter reaches zero instead of blocking
+        void wait(JobCounter& counter);
+        // runs one queued job, false when every deque was empty
+        bool runPendingJob();
+
+        uint32_t getThreadCount() const { return (uint32_t)m_workers.size() + 1; }
+        // 0 on the thread that called initialize() and on threads the system does not own
+        uint32_t getThreadIndex() const;
+
+        std::atomic<uint64_t> m_executed_count {0};
+        std::atomic<uint64_t> m_stolen_count {0};
+
+    private:
+        // a ring that only grows, so pushing and stealing stop touching the heap once it fits the busiest burst
+        struct WorkerQueue
+        {
+            std::mutex       mutex;
+            std::vector<Job> jobs;
+            size_t           first {0};
+            size_t           count {0};
+        };
+
+        void push(Job job);
+        bool popJob(uint32_t thread_index, Job& job);
+        void execute(Job& job);
+        void workerLoop(uint32_t thread_index);
+
+        std::vector<std::thread>                  m_workers;
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        // raised before a job is pushed, so it may briefly count a job no deque holds yet
+        std::atomic<uint32_t>                     m_queued_count {0};
+        std::mutex                                m_sleep_mutex;
+        std::condition_variable                   m_sleep_condition;
+        bool                                      m_stopping {false};
+    };
+} // namespace Aura
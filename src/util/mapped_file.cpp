@@ -0,0 +1,120 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+namespace Aura
+{
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+        m_file = file;
+        m_size = (size_t)size.QuadPart;
+        m_open = true;
+        if (m_size == 0)
+        {
+            return true;
+        }
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_data    = m_mapping != nullptr ? (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (m_data == nullptr)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != nullptr)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != nullptr)
+        {
+            CloseHandle(m_file);
+        }
+        m_data    = nullptr;
+        m_mapping = nullptr;
+        m_file    = nullptr;
+        m_size    = 0;
+        m_open    = false;
+    }
+#else
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(file, &file_stat) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+        m_size = (size_t)file_stat.st_size;
+        m_open = true;
+        if (m_size > 0)
+        {
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                m_size = 0;
+                m_open = false;
+                return false;
+            }
+            // read front to back by every loader, let the kernel read ahead aggressively
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = (const uint8_t*)data;
+        }
+        // the mapping keeps the file referenced
+        ::close(file);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            munmap((void*)m_data, m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+#endif
+} // namespace Aura
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+namespace Aura
+{
+    // read-only view of a whole file. pages are faulted in by the os as they are touched, so nothing is
+    // copied until the caller reads it
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // false when the file cannot be opened or mapped, an empty file maps to a null view
+        bool open(const std::string& path);
+        void close();
+
+        const uint8_t* getData() const { return m_data; }
+        size_t         getSize() const { return m_size; }
+        bool           isOpen() const { return m_open; }
+
+    private:
+        const uint8_t* m_data {nullptr};
+        size_t         m_size {0};
+        bool           m_open {false};
+#ifdef _WIN32
+        void* m_file {nullptr};
+        void* m_mapping {nullptr};
+#endif
+    };
+} // namespace Aura
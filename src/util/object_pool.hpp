@@ -0,0 +1,211 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+namespace Aura
+{
+    // 32-bit generational handle, the slot index in the low 20 bits and the slot's generation in the high 12.
+    // the tag only keeps handles of different pools apart. like the vulkan.hpp handles it converts from and
+    // compares with nullptr, which stands for the invalid handle 0
+    template<typename Tag>
+    class ObjectHandle
+    {
+    public:
+        ObjectHandle() = default;
+        ObjectHandle(std::nullptr_t) {}
+        explicit ObjectHandle(uint32_t value) : m_value(value) {}
+
+        uint32_t getValue() const { return m_value; }
+        explicit operator bool() const { return m_value != 0; }
+
+        friend bool operator==(ObjectHandle a, ObjectHandle b) { return a.m_value == b.m_value; }
+        friend bool operator!=(ObjectHandle a, ObjectHandle b) { return a.m_value != b.m_value; }
+        friend bool operator<(ObjectHandle a, ObjectHandle b) { return a.m_value < b.m_value; }
+
+    private:
+        uint32_t m_value {0};
+    };
+
+    // typed table addressed by generational handles. every field lives in an array of its own, so a lookup of
+    // one field, the vulkan object while recording say, only touches that array. the arrays are split into
+    // chunks that never move, so get() and set() take no lock, only create() and destroy() do.
+    // destroy() bumps the slot's generation, a stale handle then fails isValid() and reads default fields
+    // instead of whatever took the slot over. freed slots are reused oldest first, which keeps a stale handle
+    // failing for as long as possible. generations wrap after 4095 reuses of a slot, which only narrows what
+    // is caught
+    template<typename Handle, typename... Fields>
+    class ObjectPool
+    {
+    public:
+        template<size_t I>
+        using Field = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+        static uint32_t const k_index_bits {20};
+        static uint32_t const k_index_mask {(1u << k_index_bits) - 1};
+        static uint32_t const k_generation_mask {(1u << (32 - k_index_bits)) - 1};
+
+        ObjectPool() = default;
+        ~ObjectPool()
+        {
+            for (std::atomic<Chunk*>& chunk : m_chunks)
+            {
+                delete chunk.load(std::memory_order_relaxed);
+            }
+        }
+        ObjectPool(const ObjectPool&)            = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        // the invalid handle once all 2^20 slots are taken
+        Handle create(const Fields&... fields)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint32_t index;
+            if (!m_free_slots.empty())
+            {
+                index = m_free_slots.front();
+                m_free_slots.pop_front();
+            }
+            else
+            {
+                if (m_slot_count > k_index_mask)
+                {
+                    return Handle();
+                }
+                index = m_slot_count++;
+                if (index % k_chunk_size == 0)
+                {
+                    m_chunks[index / k_chunk_size].store(new Chunk(), std::memory_order_release);
+                }
+            }
+            Chunk&   chunk = *m_chunks[index / k_chunk_size].load(std::memory_order_relaxed);
+            uint32_t slot  = index % k_chunk_size;
+            if (chunk.generations[slot] == 0)
+            {
+                chunk.generations[slot] = 1;
+            }
+            assignFields(chunk, slot, std::index_sequence_for<Fields...>(), fields...);
+            chunk.live[slot] = 1;
+            ++m_live_count;
+            return Handle(((uint32_t)chunk.generations[slot] << k_index_bits) | index);
+        }
+
+        bool isValid(Handle handle) const { return findChunk(handle) != nullptr; }
+
+        // default-constructed for stale handles
+        template<size_t I = 0>
+        Field<I> get(Handle handle) const
+        {
+            const Chunk* chunk = findChunk(handle);
+            return chunk != nullptr ? std::get<I>(chunk->fields)[(handle.getValue() & k_index_mask) % k_chunk_size] : Field<I>();
+        }
+
+        // false for stale handles
+        template<size_t I = 0>
+        bool set(Handle handle, const Field<I>& value)
+        {
+            Chunk* chunk = findChunk(handle);
+            if (chunk == nullptr)
+            {
+                return false;
+            }
+            std::get<I>(chunk->fields)[(handle.getValue() & k_index_mask) % k_chunk_size] = value;
+            return true;
+        }
+
+        // false when the handle is stale, the object was destroyed already
+        bool destroy(Handle handle)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (findChunk(handle) == nullptr)
+            {
+                return false;
+            }
+            release(handle.getValue() & k_index_mask);
+            return true;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (uint32_t index = 0; index < m_slot_count; ++index)
+            {
+                if (m_chunks[index / k_chunk_size].load(std::memory_order_relaxed)->live[index % k_chunk_size])
+                {
+                    release(index);
+                }
+            }
+        }
+
+        uint32_t getLiveCount()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_live_count;
+        }
+
+    private:
+        static_assert(sizeof...(Fields) > 0, "a pool needs at least one field");
+        static_assert(std::conjunction<std::is_trivially_copyable<Fields>...>::value, "fields are plain values");
+        static uint32_t const k_chunk_size {256};
+        static uint32_t const k_max_chunks {(k_index_mask + 1) / k_chunk_size};
+
+        struct Chunk
+        {
+            uint16_t                                        generations[k_chunk_size] {};
+            uint8_t                                         live[k_chunk_size] {};
+            std::tuple<std::array<Fields, k_chunk_size>...> fields {};
+        };
+
+        template<size_t... Is>
+        static void assignFields(Chunk& chunk, uint32_t slot, std::index_sequence<Is...>, const Fields&... fields)
+        {
+            ((std::get<Is>(chunk.fields)[slot] = fields), ...);
+        }
+
+        Chunk* findChunk(Handle handle) const
+        {
+            uint32_t index = handle.getValue() & k_index_mask;
+            Chunk*   chunk = m_chunks[index / k_chunk_size].load(std::memory_order_acquire);
+            if (chunk == nullptr)
+            {
+                return nullptr;
+            }
+            uint32_t slot = index % k_chunk_size;
+            return chunk->live[slot] && chunk->generations[slot] == handle.getValue() >> k_index_bits ? chunk : nullptr;
+        }
+
+        void release(uint32_t index)
+        {
+            Chunk&   chunk = *m_chunks[index / k_chunk_size].load(std::memory_order_relaxed);
+            uint32_t slot  = index % k_chunk_size;
+            chunk.live[slot] = 0;
+            if (++chunk.generations[slot] > k_generation_mask)
+            {
+                chunk.generations[slot] = 1;
+            }
+            m_free_slots.push_back(index);
+            --m_live_count;
+        }
+
+        std::atomic<Chunk*>  m_chunks[k_max_chunks] {};
+        uint32_t             m_slot_count {0};
+        std::deque<uint32_t> m_free_slots;
+        uint32_t             m_live_count {0};
+        std::mutex           m_mutex;
+    };
+} // namespace Aura
+
+namespace std
+{
+    template<typename Tag>
+    struct hash<Aura::ObjectHandle<Tag>>
+    {
+        size_t operator()(Aura::ObjectHandle<Tag> handle) const { return std::hash<uint32_t>()(handle.getValue()); }
+    };
+} // namespace std
@@ -0,0 +1,124 @@
+#include "scratch_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+namespace Aura
+{
+    std::atomic<uint64_t> ScratchArena::s_heap_allocation_count {0};
+    std::atomic<bool>     ScratchArena::s_heap_fallback {false};
+
+    ScratchArena::~ScratchArena()
+    {
+        for (void* allocation : m_heap_allocations)
+        {
+            free(allocation);
+        }
+        freeBlocks();
+    }
+
+    void* ScratchArena::allocate(size_t size, size_t alignment)
+    {
+        if (s_heap_fallback.load(std::memory_order_relaxed))
+        {
+            void* allocation = malloc(std::max<size_t>(size, 1));
+            m_heap_allocations.push_back(allocation);
+            s_heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+            return allocation;
+        }
+
+        for (; m_block < m_blocks.size(); ++m_block, m_offset = 0)
+        {
+            const Block& block   = m_blocks[m_block];
+            uintptr_t    address = ((uintptr_t)block.data + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            size_t       offset  = address - (uintptr_t)block.data;
+            if (offset + size <= block.size)
+            {
+                m_offset = offset + size;
+                return block.data + offset;
+            }
+        }
+
+        // each spill at least doubles the capacity so a burst needs few blocks before they are merged
+        size_t block_size = std::max(std::max(m_min_block_size, size + alignment), getCapacity());
+        Block  block {new uint8_t[block_size], block_size};
+        m_blocks.push_back(block);
+        s_heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+        m_block = m_blocks.size() - 1;
+        uintptr_t address = ((uintptr_t)block.data + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        m_offset          = address - (uintptr_t)block.data + size;
+        return (void*)address;
+    }
+
+    size_t ScratchArena::getCapacity() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    ScratchArena& ScratchArena::get()
+    {
+        thread_local ScratchArena arena;
+        return arena;
+    }
+
+    uint64_t ScratchArena::getHeapAllocationCount()
+    {
+        return s_heap_allocation_count.load(std::memory_order_relaxed);
+    }
+
+    void ScratchArena::setHeapFallback(bool enabled)
+    {
+        s_heap_fallback.store(enabled, std::memory_order_relaxed);
+    }
+
+    ScratchArena::Marker ScratchArena::getMarker() const
+    {
+        return Marker {m_block, m_offset, m_heap_allocations.size()};
+    }
+
+    void ScratchArena::rewind(const Marker& marker)
+    {
+        while (m_heap_allocations.size() > marker.heap_allocation)
+        {
+            free(m_heap_allocations.back());
+            m_heap_allocations.pop_back();
+        }
+        m_block  = marker.block;
+        m_offset = marker.offset;
+
+        if (m_scope_depth == 0 && m_blocks.size() > 1)
+        {
+            size_t capacity = getCapacity();
+            freeBlocks();
+            m_blocks.push_back(Block {new uint8_t[capacity], capacity});
+            s_heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+            m_block  = 0;
+            m_offset = 0;
+        }
+    }
+
+    void ScratchArena::freeBlocks()
+    {
+        for (Block& block : m_blocks)
+        {
+            delete[] block.data;
+        }
+        m_blocks.clear();
+    }
+
+    ScratchScope::ScratchScope() : m_arena(ScratchArena::get()), m_marker(m_arena.getMarker())
+    {
+        ++m_arena.m_scope_depth;
+    }
+
+    ScratchScope::~ScratchScope()
+    {
+        --m_arena.m_scope_depth;
+        m_arena.rewind(m_marker);
+    }
+} // namespace Aura
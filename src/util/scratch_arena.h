@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+namespace Aura
+{
+    // linear allocator for temporaries that die before the call that made them returns, one per thread.
+    // ScratchScope rewinds it, and once the outermost scope has rewound everything the blocks a burst
+    // spilled into are merged into one, so a workload that repeats every frame stops touching the heap
+    // after its first frames
+    class ScratchArena
+    {
+    public:
+        ScratchArena() = default;
+        ~ScratchArena();
+        ScratchArena(const ScratchArena&)            = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        void* allocate(size_t size, size_t alignment);
+        // value-initialized, nothing ever runs destructors on scratch memory
+        template<typename T>
+        T* allocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "scratch memory is never destroyed");
+            T* values = (T*)allocate(sizeof(T) * count, alignof(T));
+            for (size_t i = 0; i < count; ++i)
+            {
+                new (&values[i]) T();
+            }
+            return values;
+        }
+
+        size_t getCapacity() const;
+
+        // the calling thread's arena
+        static ScratchArena& get();
+        // heap allocations made by all arenas so far
+        static uint64_t getHeapAllocationCount();
+        // every allocation goes to the heap and is freed on rewind, the way the std::vector temporaries
+        // behaved. only for measuring what the arena saves
+        static void setHeapFallback(bool enabled);
+
+        size_t m_min_block_size {64 * 1024};
+
+    private:
+        friend class ScratchScope;
+
+        struct Block
+        {
+            uint8_t* data;
+            size_t   size;
+        };
+
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+            size_t heap_allocation;
+        };
+
+        Marker getMarker() const;
+        void   rewind(const Marker& marker);
+        void   freeBlocks();
+
+        std::vector<Block> m_blocks;
+        size_t             m_block {0};
+        size_t             m_offset {0};
+        uint32_t           m_scope_depth {0};
+        std::vector<void*> m_heap_allocations;
+
+        static std::atomic<uint64_t> s_heap_allocation_count;
+        static std::atomic<bool>     s_heap_fallback;
+    };
+
+    // releases everything allocated from the thread's arena while it was alive
+    class ScratchScope
+    {
+    public:
+        ScratchScope();
+        ~ScratchScope();
+        ScratchScope(const ScratchScope&)            = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+
+        template<typename T>
+        T* allocateArray(size_t count)
+        {
+            return m_arena.allocateArray<T>(count);
+        }
+
+    private:
+        ScratchArena&        m_arena;
+        ScratchArena::Marker m_marker;
+    };
+} // namespace Aura